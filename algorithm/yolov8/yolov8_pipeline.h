@@ -0,0 +1,505 @@
+#pragma once
+
+/**
+ * @file yolov8_pipeline.h
+ * @brief YOLOv8 的 AlgoPipeline 阶段实现（输入尺寸与类别数为模板参数）
+ *
+ * Yolov8Pipeline<640, 640, 80> 即标准 COCO 模型：输入 [1,3,640,640]，输出 [1,84,8400]。
+ * Yolov8SegPipeline<640, 640, 80>：输出 [1,116,8400] + 掩码原型 [1,32,160,160]。
+ * Yolov8PosePipeline<640, 640>：输出 [1,56,8400]（1 类 + 17 个关键点 x 3）。
+ */
+
+#include "../../src/algo_utils/coco_classes.h"
+#include "../../src/algo_utils/letterbox.h"
+#include "../../src/algo_utils/letterbox_yuv.h"
+#include "../../src/algo_utils/nms.h"
+#include "../../src/algo_utils/yolov8_decode.h"
+#include "../../src/algo_utils/yolov8_mask.h"
+#include "../../src/plugin/algo_pipeline.h"
+#include "../../src/plugin/tracking_pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace infer_frame {
+namespace yolov8 {
+
+using plugin::FixedShape;
+using plugin::FrameContext;
+
+/**
+ * @brief 各尺度特征图的 anchor 总数（stride 8/16/32）
+ */
+constexpr int64_t anchorCount(int width, int height) {
+  return static_cast<int64_t>(width / 8) * (height / 8) +
+         static_cast<int64_t>(width / 16) * (height / 16) +
+         static_cast<int64_t>(width / 32) * (height / 32);
+}
+
+/**
+ * @brief 前处理：NV12/I420/BGR/RGB UINT8 任意尺寸 -> letterbox -> RGB 平面 float [0,1]
+ *
+ * 已预处理好的 RGB_PLANAR float（尺寸等于模型输入）直接拷贝。
+ * row_stride 小于一行像素、或 size 不足以容纳声明的图像时返回 INVALID_PARAM。
+ */
+template <int Width, int Height>
+struct LetterboxPre {
+  using OutputShape = FixedShape<1, 3, Height, Width>;
+
+  static const AlgoInputCaps* inputCaps() {
+    static const AlgoInputFormat formats[] = {
+      {ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8, 0, 0},
+      {ALGO_PIXEL_FORMAT_I420, ALGO_DATA_TYPE_UINT8, 0, 0},
+      {ALGO_PIXEL_FORMAT_RGB_PLANAR, ALGO_DATA_TYPE_FLOAT32, Width, Height},
+      {ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8, 0, 0},
+      {ALGO_PIXEL_FORMAT_RGB, ALGO_DATA_TYPE_UINT8, 0, 0},
+    };
+    static const AlgoInputCaps caps = {formats, 5, 7680, 4320, 2};
+    return &caps;
+  }
+
+  AlgoStatus run(const AlgoTensor& input, float* output, FrameContext* ctx) const {
+    if (input.pixel_format == ALGO_PIXEL_FORMAT_RGB_PLANAR ||
+        (input.pixel_format == ALGO_PIXEL_FORMAT_UNKNOWN &&
+         input.data_type == ALGO_DATA_TYPE_FLOAT32)) {
+      if (input.data_type != ALGO_DATA_TYPE_FLOAT32 || !OutputShape::matches(input) ||
+          input.size < sizeof(float) * OutputShape::kNumel) {
+        return ALGO_STATUS_ERROR_INVALID_PARAM;
+      }
+      std::memcpy(output, input.data, sizeof(float) * OutputShape::kNumel);
+      ctx->src_width = Width;
+      ctx->src_height = Height;
+      return ALGO_STATUS_SUCCESS;
+    }
+    if (input.pixel_format == ALGO_PIXEL_FORMAT_NV12 ||
+        input.pixel_format == ALGO_PIXEL_FORMAT_I420) {
+      return runYuv(input, output, ctx);
+    }
+
+    if (input.data_type != ALGO_DATA_TYPE_UINT8 || input.ndim != 4 || input.shape[3] != 3 ||
+        (input.pixel_format != ALGO_PIXEL_FORMAT_BGR &&
+         input.pixel_format != ALGO_PIXEL_FORMAT_RGB &&
+         input.pixel_format != ALGO_PIXEL_FORMAT_UNKNOWN)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    const int src_h = static_cast<int>(input.shape[1]);
+    const int src_w = static_cast<int>(input.shape[2]);
+    if (src_w <= 0 || src_h <= 0 || input.row_stride < 0) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    const size_t stride = input.row_stride > 0 ? static_cast<size_t>(input.row_stride)
+                                               : static_cast<size_t>(src_w) * 3;
+    if (!algo_utils::interleavedImageFits(src_w, src_h, stride, input.size)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    algo_utils::LetterboxOptions options;
+    options.swap_rb = input.pixel_format != ALGO_PIXEL_FORMAT_RGB;
+    algo_utils::LetterboxParams params = algo_utils::letterboxToPlanar(
+        static_cast<const uint8_t*>(input.data), src_w, src_h, stride, output, Width, Height,
+        options);
+    fillContext(params, ctx);
+    return ALGO_STATUS_SUCCESS;
+  }
+
+ private:
+  /**
+   * @brief NV12 / I420（shape [1, H, W]）直接 letterbox
+   */
+  static AlgoStatus runYuv(const AlgoTensor& input, float* output, FrameContext* ctx) {
+    if (input.data_type != ALGO_DATA_TYPE_UINT8 || input.ndim != 3 || !input.data) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    const int src_h = static_cast<int>(input.shape[1]);
+    const int src_w = static_cast<int>(input.shape[2]);
+    if (src_w <= 0 || src_h <= 0 || input.row_stride < 0) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    const auto* data = static_cast<const uint8_t*>(input.data);
+    const size_t stride = input.row_stride > 0 ? static_cast<size_t>(input.row_stride) : 0;
+    const algo_utils::YuvImage image =
+        input.pixel_format == ALGO_PIXEL_FORMAT_NV12
+            ? algo_utils::nv12Image(data, src_w, src_h, stride)
+            : algo_utils::i420Image(data, src_w, src_h, stride);
+    if (!algo_utils::yuvImageFits(image, input.size)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    fillContext(algo_utils::letterboxYuvToPlanar(image, output, Width, Height), ctx);
+    return ALGO_STATUS_SUCCESS;
+  }
+
+  static void fillContext(const algo_utils::LetterboxParams& params, FrameContext* ctx) {
+    ctx->src_width = params.src_width;
+    ctx->src_height = params.src_height;
+    ctx->scale = params.scale;
+    ctx->pad_x = static_cast<float>(params.pad_x);
+    ctx->pad_y = static_cast<float>(params.pad_y);
+  }
+};
+
+/**
+ * @brief seg 模型的第二输出：掩码原型 [1, P, H/4, W/4]
+ */
+template <int Width, int Height, int NumProtos>
+struct ProtoOutput {
+  using AuxShape = FixedShape<1, NumProtos, Height / 4, Width / 4>;
+};
+
+template <int Width, int Height>
+struct ProtoOutput<Width, Height, 0> {};
+
+/**
+ * @brief 模型推理：[1,3,H,W] -> [1,NumChannels,A]（NumProtos > 0 时另有掩码原型输出）
+ *
+ * 尚未接入 TensorRT / ONNX Runtime：init / run 返回 ALGO_STATUS_ERROR_NOT_SUPPORTED，
+ * 而不是输出全零让调用方误以为画面中没有目标。
+ */
+template <int Width, int Height, int NumChannels, int NumProtos = 0>
+struct BackendInfer : ProtoOutput<Width, Height, NumProtos> {
+  using InputShape = FixedShape<1, 3, Height, Width>;
+  using OutputShape = FixedShape<1, NumChannels, anchorCount(Width, Height)>;
+
+  AlgoStatus init(const AlgoInitParam* param) {
+    model_path_ = param->model_path;
+    backend_ = param->backend;
+    device_id_ = param->device_id;
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+
+  AlgoStatus run(const float* input, float* output) const {
+    (void)input;
+    (void)output;
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+
+  AlgoStatus run(const float* input, float* output, float* protos) const {
+    static_assert(NumProtos > 0, "only seg models have a proto output");
+    (void)protos;
+    return run(input, output);
+  }
+
+ private:
+  std::string model_path_;
+  AlgoBackendType backend_ = ALGO_BACKEND_UNKNOWN;
+  int device_id_ = 0;
+};
+
+/**
+ * @brief 后处理：解码 [4+C, A] 输出 + 置信度过滤 + 按类别 NMS + 映射回原图坐标
+ *
+ * NumChannels > 4 + C 时（seg / pose）额外通道不参与解码，由派生的后处理按幸存框读取。
+ */
+template <int Width, int Height, int NumClasses, int MaxDetections = 300,
+          int NumChannels = 4 + NumClasses>
+struct DecodePost {
+  static constexpr int64_t kAnchors = anchorCount(Width, Height);
+  using InputShape = FixedShape<1, NumChannels, kAnchors>;
+  static constexpr int kMaxDetections = MaxDetections;
+  static constexpr algo_utils::Yolov8OutputLayout kLayout{NumClasses, NumChannels,
+                                                          static_cast<int>(kAnchors)};
+
+  float conf_threshold = 0.25f;
+  float nms_threshold = 0.45f;
+
+  AlgoStatus configure(const nlohmann::json& params, bool initial) {
+    (void)initial;
+    float conf = conf_threshold;
+    float nms = nms_threshold;
+    try {
+      conf = params.value("conf_threshold", conf_threshold);
+      nms = params.value("nms_threshold", nms_threshold);
+    } catch (const nlohmann::json::exception&) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    if (conf < 0.0f || conf > 1.0f || nms < 0.0f || nms > 1.0f) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    // 输入尺寸由模板参数固定，修改需要换用另一个特化（重新加载）
+    if ((params.contains("input_width") && params["input_width"] != Width) ||
+        (params.contains("input_height") && params["input_height"] != Height)) {
+      return ALGO_STATUS_ERROR_RELOAD_REQUIRED;
+    }
+    conf_threshold = conf;
+    nms_threshold = nms;
+    return ALGO_STATUS_SUCCESS;
+  }
+
+  void run(const float* output, const FrameContext& ctx, AlgoDetSoA* out) {
+    decode(output);
+    const algo_utils::LetterboxParams letterbox = toLetterbox(ctx);
+    for (algo_utils::DetCandidate c : candidates_) {
+      algo_utils::mapToSource(letterbox, &c);
+      plugin::pushDetBox(out, c.x1, c.y1, c.x2, c.y2, c.score, c.class_id);
+    }
+  }
+
+ protected:
+  std::vector<algo_utils::DetCandidate> candidates_;    // NMS 之后，模型输入坐标
+
+  /**
+   * @brief 解码 + NMS，结果在 candidates_（保留 anchor，供读取额外通道）
+   */
+  void decode(const float* output) {
+    // 输出为 [C', A] 通道优先，直接按类别行扫描，不转置
+    candidates_.clear();
+    algo_utils::decodeYolov8(output, kLayout, conf_threshold, &candidates_);
+
+    algo_utils::NmsOptions nms_options = nms_.options();
+    nms_options.iou_threshold = nms_threshold;
+    nms_options.max_detections = kMaxDetections;
+    nms_.setOptions(nms_options);
+    nms_.run(&candidates_);
+  }
+
+  static algo_utils::LetterboxParams toLetterbox(const FrameContext& ctx) {
+    algo_utils::LetterboxParams letterbox;
+    letterbox.src_width = ctx.src_width > 0 ? ctx.src_width : Width;
+    letterbox.src_height = ctx.src_height > 0 ? ctx.src_height : Height;
+    letterbox.dst_width = Width;
+    letterbox.dst_height = Height;
+    letterbox.scale = ctx.scale > 0.0f ? ctx.scale : 1.0f;
+    letterbox.pad_x = static_cast<int>(ctx.pad_x);
+    letterbox.pad_y = static_cast<int>(ctx.pad_y);
+    return letterbox;
+  }
+
+ private:
+  algo_utils::NmsEngine nms_;
+};
+
+/**
+ * @brief 分割后处理：检测 + 幸存框的延迟掩码组装（yolov8_mask.h）
+ *
+ * 掩码系数只对 NMS 之后的框读取，系数 x 原型只在框的裁剪区内计算；
+ * 编码由调用者在 AlgoSegResult::encoding 中指定（RLE 或位图）。
+ */
+template <int Width, int Height, int NumClasses, int NumProtos = 32>
+struct SegPost : DecodePost<Width, Height, NumClasses, 300, 4 + NumClasses + NumProtos> {
+  using AuxShape = FixedShape<1, NumProtos, Height / 4, Width / 4>;
+
+  AlgoStatus runSegmentation(const float* output, const float* protos, const FrameContext& ctx,
+                             AlgoSegResult* result) {
+    if ((result->instance_capacity > 0 && !result->instances) ||
+        (result->mask_capacity > 0 && !result->mask_data) ||
+        (result->encoding != ALGO_MASK_RLE && result->encoding != ALGO_MASK_BITMASK)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    this->decode(output);
+    const algo_utils::LetterboxParams letterbox = this->toLetterbox(ctx);
+    const algo_utils::MaskProtoLayout proto_layout{NumProtos, Width / 4, Height / 4};
+    auto* mask_data = static_cast<uint8_t*>(result->mask_data);
+
+    const int count = static_cast<int>(this->candidates_.size());
+    size_t used = 0;
+    float coefficients[NumProtos];
+    for (int i = 0; i < count; ++i) {
+      const algo_utils::DetCandidate& c = this->candidates_[i];
+      algo_utils::gatherAnchorChannels(output, this->kLayout, c.anchor, 4 + NumClasses,
+                                       NumProtos, coefficients);
+      algo_utils::MaskRegion region =
+          assembler_.assemble(coefficients, protos, proto_layout, c, letterbox);
+      const void* bytes = nullptr;
+      size_t length = 0;
+      if (result->encoding == ALGO_MASK_RLE) {
+        assembler_.encodeRle(&runs_);
+        bytes = runs_.data();
+        length = runs_.size() * sizeof(uint32_t);
+      } else {
+        assembler_.encodeBitmask(&bits_);
+        bytes = bits_.data();
+        length = bits_.size();
+      }
+      if (i < result->instance_capacity) {
+        algo_utils::DetCandidate box = c;
+        algo_utils::mapToSource(letterbox, &box);
+        AlgoSegInstance& inst = result->instances[i];
+        inst.x1 = box.x1;
+        inst.y1 = box.y1;
+        inst.x2 = box.x2;
+        inst.y2 = box.y2;
+        inst.score = box.score;
+        inst.class_id = box.class_id;
+        inst.mask_x = region.x;
+        inst.mask_y = region.y;
+        inst.mask_width = region.width;
+        inst.mask_height = region.height;
+        inst.mask_offset = static_cast<uint32_t>(used);
+        inst.mask_length = static_cast<uint32_t>(length);
+      }
+      if (length > 0 && used + length <= result->mask_capacity) {
+        std::memcpy(mask_data + used, bytes, length);
+      }
+      used += length;
+    }
+    result->num_instances = count;
+    result->mask_used = used;
+    return count > result->instance_capacity || used > result->mask_capacity
+               ? ALGO_STATUS_ERROR_BUFFER_TOO_SMALL
+               : ALGO_STATUS_SUCCESS;
+  }
+
+ private:
+  algo_utils::MaskAssembler assembler_;
+  std::vector<uint32_t> runs_;
+  std::vector<uint8_t> bits_;
+};
+
+/**
+ * @brief 姿态后处理：单类检测 + 幸存框的关键点（与检测共用解码与 NMS）
+ */
+template <int Width, int Height, int NumKeypoints = 17>
+struct PosePost : DecodePost<Width, Height, 1, 300, 5 + 3 * NumKeypoints> {
+  AlgoStatus runPose(const float* output, const FrameContext& ctx, AlgoPoseResult* result) {
+    if ((result->instance_capacity > 0 && !result->instances) ||
+        (result->keypoint_capacity > 0 && !result->keypoints)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    this->decode(output);
+    const algo_utils::LetterboxParams letterbox = this->toLetterbox(ctx);
+
+    const int count = static_cast<int>(this->candidates_.size());
+    const int written = std::min({count, result->instance_capacity,
+                                  result->keypoint_capacity / NumKeypoints});
+    algo_utils::Keypoint keypoints[NumKeypoints];
+    for (int i = 0; i < written; ++i) {
+      algo_utils::DetCandidate box = this->candidates_[i];
+      algo_utils::decodeKeypoints(output, this->kLayout, box, NumKeypoints, keypoints);
+      algo_utils::mapToSource(letterbox, &box);
+      AlgoPoseInstance& inst = result->instances[i];
+      inst.x1 = box.x1;
+      inst.y1 = box.y1;
+      inst.x2 = box.x2;
+      inst.y2 = box.y2;
+      inst.score = box.score;
+      inst.class_id = box.class_id;
+      inst.keypoint_offset = static_cast<uint32_t>(i * NumKeypoints);
+      AlgoKeypoint* out = result->keypoints + i * NumKeypoints;
+      for (int k = 0; k < NumKeypoints; ++k) {
+        algo_utils::mapToSource(letterbox, &keypoints[k]);
+        out[k].x = keypoints[k].x;
+        out[k].y = keypoints[k].y;
+        out[k].score = keypoints[k].score;
+      }
+    }
+    result->num_instances = count;
+    result->num_keypoints = count * NumKeypoints;
+    result->keypoints_per_instance = NumKeypoints;
+    return written < count ? ALGO_STATUS_ERROR_BUFFER_TOO_SMALL : ALGO_STATUS_SUCCESS;
+  }
+};
+
+/**
+ * @brief 发布的类别名称表：80 类按 COCO 顺序，其他类别数不带名称（只有 ID）
+ */
+template <int NumClasses>
+constexpr const char* const* classNames() {
+  return NumClasses == algo_utils::kCocoNumClasses ? algo_utils::kCocoClassNames : nullptr;
+}
+
+inline constexpr const char* kPoseClassNames[] = {"person"};
+
+/**
+ * @brief YOLOv8 流水线特化
+ */
+template <int Width, int Height, int NumClasses>
+struct Yolov8Pipeline
+    : plugin::AlgoPipeline<LetterboxPre<Width, Height>,
+                           BackendInfer<Width, Height, 4 + NumClasses>,
+                           DecodePost<Width, Height, NumClasses>> {
+  static const AlgoInfo* info() {
+    static AlgoBackendType backends[] = {ALGO_BACKEND_TENSORRT, ALGO_BACKEND_ONNXRUNTIME};
+    static AlgoInfo algo_info = {
+      "YOLOv8-Pipeline",
+      "1.0.0",
+      ALGO_TYPE_DETECTION,
+      "YOLOv8 detection built from compile-time pipeline stages",
+      "infer-frame",
+      backends,
+      2,
+      classNames<NumClasses>(),
+      NumClasses
+    };
+    return &algo_info;
+  }
+};
+
+using Yolov8CocoPipeline = Yolov8Pipeline<640, 640, 80>;
+
+/**
+ * @brief YOLOv8-seg：检测框 + 实例掩码（ALGO_TYPE_SEGMENTATION，也可取检测框）
+ */
+template <int Width, int Height, int NumClasses>
+struct Yolov8SegPipeline
+    : plugin::AlgoPipeline<LetterboxPre<Width, Height>,
+                           BackendInfer<Width, Height, 4 + NumClasses + 32, 32>,
+                           SegPost<Width, Height, NumClasses, 32>> {
+  static const AlgoInfo* info() {
+    static AlgoBackendType backends[] = {ALGO_BACKEND_TENSORRT, ALGO_BACKEND_ONNXRUNTIME};
+    static AlgoInfo algo_info = {
+      "YOLOv8-Seg",
+      "1.0.0",
+      ALGO_TYPE_SEGMENTATION,
+      "YOLOv8 instance segmentation, masks assembled per surviving box",
+      "infer-frame",
+      backends,
+      2,
+      classNames<NumClasses>(),
+      NumClasses
+    };
+    return &algo_info;
+  }
+};
+
+/**
+ * @brief YOLOv8-pose：人体框 + 17 个 COCO 关键点（ALGO_TYPE_POSE，也可取检测框）
+ */
+template <int Width, int Height>
+struct Yolov8PosePipeline
+    : plugin::AlgoPipeline<LetterboxPre<Width, Height>,
+                           BackendInfer<Width, Height, 5 + 3 * 17>,
+                           PosePost<Width, Height, 17>> {
+  static const AlgoInfo* info() {
+    static AlgoBackendType backends[] = {ALGO_BACKEND_TENSORRT, ALGO_BACKEND_ONNXRUNTIME};
+    static AlgoInfo algo_info = {
+      "YOLOv8-Pose",
+      "1.0.0",
+      ALGO_TYPE_POSE,
+      "YOLOv8 person keypoints decoded from the shared detection path",
+      "infer-frame",
+      backends,
+      2,
+      kPoseClassNames,
+      1
+    };
+    return &algo_info;
+  }
+};
+
+using Yolov8CocoSegPipeline = Yolov8SegPipeline<640, 640, 80>;
+using Yolov8CocoPosePipeline = Yolov8PosePipeline<640, 640>;
+
+/**
+ * @brief YOLOv8 + ByteTrack：隔帧检测，其余帧传播轨迹（ALGO_TYPE_TRACK）
+ */
+struct Yolov8TrackPipeline : plugin::TrackingPipeline<Yolov8CocoPipeline> {
+  static const AlgoInfo* info() {
+    static AlgoBackendType backends[] = {ALGO_BACKEND_TENSORRT, ALGO_BACKEND_ONNXRUNTIME};
+    static AlgoInfo algo_info = {
+      "YOLOv8-Track",
+      "1.0.0",
+      ALGO_TYPE_TRACK,
+      "YOLOv8 detection every K frames with ByteTrack propagation in between",
+      "infer-frame",
+      backends,
+      2,
+      algo_utils::kCocoClassNames,
+      algo_utils::kCocoNumClasses
+    };
+    return &algo_info;
+  }
+};
+
+}  // namespace yolov8
+}  // namespace infer_frame
@@ -0,0 +1,11 @@
+/**
+ * @file yolov8_pipeline_c.cpp
+ * @brief YOLOv8 C 插件（由 AlgoPipeline 编译期组合生成）
+ *
+ * 与 yolov8_plugin_c.cpp 导出相同的 C 接口，前处理 / 推理 / 后处理由
+ * yolov8_pipeline.h 中的阶段类型组合，输入尺寸与类别数在编译期固定（640x640，80 类）。
+ */
+
+#include "yolov8_pipeline.h"
+
+ALGO_PIPELINE_EXPORT_C(infer_frame::yolov8::Yolov8CocoPipeline)
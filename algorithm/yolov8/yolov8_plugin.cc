@@ -98,6 +98,53 @@ base::Status YOLOv8Plugin::init(
   return base::Status::OK();
 }
 
+base::Status YOLOv8Plugin::updateParams(
+    const std::map<std::string, std::string>& algo_params) {
+  
+  if (!initialized_) {
+    return base::Status(base::StatusCode::kErrorNotInitialized,
+                        "YOLOv8Plugin not initialized");
+  }
+  
+  // 输入尺寸与后端由模型决定，修改需要重新加载
+  for (const char* key : {"input_width", "input_height", "backend_type"}) {
+    if (algo_params.count(key)) {
+      return base::Status::NotImplemented(std::string(key) + " requires model reload");
+    }
+  }
+  
+  float conf_threshold;
+  float nms_threshold;
+  {
+    std::lock_guard<std::mutex> lock(params_mutex_);
+    conf_threshold = conf_threshold_;
+    nms_threshold = nms_threshold_;
+  }
+  try {
+    if (algo_params.count("conf_threshold")) {
+      conf_threshold = std::stof(algo_params.at("conf_threshold"));
+    }
+    if (algo_params.count("nms_threshold")) {
+      nms_threshold = std::stof(algo_params.at("nms_threshold"));
+    }
+  } catch (const std::exception& e) {
+    return base::Status::InvalidParam(std::string("Invalid YOLOv8 param: ") + e.what());
+  }
+  if (conf_threshold < 0.0f || conf_threshold > 1.0f || nms_threshold < 0.0f ||
+      nms_threshold > 1.0f) {
+    return base::Status::InvalidParam("YOLOv8 thresholds must be within [0, 1]");
+  }
+  
+  {
+    std::lock_guard<std::mutex> lock(params_mutex_);
+    conf_threshold_ = conf_threshold;
+    nms_threshold_ = nms_threshold;
+  }
+  LOG_INFO("YOLOv8 params updated - conf: {}, nms: {}", conf_threshold, nms_threshold);
+  
+  return base::Status::OK();
+}
+
 base::Status YOLOv8Plugin::infer(
     std::vector<base::Tensor*>& inputs,
     std::vector<base::Tensor*>& outputs) {
@@ -106,21 +153,14 @@ base::Status YOLOv8Plugin::infer(
     return base::Status(base::StatusCode::kErrorNotInitialized,
                         "YOLOv8Plugin not initialized");
   }
+  if (inputs.empty()) {
+    return base::Status::InvalidParam("YOLOv8 infer needs an input frame");
+  }
   
   LOG_DEBUG("YOLOv8 infer - inputs: {}, outputs: {}",
             inputs.size(), outputs.size());
   
-  // TODO: 实现实际的 YOLO 推理逻辑
-  // 1. 预处理
-  // 2. 后端推理
-  // 3. 后处理（解析检测框、NMS 等）
-  
-  // 占位实现
-  if (backend_) {
-    return backend_->infer(inputs, outputs);
-  }
-  
-  return base::Status::OK();
+  return runBatch({inputs[0]}, &outputs);
 }
 
 base::Status YOLOv8Plugin::inferBatch(
@@ -134,21 +174,123 @@ base::Status YOLOv8Plugin::inferBatch(
   
   LOG_DEBUG("YOLOv8 inferBatch - batch size: {}", batch_inputs.size());
   
-  // TODO: 实现批量推理
-  // 占位实现：逐帧推理
-  for (size_t i = 0; i < batch_inputs.size(); ++i) {
-    auto inputs = const_cast<std::vector<base::Tensor*>&>(batch_inputs[i]);
-    std::vector<base::Tensor*> outputs;
-    auto status = infer(inputs, outputs);
-    if (!status.ok()) {
-      return status;
+  // 所有帧拼成一个 [N, 3, H, W] 输入，只调用一次后端
+  std::vector<base::Tensor*> frames;
+  frames.reserve(batch_inputs.size());
+  for (const auto& inputs : batch_inputs) {
+    if (inputs.empty()) {
+      return base::Status::InvalidParam("YOLOv8 inferBatch needs one input frame per item");
     }
-    batch_outputs.push_back(outputs);
+    frames.push_back(inputs[0]);
+  }
+  
+  std::vector<base::Tensor*> outputs;
+  auto status = runBatch(frames, &outputs);
+  if (!status.ok()) {
+    return status;
+  }
+  for (base::Tensor* output : outputs) {
+    batch_outputs.push_back({output});
   }
   
   return base::Status::OK();
 }
 
+base::Status YOLOv8Plugin::runBatch(const std::vector<base::Tensor*>& frames,
+                                    std::vector<base::Tensor*>* outputs) {
+  if (frames.empty()) {
+    return base::Status::OK();
+  }
+  
+  // 阈值可在线更新：每批取一次快照，同一批内的帧使用同一组阈值
+  float conf_threshold;
+  float nms_threshold;
+  {
+    std::lock_guard<std::mutex> lock(params_mutex_);
+    conf_threshold = conf_threshold_;
+    nms_threshold = nms_threshold_;
+  }
+  
+  // 1. 前处理：每帧写入模型输入中自己的平面
+  const int batch = static_cast<int>(frames.size());
+  base::Tensor* model_input = modelInput(batch);
+  std::vector<algo_utils::LetterboxParams> letterboxes(batch);
+  {
+    algo_utils::ScopedStageTimer timer(recorder_, kStagePreprocess);
+    const size_t plane = static_cast<size_t>(3) * input_width_ * input_height_;
+    float* data = static_cast<float*>(model_input->getData());
+    for (int n = 0; n < batch; ++n) {
+      auto status = preprocess(frames[n], data + plane * n, &letterboxes[n]);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+  
+  // 2. 后端推理（输出由后端分配，这里释放）
+  std::vector<base::Tensor*> model_inputs = {model_input};
+  std::vector<base::Tensor*> model_outputs;
+  base::Status status = base::Status::OK();
+  {
+    algo_utils::ScopedStageTimer timer(recorder_, kStageInference);
+    status = backend_->infer(model_inputs, model_outputs);
+  }
+  if (status.ok() && model_outputs.empty()) {
+    status = base::Status::InferenceError("YOLOv8 backend returned no output");
+  }
+  
+  // 3. 后处理：解码 + NMS + 映射回原图
+  std::vector<std::vector<algo_utils::DetCandidate>> detections;
+  if (status.ok()) {
+    algo_utils::ScopedStageTimer timer(recorder_, kStagePostprocess);
+    status = postprocess(model_outputs[0], conf_threshold, nms_threshold, letterboxes,
+                         &detections);
+  }
+  for (base::Tensor* tensor : model_outputs) {
+    delete tensor;
+  }
+  if (!status.ok()) {
+    return status;
+  }
+  
+  for (const auto& boxes : detections) {
+    outputs->push_back(packDetections(boxes));
+    recorder_.addFrame();
+  }
+  return base::Status::OK();
+}
+
+base::Tensor* YOLOv8Plugin::modelInput(int batch) {
+  if (!model_input_ || model_input_->getDesc().shape_[0] != batch) {
+    base::TensorDesc desc;
+    desc.shape_ = {batch, 3, input_height_, input_width_};
+    desc.data_type_ = nndeploy::base::dataTypeOf<float>();
+    model_input_.reset(
+        new base::Tensor(nndeploy::device::getDefaultHostDevice(), desc, "images"));
+  }
+  return model_input_.get();
+}
+
+base::Tensor* YOLOv8Plugin::packDetections(
+    const std::vector<algo_utils::DetCandidate>& boxes) {
+  base::TensorDesc desc;
+  desc.shape_ = {1, static_cast<int>(boxes.size()), kDetFields};
+  desc.data_type_ = nndeploy::base::dataTypeOf<float>();
+  auto* tensor = new base::Tensor(nndeploy::device::getDefaultHostDevice(), desc, "detections");
+  
+  float* data = static_cast<float*>(tensor->getData());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    float* row = data + i * kDetFields;
+    row[0] = boxes[i].x1;
+    row[1] = boxes[i].y1;
+    row[2] = boxes[i].x2;
+    row[3] = boxes[i].y2;
+    row[4] = boxes[i].score;
+    row[5] = static_cast<float>(boxes[i].class_id);
+  }
+  return tensor;
+}
+
 base::Status YOLOv8Plugin::deinit() {
   if (!initialized_) {
     return base::Status::OK();
@@ -160,6 +302,7 @@ base::Status YOLOv8Plugin::deinit() {
     backend_->deinit();
     backend_.reset();
   }
+  model_input_.reset();
   
   initialized_ = false;
   LOG_INFO("YOLOv8Plugin deinitialized");
@@ -167,21 +310,51 @@ base::Status YOLOv8Plugin::deinit() {
   return base::Status::OK();
 }
 
-base::Status YOLOv8Plugin::preprocess(base::Tensor* input, base::Tensor* output) {
-  // TODO: 实现预处理
-  // - Resize 到 input_width_ x input_height_
-  // - 归一化到 [0, 1]
-  // - HWC -> CHW
-  // - BGR -> RGB (if needed)
+base::Status YOLOv8Plugin::preprocess(base::Tensor* input, float* output,
+                                      algo_utils::LetterboxParams* letterbox) {
+  // 输入：解码器输出的 NHWC BGR uint8 [1, H, W, 3]
+  // 输出：模型输入 NCHW float 中本帧的 [3, input_height_, input_width_] 平面
+  if (!input || !input->getData() || !output) {
+    return base::Status::InvalidParam("preprocess needs allocated input and output tensors");
+  }
+  const auto& in_shape = input->getDesc().shape_;
+  if (in_shape.size() != 4 || in_shape[0] != 1 || in_shape[3] != 3 ||
+      input->getDesc().data_type_.code_ != base::kDataTypeCodeUint) {
+    return base::Status::InvalidParam("preprocess expects NHWC uint8 BGR input");
+  }
+
+  // 单遍完成 resize + 填充 + BGR->RGB + 归一化 + HWC->CHW
+  const int src_width = static_cast<int>(in_shape[2]);
+  const int src_height = static_cast<int>(in_shape[1]);
+  *letterbox = algo_utils::letterboxToPlanar(
+      static_cast<const uint8_t*>(input->getData()), src_width, src_height,
+      static_cast<size_t>(src_width) * 3, output, input_width_, input_height_);
   return base::Status::OK();
 }
 
-base::Status YOLOv8Plugin::postprocess(base::Tensor* input, base::Tensor* output) {
-  // TODO: 实现后处理
-  // - 解析检测结果
-  // - 置信度过滤
-  // - NMS
-  // - 坐标映射回原图
+base::Status YOLOv8Plugin::postprocess(
+    base::Tensor* output, float conf_threshold, float nms_threshold,
+    const std::vector<algo_utils::LetterboxParams>& letterboxes,
+    std::vector<std::vector<algo_utils::DetCandidate>>* detections) {
+  // 输入：模型原始输出 [N, 4 + 80, num_anchors]，通道优先，不做转置
+  if (!output || !output->getData() || !detections) {
+    return base::Status::InvalidParam("postprocess needs an allocated output tensor");
+  }
+  const auto& shape = output->getDesc().shape_;
+  if (shape.size() != 3 || shape[1] < 4 + kNumClasses) {
+    return base::Status::InvalidParam("postprocess expects [N, 4 + C, anchors] output");
+  }
+  if (shape[0] < static_cast<int>(letterboxes.size())) {
+    return base::Status::InvalidParam("postprocess output batch smaller than input batch");
+  }
+
+  algo_utils::Yolov8OutputLayout layout;
+  layout.num_classes = kNumClasses;
+  layout.num_channels = static_cast<int>(shape[1]);
+  layout.num_anchors = static_cast<int>(shape[2]);
+  algo_utils::postprocessYolov8(static_cast<const float*>(output->getData()),
+                                static_cast<int>(letterboxes.size()), layout, conf_threshold,
+                                nms_threshold, letterboxes.data(), &nms_, detections);
   return base::Status::OK();
 }
 
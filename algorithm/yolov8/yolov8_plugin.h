@@ -1,9 +1,14 @@
 #pragma once
 
+#include "algo_utils/letterbox.h"
+#include "algo_utils/nms.h"
+#include "algo_utils/yolov8_decode.h"
+#include "algo_utils/yolov8_postprocess.h"
 #include "plugin/algo_plugin_base.h"
 #include "inference/backend_interface.h"
 #include "utils/one_logger.hpp"
 #include <memory>
+#include <mutex>
 
 namespace infer_frame {
 namespace plugin {
@@ -11,10 +16,15 @@ namespace plugin {
 /**
  * @brief YOLOv8 目标检测插件
  * 
- * 这是一个示例插件，演示如何实现算法插件接口。
- * 实际的 YOLO 检测逻辑需要根据具体需求实现。
+ * 每帧输入为解码器输出的 NHWC BGR uint8 [1, H, W, 3]，插件内部完成
+ * letterbox 前处理 -> 后端推理 -> 解码 + NMS，输出每帧一个检测结果 Tensor：
+ * float [1, num_boxes, 6]，每行 (x1, y1, x2, y2, score, class_id)，坐标为原图坐标。
+ * 输出 Tensor 由插件分配，调用者负责 delete。
+ *
+ * 声明为 final：通过具体类型（如静态链接时）的调用可以去虚化；
+ * 主程序经 shared_ptr<AlgoPluginBase> 的调用仍是虚调用。
  */
-class YOLOv8Plugin : public AlgoPluginBase {
+class YOLOv8Plugin final : public AlgoPluginBase {
  public:
   YOLOv8Plugin();
   ~YOLOv8Plugin() override;
@@ -27,6 +37,8 @@ class YOLOv8Plugin : public AlgoPluginBase {
       const backend::BackendConfig& backend_config,
       const std::map<std::string, std::string>& algo_params) override;
   
+  base::Status updateParams(const std::map<std::string, std::string>& algo_params) override;
+  
   base::Status infer(
       std::vector<base::Tensor*>& inputs,
       std::vector<base::Tensor*>& outputs) override;
@@ -39,26 +51,58 @@ class YOLOv8Plugin : public AlgoPluginBase {
   
   bool isInitialized() const override { return initialized_; }
   
+  algo_utils::PerfStats getStats() const override { return recorder_.snapshot(); }
+  
  private:
+  enum Stage { kStagePreprocess = 0, kStageInference, kStagePostprocess };
+  static constexpr int kNumClasses = 80;
+  static constexpr int kDetFields = 6;    // x1, y1, x2, y2, score, class_id
+  
   bool initialized_;
   std::shared_ptr<backend::BackendInterface> backend_;
   std::string model_path_;
   
-  // YOLO 参数
+  // YOLO 参数（阈值可在线更新，由 params_mutex_ 保护）
   float conf_threshold_;  // 置信度阈值
   float nms_threshold_;   // NMS 阈值
+  std::mutex params_mutex_;
   int input_width_;       // 输入宽度
   int input_height_;      // 输入高度
   
+  algo_utils::StageRecorder recorder_{"preprocess", "inference", "postprocess"};
+  algo_utils::NmsEngine nms_;  // 内部缓冲跨帧复用
+  std::unique_ptr<base::Tensor> model_input_;  // [N, 3, H, W]，batch 变化时重新分配
+  
+  /**
+   * @brief 一批帧：前处理 -> 后端推理 -> 后处理，每帧追加一个检测结果 Tensor 到 outputs
+   */
+  base::Status runBatch(const std::vector<base::Tensor*>& frames,
+                        std::vector<base::Tensor*>* outputs);
+  
+  /**
+   * @brief 模型输入 Tensor（按 batch 复用）
+   */
+  base::Tensor* modelInput(int batch);
+  
+  /**
+   * @brief 预处理：letterbox + BGR->RGB + 归一化 + HWC->CHW
+   * @param output 模型输入中本帧的 [3, input_height_, input_width_] 平面
+   */
+  base::Status preprocess(base::Tensor* input, float* output,
+                          algo_utils::LetterboxParams* letterbox);
+  
   /**
-   * @brief 预处理：图像 resize、归一化等
+   * @brief 后处理：解码 [N, 4 + C, A] 输出 + 按类别 NMS，按帧返回检测框
+   * @param letterboxes 各帧前处理参数，用于把框映射回原图
    */
-  base::Status preprocess(base::Tensor* input, base::Tensor* output);
+  base::Status postprocess(base::Tensor* output, float conf_threshold, float nms_threshold,
+                           const std::vector<algo_utils::LetterboxParams>& letterboxes,
+                           std::vector<std::vector<algo_utils::DetCandidate>>* detections);
   
   /**
-   * @brief 后处理：解析检测结果、NMS 等
+   * @brief 检测框打包为 float [1, num_boxes, kDetFields] Tensor
    */
-  base::Status postprocess(base::Tensor* input, base::Tensor* output);
+  static base::Tensor* packDetections(const std::vector<algo_utils::DetCandidate>& boxes);
 };
 
 }  // namespace plugin
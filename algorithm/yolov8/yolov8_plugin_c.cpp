@@ -9,13 +9,28 @@
  * 4. 不依赖主程序的 BackendFactory
  */
 
+#include "../../src/plugin/algo_det_soa.h"
 #include "../../src/plugin/algo_plugin_interface.h"
+#include "../../src/plugin/plugin_abi.h"
+#include "../../src/algo_utils/coco_classes.h"
+#include "../../src/algo_utils/letterbox.h"
+#include "../../src/algo_utils/letterbox_yuv.h"
+#include "../../src/algo_utils/nms.h"
+#include "../../src/algo_utils/roi.h"
+#include "../../src/algo_utils/stage_timer.h"
+#include "../../src/algo_utils/tiling.h"
+#include "../../src/algo_utils/yolov8_decode.h"
 
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <cstring>
 #include <memory>
+#include <mutex>
 
 // ============================================================================
 // YOLOv8 算法实现类（C++ 内部实现）
@@ -42,12 +57,9 @@ class YOLOv8Impl {
     device_id_ = param->device_id;
     
     // 解析 JSON 配置
-    if (param->config_json) {
-      // TODO: 解析 JSON 参数（conf_threshold, nms_threshold 等）
-      conf_threshold_ = 0.25f;
-      nms_threshold_ = 0.45f;
-      input_width_ = 640;
-      input_height_ = 640;
+    Params params;
+    if (!parseParams(param->config_json, &params)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
     }
     
     // 根据 Backend 类型初始化推理引擎
@@ -67,63 +79,285 @@ class YOLOv8Impl {
         return ALGO_STATUS_ERROR_BACKEND_NOT_SUPPORTED;
     }
     
+    // 初始化成功后才生效，失败时实例保持原状
+    params_ = params;
+    input_width_ = params.input_width;
+    input_height_ = params.input_height;
     initialized_ = true;
     std::cout << "[YOLOv8] Initialized successfully" << std::endl;
     std::cout << "[YOLOv8] Model: " << model_path_ << std::endl;
     std::cout << "[YOLOv8] Backend: " << backend_ << std::endl;
     std::cout << "[YOLOv8] Device: " << device_id_ << std::endl;
-    std::cout << "[YOLOv8] Conf threshold: " << conf_threshold_ << std::endl;
-    std::cout << "[YOLOv8] NMS threshold: " << nms_threshold_ << std::endl;
+    std::cout << "[YOLOv8] Conf threshold: " << params_.conf_threshold << std::endl;
+    std::cout << "[YOLOv8] NMS threshold: " << params_.nms_threshold << std::endl;
     
     return ALGO_STATUS_SUCCESS;
   }
   
-  AlgoStatus infer(const AlgoTensor* input, AlgoDetResult* result) {
+  /**
+   * @brief 在线更新阈值类参数，下一帧生效；输入尺寸变化需要重新加载模型
+   *
+   * 在当前参数上合并：config_json 中出现的字段覆盖当前值，未出现的字段保持当前值。
+   */
+  AlgoStatus setParams(const char* config_json) {
     if (!initialized_) {
       return ALGO_STATUS_ERROR_NOT_INITIALIZED;
     }
     
+    Params params = snapshotParams();
+    if (!parseParams(config_json, &params)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    if (params.input_width != input_width_ || params.input_height != input_height_) {
+      return ALGO_STATUS_ERROR_RELOAD_REQUIRED;
+    }
+    
+    {
+      std::lock_guard<std::mutex> lock(params_mutex_);
+      params_ = params;
+    }
+    return ALGO_STATUS_SUCCESS;
+  }
+  
+  /**
+   * @brief 检测，旧格式结果（类别名称按 COCO 名称表逐框填入）
+   */
+  AlgoStatus infer(const AlgoTensor* input, AlgoDetResult* result) {
+    if (!initialized_) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
     if (!input || !result) {
       return ALGO_STATUS_ERROR_INVALID_PARAM;
     }
+    result->boxes = nullptr;
+    result->num_boxes = 0;
+    result->timestamp = 0;
+    AlgoStatus status = detect(input);
+    if (status != ALGO_STATUS_SUCCESS || candidates_.empty()) {
+      return status;
+    }
     
-    std::cout << "[YOLOv8] Running inference..." << std::endl;
-    std::cout << "[YOLOv8] Input shape: [";
-    for (int i = 0; i < input->ndim; ++i) {
-      std::cout << input->shape[i];
-      if (i < input->ndim - 1) std::cout << ", ";
+    const infer_frame::plugin::ClassNameTable names{
+        infer_frame::algo_utils::kCocoClassNames, infer_frame::algo_utils::kCocoNumClasses};
+    result->boxes = new (std::nothrow) AlgoDetBox[candidates_.size()];
+    if (!result->boxes) {
+      return ALGO_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+    for (const auto& candidate : candidates_) {
+      AlgoDetBox& box = result->boxes[result->num_boxes++];
+      box.x1 = candidate.x1;
+      box.y1 = candidate.y1;
+      box.x2 = candidate.x2;
+      box.y2 = candidate.y2;
+      box.score = candidate.score;
+      box.class_id = candidate.class_id;
+      std::strncpy(box.class_name, names.name(candidate.class_id), sizeof(box.class_name) - 1);
+      box.class_name[sizeof(box.class_name) - 1] = '\0';
+    }
+    return ALGO_STATUS_SUCCESS;
+  }
+  
+  /**
+   * @brief 检测，紧凑结果直接写入调用者的数组（不带类别名称）
+   */
+  AlgoStatus inferSoA(const AlgoTensor* input, AlgoDetSoA* result) {
+    if (!initialized_) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    if (!input || !infer_frame::plugin::validDetSoA(result)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    result->num_boxes = 0;
+    result->timestamp = 0;
+    AlgoStatus status = detect(input);
+    if (status != ALGO_STATUS_SUCCESS) {
+      return status;
+    }
+    for (const auto& c : candidates_) {
+      infer_frame::plugin::pushDetBox(result, c.x1, c.y1, c.x2, c.y2, c.score, c.class_id);
+    }
+    return result->num_boxes > result->capacity ? ALGO_STATUS_ERROR_BUFFER_TOO_SMALL
+                                                : ALGO_STATUS_SUCCESS;
+  }
+  
+  void getStats(AlgoStats* stats) const {
+    recorder_.fill(stats);
+  }
+  
+ private:
+  /**
+   * @brief 前处理 + 推理 + 解码 + NMS，结果（原图坐标）在 candidates_
+   */
+  AlgoStatus detect(const AlgoTensor* input) {
+    if (!acceptsInput(input)) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
     }
-    std::cout << "]" << std::endl;
     
-    // TODO: 实际推理逻辑
-    // 1. 预处理
-    // 2. Backend 推理
-    // 3. 后处理（NMS）
+    // 每帧开始时取一次参数快照，在线更新不会让同一帧前后使用不同阈值
+    const Params params = snapshotParams();
     
-    // 模拟结果
-    result->num_boxes = 2;
-    result->boxes = new AlgoDetBox[2];
+    const auto frame_begin = std::chrono::steady_clock::now();
+    if (params.tiling && !sameTiling(tile_planner_.options(), params.tile_options)) {
+      tile_planner_.setOptions(params.tile_options);
+    }
+    if (params.roi_revision != roi_revision_) {
+      roi_set_.setRegions(params.rois, params.roi_normalized);
+      roi_revision_ = params.roi_revision;
+    }
+    const float* model_input = nullptr;
+    {
+      infer_frame::algo_utils::ScopedStageTimer timer(recorder_, kStagePreprocess);
+      model_input = preprocess(input, params);
+      if (!model_input) {
+        return ALGO_STATUS_ERROR_INVALID_PARAM;
+      }
+    }
+    const infer_frame::algo_utils::Yolov8OutputLayout layout = outputLayout();
+    const int batch = static_cast<int>(tiles_.size());
+    {
+      infer_frame::algo_utils::ScopedStageTimer timer(recorder_, kStageInference);
+      // 一帧的所有区域作为一个 batch：model_input [batch, 3, H, W] -> [batch, 4 + C, A]
+      (void)model_input;
+      output_buffer_.resize(layout.imageStride() * batch);
+      runModel(batch, layout, output_buffer_.data());
+    }
+    {
+      infer_frame::algo_utils::ScopedStageTimer timer(recorder_, kStageDecode);
+      // 直接读通道优先输出，不转置；只有过阈值的 anchor 才读取框坐标
+      candidates_.clear();
+      const bool cull_edges = batch > 1 && tiles_.back().global;
+      for (int t = 0; t < batch; ++t) {
+        size_t kept = candidates_.size();
+        infer_frame::algo_utils::decodeYolov8(output_buffer_.data() + t * layout.imageStride(),
+                                              layout, params.conf_threshold, &candidates_);
+        const infer_frame::algo_utils::RoiMask* mask = region_masks_[t];
+        for (size_t i = kept; i < candidates_.size(); ++i) {
+          infer_frame::algo_utils::DetCandidate candidate = candidates_[i];
+          // 多边形 ROI：框中心（模型输入坐标）查掩码，多边形外的框在 NMS 之前丢弃
+          if (mask && !mask->contains(0.5f * (candidate.x1 + candidate.x2),
+                                      0.5f * (candidate.y1 + candidate.y2))) {
+            continue;
+          }
+          infer_frame::algo_utils::mapTileToSource(letterboxes_[t], tiles_[t], &candidate);
+          if (cull_edges && infer_frame::algo_utils::touchesInnerEdge(
+                                candidate, tiles_[t], frame_width_, frame_height_)) {
+            continue;
+          }
+          candidates_[kept++] = candidate;
+        }
+        candidates_.resize(kept);
+      }
+    }
+    {
+      // 切片之间重叠区域的重复框也在这里合并
+      infer_frame::algo_utils::ScopedStageTimer timer(recorder_, kStageNms);
+      infer_frame::algo_utils::NmsOptions nms_options = nms_.options();
+      nms_options.iou_threshold = params.nms_threshold;
+      nms_.setOptions(nms_options);
+      nms_.run(&candidates_);
+    }
+    if (params.tiling && roi_set_.empty()) {
+      tile_planner_.reportLatency(std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - frame_begin).count(),
+                                  batch);
+    }
     
-    result->boxes[0].x1 = 100.0f;
-    result->boxes[0].y1 = 150.0f;
-    result->boxes[0].x2 = 300.0f;
-    result->boxes[0].y2 = 400.0f;
-    result->boxes[0].score = 0.95f;
-    result->boxes[0].class_id = 0;
-    strcpy(result->boxes[0].class_name, "person");
+    recorder_.addFrame();
     
-    result->boxes[1].x1 = 200.0f;
-    result->boxes[1].y1 = 100.0f;
-    result->boxes[1].x2 = 450.0f;
-    result->boxes[1].y2 = 350.0f;
-    result->boxes[1].score = 0.88f;
-    result->boxes[1].class_id = 2;
-    strcpy(result->boxes[1].class_name, "car");
+    return ALGO_STATUS_SUCCESS;
+  }
+  
+ public:
+  /**
+   * @brief 输入能力：硬解码输出的 NV12/I420 优先（免去主程序转 BGR），
+   *        已预处理的 RGB 平面 float 可直接送 Backend，
+   *        BGR/RGB 交错 uint8 由插件内部做 letterbox + 归一化
+   */
+  const AlgoInputCaps* getInputCaps() {
+    if (!initialized_) {
+      return nullptr;
+    }
+    input_formats_[0] = {ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8, 0, 0};
+    input_formats_[1] = {ALGO_PIXEL_FORMAT_I420, ALGO_DATA_TYPE_UINT8, 0, 0};
+    input_formats_[2] = {ALGO_PIXEL_FORMAT_RGB_PLANAR, ALGO_DATA_TYPE_FLOAT32,
+                         input_width_, input_height_};
+    input_formats_[3] = {ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8, 0, 0};
+    input_formats_[4] = {ALGO_PIXEL_FORMAT_RGB, ALGO_DATA_TYPE_UINT8, 0, 0};
+    input_caps_.formats = input_formats_;
+    input_caps_.num_formats = 5;
+    input_caps_.max_width = 7680;
+    input_caps_.max_height = 4320;
+    input_caps_.size_align = 2;   // 4:2:0 色度按 2x2 采样
+    return &input_caps_;
+  }
+  
+  /**
+   * @brief 各尺度特征图的 anchor 总数（stride 8/16/32）
+   */
+  int64_t numAnchors() const {
+    return static_cast<int64_t>(input_width_ / 8) * (input_height_ / 8) +
+           static_cast<int64_t>(input_width_ / 16) * (input_height_ / 16) +
+           static_cast<int64_t>(input_width_ / 32) * (input_height_ / 32);
+  }
+  
+  infer_frame::algo_utils::Yolov8OutputLayout outputLayout() const {
+    return {kNumClasses, 4 + kNumClasses, static_cast<int>(numAnchors())};
+  }
+  
+  /**
+   * @brief 原始输出描述：output0 [1, 4 + num_classes, num_anchors]
+   */
+  void describeOutput(AlgoTensor* output) const {
+    int64_t num_anchors = numAnchors();
+    memset(output->name, 0, sizeof(output->name));
+    strcpy(output->name, "output0");
+    output->data_type = ALGO_DATA_TYPE_FLOAT32;
+    output->ndim = 3;
+    output->shape[0] = 1;
+    output->shape[1] = 4 + kNumClasses;
+    output->shape[2] = num_anchors;
+    output->size = static_cast<size_t>(output->shape[1] * num_anchors) * sizeof(float);
+  }
+  
+  AlgoStatus getOutputInfo(AlgoTensor* outputs, int* num_outputs) {
+    if (!initialized_) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    if (!outputs || !num_outputs) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    if (*num_outputs < 1) {
+      *num_outputs = 1;
+      return ALGO_STATUS_ERROR_BUFFER_TOO_SMALL;
+    }
     
-    result->timestamp = 0;
+    describeOutput(&outputs[0]);
+    outputs[0].data = nullptr;
+    *num_outputs = 1;
+    return ALGO_STATUS_SUCCESS;
+  }
+  
+  AlgoStatus inferTensors(const AlgoTensor* inputs, int num_inputs,
+                          AlgoTensor* outputs, int num_outputs) {
+    if (!initialized_) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    if (!inputs || num_inputs != 1 || !inputs[0].data || !acceptsInput(&inputs[0]) || !outputs ||
+        num_outputs < 1) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
     
-    std::cout << "[YOLOv8] Detected " << result->num_boxes << " objects" << std::endl;
+    // 输出缓冲由调用者分配，容量不足时回填所需字节数
+    size_t capacity = outputs[0].size;
+    void* data = outputs[0].data;
+    describeOutput(&outputs[0]);
+    outputs[0].data = data;
+    if (!data || capacity < outputs[0].size) {
+      return ALGO_STATUS_ERROR_BUFFER_TOO_SMALL;
+    }
     
+    // 原始输出直接写入调用者缓冲（不做解码、NMS 等后处理）
+    runModel(1, outputLayout(), static_cast<float*>(data));
     return ALGO_STATUS_SUCCESS;
   }
   
@@ -142,16 +376,308 @@ class YOLOv8Impl {
   bool isInitialized() const { return initialized_; }
   
  private:
+  static constexpr int kNumClasses = 80;
+  
+  /**
+   * @brief 模拟模型在每张输入图上输出的目标（模型输入坐标）
+   */
+  static constexpr infer_frame::algo_utils::DetCandidate kSimulatedObjects[] = {
+    {100.0f, 150.0f, 300.0f, 400.0f, 0.95f, 0, 0},    // person
+    {200.0f, 100.0f, 450.0f, 350.0f, 0.88f, 2, 1},    // car
+  };
+  
+  /**
+   * @brief 模型推理：batch 张图的原始输出 [batch, 4 + C, A] 写入 output
+   *
+   * 插件独立编译、不链接主程序的 Backend，TensorRT / ONNX Runtime 会话接入之前由模拟模型
+   * 产生输出：每张图在 kSimulatedObjects 的位置各有一个目标（anchor 0 / 1），其余 anchor
+   * 分数为 0。输出格式与真实模型相同（cx, cy, w, h + 各类别分数），后续解码路径不区分。
+   */
+  void runModel(int batch, const infer_frame::algo_utils::Yolov8OutputLayout& layout,
+                float* output) const {
+    const size_t anchors = static_cast<size_t>(layout.num_anchors);
+    for (int b = 0; b < batch; ++b) {
+      float* image = output + b * layout.imageStride();
+      std::fill(image, image + layout.imageStride(), 0.0f);
+      for (const auto& object : kSimulatedObjects) {
+        const size_t anchor = static_cast<size_t>(object.anchor);
+        image[anchor] = 0.5f * (object.x1 + object.x2);
+        image[anchors + anchor] = 0.5f * (object.y1 + object.y2);
+        image[2 * anchors + anchor] = object.x2 - object.x1;
+        image[3 * anchors + anchor] = object.y2 - object.y1;
+        image[(4 + object.class_id) * anchors + anchor] = object.score;
+      }
+    }
+  }
+  
+  // 算法参数（阈值可在线更新）
+  struct Params {
+    float conf_threshold = 0.25f;
+    float nms_threshold = 0.45f;
+    int input_width = 640;
+    int input_height = 640;
+    int preprocess_threads = 1;   // letterbox 按行切分的段数（在共享 TaskExecutor 上并行）
+    bool tiling = false;          // 高分辨率切片推理，切片尺寸等于模型输入
+    infer_frame::algo_utils::TilingOptions tile_options;
+    std::vector<infer_frame::algo_utils::RoiRegion> rois;  // 非空时只推理 ROI，忽略切片
+    bool roi_normalized = false;  // ROI 坐标为 [0, 1] 比例
+    int roi_revision = 0;         // 每次设置 rois 递增，推理线程据此重建掩码
+  };
+  
+  enum Stage { kStagePreprocess = 0, kStageInference, kStageDecode, kStageNms };
+  infer_frame::algo_utils::StageRecorder recorder_{"preprocess", "inference", "decode", "nms"};
+  
+  Params snapshotParams() {
+    std::lock_guard<std::mutex> lock(params_mutex_);
+    return params_;
+  }
+  
+  /**
+   * @brief 解析 JSON 参数，只覆盖出现的字段（不修改实例状态，由调用者决定是否生效）
+   */
+  static bool parseParams(const char* config_json, Params* params) {
+    if (!config_json || config_json[0] == '\0') {
+      return true;
+    }
+    try {
+      nlohmann::json j = nlohmann::json::parse(config_json);
+      params->conf_threshold = j.value("conf_threshold", params->conf_threshold);
+      params->nms_threshold = j.value("nms_threshold", params->nms_threshold);
+      params->input_width = j.value("input_width", params->input_width);
+      params->input_height = j.value("input_height", params->input_height);
+      params->preprocess_threads = j.value("preprocess_threads", params->preprocess_threads);
+      auto& tiling = params->tile_options;
+      params->tiling = j.value("tiling", params->tiling);
+      tiling.overlap = j.value("tile_overlap", tiling.overlap);
+      tiling.global_view = j.value("tile_global_view", tiling.global_view);
+      tiling.max_tiles = j.value("max_tiles", tiling.max_tiles);
+      tiling.target_latency_ms = j.value("tile_target_ms", tiling.target_latency_ms);
+      if (j.contains("rois") && !parseRois(j, params)) {
+        return false;
+      }
+    } catch (const std::exception& e) {
+      std::cout << "[YOLOv8] Invalid config_json: " << e.what() << std::endl;
+      return false;
+    }
+    if (params->conf_threshold < 0.0f || params->conf_threshold > 1.0f ||
+        params->nms_threshold < 0.0f || params->nms_threshold > 1.0f ||
+        params->input_width <= 0 || params->input_height <= 0 ||
+        params->preprocess_threads <= 0 || params->tile_options.overlap < 0.0f ||
+        params->tile_options.overlap >= 0.9f || params->tile_options.max_tiles <= 0 ||
+        params->tile_options.target_latency_ms < 0.0f) {
+      return false;
+    }
+    params->tile_options.tile_width = params->input_width;
+    params->tile_options.tile_height = params->input_height;
+    return true;
+  }
+  
+  /**
+   * @brief 解析 ROI：{"rois": [{"rect": [x, y, w, h]}, {"polygon": [[x, y], ...]}],
+   *                  "roi_normalized": false}
+   *
+   * 对应摄像头配置 AddCameraRequest.config["roi"]，由主程序原样放入 config_json。
+   */
+  static bool parseRois(const nlohmann::json& j, Params* params) {
+    std::vector<infer_frame::algo_utils::RoiRegion> rois;
+    for (const auto& item : j.at("rois")) {
+      if (item.contains("rect")) {
+        auto rect = item.at("rect").get<std::vector<float>>();
+        if (rect.size() != 4 || rect[2] <= 0.0f || rect[3] <= 0.0f) {
+          return false;
+        }
+        rois.push_back(infer_frame::algo_utils::roiRect(rect[0], rect[1], rect[2], rect[3]));
+      } else if (item.contains("polygon")) {
+        std::vector<infer_frame::algo_utils::RoiPoint> points;
+        for (const auto& point : item.at("polygon")) {
+          auto xy = point.get<std::vector<float>>();
+          if (xy.size() != 2) {
+            return false;
+          }
+          points.push_back({xy[0], xy[1]});
+        }
+        if (points.size() < 3) {
+          return false;
+        }
+        rois.push_back(infer_frame::algo_utils::roiPolygon(std::move(points)));
+      } else {
+        return false;
+      }
+    }
+    params->rois = std::move(rois);
+    params->roi_normalized = j.value("roi_normalized", false);
+    ++params->roi_revision;
+    return true;
+  }
+  
+  static bool sameTiling(const infer_frame::algo_utils::TilingOptions& a,
+                         const infer_frame::algo_utils::TilingOptions& b) {
+    return a.tile_width == b.tile_width && a.tile_height == b.tile_height &&
+           a.overlap == b.overlap && a.global_view == b.global_view &&
+           a.max_tiles == b.max_tiles && a.target_latency_ms == b.target_latency_ms &&
+           a.align == b.align;
+  }
+  
+  bool acceptsInput(const AlgoTensor* input) const {
+    switch (input->pixel_format) {
+      case ALGO_PIXEL_FORMAT_UNKNOWN:      // 旧版主程序：按 shape 解释
+        return true;
+      case ALGO_PIXEL_FORMAT_RGB_PLANAR:
+        return input->data_type == ALGO_DATA_TYPE_FLOAT32 && input->ndim == 4 &&
+               input->shape[2] == input_height_ && input->shape[3] == input_width_;
+      case ALGO_PIXEL_FORMAT_BGR:
+      case ALGO_PIXEL_FORMAT_RGB:
+        return input->data_type == ALGO_DATA_TYPE_UINT8;
+      case ALGO_PIXEL_FORMAT_NV12:
+      case ALGO_PIXEL_FORMAT_I420:
+        return input->data_type == ALGO_DATA_TYPE_UINT8 && input->ndim == 3;
+      default:
+        return false;
+    }
+  }
+  
+  /**
+   * @brief 交错 uint8 / NV12 / I420 输入按 ROI 或切片（都未开启时为整帧）做单遍 letterbox，
+   *        依次写入内部缓冲构成一个 batch；RGB 平面 float 直接使用
+   *
+   * 结果写入 tiles_ / letterboxes_ / region_masks_，与 batch 一一对应。
+   * @return 模型输入首地址，格式不符、row_stride 小于一行像素或 size 不足时返回 nullptr
+   */
+  const float* preprocess(const AlgoTensor* input, const Params& params) {
+    const bool yuv = input->pixel_format == ALGO_PIXEL_FORMAT_NV12 ||
+                     input->pixel_format == ALGO_PIXEL_FORMAT_I420;
+    const bool interleaved =
+        input->data_type == ALGO_DATA_TYPE_UINT8 && input->ndim == 4 && input->shape[3] == 3;
+    if (!yuv && !interleaved) {
+      const size_t plane_bytes = sizeof(float) * 3 * input_width_ * input_height_;
+      if (input->data_type != ALGO_DATA_TYPE_FLOAT32 || !input->data ||
+          input->size < plane_bytes) {
+        return nullptr;
+      }
+      frame_width_ = input_width_;
+      frame_height_ = input_height_;
+      tiles_.assign(1, fullFrameTile());
+      region_masks_.assign(1, nullptr);
+      letterboxes_.assign(1, infer_frame::algo_utils::computeLetterbox(
+                                 input_width_, input_height_, input_width_, input_height_));
+      return static_cast<const float*>(input->data);
+    }
+    
+    frame_height_ = static_cast<int>(input->shape[1]);
+    frame_width_ = static_cast<int>(input->shape[2]);
+    if (!input->data || frame_width_ <= 0 || frame_height_ <= 0 || input->row_stride < 0) {
+      return nullptr;
+    }
+    const bool fits =
+        yuv ? infer_frame::algo_utils::yuvImageFits(yuvImage(input), input->size)
+            : infer_frame::algo_utils::interleavedImageFits(frame_width_, frame_height_,
+                                                            interleavedStride(input), input->size);
+    if (!fits) {
+      return nullptr;
+    }
+    tiles_.clear();
+    region_masks_.clear();
+    if (!roi_set_.empty()) {
+      for (const auto& roi : roi_set_.resolve(frame_width_, frame_height_, input_width_,
+                                              input_height_)) {
+        tiles_.push_back(roi.crop);
+        region_masks_.push_back(&roi.mask);
+      }
+    }
+    if (tiles_.empty()) {
+      // 未配置 ROI，或 ROI 全部落在画面外
+      if (params.tiling) {
+        tiles_ = tile_planner_.plan(frame_width_, frame_height_);
+      } else {
+        tiles_.assign(1, fullFrameTile());
+      }
+      region_masks_.assign(tiles_.size(), nullptr);
+    }
+    const size_t plane = static_cast<size_t>(3) * input_width_ * input_height_;
+    input_buffer_.resize(plane * tiles_.size());
+    letterboxes_.resize(tiles_.size());
+    for (size_t t = 0; t < tiles_.size(); ++t) {
+      letterboxes_[t] = letterboxRegion(input, params, tiles_[t], input_buffer_.data() + t * plane);
+    }
+    return input_buffer_.data();
+  }
+  
+  /**
+   * @brief 当前帧（frame_width_ x frame_height_）的 NV12 / I420 平面描述
+   */
+  infer_frame::algo_utils::YuvImage yuvImage(const AlgoTensor* input) const {
+    const auto* data = static_cast<const uint8_t*>(input->data);
+    const size_t stride = input->row_stride > 0 ? static_cast<size_t>(input->row_stride) : 0;
+    return input->pixel_format == ALGO_PIXEL_FORMAT_NV12
+               ? infer_frame::algo_utils::nv12Image(data, frame_width_, frame_height_, stride)
+               : infer_frame::algo_utils::i420Image(data, frame_width_, frame_height_, stride);
+  }
+  
+  size_t interleavedStride(const AlgoTensor* input) const {
+    return input->row_stride > 0 ? static_cast<size_t>(input->row_stride)
+                                 : static_cast<size_t>(frame_width_) * 3;
+  }
+  
+  infer_frame::algo_utils::Tile fullFrameTile() const {
+    infer_frame::algo_utils::Tile tile;
+    tile.width = frame_width_;
+    tile.height = frame_height_;
+    tile.global = true;
+    return tile;
+  }
+  
+  /**
+   * @brief 原图的一块区域 letterbox 到 dst（零拷贝截取，NV12 / I420 不经过 BGR 中间图）
+   */
+  infer_frame::algo_utils::LetterboxParams letterboxRegion(
+      const AlgoTensor* input, const Params& params, const infer_frame::algo_utils::Tile& tile,
+      float* dst) const {
+    const auto* data = static_cast<const uint8_t*>(input->data);
+    infer_frame::algo_utils::LetterboxOptions options;
+    options.num_threads = params.preprocess_threads;
+    
+    if (input->pixel_format == ALGO_PIXEL_FORMAT_NV12 ||
+        input->pixel_format == ALGO_PIXEL_FORMAT_I420) {
+      return infer_frame::algo_utils::letterboxYuvToPlanar(
+          infer_frame::algo_utils::cropYuv(yuvImage(input), tile.x, tile.y, tile.width,
+                                           tile.height),
+          dst, input_width_, input_height_, options);
+    }
+    
+    const size_t stride = interleavedStride(input);
+    options.swap_rb = input->pixel_format != ALGO_PIXEL_FORMAT_RGB;
+    return infer_frame::algo_utils::letterboxToPlanar(
+        data + static_cast<size_t>(tile.y) * stride + static_cast<size_t>(tile.x) * 3,
+        tile.width, tile.height, stride, dst, input_width_, input_height_, options);
+  }
+  
+  AlgoInputFormat input_formats_[5];
+  AlgoInputCaps input_caps_;
+  
   bool initialized_;
   std::string model_path_;
   AlgoBackendType backend_;
   int device_id_;
   
   // 算法参数
-  float conf_threshold_;
-  float nms_threshold_;
-  int input_width_;
-  int input_height_;
+  Params params_;
+  std::mutex params_mutex_;      // 保护 params_，推理线程与控制线程并发
+  int input_width_ = 640;
+  int input_height_ = 640;
+  std::vector<float> input_buffer_;   // letterbox 输出 [切片数, 3, H, W]，跨帧复用
+  std::vector<float> output_buffer_;  // 模型原始输出 [切片数, 4 + C, A]
+  std::vector<infer_frame::algo_utils::DetCandidate> candidates_;
+  infer_frame::algo_utils::NmsEngine nms_;
+  
+  // 当前帧的 batch：每块区域（ROI / 切片 / 整帧）及各自的 letterbox 参数与 ROI 掩码
+  infer_frame::algo_utils::TilePlanner tile_planner_;
+  std::vector<infer_frame::algo_utils::Tile> tiles_;
+  std::vector<infer_frame::algo_utils::LetterboxParams> letterboxes_;
+  std::vector<const infer_frame::algo_utils::RoiMask*> region_masks_;  // 切片 / 整帧为空
+  int frame_width_ = 0;
+  int frame_height_ = 0;
+  infer_frame::algo_utils::RoiSet roi_set_;
+  int roi_revision_ = 0;
   
   // Backend 实现（根据类型选择）
   // std::unique_ptr<BackendInterface> backend_impl_;
@@ -174,7 +700,9 @@ static AlgoInfo algo_info = {
   "YOLOv8 object detection with multi-backend support",  // description
   "infer-frame",                             // author
   supported_backends,                        // supported_backends
-  2                                          // num_backends
+  2,                                         // num_backends
+  infer_frame::algo_utils::kCocoClassNames,  // class_names
+  infer_frame::algo_utils::kCocoNumClasses   // num_classes
 };
 
 extern "C" {
@@ -183,6 +711,10 @@ const AlgoInfo* AlgoGetInfo() {
   return &algo_info;
 }
 
+int AlgoNegotiateAbiVersion(int host_abi_version) {
+  return infer_frame::plugin::negotiateAbiVersion(host_abi_version);
+}
+
 AlgoHandle AlgoCreate() {
   std::cout << "[YOLOv8] Creating instance..." << std::endl;
   return reinterpret_cast<AlgoHandle>(new YOLOv8Impl());
@@ -202,8 +734,67 @@ AlgoStatus AlgoInferDetection(AlgoHandle handle, const AlgoTensor* input, AlgoDe
     return ALGO_STATUS_ERROR_INVALID_PARAM;
   }
   
+  // 旧版主程序的 AlgoTensor 没有 pixel_format / row_stride
+  AlgoTensor legacy;
+  YOLOv8Impl* impl = reinterpret_cast<YOLOv8Impl*>(handle);
+  return impl->infer(infer_frame::plugin::hostTensor(input, &legacy), result);
+}
+
+AlgoStatus AlgoInferDetectionSoA(AlgoHandle handle, const AlgoTensor* input,
+                                 AlgoDetSoA* result) {
+  if (!handle) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  
+  YOLOv8Impl* impl = reinterpret_cast<YOLOv8Impl*>(handle);
+  return impl->inferSoA(input, result);
+}
+
+AlgoStatus AlgoGetStats(AlgoHandle handle, AlgoStats* stats) {
+  if (!handle || !stats) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  
+  YOLOv8Impl* impl = reinterpret_cast<YOLOv8Impl*>(handle);
+  impl->getStats(stats);
+  return ALGO_STATUS_SUCCESS;
+}
+
+const AlgoInputCaps* AlgoGetInputCaps(AlgoHandle handle) {
+  if (!handle) {
+    return nullptr;
+  }
+  
+  YOLOv8Impl* impl = reinterpret_cast<YOLOv8Impl*>(handle);
+  return impl->getInputCaps();
+}
+
+AlgoStatus AlgoGetOutputInfo(AlgoHandle handle, AlgoTensor* outputs, int* num_outputs) {
+  if (!handle) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  
+  YOLOv8Impl* impl = reinterpret_cast<YOLOv8Impl*>(handle);
+  return impl->getOutputInfo(outputs, num_outputs);
+}
+
+AlgoStatus AlgoInferTensors(AlgoHandle handle, const AlgoTensor* inputs, int num_inputs,
+                            AlgoTensor* outputs, int num_outputs) {
+  if (!handle) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  
+  YOLOv8Impl* impl = reinterpret_cast<YOLOv8Impl*>(handle);
+  return impl->inferTensors(inputs, num_inputs, outputs, num_outputs);
+}
+
+AlgoStatus AlgoSetParams(AlgoHandle handle, const char* config_json) {
+  if (!handle) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  
   YOLOv8Impl* impl = reinterpret_cast<YOLOv8Impl*>(handle);
-  return impl->infer(input, result);
+  return impl->setParams(config_json);
 }
 
 AlgoStatus AlgoDeinit(AlgoHandle handle) {
@@ -0,0 +1,12 @@
+/**
+ * @file yolov8_pose_c.cpp
+ * @brief YOLOv8-pose C 插件：人体框 + 17 个关键点
+ *
+ * 阶段实现见 yolov8_pipeline.h（PosePost）：关键点与检测共用解码和 NMS，只读取幸存框的通道。
+ * 除检测流水线的 C 接口外还导出 AlgoInferPose。
+ */
+
+#include "yolov8_pipeline.h"
+
+ALGO_PIPELINE_EXPORT_C(infer_frame::yolov8::Yolov8CocoPosePipeline)
+ALGO_PIPELINE_EXPORT_POSE_C(infer_frame::yolov8::Yolov8CocoPosePipeline)
@@ -0,0 +1,12 @@
+/**
+ * @file yolov8_seg_c.cpp
+ * @brief YOLOv8-seg C 插件：检测框 + 按幸存框延迟组装的实例掩码
+ *
+ * 阶段实现见 yolov8_pipeline.h（SegPost），掩码组装见 algo_utils/yolov8_mask.h。
+ * 除检测流水线的 C 接口外还导出 AlgoInferSegmentation（掩码为 RLE 或位图）。
+ */
+
+#include "yolov8_pipeline.h"
+
+ALGO_PIPELINE_EXPORT_C(infer_frame::yolov8::Yolov8CocoSegPipeline)
+ALGO_PIPELINE_EXPORT_SEG_C(infer_frame::yolov8::Yolov8CocoSegPipeline)
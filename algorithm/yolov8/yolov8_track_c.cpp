@@ -0,0 +1,12 @@
+/**
+ * @file yolov8_track_c.cpp
+ * @brief YOLOv8 跟踪 C 插件：每 K 帧检测一次，其余帧由 ByteTrack 传播轨迹
+ *
+ * 检测部分与 yolov8_pipeline_c.cpp 相同（Yolov8CocoPipeline），跟踪参数见 tracking_pipeline.h。
+ * 除检测流水线的 C 接口外还导出 AlgoInferTrack（带轨迹 ID）。
+ */
+
+#include "yolov8_pipeline.h"
+
+ALGO_PIPELINE_EXPORT_C(infer_frame::yolov8::Yolov8TrackPipeline)
+ALGO_TRACK_EXPORT_C(infer_frame::yolov8::Yolov8TrackPipeline)
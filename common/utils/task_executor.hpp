@@ -0,0 +1,467 @@
+#pragma once
+
+/**
+ * @file task_executor.hpp
+ * @brief 进程级共享的工作窃取 CPU 任务执行器
+ *
+ * 所有摄像头的预处理 / 后处理 / NMS / 编码 / 结果序列化都作为任务提交到同一组 worker
+ * （默认每个硬件线程一个），而不是每路摄像头每个阶段各开一个线程：
+ * - 每个 worker 一组按优先级划分的双端队列：外部提交的任务排在队尾（先到先执行），
+ *   worker 提交给自己的后续任务放在队头；自己从队头取，空闲时按优先级从其他 worker 的队尾窃取
+ * - 亲和性提示：同一路摄像头的任务用相同的 affinity（如 camera_id）提交到同一个 worker，
+ *   数据留在同一个核的缓存里；只是提示，空闲 worker 仍会窃取
+ * - 优先级：权重为 0 的优先级严格优先（默认只有 high，如安全区域 / 告警工作流），在所有 worker 上
+ *   都先于其他任务执行；其余优先级按 TaskExecutorOptions::priority_weights 加权公平分享
+ *   （每个 worker 按起始时间公平排队选择优先级），低优先级在过载时仍按份额推进而不会饿死
+ * - TaskGroup：等待一组任务完成（fork-join），等待的线程同时帮忙执行任务，worker 内嵌套等待不会死锁
+ * - 任务抛出的异常不会传出 worker：计入 failed，交给 on_task_error（未设置时写错误日志），
+ *   所属 TaskGroup 的 failed() 随之增加
+ *
+ * @code
+ * auto& executor = TaskExecutor::getInstance();
+ * TaskGroup group;
+ * executor.submit(group, [&] { preprocess(frame); }, {TaskPriority::kHigh, camera_id});
+ * executor.submit(group, [&] { encode(frame); }, {TaskPriority::kLow, camera_id});
+ * executor.wait(group);
+ * @endcode
+ */
+
+#include "one_logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace infer_frame {
+
+enum class TaskPriority {
+  kHigh = 0,
+  kNormal = 1,
+  kLow = 2,
+};
+
+constexpr int kNumTaskPriorities = 3;
+
+struct TaskOptions {
+  TaskPriority priority = TaskPriority::kNormal;
+  int affinity = -1;    // 首选 worker（取模），-1 表示提交到当前 worker 或轮转
+};
+
+struct TaskExecutorOptions {
+  int num_workers = 0;            // 0 表示 std::thread::hardware_concurrency()
+  bool pin_threads = false;       // worker i 绑定到 CPU i（仅 Linux）
+  int spin_before_sleep = 64;     // 找不到任务时休眠前的重试次数
+  int priority_weights[kNumTaskPriorities] = {0, 4, 1};   // 0 表示严格优先，其余为份额
+  std::function<void(const char* what)> on_task_error;    // 任务抛出异常时调用，空表示写 LOG_ERROR
+};
+
+/**
+ * @brief 执行器统计快照
+ */
+struct TaskExecutorStats {
+  int workers = 0;
+  uint64_t submitted = 0;
+  uint64_t executed = 0;
+  uint64_t stolen = 0;              // 由非所属 worker 执行的任务
+  uint64_t failed = 0;              // 抛出异常的任务
+  uint64_t pending = 0;
+  uint64_t executed_by_priority[kNumTaskPriorities] = {};
+  uint64_t wait_ns_total[kNumTaskPriorities] = {};    // 入队到开始执行
+  uint64_t wait_ns_max[kNumTaskPriorities] = {};
+
+  double meanWaitUs(TaskPriority priority) const {
+    const int p = static_cast<int>(priority);
+    return executed_by_priority[p] > 0
+               ? wait_ns_total[p] / 1000.0 / static_cast<double>(executed_by_priority[p])
+               : 0.0;
+  }
+};
+
+/**
+ * @brief 一组任务的完成计数
+ */
+class TaskGroup {
+ public:
+  TaskGroup() = default;
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  size_t pending() const { return pending_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 已完成的任务中抛出异常的个数（wait 返回后读取）
+   */
+  size_t failed() const { return failed_.load(std::memory_order_acquire); }
+
+ private:
+  friend class TaskExecutor;
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> failed_{0};
+};
+
+class TaskExecutor {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief 进程级共享实例（首次调用时创建，worker 数为硬件线程数）
+   */
+  static TaskExecutor& getInstance() {
+    static TaskExecutor executor;
+    return executor;
+  }
+
+  explicit TaskExecutor(const TaskExecutorOptions& options = {});
+
+  /**
+   * @brief 执行完已提交的任务后停止 worker
+   */
+  ~TaskExecutor();
+
+  TaskExecutor(const TaskExecutor&) = delete;
+  TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+  void submit(Task task, const TaskOptions& options = {}) {
+    push(std::move(task), options, nullptr);
+  }
+
+  void submit(TaskGroup& group, Task task, const TaskOptions& options = {}) {
+    group.pending_.fetch_add(1, std::memory_order_relaxed);
+    push(std::move(task), options, &group);
+  }
+
+  /**
+   * @brief 等待 group 中的任务全部完成，等待期间当前线程也执行任务
+   */
+  void wait(TaskGroup& group);
+
+  int numWorkers() const { return static_cast<int>(workers_.size()); }
+
+  /**
+   * @brief 当前线程在本执行器中的 worker 序号，非 worker 线程返回 -1
+   */
+  int currentWorker() const { return tls_owner_ == this ? tls_worker_ : -1; }
+
+  TaskExecutorStats stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Item {
+    Task fn;
+    TaskGroup* group = nullptr;
+    int priority = 0;
+    Clock::time_point enqueue;
+  };
+
+  // 每个 worker 一把锁：只与窃取者竞争，提交 / 执行不经过全局锁
+  struct alignas(64) Worker {
+    std::mutex mutex;
+    std::deque<Item> queues[kNumTaskPriorities];
+    std::thread thread;
+    // 加权公平排队的虚拟时间，只由所属 worker 线程读写
+    double finish_tag[kNumTaskPriorities] = {};
+    double virtual_time = 0.0;
+  };
+
+  TaskExecutorOptions options_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<uint64_t> next_worker_{0};
+  std::atomic<int64_t> pending_{0};
+  std::atomic<bool> stopping_{false};
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<int> sleepers_{0};
+
+  std::atomic<uint64_t> submitted_{0};
+  std::atomic<uint64_t> executed_{0};
+  std::atomic<uint64_t> stolen_{0};
+  std::atomic<uint64_t> failed_{0};
+  std::atomic<uint64_t> executed_by_priority_[kNumTaskPriorities] = {};
+  std::atomic<uint64_t> wait_ns_total_[kNumTaskPriorities] = {};
+  std::atomic<uint64_t> wait_ns_max_[kNumTaskPriorities] = {};
+
+  static thread_local const TaskExecutor* tls_owner_;
+  static thread_local int tls_worker_;
+
+  void push(Task task, const TaskOptions& options, TaskGroup* group);
+  void priorityOrder(int self, int* order) const;
+  bool findTask(int self, Item& item);
+  void execute(Item& item);
+  void reportFailure(Item& item, const char* what);
+  void workerLoop(int index);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline thread_local const TaskExecutor* TaskExecutor::tls_owner_ = nullptr;
+inline thread_local int TaskExecutor::tls_worker_ = -1;
+
+inline TaskExecutor::TaskExecutor(const TaskExecutorOptions& options) : options_(options) {
+  int n = options_.num_workers;
+  if (n <= 0) {
+    n = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  options_.num_workers = n;
+  for (int& weight : options_.priority_weights) {
+    weight = std::max(weight, 0);
+  }
+  for (int i = 0; i < n; ++i) {
+    workers_.emplace_back(new Worker());
+  }
+  const int cpus = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  for (int i = 0; i < n; ++i) {
+    workers_[i]->thread = std::thread(&TaskExecutor::workerLoop, this, i);
+#ifdef __linux__
+    if (options_.pin_threads) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(i % cpus, &set);
+      pthread_setaffinity_np(workers_[i]->thread.native_handle(), sizeof(set), &set);
+    }
+#else
+    (void)cpus;
+#endif
+  }
+}
+
+inline TaskExecutor::~TaskExecutor() {
+  stopping_.store(true, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_all();
+  }
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+inline void TaskExecutor::push(Task task, const TaskOptions& options, TaskGroup* group) {
+  const int n = numWorkers();
+  int target;
+  if (options.affinity >= 0) {
+    target = options.affinity % n;
+  } else if (currentWorker() >= 0) {
+    target = currentWorker();
+  } else {
+    target = static_cast<int>(next_worker_.fetch_add(1, std::memory_order_relaxed) % n);
+  }
+  const int priority =
+      std::min(std::max(static_cast<int>(options.priority), 0), kNumTaskPriorities - 1);
+
+  // worker 提交给自己的后续任务放在队头，紧接着执行（数据还在缓存里，在途帧先于新帧完成）
+  Worker& worker = *workers_[target];
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    Item item{std::move(task), group, priority, Clock::now()};
+    if (target == currentWorker()) {
+      worker.queues[priority].push_front(std::move(item));
+    } else {
+      worker.queues[priority].push_back(std::move(item));
+    }
+  }
+  submitted_.fetch_add(1, std::memory_order_relaxed);
+  pending_.fetch_add(1, std::memory_order_relaxed);
+
+  // 与 worker 的 "登记休眠 -> 复查 pending_" 配对
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleepers_.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_one();
+  }
+}
+
+inline void TaskExecutor::priorityOrder(int self, int* order) const {
+  // 严格优先级在前；加权优先级按起始标签（上一个任务的结束标签与虚拟时间取大）从小到大
+  double key[kNumTaskPriorities];
+  for (int p = 0; p < kNumTaskPriorities; ++p) {
+    order[p] = p;
+    const int weight = options_.priority_weights[p];
+    if (weight == 0) {
+      key[p] = -1.0 - (kNumTaskPriorities - p);
+    } else if (self < 0) {
+      key[p] = p;     // 非 worker 线程（wait 中帮忙执行）按优先级顺序
+    } else {
+      const Worker& worker = *workers_[self];
+      key[p] = std::max(worker.finish_tag[p], worker.virtual_time);
+    }
+  }
+  std::sort(order, order + kNumTaskPriorities,
+            [&key](int a, int b) { return key[a] < key[b] || (key[a] == key[b] && a < b); });
+}
+
+inline bool TaskExecutor::findTask(int self, Item& item) {
+  const int n = numWorkers();
+  int order[kNumTaskPriorities];
+  priorityOrder(self, order);
+  for (int p : order) {
+    if (self >= 0) {
+      Worker& own = *workers_[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.queues[p].empty()) {
+        item = std::move(own.queues[p].front());
+        own.queues[p].pop_front();
+        return true;
+      }
+    }
+    // 窃取：从队尾取，不与所属 worker 争同一端
+    const int start = self >= 0 ? self + 1 : 0;
+    for (int k = 0; k < n; ++k) {
+      const int victim = (start + k) % n;
+      if (victim == self) {
+        continue;
+      }
+      Worker& other = *workers_[victim];
+      std::unique_lock<std::mutex> lock(other.mutex, std::try_to_lock);
+      if (!lock.owns_lock() || other.queues[p].empty()) {
+        continue;
+      }
+      item = std::move(other.queues[p].back());
+      other.queues[p].pop_back();
+      stolen_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void TaskExecutor::execute(Item& item) {
+  pending_.fetch_sub(1, std::memory_order_relaxed);
+  const int self = currentWorker();
+  const int weight = options_.priority_weights[item.priority];
+  if (self >= 0 && weight > 0) {
+    // 起始时间公平排队：空闲过的优先级从当前虚拟时间开始计，不会攒下份额后突发
+    Worker& worker = *workers_[self];
+    const double start = std::max(worker.finish_tag[item.priority], worker.virtual_time);
+    worker.finish_tag[item.priority] = start + 1.0 / weight;
+    worker.virtual_time = start;
+  }
+  const uint64_t wait_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - item.enqueue).count());
+  const int p = item.priority;
+  executed_by_priority_[p].fetch_add(1, std::memory_order_relaxed);
+  wait_ns_total_[p].fetch_add(wait_ns, std::memory_order_relaxed);
+  uint64_t prev = wait_ns_max_[p].load(std::memory_order_relaxed);
+  while (wait_ns > prev &&
+         !wait_ns_max_[p].compare_exchange_weak(prev, wait_ns, std::memory_order_relaxed)) {
+  }
+
+  try {
+    item.fn();
+  } catch (const std::exception& e) {
+    reportFailure(item, e.what());
+  } catch (...) {
+    reportFailure(item, "unknown exception");
+  }
+  item.fn = nullptr;    // 在完成计数之前释放捕获的资源
+  executed_.fetch_add(1, std::memory_order_relaxed);
+  if (item.group) {
+    item.group->pending_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+inline void TaskExecutor::reportFailure(Item& item, const char* what) {
+  failed_.fetch_add(1, std::memory_order_relaxed);
+  if (item.group) {
+    item.group->failed_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (options_.on_task_error) {
+    try {
+      options_.on_task_error(what);
+    } catch (...) {
+    }
+  } else {
+    LOG_ERROR("TaskExecutor: task threw: {}", what);
+  }
+}
+
+inline void TaskExecutor::wait(TaskGroup& group) {
+  const int self = currentWorker();
+  Item item;
+  int idle = 0;
+  while (group.pending() > 0) {
+    if (findTask(self, item)) {
+      execute(item);
+      idle = 0;
+    } else if (++idle < options_.spin_before_sleep) {
+      std::this_thread::yield();
+    } else {
+      // 剩余任务正在其他 worker 上执行
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+}
+
+inline void TaskExecutor::workerLoop(int index) {
+  tls_owner_ = this;
+  tls_worker_ = index;
+  Item item;
+  int idle = 0;
+  while (true) {
+    if (findTask(index, item)) {
+      execute(item);
+      idle = 0;
+      continue;
+    }
+    if (stopping_.load(std::memory_order_acquire) &&
+        pending_.load(std::memory_order_acquire) <= 0) {
+      break;
+    }
+    if (++idle < options_.spin_before_sleep) {
+      std::this_thread::yield();
+      continue;
+    }
+    sleepers_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+      // 在锁内复查：push 持同一把锁唤醒，复查之后的唤醒不会丢失
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.wait(lock, [this] {
+        return pending_.load(std::memory_order_relaxed) > 0 ||
+               stopping_.load(std::memory_order_acquire);
+      });
+    }
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    idle = 0;
+  }
+  tls_owner_ = nullptr;
+  tls_worker_ = -1;
+}
+
+inline TaskExecutorStats TaskExecutor::stats() const {
+  TaskExecutorStats stats;
+  stats.workers = numWorkers();
+  stats.submitted = submitted_.load(std::memory_order_relaxed);
+  stats.executed = executed_.load(std::memory_order_relaxed);
+  stats.stolen = stolen_.load(std::memory_order_relaxed);
+  stats.failed = failed_.load(std::memory_order_relaxed);
+  stats.pending = static_cast<uint64_t>(std::max<int64_t>(pending_.load(), 0));
+  for (int p = 0; p < kNumTaskPriorities; ++p) {
+    stats.executed_by_priority[p] = executed_by_priority_[p].load(std::memory_order_relaxed);
+    stats.wait_ns_total[p] = wait_ns_total_[p].load(std::memory_order_relaxed);
+    stats.wait_ns_max[p] = wait_ns_max_[p].load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+}  // namespace infer_frame
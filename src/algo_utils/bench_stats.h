@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * @file bench_stats.h
+ * @brief 各 *_bench 程序共用的耗时采样与统计（mean / p50 / p99）
+ *
+ * @code
+ * algo_utils::LatencySummary s = algo_utils::measure(1000, [&] { run(); });
+ * LOG_INFO("{:.1f} us", s.p50_us);
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace infer_frame {
+namespace algo_utils {
+
+struct LatencySummary {
+  double mean_us = 0.0;
+  double p50_us = 0.0;
+  double p99_us = 0.0;
+};
+
+inline double elapsedUs(std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin)
+      .count();
+}
+
+/**
+ * @brief 统计一组耗时样本（微秒），会对 samples 排序
+ */
+inline LatencySummary summarize(std::vector<double>& samples) {
+  LatencySummary s;
+  if (samples.empty()) {
+    return s;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0.0;
+  for (double v : samples) {
+    sum += v;
+  }
+  s.mean_us = sum / samples.size();
+  s.p50_us = samples[samples.size() / 2];
+  s.p99_us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+  return s;
+}
+
+/**
+ * @brief 逐次计时 run_once，返回每次的耗时（微秒）
+ */
+template <typename Func>
+std::vector<double> sampleUs(int iterations, Func&& run_once) {
+  std::vector<double> samples;
+  samples.reserve(iterations);
+  for (int i = 0; i < iterations; ++i) {
+    auto begin = std::chrono::steady_clock::now();
+    run_once();
+    samples.push_back(elapsedUs(begin));
+  }
+  return samples;
+}
+
+/**
+ * @brief 预热一次后计时 iterations 次
+ */
+template <typename Func>
+LatencySummary measure(int iterations, Func&& run_once) {
+  run_once();  // 预热：查找表构建、页面分配
+  std::vector<double> samples = sampleUs(iterations, run_once);
+  return summarize(samples);
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file coco_classes.h
+ * @brief COCO 80 类名称表（按 YOLOv8 的类别下标）
+ *
+ * 插件通过 AlgoInfo::class_names 发布一次，结果中只带类别 ID。
+ */
+
+namespace infer_frame {
+namespace algo_utils {
+
+constexpr int kCocoNumClasses = 80;
+
+inline constexpr const char* kCocoClassNames[kCocoNumClasses] = {
+  "person",        "bicycle",      "car",           "motorcycle",    "airplane",
+  "bus",           "train",        "truck",         "boat",          "traffic light",
+  "fire hydrant",  "stop sign",    "parking meter", "bench",         "bird",
+  "cat",           "dog",          "horse",         "sheep",         "cow",
+  "elephant",      "bear",         "zebra",         "giraffe",       "backpack",
+  "umbrella",      "handbag",      "tie",           "suitcase",      "frisbee",
+  "skis",          "snowboard",    "sports ball",   "kite",          "baseball bat",
+  "baseball glove", "skateboard",  "surfboard",     "tennis racket", "bottle",
+  "wine glass",    "cup",          "fork",          "knife",         "spoon",
+  "bowl",          "banana",       "apple",         "sandwich",      "orange",
+  "broccoli",      "carrot",       "hot dog",       "pizza",         "donut",
+  "cake",          "chair",        "couch",         "potted plant",  "bed",
+  "dining table",  "toilet",       "tv",            "laptop",        "mouse",
+  "remote",        "keyboard",     "cell phone",    "microwave",     "oven",
+  "toaster",       "sink",         "refrigerator",  "book",          "clock",
+  "vase",          "scissors",     "teddy bear",    "hair drier",    "toothbrush",
+};
+
+}  // namespace algo_utils
+}  // namespace infer_frame
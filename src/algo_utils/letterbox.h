@@ -0,0 +1,384 @@
+#pragma once
+
+/**
+ * @file letterbox.h
+ * @brief 单遍 letterbox 前处理（header-only，不依赖 OpenCV）
+ *
+ * 一次遍历完成：等比缩放（双线性）+ 填充 + BGR->RGB + 归一化 + HWC->CHW float。
+ * 原来的 OpenCV 写法（resize / cvtColor / convertTo / 逐像素拷贝）要把整帧读写四遍，
+ * 这里每个输出像素只写一次，源图只读取用到的两行。
+ *
+ * - x86_64 上运行时检测 AVX2，8 个输出像素一组向量化，结果与标量实现逐位一致（两者都不做
+ *   FMA 合并，见 INFER_FRAME_NO_FP_CONTRACT）；其他平台走标量实现
+ * - 可按输出行切分为多段，在共享 TaskExecutor 上并行（不为每次调用创建线程）
+ * - 返回 LetterboxParams，用于把模型坐标映射回原图
+ *
+ * @code
+ * algo_utils::LetterboxOptions options;
+ * options.num_threads = 4;
+ * auto params = algo_utils::letterboxToPlanar(bgr, 1920, 1080, 1920 * 3,
+ *                                             input, 640, 640, options);
+ * float x = params.toSrcX(box_x);
+ * @endcode
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../../common/utils/task_executor.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INFER_FRAME_LETTERBOX_X86 1
+#endif
+
+// GCC 在 -O3 下默认 -ffp-contract=fast，目标支持 FMA 时会把分开写的乘、加合并为 FMA，
+// 舍入随之改变；双线性插值的标量与 AVX2 实现都关闭合并，保证两者逐位一致
+#if defined(__GNUC__) && !defined(__clang__)
+#define INFER_FRAME_NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#define INFER_FRAME_NO_FP_CONTRACT
+#endif
+
+namespace infer_frame {
+namespace algo_utils {
+
+/**
+ * @brief letterbox 几何参数
+ */
+struct LetterboxParams {
+  int src_width = 0;
+  int src_height = 0;
+  int dst_width = 0;
+  int dst_height = 0;
+  float scale = 1.0f;     // 原图 -> 模型输入
+  float scale_y = 0.0f;   // 纵向缩放，0 表示与 scale 相同（拉伸模式下两者不同）
+  int new_width = 0;      // 缩放后的有效区域
+  int new_height = 0;
+  int pad_x = 0;          // 左侧填充
+  int pad_y = 0;          // 上方填充
+
+  float toSrcX(float x) const { return (x - pad_x) / scale; }
+  float toSrcY(float y) const { return (y - pad_y) / scaleY(); }
+  float scaleY() const { return scale_y > 0.0f ? scale_y : scale; }
+};
+
+struct LetterboxOptions {
+  bool swap_rb = true;            // 输入为 BGR，输出 RGB 平面
+  float pad_value = 114.0f;       // 填充像素值（归一化前）
+  float norm = 1.0f / 255.0f;     // 归一化系数
+  int num_threads = 1;            // 按输出行切分的段数，>1 时在 executor 上并行
+  TaskExecutor* executor = nullptr;   // nullptr 表示 TaskExecutor::getInstance()
+  bool allow_simd = true;         // false 时强制标量实现（测试 / 对比用）
+  bool yuv_full_range = false;    // YUV 输入：true 为 BT.601 全范围（JPEG），false 为有限范围（视频）
+  bool keep_aspect = true;        // false 时拉伸到目标尺寸（不保持宽高比、不填充）
+};
+
+/**
+ * @brief 交错 3 通道 uint8 图像是否完整落在 size 字节内
+ *
+ * stride 不能小于一行像素（width * 3）；最后一行只需覆盖到行内最后一个像素。
+ */
+inline bool interleavedImageFits(int width, int height, size_t stride, size_t size) {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  const size_t row = static_cast<size_t>(width) * 3;
+  return stride >= row && size >= stride * static_cast<size_t>(height - 1) + row;
+}
+
+/**
+ * @brief 计算等比缩放与居中填充参数
+ */
+inline LetterboxParams computeLetterbox(int src_width, int src_height, int dst_width,
+                                        int dst_height) {
+  LetterboxParams p;
+  p.src_width = src_width;
+  p.src_height = src_height;
+  p.dst_width = dst_width;
+  p.dst_height = dst_height;
+  p.scale = std::min(static_cast<float>(dst_width) / src_width,
+                     static_cast<float>(dst_height) / src_height);
+  p.new_width = std::min(dst_width, static_cast<int>(std::lround(src_width * p.scale)));
+  p.new_height = std::min(dst_height, static_cast<int>(std::lround(src_height * p.scale)));
+  p.pad_x = (dst_width - p.new_width) / 2;
+  p.pad_y = (dst_height - p.new_height) / 2;
+  return p;
+}
+
+/**
+ * @brief 计算拉伸参数：横纵分别缩放到目标尺寸，无填充
+ */
+inline LetterboxParams computeStretch(int src_width, int src_height, int dst_width,
+                                      int dst_height) {
+  LetterboxParams p;
+  p.src_width = src_width;
+  p.src_height = src_height;
+  p.dst_width = dst_width;
+  p.dst_height = dst_height;
+  p.scale = static_cast<float>(dst_width) / src_width;
+  p.scale_y = static_cast<float>(dst_height) / src_height;
+  p.new_width = dst_width;
+  p.new_height = dst_height;
+  return p;
+}
+
+/**
+ * @brief 按 options.keep_aspect 选择 letterbox 或拉伸参数
+ */
+inline LetterboxParams computeResize(int src_width, int src_height, int dst_width,
+                                     int dst_height, const LetterboxOptions& options) {
+  return options.keep_aspect ? computeLetterbox(src_width, src_height, dst_width, dst_height)
+                             : computeStretch(src_width, src_height, dst_width, dst_height);
+}
+
+namespace letterbox_detail {
+
+/**
+ * @brief 水平方向采样表（每个有效输出列一项，整帧共享）
+ */
+struct ColumnTable {
+  std::vector<int32_t> offset0;   // 左侧源像素字节偏移（x0 * 3）
+  std::vector<int32_t> offset1;   // 右侧源像素字节偏移（x1 * 3）
+  std::vector<float> weight;      // 右侧像素权重
+  int vector_end = 0;             // [0, vector_end) 的列 offset1 + 3 + 4 不越过行尾，可用 32 位 gather
+};
+
+inline void buildColumnTable(const LetterboxParams& p, ColumnTable* table) {
+  const int n = p.new_width;
+  table->offset0.resize(n);
+  table->offset1.resize(n);
+  table->weight.resize(n);
+  const float inv_scale = 1.0f / p.scale;
+  const int row_bytes = p.src_width * 3;
+  table->vector_end = n;
+  for (int i = 0; i < n; ++i) {
+    float fx = std::max(0.0f, (i + 0.5f) * inv_scale - 0.5f);
+    int x0 = std::min(static_cast<int>(fx), p.src_width - 1);
+    int x1 = std::min(x0 + 1, p.src_width - 1);
+    table->offset0[i] = x0 * 3;
+    table->offset1[i] = x1 * 3;
+    table->weight[i] = fx - x0;
+  }
+  // gather 一次读 4 字节：最后一个源像素的通道 2 会多读 3 字节，尾部留给标量
+  while (table->vector_end > 0 && table->offset1[table->vector_end - 1] + 2 + 4 > row_bytes) {
+    --table->vector_end;
+  }
+  table->vector_end -= table->vector_end % 8;
+}
+
+inline void fillValue(float* dst, int count, float value) {
+  std::fill(dst, dst + count, value);
+}
+
+/**
+ * @brief 标量实现：处理有效区域一行中 [begin, end) 列
+ */
+INFER_FRAME_NO_FP_CONTRACT inline void blendRowScalar(
+    const uint8_t* row0, const uint8_t* row1, float wy, const ColumnTable& table, int begin,
+    int end, int ch_r, int ch_b, float norm, float* out_r, float* out_g, float* out_b) {
+  const int channels[3] = {ch_r, 1, ch_b};
+  float* outs[3] = {out_r, out_g, out_b};
+  for (int i = begin; i < end; ++i) {
+    const int o0 = table.offset0[i];
+    const int o1 = table.offset1[i];
+    const float wx = table.weight[i];
+    for (int c = 0; c < 3; ++c) {
+      const int ch = channels[c];
+      float top = row0[o0 + ch] + (row0[o1 + ch] - row0[o0 + ch]) * wx;
+      float bottom = row1[o0 + ch] + (row1[o1 + ch] - row1[o0 + ch]) * wx;
+      outs[c][i] = (top + (bottom - top) * wy) * norm;
+    }
+  }
+}
+
+#if defined(INFER_FRAME_LETTERBOX_X86)
+
+inline bool cpuHasAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return supported;
+}
+
+__attribute__((target("avx2"))) inline __m256 gatherChannel(const uint8_t* base,
+                                                            __m256i offsets) {
+  const __m256i mask = _mm256_set1_epi32(0xFF);
+  __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), offsets, 1);
+  return _mm256_cvtepi32_ps(_mm256_and_si256(v, mask));
+}
+
+/**
+ * @brief AVX2 实现：一次 8 个输出像素，[0, table.vector_end) 列
+ *
+ * 只启用 avx2（不带 fma）并关闭 FP 合并，乘加与标量实现一样分两步舍入。
+ */
+__attribute__((target("avx2"))) INFER_FRAME_NO_FP_CONTRACT inline void blendRowAvx2(
+    const uint8_t* row0, const uint8_t* row1, float wy, const ColumnTable& table, int ch_r,
+    int ch_b, float norm, float* out_r, float* out_g, float* out_b) {
+  const __m256 vwy = _mm256_set1_ps(wy);
+  const __m256 vnorm = _mm256_set1_ps(norm);
+  const uint8_t* bases0[3] = {row0 + ch_r, row0 + 1, row0 + ch_b};
+  const uint8_t* bases1[3] = {row1 + ch_r, row1 + 1, row1 + ch_b};
+  float* outs[3] = {out_r, out_g, out_b};
+
+  for (int i = 0; i < table.vector_end; i += 8) {
+    const __m256i o0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&table.offset0[i]));
+    const __m256i o1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&table.offset1[i]));
+    const __m256 wx = _mm256_loadu_ps(&table.weight[i]);
+    for (int c = 0; c < 3; ++c) {
+      __m256 p00 = gatherChannel(bases0[c], o0);
+      __m256 p01 = gatherChannel(bases0[c], o1);
+      __m256 p10 = gatherChannel(bases1[c], o0);
+      __m256 p11 = gatherChannel(bases1[c], o1);
+      // 乘加分两步舍入（不用 FMA），与标量实现一致
+      __m256 top = _mm256_add_ps(p00, _mm256_mul_ps(_mm256_sub_ps(p01, p00), wx));
+      __m256 bottom = _mm256_add_ps(p10, _mm256_mul_ps(_mm256_sub_ps(p11, p10), wx));
+      __m256 value = _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), vwy));
+      _mm256_storeu_ps(outs[c] + i, _mm256_mul_ps(value, vnorm));
+    }
+  }
+}
+
+#endif  // INFER_FRAME_LETTERBOX_X86
+
+/**
+ * @brief 处理输出行 [row_begin, row_end)
+ */
+inline void letterboxRows(const uint8_t* src, size_t src_stride, float* dst,
+                          const LetterboxParams& p, const ColumnTable& table,
+                          const LetterboxOptions& options, bool use_simd, int row_begin,
+                          int row_end) {
+  const int64_t plane = static_cast<int64_t>(p.dst_width) * p.dst_height;
+  const float pad = options.pad_value * options.norm;
+  const int ch_r = options.swap_rb ? 2 : 0;
+  const int ch_b = options.swap_rb ? 0 : 2;
+  const float inv_scale_y = 1.0f / p.scaleY();
+  const int right_pad = p.dst_width - p.pad_x - p.new_width;
+
+  for (int y = row_begin; y < row_end; ++y) {
+    float* out[3];
+    for (int c = 0; c < 3; ++c) {
+      out[c] = dst + c * plane + static_cast<int64_t>(y) * p.dst_width;
+    }
+    if (y < p.pad_y || y >= p.pad_y + p.new_height) {
+      for (int c = 0; c < 3; ++c) {
+        fillValue(out[c], p.dst_width, pad);
+      }
+      continue;
+    }
+
+    float fy = std::max(0.0f, (y - p.pad_y + 0.5f) * inv_scale_y - 0.5f);
+    int y0 = std::min(static_cast<int>(fy), p.src_height - 1);
+    int y1 = std::min(y0 + 1, p.src_height - 1);
+    float wy = fy - y0;
+    const uint8_t* row0 = src + static_cast<size_t>(y0) * src_stride;
+    const uint8_t* row1 = src + static_cast<size_t>(y1) * src_stride;
+
+    for (int c = 0; c < 3; ++c) {
+      fillValue(out[c], p.pad_x, pad);
+      fillValue(out[c] + p.pad_x + p.new_width, right_pad, pad);
+    }
+    float* r = out[0] + p.pad_x;
+    float* g = out[1] + p.pad_x;
+    float* b = out[2] + p.pad_x;
+
+    int scalar_begin = 0;
+#if defined(INFER_FRAME_LETTERBOX_X86)
+    if (use_simd) {
+      blendRowAvx2(row0, row1, wy, table, ch_r, ch_b, options.norm, r, g, b);
+      scalar_begin = table.vector_end;
+    }
+#else
+    (void)use_simd;
+#endif
+    blendRowScalar(row0, row1, wy, table, scalar_begin, p.new_width, ch_r, ch_b, options.norm,
+                   r, g, b);
+  }
+}
+
+/**
+ * @brief 把 [0, rows) 按行切分为 num_bands 段，其余段提交到 executor，调用线程处理第一段
+ *
+ * 等待期间调用线程也执行任务，在 executor 的 worker 中调用不会死锁。
+ */
+template <typename RowFunc>
+void parallelRows(int rows, int num_bands, TaskExecutor* executor, RowFunc&& run_rows) {
+  const int bands = std::max(1, std::min(num_bands, rows));
+  if (bands == 1) {
+    run_rows(0, rows);
+    return;
+  }
+  TaskExecutor& pool = executor ? *executor : TaskExecutor::getInstance();
+  TaskGroup group;
+  const int rows_per_band = (rows + bands - 1) / bands;
+  for (int t = 1; t < bands; ++t) {
+    int begin = t * rows_per_band;
+    int end = std::min(rows, begin + rows_per_band);
+    if (begin >= end) {
+      break;
+    }
+    pool.submit(group, [&run_rows, begin, end]() { run_rows(begin, end); });
+  }
+  run_rows(0, std::min(rows, rows_per_band));
+  pool.wait(group);
+}
+
+}  // namespace letterbox_detail
+
+/**
+ * @brief 当前 CPU 是否使用向量化实现
+ */
+inline bool letterboxUsesSimd() {
+#if defined(INFER_FRAME_LETTERBOX_X86)
+  return letterbox_detail::cpuHasAvx2();
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief 交错 3 通道 uint8（BGR/RGB）-> letterbox -> 3 平面 float（CHW）
+ *
+ * @param src 源图首地址
+ * @param src_width 源图宽
+ * @param src_height 源图高
+ * @param src_stride 源图每行字节数（>= src_width * 3）
+ * @param dst 输出，容量 3 * dst_width * dst_height
+ * @param options keep_aspect 为 false 时拉伸到 dst_width x dst_height
+ * @return letterbox 参数
+ */
+inline LetterboxParams letterboxToPlanar(const uint8_t* src, int src_width, int src_height,
+                                         size_t src_stride, float* dst, int dst_width,
+                                         int dst_height,
+                                         const LetterboxOptions& options = LetterboxOptions()) {
+  LetterboxParams params = computeResize(src_width, src_height, dst_width, dst_height, options);
+
+  // 采样表按线程缓存，同尺寸的连续帧直接复用
+  thread_local std::shared_ptr<const letterbox_detail::ColumnTable> table;
+  thread_local LetterboxParams table_params;
+  if (!table || table_params.src_width != src_width || table_params.src_height != src_height ||
+      table_params.dst_width != dst_width || table_params.dst_height != dst_height ||
+      table_params.scale != params.scale) {
+    auto rebuilt = std::make_shared<letterbox_detail::ColumnTable>();
+    letterbox_detail::buildColumnTable(params, rebuilt.get());
+    table = std::move(rebuilt);
+    table_params = params;
+  }
+
+  // 工作线程看到的是各自的 thread_local 实例，这里显式传调用线程的表；持有引用计数，
+  // 调用线程等待时执行的其他任务即使重建了缓存表，本次调用的各段仍读这一份
+  const std::shared_ptr<const letterbox_detail::ColumnTable> shared_table = table;
+  const bool use_simd = options.allow_simd && letterboxUsesSimd();
+  letterbox_detail::parallelRows(dst_height, options.num_threads, options.executor,
+                                 [&](int begin, int end) {
+    letterbox_detail::letterboxRows(src, src_stride, dst, params, *shared_table, options,
+                                    use_simd, begin, end);
+  });
+  return params;
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
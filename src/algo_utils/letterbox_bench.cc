@@ -0,0 +1,212 @@
+/**
+ * @file letterbox_bench.cc
+ * @brief YOLOv8 前处理耗时对比：OpenCV 多遍实现 vs 单遍 letterbox
+ *
+ * 对比项（输入 1080p / 4K BGR，输出 [1,3,640,640] float）：
+ *   1. OpenCV 4 遍：resize -> cvtColor -> convertTo -> 逐像素 HWC->CHW（原 preprocessImage）
+ *   2. OpenCV letterbox：等比 resize + copyMakeBorder + cvtColor + convertTo + split
+ *   3. 单遍 letterbox，标量
+ *   4. 单遍 letterbox，AVX2（CPU 支持时）
+ *   5. 单遍 letterbox，多线程
+ *   6. NV12 输入：OpenCV 转 BGR + 单遍 letterbox vs 直接从 NV12 letterbox（标量 / AVX2）
+ * 每种实现的输出与同一输入的标量结果比较，maxdiff 为最大绝对误差（归一化后）。
+ * OpenCV 4 遍是拉伸缩放、语义不同，不参与比较。
+ *
+ * 用法: letterbox_bench [iterations] [threads]
+ */
+
+#include "algo_utils/bench_stats.h"
+#include "algo_utils/letterbox.h"
+#include "algo_utils/letterbox_yuv.h"
+#include "utils/one_logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __has_include(<opencv2/opencv.hpp>)
+#include <opencv2/opencv.hpp>
+#define LETTERBOX_BENCH_OPENCV 1
+#endif
+
+using namespace infer_frame;
+
+namespace {
+
+constexpr int kInputWidth = 640;
+constexpr int kInputHeight = 640;
+
+using algo_utils::LatencySummary;
+using algo_utils::measure;
+
+/**
+ * @param max_diff 与标量结果的最大绝对误差，负数表示不比较
+ */
+void report(const std::string& mode, const LatencySummary& s, double baseline_p50,
+            float max_diff = -1.0f) {
+  const double speedup = baseline_p50 > 0.0 ? baseline_p50 / s.p50_us : 1.0;
+  if (max_diff < 0.0f) {
+    LOG_INFO("{:<22} {:>10.1f} {:>10.1f} {:>10.1f} {:>8.2f}x {:>10}", mode, s.mean_us, s.p50_us,
+             s.p99_us, speedup, "-");
+  } else {
+    LOG_INFO("{:<22} {:>10.1f} {:>10.1f} {:>10.1f} {:>8.2f}x {:>10.2e}", mode, s.mean_us,
+             s.p50_us, s.p99_us, speedup, max_diff);
+  }
+}
+
+float maxAbsDiff(const std::vector<float>& a, const std::vector<float>& b) {
+  float diff = 0.0f;
+  for (size_t i = 0; i < a.size(); ++i) {
+    diff = std::max(diff, std::fabs(a[i] - b[i]));
+  }
+  return diff;
+}
+
+#if defined(LETTERBOX_BENCH_OPENCV)
+/**
+ * @brief 原 yolov8_onnx_test 的前处理（拉伸 resize，不保持宽高比）
+ */
+void opencvFourPass(const cv::Mat& image, float* dst) {
+  cv::Mat resized;
+  cv::resize(image, resized, cv::Size(kInputWidth, kInputHeight));
+  cv::Mat rgb;
+  cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
+  rgb.convertTo(rgb, CV_32F, 1.0 / 255.0);
+  const int area = kInputWidth * kInputHeight;
+  for (int c = 0; c < 3; ++c) {
+    for (int h = 0; h < kInputHeight; ++h) {
+      for (int w = 0; w < kInputWidth; ++w) {
+        dst[c * area + h * kInputWidth + w] = rgb.at<cv::Vec3f>(h, w)[c];
+      }
+    }
+  }
+}
+
+/**
+ * @brief 同样语义（等比缩放 + 114 填充）的 OpenCV 写法
+ */
+void opencvLetterbox(const cv::Mat& image, float* dst) {
+  auto params = algo_utils::computeLetterbox(image.cols, image.rows, kInputWidth, kInputHeight);
+  cv::Mat resized;
+  cv::resize(image, resized, cv::Size(params.new_width, params.new_height));
+  cv::Mat padded;
+  cv::copyMakeBorder(resized, padded, params.pad_y,
+                     kInputHeight - params.new_height - params.pad_y, params.pad_x,
+                     kInputWidth - params.new_width - params.pad_x, cv::BORDER_CONSTANT,
+                     cv::Scalar(114, 114, 114));
+  cv::Mat rgb;
+  cv::cvtColor(padded, rgb, cv::COLOR_BGR2RGB);
+  rgb.convertTo(rgb, CV_32F, 1.0 / 255.0);
+  const int area = kInputWidth * kInputHeight;
+  std::vector<cv::Mat> planes = {
+    cv::Mat(kInputHeight, kInputWidth, CV_32F, dst),
+    cv::Mat(kInputHeight, kInputWidth, CV_32F, dst + area),
+    cv::Mat(kInputHeight, kInputWidth, CV_32F, dst + 2 * area),
+  };
+  cv::split(rgb, planes);
+}
+#endif
+
+void runResolution(int width, int height, int iterations, int threads) {
+  std::vector<uint8_t> frame(static_cast<size_t>(width) * height * 3);
+  std::mt19937 rng(42);
+  for (auto& v : frame) {
+    v = static_cast<uint8_t>(rng() & 0xFF);
+  }
+  std::vector<float> output(3 * kInputWidth * kInputHeight);
+  std::vector<float> reference(output.size());
+  const size_t stride = static_cast<size_t>(width) * 3;
+
+  LOG_INFO("--------------------------------------");
+  LOG_INFO("  {}x{} -> {}x{} ({} iterations)", width, height, kInputWidth, kInputHeight,
+           iterations);
+  LOG_INFO("{:<22} {:>10} {:>10} {:>10} {:>9} {:>10}", "mode", "mean(us)", "p50(us)", "p99(us)",
+           "speedup", "maxdiff");
+
+  // 标量结果作为比较基准
+  algo_utils::LetterboxOptions options;
+  options.allow_simd = false;
+  auto scalar = measure(iterations, [&]() {
+    algo_utils::letterboxToPlanar(frame.data(), width, height, stride, reference.data(),
+                                  kInputWidth, kInputHeight, options);
+  });
+
+  double baseline_p50 = scalar.p50_us;
+#if defined(LETTERBOX_BENCH_OPENCV)
+  cv::Mat image(height, width, CV_8UC3, frame.data());
+  auto four_pass = measure(iterations, [&]() { opencvFourPass(image, output.data()); });
+  baseline_p50 = four_pass.p50_us;
+  report("opencv 4-pass", four_pass, baseline_p50);
+  auto opencv = measure(iterations, [&]() { opencvLetterbox(image, output.data()); });
+  report("opencv letterbox", opencv, baseline_p50, maxAbsDiff(output, reference));
+#else
+  LOG_INFO("OpenCV not available, speedup relative to scalar kernel");
+#endif
+  report("single-pass scalar", scalar, baseline_p50, 0.0f);
+
+  if (algo_utils::letterboxUsesSimd()) {
+    options.allow_simd = true;
+    auto simd = measure(iterations, [&]() {
+      algo_utils::letterboxToPlanar(frame.data(), width, height, stride, output.data(),
+                                    kInputWidth, kInputHeight, options);
+    });
+    report("single-pass avx2", simd, baseline_p50, maxAbsDiff(output, reference));
+  } else {
+    LOG_INFO("AVX2 not supported on this CPU, skip SIMD path");
+  }
+
+  if (threads > 1) {
+    options.num_threads = threads;
+    auto banded = measure(iterations, [&]() {
+      algo_utils::letterboxToPlanar(frame.data(), width, height, stride, output.data(),
+                                    kInputWidth, kInputHeight, options);
+    });
+    report("single-pass x" + std::to_string(threads), banded, baseline_p50,
+           maxAbsDiff(output, reference));
+  }
+
+  // 硬解码输出 NV12：复用 frame 的前 1.5 字节/像素作为 Y + UV
+  const algo_utils::YuvImage nv12 = algo_utils::nv12Image(frame.data(), width, height);
+  options = algo_utils::LetterboxOptions();
+  options.allow_simd = false;
+  auto nv12_scalar = measure(iterations, [&]() {
+    algo_utils::letterboxYuvToPlanar(nv12, reference.data(), kInputWidth, kInputHeight, options);
+  });
+  options.allow_simd = true;
+#if defined(LETTERBOX_BENCH_OPENCV)
+  cv::Mat yuv(height * 3 / 2, width, CV_8UC1, frame.data());
+  cv::Mat bgr;
+  auto cvt = measure(iterations, [&]() {
+    cv::cvtColor(yuv, bgr, cv::COLOR_YUV2BGR_NV12);
+    algo_utils::letterboxToPlanar(bgr.data, width, height, bgr.step, output.data(), kInputWidth,
+                                  kInputHeight, options);
+  });
+  report("nv12 cvt+letterbox", cvt, baseline_p50, maxAbsDiff(output, reference));
+#endif
+  report("nv12 direct scalar", nv12_scalar, baseline_p50, 0.0f);
+  if (algo_utils::letterboxUsesSimd()) {
+    auto nv12_simd = measure(iterations, [&]() {
+      algo_utils::letterboxYuvToPlanar(nv12, output.data(), kInputWidth, kInputHeight, options);
+    });
+    report("nv12 direct avx2", nv12_simd, baseline_p50, maxAbsDiff(output, reference));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? std::stoi(argv[1]) : 200;
+  int threads = argc > 2 ? std::stoi(argv[2])
+                         : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+  LOG_INFO("======================================");
+  LOG_INFO("  YOLOv8 Preprocess Benchmark");
+  LOG_INFO("======================================");
+  runResolution(1920, 1080, iterations, threads);
+  runResolution(3840, 2160, iterations, threads);
+  return 0;
+}
@@ -0,0 +1,397 @@
+#pragma once
+
+/**
+ * @file letterbox_yuv.h
+ * @brief NV12 / I420 直接 letterbox 到 RGB 平面 float（header-only）
+ *
+ * 硬解码器输出 NV12 / I420。原来要先整帧转成 BGR（全分辨率读写一遍，外加 3 字节/像素的中间图），
+ * 再做 letterbox。这里每个输出像素直接从 Y、UV 平面双线性采样，同时完成 YUV->RGB、归一化、
+ * HWC->CHW，不产生中间图。
+ *
+ * 采样、填充、多线程与 letterbox.h 一致；x86_64 上运行时检测 AVX2/FMA。
+ *
+ * @code
+ * auto image = algo_utils::nv12Image(frame, 1920, 1080, stride);
+ * auto params = algo_utils::letterboxYuvToPlanar(image, input, 640, 640);
+ * @endcode
+ */
+
+#include "letterbox.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace infer_frame {
+namespace algo_utils {
+
+/**
+ * @brief YUV 4:2:0 图像的平面描述
+ */
+struct YuvImage {
+  const uint8_t* y = nullptr;
+  const uint8_t* u = nullptr;     // NV12：UV 交错平面首地址；I420：U 平面
+  const uint8_t* v = nullptr;     // NV12：u + 1；I420：V 平面
+  int width = 0;
+  int height = 0;
+  size_t y_stride = 0;
+  size_t uv_stride = 0;
+  int uv_step = 1;                // 同一行相邻色度样本的字节间隔：NV12 为 2，I420 为 1
+
+  int chromaWidth() const { return (width + 1) / 2; }
+  int chromaHeight() const { return (height + 1) / 2; }
+};
+
+/**
+ * @brief YUV 图像的各平面是否完整落在 data 起始的 size 字节内
+ *
+ * 行跨度不能小于一行样本（Y：width，NV12 UV：2 * chromaWidth，I420 U/V：chromaWidth）；
+ * 最后一个色度平面的最后一行只需覆盖到行内最后一个样本。
+ */
+inline bool yuvImageFits(const YuvImage& image, size_t size) {
+  if (!image.y || image.width <= 0 || image.height <= 0) {
+    return false;
+  }
+  const size_t chroma_width = static_cast<size_t>(image.chromaWidth());
+  const size_t chroma_height = static_cast<size_t>(image.chromaHeight());
+  const size_t chroma_row = (chroma_width - 1) * image.uv_step + 1;
+  if (image.y_stride < static_cast<size_t>(image.width) || image.uv_stride < chroma_row) {
+    return false;
+  }
+  const uint8_t* last_plane = std::max(image.u, image.v);
+  const size_t end = static_cast<size_t>(last_plane - image.y) +
+                     image.uv_stride * (chroma_height - 1) + chroma_row;
+  return size >= end;
+}
+
+/**
+ * @brief NV12：Y 平面后紧跟 UV 交错平面，两者行跨度相同
+ * @param stride Y 平面每行字节数，0 表示紧密排列
+ */
+inline YuvImage nv12Image(const uint8_t* data, int width, int height, size_t stride = 0) {
+  YuvImage image;
+  image.width = width;
+  image.height = height;
+  image.y_stride = stride > 0 ? stride : static_cast<size_t>(width);
+  image.uv_stride = image.y_stride;
+  image.y = data;
+  image.u = data + image.y_stride * height;
+  image.v = image.u + 1;
+  image.uv_step = 2;
+  return image;
+}
+
+/**
+ * @brief I420：Y 平面后依次为 U、V 平面，色度行跨度为亮度的一半
+ * @param stride Y 平面每行字节数，0 表示紧密排列
+ */
+inline YuvImage i420Image(const uint8_t* data, int width, int height, size_t stride = 0) {
+  YuvImage image;
+  image.width = width;
+  image.height = height;
+  image.y_stride = stride > 0 ? stride : static_cast<size_t>(width);
+  image.uv_stride = stride > 0 ? stride / 2 : static_cast<size_t>(image.chromaWidth());
+  image.y = data;
+  image.u = data + image.y_stride * height;
+  image.v = image.u + image.uv_stride * image.chromaHeight();
+  image.uv_step = 1;
+  return image;
+}
+
+/**
+ * @brief 截取子区域（零拷贝），x / y 需为偶数以保持色度对齐
+ */
+inline YuvImage cropYuv(const YuvImage& image, int x, int y, int width, int height) {
+  YuvImage crop = image;
+  crop.width = width;
+  crop.height = height;
+  crop.y = image.y + static_cast<size_t>(y) * image.y_stride + x;
+  const size_t chroma = static_cast<size_t>(y / 2) * image.uv_stride +
+                        static_cast<size_t>(x / 2) * image.uv_step;
+  crop.u = image.u + chroma;
+  crop.v = image.v + chroma;
+  return crop;
+}
+
+namespace letterbox_detail {
+
+/**
+ * @brief YUV 水平采样表（亮度与色度各一组）
+ */
+struct YuvColumnTable {
+  std::vector<int32_t> y_offset0;
+  std::vector<int32_t> y_offset1;
+  std::vector<float> y_weight;
+  std::vector<int32_t> c_offset0;   // 色度字节偏移（cx * uv_step）
+  std::vector<int32_t> c_offset1;
+  std::vector<float> c_weight;
+  int vector_end = 0;               // [0, vector_end) 的列 32 位 gather 不越过行尾
+};
+
+/**
+ * @brief 源坐标（像素中心对齐）-> 相邻两个采样点与右侧权重
+ */
+inline void samplePoints(float f, int limit, int* i0, int* i1, float* weight) {
+  f = std::max(0.0f, f);
+  *i0 = std::min(static_cast<int>(f), limit - 1);
+  *i1 = std::min(*i0 + 1, limit - 1);
+  *weight = f - *i0;
+}
+
+inline void buildYuvColumnTable(const LetterboxParams& p, int uv_step, YuvColumnTable* table) {
+  const int n = p.new_width;
+  const int chroma_width = (p.src_width + 1) / 2;
+  for (auto* v : {&table->y_offset0, &table->y_offset1, &table->c_offset0, &table->c_offset1}) {
+    v->resize(n);
+  }
+  table->y_weight.resize(n);
+  table->c_weight.resize(n);
+  const float inv_scale = 1.0f / p.scale;
+  table->vector_end = n;
+  for (int i = 0; i < n; ++i) {
+    int x0, x1, cx0, cx1;
+    samplePoints((i + 0.5f) * inv_scale - 0.5f, p.src_width, &x0, &x1, &table->y_weight[i]);
+    samplePoints((i + 0.5f) * inv_scale * 0.5f - 0.5f, chroma_width, &cx0, &cx1,
+                 &table->c_weight[i]);
+    table->y_offset0[i] = x0;
+    table->y_offset1[i] = x1;
+    table->c_offset0[i] = cx0 * uv_step;
+    table->c_offset1[i] = cx1 * uv_step;
+  }
+  // gather 一次读 4 字节；NV12 的 V 从 u + 1 开始读
+  const int chroma_bytes = chroma_width * uv_step;
+  const int v_shift = uv_step == 2 ? 1 : 0;
+  while (table->vector_end > 0 &&
+         (table->y_offset1[table->vector_end - 1] + 4 > p.src_width ||
+          table->c_offset1[table->vector_end - 1] + v_shift + 4 > chroma_bytes)) {
+    --table->vector_end;
+  }
+  table->vector_end -= table->vector_end % 8;
+}
+
+/**
+ * @brief YUV -> RGB 系数（BT.601）
+ */
+struct YuvCoefficients {
+  float y_offset;
+  float y_gain;
+  float r_v;
+  float g_u;
+  float g_v;
+  float b_u;
+};
+
+inline YuvCoefficients yuvCoefficients(bool full_range) {
+  if (full_range) {
+    return {0.0f, 1.0f, 1.402f, -0.344136f, -0.714136f, 1.772f};
+  }
+  return {16.0f, 1.164383f, 1.596027f, -0.391762f, -0.812968f, 2.017232f};
+}
+
+/**
+ * @brief 标量实现：处理有效区域一行中 [begin, end) 列
+ */
+inline void yuvRowScalar(const uint8_t* y_row0, const uint8_t* y_row1, float wy,
+                         const uint8_t* u_row0, const uint8_t* u_row1, const uint8_t* v_row0,
+                         const uint8_t* v_row1, float cwy, const YuvColumnTable& table,
+                         const YuvCoefficients& k, float norm, int begin, int end,
+                         float* out_r, float* out_g, float* out_b) {
+  auto bilinear = [](const uint8_t* r0, const uint8_t* r1, int o0, int o1, float wx, float w) {
+    float top = r0[o0] + (r0[o1] - r0[o0]) * wx;
+    float bottom = r1[o0] + (r1[o1] - r1[o0]) * wx;
+    return top + (bottom - top) * w;
+  };
+  for (int i = begin; i < end; ++i) {
+    const float y = bilinear(y_row0, y_row1, table.y_offset0[i], table.y_offset1[i],
+                             table.y_weight[i], wy);
+    const float u = bilinear(u_row0, u_row1, table.c_offset0[i], table.c_offset1[i],
+                             table.c_weight[i], cwy) - 128.0f;
+    const float v = bilinear(v_row0, v_row1, table.c_offset0[i], table.c_offset1[i],
+                             table.c_weight[i], cwy) - 128.0f;
+    const float luma = (y - k.y_offset) * k.y_gain;
+    out_r[i] = std::min(255.0f, std::max(0.0f, luma + k.r_v * v)) * norm;
+    out_g[i] = std::min(255.0f, std::max(0.0f, luma + k.g_u * u + k.g_v * v)) * norm;
+    out_b[i] = std::min(255.0f, std::max(0.0f, luma + k.b_u * u)) * norm;
+  }
+}
+
+#if defined(INFER_FRAME_LETTERBOX_X86)
+
+__attribute__((target("avx2,fma"))) inline __m256 bilinearAvx2(const uint8_t* row0,
+                                                               const uint8_t* row1,
+                                                               __m256i o0, __m256i o1,
+                                                               __m256 wx, __m256 w) {
+  __m256 p00 = gatherChannel(row0, o0);
+  __m256 p01 = gatherChannel(row0, o1);
+  __m256 p10 = gatherChannel(row1, o0);
+  __m256 p11 = gatherChannel(row1, o1);
+  __m256 top = _mm256_fmadd_ps(_mm256_sub_ps(p01, p00), wx, p00);
+  __m256 bottom = _mm256_fmadd_ps(_mm256_sub_ps(p11, p10), wx, p10);
+  return _mm256_fmadd_ps(_mm256_sub_ps(bottom, top), w, top);
+}
+
+__attribute__((target("avx2"))) inline __m256i loadOffsets(const int32_t* offsets) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets));
+}
+
+/**
+ * @brief 裁剪到 [0, 255] 后归一化写出
+ */
+__attribute__((target("avx2"))) inline void storeClamped(float* out, __m256 value, __m256 zero,
+                                                         __m256 max_value, __m256 norm) {
+  value = _mm256_min_ps(max_value, _mm256_max_ps(zero, value));
+  _mm256_storeu_ps(out, _mm256_mul_ps(value, norm));
+}
+
+/**
+ * @brief AVX2 实现：一次 8 个输出像素，[0, table.vector_end) 列
+ */
+__attribute__((target("avx2,fma"))) inline void yuvRowAvx2(
+    const uint8_t* y_row0, const uint8_t* y_row1, float wy, const uint8_t* u_row0,
+    const uint8_t* u_row1, const uint8_t* v_row0, const uint8_t* v_row1, float cwy,
+    const YuvColumnTable& table, const YuvCoefficients& k, float norm, float* out_r,
+    float* out_g, float* out_b) {
+  const __m256 vwy = _mm256_set1_ps(wy);
+  const __m256 vcwy = _mm256_set1_ps(cwy);
+  const __m256 vnorm = _mm256_set1_ps(norm);
+  const __m256 c128 = _mm256_set1_ps(128.0f);
+  const __m256 y_offset = _mm256_set1_ps(k.y_offset);
+  const __m256 y_gain = _mm256_set1_ps(k.y_gain);
+  const __m256 r_v = _mm256_set1_ps(k.r_v);
+  const __m256 g_u = _mm256_set1_ps(k.g_u);
+  const __m256 g_v = _mm256_set1_ps(k.g_v);
+  const __m256 b_u = _mm256_set1_ps(k.b_u);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 max_value = _mm256_set1_ps(255.0f);
+
+  for (int i = 0; i < table.vector_end; i += 8) {
+    const __m256i yo0 = loadOffsets(table.y_offset0.data() + i);
+    const __m256i yo1 = loadOffsets(table.y_offset1.data() + i);
+    const __m256i co0 = loadOffsets(table.c_offset0.data() + i);
+    const __m256i co1 = loadOffsets(table.c_offset1.data() + i);
+    const __m256 ywx = _mm256_loadu_ps(&table.y_weight[i]);
+    const __m256 cwx = _mm256_loadu_ps(&table.c_weight[i]);
+
+    __m256 y = bilinearAvx2(y_row0, y_row1, yo0, yo1, ywx, vwy);
+    __m256 u = _mm256_sub_ps(bilinearAvx2(u_row0, u_row1, co0, co1, cwx, vcwy), c128);
+    __m256 v = _mm256_sub_ps(bilinearAvx2(v_row0, v_row1, co0, co1, cwx, vcwy), c128);
+    __m256 luma = _mm256_mul_ps(_mm256_sub_ps(y, y_offset), y_gain);
+    storeClamped(out_r + i, _mm256_fmadd_ps(r_v, v, luma), zero, max_value, vnorm);
+    storeClamped(out_g + i, _mm256_fmadd_ps(g_v, v, _mm256_fmadd_ps(g_u, u, luma)), zero,
+                 max_value, vnorm);
+    storeClamped(out_b + i, _mm256_fmadd_ps(b_u, u, luma), zero, max_value, vnorm);
+  }
+}
+
+#endif  // INFER_FRAME_LETTERBOX_X86
+
+/**
+ * @brief 处理输出行 [row_begin, row_end)
+ */
+inline void letterboxYuvRows(const YuvImage& image, float* dst, const LetterboxParams& p,
+                             const YuvColumnTable& table, const LetterboxOptions& options,
+                             bool use_simd, int row_begin, int row_end) {
+  const int64_t plane = static_cast<int64_t>(p.dst_width) * p.dst_height;
+  const float pad = options.pad_value * options.norm;
+  const float inv_scale_y = 1.0f / p.scaleY();
+  const int right_pad = p.dst_width - p.pad_x - p.new_width;
+  const YuvCoefficients k = yuvCoefficients(options.yuv_full_range);
+  // swap_rb 为 false 时输出 BGR 平面
+  float* planes[3] = {dst, dst + plane, dst + 2 * plane};
+  if (!options.swap_rb) {
+    std::swap(planes[0], planes[2]);
+  }
+
+  for (int row = row_begin; row < row_end; ++row) {
+    float* out[3];
+    for (int c = 0; c < 3; ++c) {
+      out[c] = planes[c] + static_cast<int64_t>(row) * p.dst_width;
+    }
+    if (row < p.pad_y || row >= p.pad_y + p.new_height) {
+      for (int c = 0; c < 3; ++c) {
+        fillValue(out[c], p.dst_width, pad);
+      }
+      continue;
+    }
+
+    const float fy = (row - p.pad_y + 0.5f) * inv_scale_y;
+    int y0, y1, cy0, cy1;
+    float wy, cwy;
+    samplePoints(fy - 0.5f, image.height, &y0, &y1, &wy);
+    samplePoints(fy * 0.5f - 0.5f, image.chromaHeight(), &cy0, &cy1, &cwy);
+    const uint8_t* y_row0 = image.y + static_cast<size_t>(y0) * image.y_stride;
+    const uint8_t* y_row1 = image.y + static_cast<size_t>(y1) * image.y_stride;
+    const uint8_t* u_row0 = image.u + static_cast<size_t>(cy0) * image.uv_stride;
+    const uint8_t* u_row1 = image.u + static_cast<size_t>(cy1) * image.uv_stride;
+    const uint8_t* v_row0 = image.v + static_cast<size_t>(cy0) * image.uv_stride;
+    const uint8_t* v_row1 = image.v + static_cast<size_t>(cy1) * image.uv_stride;
+
+    for (int c = 0; c < 3; ++c) {
+      fillValue(out[c], p.pad_x, pad);
+      fillValue(out[c] + p.pad_x + p.new_width, right_pad, pad);
+    }
+    float* r = out[0] + p.pad_x;
+    float* g = out[1] + p.pad_x;
+    float* b = out[2] + p.pad_x;
+
+    int scalar_begin = 0;
+#if defined(INFER_FRAME_LETTERBOX_X86)
+    if (use_simd) {
+      yuvRowAvx2(y_row0, y_row1, wy, u_row0, u_row1, v_row0, v_row1, cwy, table, k,
+                 options.norm, r, g, b);
+      scalar_begin = table.vector_end;
+    }
+#else
+    (void)use_simd;
+#endif
+    yuvRowScalar(y_row0, y_row1, wy, u_row0, u_row1, v_row0, v_row1, cwy, table, k,
+                 options.norm, scalar_begin, p.new_width, r, g, b);
+  }
+}
+
+}  // namespace letterbox_detail
+
+/**
+ * @brief YUV 4:2:0 -> letterbox -> RGB 平面 float（CHW）
+ *
+ * @param image Y / U / V 平面描述（nv12Image / i420Image）
+ * @param dst 输出，容量 3 * dst_width * dst_height
+ * @param options swap_rb 为 false 时输出 BGR 平面；yuv_full_range 选择 BT.601 全范围 / 有限范围；
+ *                keep_aspect 为 false 时拉伸
+ * @return letterbox 参数
+ */
+inline LetterboxParams letterboxYuvToPlanar(const YuvImage& image, float* dst, int dst_width,
+                                            int dst_height,
+                                            const LetterboxOptions& options = LetterboxOptions()) {
+  LetterboxParams params =
+      computeResize(image.width, image.height, dst_width, dst_height, options);
+
+  thread_local std::shared_ptr<const letterbox_detail::YuvColumnTable> table;
+  thread_local LetterboxParams table_params;
+  thread_local int table_uv_step = 0;
+  if (!table || table_params.src_width != image.width ||
+      table_params.src_height != image.height || table_params.dst_width != dst_width ||
+      table_params.dst_height != dst_height || table_params.scale != params.scale ||
+      table_uv_step != image.uv_step) {
+    auto rebuilt = std::make_shared<letterbox_detail::YuvColumnTable>();
+    letterbox_detail::buildYuvColumnTable(params, image.uv_step, rebuilt.get());
+    table = std::move(rebuilt);
+    table_params = params;
+    table_uv_step = image.uv_step;
+  }
+
+  // 同 letterboxToPlanar：持有本次调用使用的采样表
+  const std::shared_ptr<const letterbox_detail::YuvColumnTable> shared_table = table;
+  const bool use_simd = options.allow_simd && letterboxUsesSimd();
+  letterbox_detail::parallelRows(dst_height, options.num_threads, options.executor,
+                                 [&](int begin, int end) {
+    letterbox_detail::letterboxYuvRows(image, dst, params, *shared_table, options, use_simd,
+                                       begin, end);
+  });
+  return params;
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
@@ -0,0 +1,362 @@
+#pragma once
+
+/**
+ * @file motion_gate.h
+ * @brief 运动门控：画面静止时跳过推理（header-only）
+ *
+ * 固定摄像头大部分时间画面不变。每帧先把亮度降采样为 1/8 x 1/8 的小图（每格取中间一行的
+ * 8 个像素求平均，x86 上用 AVX2 的 SAD 指令一次得到 4 格），再与参考图逐格比较：
+ *
+ * - kFrameDiff：参考图为上一次推理时的帧
+ * - kBackground：参考图为滑动平均背景，缓慢的光照变化会被吸收
+ *
+ * 亮度差超过 pixel_threshold 的格子比例达到 min_changed_ratio 即判为有运动；
+ * 静止时也每隔 refresh_interval_ms 强制推理一次。NV12 / I420 直接读 Y 平面，
+ * BGR / RGB 按 (B + 2G + R) / 4 近似亮度。
+ *
+ * @code
+ * algo_utils::MotionGate gate(options);
+ * if (gate.shouldInfer(y_plane, width, height, stride, timestamp_ms)) {
+ *   // 推理并缓存结果
+ * } else {
+ *   // 复用上一次的结果
+ * }
+ * @endcode
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INFER_FRAME_MOTION_X86 1
+#endif
+
+namespace infer_frame {
+namespace algo_utils {
+
+enum class MotionMethod {
+  kFrameDiff = 0,     // 与上一次推理时的帧比较
+  kBackground,        // 与滑动平均背景比较
+};
+
+struct MotionGateOptions {
+  MotionMethod method = MotionMethod::kBackground;
+  int pixel_threshold = 15;             // 降采样后亮度差超过此值的格子计为变化（灵敏度）
+  float min_changed_ratio = 0.002f;     // 变化格子比例达到此值判为有运动
+  int background_shift = 4;             // 背景滑动平均系数 1 / 2^shift
+  int64_t refresh_interval_ms = 5000;   // 静止时强制推理的间隔，<= 0 不强制
+  bool allow_simd = true;               // false 时强制标量实现（测试 / 对比用）
+};
+
+/**
+ * @brief 门控计数（可在其他线程读取）
+ */
+struct MotionGateStats {
+  uint64_t frames = 0;
+  uint64_t inferred = 0;      // 放行推理的帧（含强制刷新）
+  uint64_t skipped = 0;       // 跳过推理、复用上一次结果的帧
+  uint64_t refreshed = 0;     // 静止但到达刷新间隔而强制推理的帧
+
+  double skipRatio() const {
+    return frames > 0 ? static_cast<double>(skipped) / frames : 0.0;
+  }
+};
+
+namespace motion_detail {
+
+constexpr int kCell = 8;
+
+/**
+ * @brief 标量实现：一行 [begin, end) 格的亮度平均
+ */
+inline void downscaleRowScalar(const uint8_t* row, int begin, int end, uint8_t* out) {
+  for (int c = begin; c < end; ++c) {
+    const uint8_t* p = row + c * kCell;
+    int sum = 0;
+    for (int i = 0; i < kCell; ++i) {
+      sum += p[i];
+    }
+    out[c] = static_cast<uint8_t>(sum / kCell);
+  }
+}
+
+/**
+ * @brief BGR / RGB 交错：(B + 2G + R) / 4 近似亮度
+ */
+inline void downscaleRowInterleaved(const uint8_t* row, int cols, uint8_t* out) {
+  for (int c = 0; c < cols; ++c) {
+    const uint8_t* p = row + c * kCell * 3;
+    int sum = 0;
+    for (int i = 0; i < kCell; ++i) {
+      sum += p[3 * i] + 2 * p[3 * i + 1] + p[3 * i + 2];
+    }
+    out[c] = static_cast<uint8_t>(sum / (4 * kCell));
+  }
+}
+
+inline int countChangedScalar(const uint8_t* a, const uint8_t* b, int begin, int end,
+                              int threshold) {
+  int changed = 0;
+  for (int i = begin; i < end; ++i) {
+    changed += std::abs(a[i] - b[i]) > threshold ? 1 : 0;
+  }
+  return changed;
+}
+
+#if defined(INFER_FRAME_MOTION_X86)
+
+inline bool cpuHasAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+/**
+ * @brief AVX2 实现：32 字节做一次 SAD 得到 4 格的和
+ * @return 已处理的格数（4 的倍数）
+ */
+__attribute__((target("avx2"))) inline int downscaleRowAvx2(const uint8_t* row, int cols,
+                                                            uint8_t* out) {
+  const __m256i zero = _mm256_setzero_si256();
+  int c = 0;
+  for (; c + 4 <= cols; c += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + c * kCell));
+    __m256i sum = _mm256_srli_epi64(_mm256_sad_epu8(v, zero), 3);
+    out[c] = static_cast<uint8_t>(_mm256_extract_epi64(sum, 0));
+    out[c + 1] = static_cast<uint8_t>(_mm256_extract_epi64(sum, 1));
+    out[c + 2] = static_cast<uint8_t>(_mm256_extract_epi64(sum, 2));
+    out[c + 3] = static_cast<uint8_t>(_mm256_extract_epi64(sum, 3));
+  }
+  return c;
+}
+
+/**
+ * @brief AVX2 实现：|a - b| > threshold 的个数
+ * @return 已处理范围内的变化数，*processed 为已处理元素数（32 的倍数）
+ */
+__attribute__((target("avx2"))) inline int countChangedAvx2(const uint8_t* a, const uint8_t* b,
+                                                            int count, int threshold,
+                                                            int* processed) {
+  const __m256i vthreshold = _mm256_set1_epi8(static_cast<char>(threshold));
+  const __m256i zero = _mm256_setzero_si256();
+  int changed = 0;
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    __m256i diff = _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va));
+    // diff > threshold  <=>  saturate(diff - threshold) != 0
+    __m256i over = _mm256_cmpeq_epi8(_mm256_subs_epu8(diff, vthreshold), zero);
+    changed += 32 - __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(over)));
+  }
+  *processed = i;
+  return changed;
+}
+
+#endif  // INFER_FRAME_MOTION_X86
+
+}  // namespace motion_detail
+
+/**
+ * @brief 当前 CPU 是否使用向量化实现
+ */
+inline bool motionGateUsesSimd() {
+#if defined(INFER_FRAME_MOTION_X86)
+  return motion_detail::cpuHasAvx2();
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief 一路摄像头的运动门控
+ *
+ * shouldInfer 只在该摄像头的处理线程调用；stats() 可在其他线程读取。
+ */
+class MotionGate {
+ public:
+  explicit MotionGate(const MotionGateOptions& options = MotionGateOptions())
+      : options_(options) {}
+
+  const MotionGateOptions& options() const { return options_; }
+
+  /**
+   * @brief 修改灵敏度等参数，下一帧强制推理
+   */
+  void setOptions(const MotionGateOptions& options) {
+    options_ = options;
+    reset();
+  }
+
+  /**
+   * @brief 单通道亮度（NV12 / I420 的 Y 平面）
+   * @param timestamp_ms 帧时间戳，用于强制刷新
+   * @return true 需要推理；false 画面静止，可复用上一次结果
+   */
+  bool shouldInfer(const uint8_t* luma, int width, int height, size_t stride,
+                   int64_t timestamp_ms);
+
+  /**
+   * @brief BGR / RGB 交错 uint8
+   */
+  bool shouldInferInterleaved(const uint8_t* image, int width, int height, size_t stride,
+                              int64_t timestamp_ms);
+
+  /**
+   * @brief 丢弃参考图，下一帧强制推理（参数更新、结果缓存失效时调用）
+   */
+  void reset() { reference_.clear(); }
+
+  MotionGateStats stats() const;
+
+  /**
+   * @brief 最近一帧的变化格子比例
+   */
+  float lastChangedRatio() const { return last_changed_ratio_; }
+
+ private:
+  MotionGateOptions options_;
+  int cols_ = 0;
+  int rows_ = 0;
+  std::vector<uint8_t> current_;
+  std::vector<uint8_t> reference_;
+  std::vector<float> background_;     // kBackground 的滑动平均
+  int64_t last_infer_ms_ = 0;
+  float last_changed_ratio_ = 0.0f;
+
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> inferred_{0};
+  std::atomic<uint64_t> refreshed_{0};
+
+  bool resize(int width, int height);
+  bool decide(int64_t timestamp_ms);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline bool MotionGate::resize(int width, int height) {
+  const int cols = width / motion_detail::kCell;
+  const int rows = height / motion_detail::kCell;
+  if (cols <= 0 || rows <= 0) {
+    return false;
+  }
+  if (cols != cols_ || rows != rows_) {
+    cols_ = cols;
+    rows_ = rows;
+    reference_.clear();
+  }
+  current_.resize(static_cast<size_t>(cols_) * rows_);
+  return true;
+}
+
+inline bool MotionGate::shouldInfer(const uint8_t* luma, int width, int height, size_t stride,
+                                    int64_t timestamp_ms) {
+  if (!luma || !resize(width, height)) {
+    ++frames_;
+    ++inferred_;
+    return true;
+  }
+  const bool use_simd = options_.allow_simd && motionGateUsesSimd();
+  for (int r = 0; r < rows_; ++r) {
+    // 每格取中间一行，只读 1/8 的行
+    const uint8_t* row = luma + (static_cast<size_t>(r) * motion_detail::kCell +
+                                 motion_detail::kCell / 2) * stride;
+    uint8_t* out = current_.data() + static_cast<size_t>(r) * cols_;
+    int begin = 0;
+#if defined(INFER_FRAME_MOTION_X86)
+    if (use_simd) {
+      begin = motion_detail::downscaleRowAvx2(row, cols_, out);
+    }
+#else
+    (void)use_simd;
+#endif
+    motion_detail::downscaleRowScalar(row, begin, cols_, out);
+  }
+  return decide(timestamp_ms);
+}
+
+inline bool MotionGate::shouldInferInterleaved(const uint8_t* image, int width, int height,
+                                               size_t stride, int64_t timestamp_ms) {
+  if (!image || !resize(width, height)) {
+    ++frames_;
+    ++inferred_;
+    return true;
+  }
+  for (int r = 0; r < rows_; ++r) {
+    const uint8_t* row = image + (static_cast<size_t>(r) * motion_detail::kCell +
+                                  motion_detail::kCell / 2) * stride;
+    motion_detail::downscaleRowInterleaved(row, cols_,
+                                           current_.data() + static_cast<size_t>(r) * cols_);
+  }
+  return decide(timestamp_ms);
+}
+
+inline bool MotionGate::decide(int64_t timestamp_ms) {
+  ++frames_;
+  const int count = static_cast<int>(current_.size());
+  if (reference_.size() != current_.size()) {
+    // 首帧或尺寸变化：建立参考图，必须推理
+    reference_ = current_;
+    background_.assign(current_.begin(), current_.end());
+    last_infer_ms_ = timestamp_ms;
+    last_changed_ratio_ = 1.0f;
+    ++inferred_;
+    return true;
+  }
+
+  int changed = 0;
+  int begin = 0;
+#if defined(INFER_FRAME_MOTION_X86)
+  if (options_.allow_simd && motionGateUsesSimd()) {
+    changed = motion_detail::countChangedAvx2(current_.data(), reference_.data(), count,
+                                              options_.pixel_threshold, &begin);
+  }
+#endif
+  changed += motion_detail::countChangedScalar(current_.data(), reference_.data(), begin, count,
+                                               options_.pixel_threshold);
+  last_changed_ratio_ = static_cast<float>(changed) / count;
+
+  const bool motion = last_changed_ratio_ >= options_.min_changed_ratio;
+  const bool refresh = !motion && options_.refresh_interval_ms > 0 &&
+                       timestamp_ms - last_infer_ms_ >= options_.refresh_interval_ms;
+  const bool infer = motion || refresh;
+
+  if (options_.method == MotionMethod::kBackground) {
+    const int shift = std::clamp(options_.background_shift, 0, 8);
+    const float alpha = 1.0f / static_cast<float>(1 << shift);
+    for (int i = 0; i < count; ++i) {
+      background_[i] += alpha * (current_[i] - background_[i]);
+      reference_[i] = static_cast<uint8_t>(background_[i] + 0.5f);
+    }
+  } else if (infer) {
+    // 复用的结果来自上一次推理的帧，慢速运动也会逐帧累积到阈值
+    reference_.swap(current_);
+  }
+
+  if (infer) {
+    last_infer_ms_ = timestamp_ms;
+    ++inferred_;
+    if (refresh) {
+      ++refreshed_;
+    }
+  }
+  return infer;
+}
+
+inline MotionGateStats MotionGate::stats() const {
+  MotionGateStats s;
+  s.frames = frames_.load(std::memory_order_relaxed);
+  s.inferred = inferred_.load(std::memory_order_relaxed);
+  s.refreshed = refreshed_.load(std::memory_order_relaxed);
+  s.skipped = s.frames >= s.inferred ? s.frames - s.inferred : 0;
+  return s;
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
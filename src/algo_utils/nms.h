@@ -0,0 +1,367 @@
+#pragma once
+
+/**
+ * @file nms.h
+ * @brief 按类别 NMS（header-only）
+ *
+ * 面向候选框很多（上千 ~ 上万）的密集场景：
+ *
+ * 1. 候选框超过 max_candidates 时先 nth_element 取分数最高的 top-k，只排序这 k 个
+ * 2. 不同类别的框按 class_id 平移到互不重叠的区域，一次 NMS 完成所有类别
+ * 3. 框坐标与面积存为 SoA 数组，x86 上 AVX 一次算 8 个 IoU
+ * 4. 被抑制的框记在 bitmask 中，IoU 比较结果直接按位或进去
+ *
+ * 另提供 soft-NMS（线性 / 高斯衰减）。内部缓冲只增不减，预热后每次调用不再分配内存；
+ * 同一个 NmsEngine 不可多线程并发使用。
+ *
+ * @code
+ * algo_utils::NmsOptions options;
+ * options.iou_threshold = 0.45f;
+ * algo_utils::NmsEngine nms(options);
+ * nms.run(&candidates);  // candidates 原地变为保留的框，按分数降序
+ * @endcode
+ */
+
+#include "yolov8_decode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INFER_FRAME_NMS_X86 1
+#endif
+
+namespace infer_frame {
+namespace algo_utils {
+
+enum class NmsMethod {
+  kHard = 0,          // 标准 NMS：IoU 超过阈值直接删除
+  kSoftLinear,        // soft-NMS：IoU 超过阈值时分数乘 (1 - IoU)
+  kSoftGaussian,      // soft-NMS：分数乘 exp(-IoU^2 / sigma)
+};
+
+struct NmsOptions {
+  float iou_threshold = 0.45f;
+  int max_candidates = 3000;        // 进入 NMS 的最多候选框数（按分数取 top-k），<= 0 不限制
+  int max_detections = 300;         // 最多保留框数，<= 0 不限制
+  bool class_agnostic = false;      // true 时不同类别之间也互相抑制
+  NmsMethod method = NmsMethod::kHard;
+  float soft_sigma = 0.5f;          // 高斯 soft-NMS 参数
+  float soft_score_threshold = 0.001f;  // soft-NMS 衰减后低于此分数的框删除
+  bool allow_simd = true;           // false 时强制标量实现（测试 / 对比用）
+};
+
+namespace nms_detail {
+
+/**
+ * @brief 标量实现：box i 与 [begin, end) 比较，IoU > 阈值的置位
+ */
+inline void suppressScalar(const float* x1, const float* y1, const float* x2, const float* y2,
+                           const float* area, int i, int begin, int end, float threshold,
+                           uint64_t* removed) {
+  for (int j = begin; j < end; ++j) {
+    float w = std::max(0.0f, std::min(x2[i], x2[j]) - std::max(x1[i], x1[j]));
+    float h = std::max(0.0f, std::min(y2[i], y2[j]) - std::max(y1[i], y1[j]));
+    float inter = w * h;
+    // IoU > t  <=>  inter > t * (area_i + area_j - inter)，避免除法
+    if (inter > threshold * (area[i] + area[j] - inter)) {
+      removed[j >> 6] |= uint64_t(1) << (j & 63);
+    }
+  }
+}
+
+inline float iouScalar(const float* x1, const float* y1, const float* x2, const float* y2,
+                       const float* area, int i, int j) {
+  float w = std::max(0.0f, std::min(x2[i], x2[j]) - std::max(x1[i], x1[j]));
+  float h = std::max(0.0f, std::min(y2[i], y2[j]) - std::max(y1[i], y1[j]));
+  float inter = w * h;
+  float uni = area[i] + area[j] - inter;
+  return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+#if defined(INFER_FRAME_NMS_X86)
+
+inline bool cpuHasAvx() {
+  static const bool supported = __builtin_cpu_supports("avx");
+  return supported;
+}
+
+/**
+ * @brief AVX 实现：begin 按 8 对齐，SoA 数组长度已补齐到 8 的倍数
+ */
+__attribute__((target("avx"))) inline void suppressAvx(const float* x1, const float* y1,
+                                                       const float* x2, const float* y2,
+                                                       const float* area, int i, int begin,
+                                                       int end, float threshold,
+                                                       uint64_t* removed) {
+  const __m256 ix1 = _mm256_set1_ps(x1[i]);
+  const __m256 iy1 = _mm256_set1_ps(y1[i]);
+  const __m256 ix2 = _mm256_set1_ps(x2[i]);
+  const __m256 iy2 = _mm256_set1_ps(y2[i]);
+  const __m256 iarea = _mm256_set1_ps(area[i]);
+  const __m256 vthreshold = _mm256_set1_ps(threshold);
+  const __m256 zero = _mm256_setzero_ps();
+  for (int j = begin; j < end; j += 8) {
+    __m256 w = _mm256_sub_ps(_mm256_min_ps(ix2, _mm256_loadu_ps(x2 + j)),
+                             _mm256_max_ps(ix1, _mm256_loadu_ps(x1 + j)));
+    __m256 h = _mm256_sub_ps(_mm256_min_ps(iy2, _mm256_loadu_ps(y2 + j)),
+                             _mm256_max_ps(iy1, _mm256_loadu_ps(y1 + j)));
+    __m256 inter = _mm256_mul_ps(_mm256_max_ps(w, zero), _mm256_max_ps(h, zero));
+    __m256 uni = _mm256_sub_ps(_mm256_add_ps(iarea, _mm256_loadu_ps(area + j)), inter);
+    __m256 hit = _mm256_cmp_ps(inter, _mm256_mul_ps(vthreshold, uni), _CMP_GT_OQ);
+    uint64_t bits = static_cast<uint32_t>(_mm256_movemask_ps(hit));
+    removed[j >> 6] |= bits << (j & 63);
+  }
+}
+
+/**
+ * @brief AVX 实现：box i 与 [begin, end) 的 IoU 写入 out（soft-NMS 用）
+ */
+__attribute__((target("avx"))) inline void iouRowAvx(const float* x1, const float* y1,
+                                                     const float* x2, const float* y2,
+                                                     const float* area, int i, int begin,
+                                                     int end, float* out) {
+  const __m256 ix1 = _mm256_set1_ps(x1[i]);
+  const __m256 iy1 = _mm256_set1_ps(y1[i]);
+  const __m256 ix2 = _mm256_set1_ps(x2[i]);
+  const __m256 iy2 = _mm256_set1_ps(y2[i]);
+  const __m256 iarea = _mm256_set1_ps(area[i]);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 eps = _mm256_set1_ps(1e-12f);
+  for (int j = begin; j < end; j += 8) {
+    __m256 w = _mm256_sub_ps(_mm256_min_ps(ix2, _mm256_loadu_ps(x2 + j)),
+                             _mm256_max_ps(ix1, _mm256_loadu_ps(x1 + j)));
+    __m256 h = _mm256_sub_ps(_mm256_min_ps(iy2, _mm256_loadu_ps(y2 + j)),
+                             _mm256_max_ps(iy1, _mm256_loadu_ps(y1 + j)));
+    __m256 inter = _mm256_mul_ps(_mm256_max_ps(w, zero), _mm256_max_ps(h, zero));
+    __m256 uni = _mm256_sub_ps(_mm256_add_ps(iarea, _mm256_loadu_ps(area + j)), inter);
+    _mm256_storeu_ps(out + j, _mm256_div_ps(inter, _mm256_max_ps(uni, eps)));
+  }
+}
+
+#endif  // INFER_FRAME_NMS_X86
+
+}  // namespace nms_detail
+
+/**
+ * @brief 当前 CPU 是否使用向量化实现
+ */
+inline bool nmsUsesSimd() {
+#if defined(INFER_FRAME_NMS_X86)
+  return nms_detail::cpuHasAvx();
+#else
+  return false;
+#endif
+}
+
+class NmsEngine {
+ public:
+  explicit NmsEngine(const NmsOptions& options = NmsOptions()) : options_(options) {}
+
+  const NmsOptions& options() const { return options_; }
+  void setOptions(const NmsOptions& options) { options_ = options; }
+
+  /**
+   * @brief 原地执行 NMS，candidates 变为保留的框（按分数降序）
+   * @return 保留框数量
+   */
+  size_t run(std::vector<DetCandidate>* candidates);
+
+  /**
+   * @brief 预先分配内部缓冲，避免首帧分配
+   */
+  void reserve(size_t max_boxes);
+
+ private:
+  NmsOptions options_;
+
+  std::vector<int> order_;
+  std::vector<float> x1_;
+  std::vector<float> y1_;
+  std::vector<float> x2_;
+  std::vector<float> y2_;
+  std::vector<float> area_;
+  std::vector<float> scores_;       // soft-NMS 衰减后的分数
+  std::vector<float> iou_row_;      // soft-NMS 一行 IoU
+  std::vector<uint64_t> removed_;
+  std::vector<DetCandidate> kept_;
+
+  int selectTopK(const std::vector<DetCandidate>& candidates);
+  void loadBoxes(const std::vector<DetCandidate>& candidates, int count);
+  void runHard(const std::vector<DetCandidate>& candidates, int count);
+  void runSoft(const std::vector<DetCandidate>& candidates, int count);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline void NmsEngine::reserve(size_t max_boxes) {
+  const size_t padded = (max_boxes + 7) / 8 * 8;
+  order_.reserve(max_boxes);
+  for (auto* v : {&x1_, &y1_, &x2_, &y2_, &area_, &scores_, &iou_row_}) {
+    v->reserve(padded);
+  }
+  removed_.reserve((padded + 63) / 64);
+  kept_.reserve(max_boxes);
+}
+
+inline size_t NmsEngine::run(std::vector<DetCandidate>* candidates) {
+  if (!candidates || candidates->empty()) {
+    return 0;
+  }
+  const int count = selectTopK(*candidates);
+  loadBoxes(*candidates, count);
+  kept_.clear();
+  if (options_.method == NmsMethod::kHard) {
+    runHard(*candidates, count);
+  } else {
+    runSoft(*candidates, count);
+  }
+  // kept_ 容量已足够，assign 不会重新分配 candidates
+  candidates->assign(kept_.begin(), kept_.end());
+  return candidates->size();
+}
+
+inline int NmsEngine::selectTopK(const std::vector<DetCandidate>& candidates) {
+  const int total = static_cast<int>(candidates.size());
+  const int count = options_.max_candidates > 0 ? std::min(total, options_.max_candidates) : total;
+  order_.resize(total);
+  std::iota(order_.begin(), order_.end(), 0);
+  auto by_score = [&candidates](int l, int r) {
+    if (candidates[l].score != candidates[r].score) {
+      return candidates[l].score > candidates[r].score;
+    }
+    return l < r;
+  };
+  if (count < total) {
+    std::nth_element(order_.begin(), order_.begin() + count, order_.end(), by_score);
+  }
+  std::sort(order_.begin(), order_.begin() + count, by_score);
+  return count;
+}
+
+inline void NmsEngine::loadBoxes(const std::vector<DetCandidate>& candidates, int count) {
+  // 按类别平移：偏移量大于所有坐标，不同类别的框不可能相交
+  float max_coord = 0.0f;
+  for (int k = 0; k < count; ++k) {
+    const DetCandidate& c = candidates[order_[k]];
+    max_coord = std::max(max_coord, std::max(std::fabs(c.x2), std::fabs(c.y2)));
+    max_coord = std::max(max_coord, std::max(std::fabs(c.x1), std::fabs(c.y1)));
+  }
+  const float class_step = options_.class_agnostic ? 0.0f : 2.0f * max_coord + 1.0f;
+
+  // 补齐到 8 的倍数，向量化尾部读到的是面积为 0 的空框
+  const size_t padded = (static_cast<size_t>(count) + 7) / 8 * 8;
+  for (auto* v : {&x1_, &y1_, &x2_, &y2_, &area_}) {
+    v->assign(padded, 0.0f);
+  }
+  for (int k = 0; k < count; ++k) {
+    const DetCandidate& c = candidates[order_[k]];
+    const float offset = class_step * static_cast<float>(c.class_id);
+    x1_[k] = c.x1 + offset;
+    y1_[k] = c.y1 + offset;
+    x2_[k] = c.x2 + offset;
+    y2_[k] = c.y2 + offset;
+    area_[k] = std::max(0.0f, c.x2 - c.x1) * std::max(0.0f, c.y2 - c.y1);
+  }
+}
+
+inline void NmsEngine::runHard(const std::vector<DetCandidate>& candidates, int count) {
+  const size_t padded = (static_cast<size_t>(count) + 7) / 8 * 8;
+  removed_.assign((padded + 63) / 64, 0);
+  const int max_keep = options_.max_detections > 0 ? options_.max_detections : count;
+  const bool use_simd = options_.allow_simd && nmsUsesSimd();
+  const float threshold = options_.iou_threshold;
+
+  for (int i = 0; i < count; ++i) {
+    if (removed_[i >> 6] & (uint64_t(1) << (i & 63))) {
+      continue;
+    }
+    kept_.push_back(candidates[order_[i]]);
+    if (static_cast<int>(kept_.size()) >= max_keep) {
+      break;
+    }
+#if defined(INFER_FRAME_NMS_X86)
+    if (use_simd) {
+      // 从 i + 1 所在的 8 对齐位置开始，顺带置位的 [.., i] 都已处理过
+      nms_detail::suppressAvx(x1_.data(), y1_.data(), x2_.data(), y2_.data(), area_.data(), i,
+                              (i + 1) & ~7, static_cast<int>(padded), threshold,
+                              removed_.data());
+      continue;
+    }
+#else
+    (void)use_simd;
+#endif
+    nms_detail::suppressScalar(x1_.data(), y1_.data(), x2_.data(), y2_.data(), area_.data(), i,
+                               i + 1, count, threshold, removed_.data());
+  }
+}
+
+inline void NmsEngine::runSoft(const std::vector<DetCandidate>& candidates, int count) {
+  const size_t padded = (static_cast<size_t>(count) + 7) / 8 * 8;
+  removed_.assign((padded + 63) / 64, 0);
+  scores_.resize(count);
+  iou_row_.resize(padded);
+  for (int k = 0; k < count; ++k) {
+    scores_[k] = candidates[order_[k]].score;
+  }
+  const int max_keep = options_.max_detections > 0 ? options_.max_detections : count;
+  const bool use_simd = options_.allow_simd && nmsUsesSimd();
+  auto is_removed = [this](int k) { return (removed_[k >> 6] >> (k & 63)) & 1; };
+
+  while (static_cast<int>(kept_.size()) < max_keep) {
+    // 衰减后顺序会变，每轮取剩余框中分数最高的
+    int best = -1;
+    for (int k = 0; k < count; ++k) {
+      if (!is_removed(k) && (best < 0 || scores_[k] > scores_[best])) {
+        best = k;
+      }
+    }
+    if (best < 0) {
+      break;
+    }
+    removed_[best >> 6] |= uint64_t(1) << (best & 63);
+    DetCandidate kept = candidates[order_[best]];
+    kept.score = scores_[best];
+    kept_.push_back(kept);
+
+#if defined(INFER_FRAME_NMS_X86)
+    if (use_simd) {
+      nms_detail::iouRowAvx(x1_.data(), y1_.data(), x2_.data(), y2_.data(), area_.data(), best,
+                            0, static_cast<int>(padded), iou_row_.data());
+    } else
+#endif
+    {
+      for (int k = 0; k < count; ++k) {
+        iou_row_[k] = nms_detail::iouScalar(x1_.data(), y1_.data(), x2_.data(), y2_.data(),
+                                            area_.data(), best, k);
+      }
+    }
+    for (int k = 0; k < count; ++k) {
+      if (is_removed(k)) {
+        continue;
+      }
+      const float iou = iou_row_[k];
+      if (options_.method == NmsMethod::kSoftLinear) {
+        if (iou > options_.iou_threshold) {
+          scores_[k] *= 1.0f - iou;
+        }
+      } else {
+        scores_[k] *= std::exp(-(iou * iou) / options_.soft_sigma);
+      }
+      if (scores_[k] < options_.soft_score_threshold) {
+        removed_[k >> 6] |= uint64_t(1) << (k & 63);
+      }
+    }
+  }
+  (void)use_simd;
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
@@ -0,0 +1,203 @@
+/**
+ * @file nms_bench.cc
+ * @brief NMS 耗时对比：朴素 O(n^2) 实现 vs NmsEngine
+ *
+ * 模拟密集场景（候选框集中在少量目标周围），分别测 100 / 1k / 10k 个候选框：
+ *   1. naive：全排序 + 两两计算 IoU（vector<bool> 标记删除）
+ *   2. engine scalar / avx：top-k + 按类别平移 + SoA IoU + bitmask
+ *   3. engine avx, no top-k：不限制进入 NMS 的候选框数
+ *   4. soft-NMS（高斯）
+ * 同时统计预热后每次调用的堆分配次数（应为 0）。
+ *
+ * 用法: nms_bench [iterations]
+ */
+
+#include "algo_utils/nms.h"
+#include "utils/one_logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+// 只统计测量线程的分配，异步日志线程的分配不计入
+thread_local size_t t_allocations = 0;
+}  // namespace
+
+// 统计堆分配次数（替换全局 new / delete，GCC 会把 malloc/free 配对误报为不匹配）
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size) {
+  ++t_allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using namespace infer_frame;
+
+namespace {
+
+struct BenchResult {
+  double p50_us = 0.0;
+  double p99_us = 0.0;
+  double allocs_per_call = 0.0;
+  size_t kept = 0;
+};
+
+template <typename Func>
+BenchResult measure(int iterations, const std::vector<algo_utils::DetCandidate>& input,
+                    std::vector<algo_utils::DetCandidate>* work, Func&& run_once) {
+  work->reserve(input.size());
+  work->assign(input.begin(), input.end());
+  run_once(work);  // 预热
+  std::vector<double> samples;
+  samples.reserve(iterations);
+  size_t allocations = 0;
+  BenchResult r;
+  for (int i = 0; i < iterations; ++i) {
+    work->assign(input.begin(), input.end());
+    size_t before = t_allocations;
+    auto begin = std::chrono::steady_clock::now();
+    r.kept = run_once(work);
+    double us =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin)
+            .count();
+    allocations += t_allocations - before;
+    samples.push_back(us);
+  }
+  std::sort(samples.begin(), samples.end());
+  r.p50_us = samples[samples.size() / 2];
+  r.p99_us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+  r.allocs_per_call = static_cast<double>(allocations) / iterations;
+  return r;
+}
+
+void report(const std::string& mode, const BenchResult& r, double baseline_p50) {
+  LOG_INFO("{:<24} {:>10.1f} {:>10.1f} {:>8.2f}x {:>6} {:>8.2f}", mode, r.p50_us, r.p99_us,
+           baseline_p50 / r.p50_us, r.kept, r.allocs_per_call);
+}
+
+float iou(const algo_utils::DetCandidate& a, const algo_utils::DetCandidate& b) {
+  float w = std::max(0.0f, std::min(a.x2, b.x2) - std::max(a.x1, b.x1));
+  float h = std::max(0.0f, std::min(a.y2, b.y2) - std::max(a.y1, b.y1));
+  float inter = w * h;
+  float uni = (a.x2 - a.x1) * (a.y2 - a.y1) + (b.x2 - b.x1) * (b.y2 - b.y1) - inter;
+  return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+/**
+ * @brief 朴素实现：全排序 + 两两比较
+ */
+size_t naiveNms(std::vector<algo_utils::DetCandidate>* boxes, float threshold, int max_det) {
+  std::sort(boxes->begin(), boxes->end(),
+            [](const auto& l, const auto& r) { return l.score > r.score; });
+  std::vector<bool> removed(boxes->size(), false);
+  std::vector<algo_utils::DetCandidate> kept;
+  for (size_t i = 0; i < boxes->size() && static_cast<int>(kept.size()) < max_det; ++i) {
+    if (removed[i]) {
+      continue;
+    }
+    kept.push_back((*boxes)[i]);
+    for (size_t j = i + 1; j < boxes->size(); ++j) {
+      const auto& a = (*boxes)[i];
+      const auto& b = (*boxes)[j];
+      if (a.class_id == b.class_id && iou(a, b) > threshold) {
+        removed[j] = true;
+      }
+    }
+  }
+  *boxes = kept;
+  return boxes->size();
+}
+
+/**
+ * @brief 密集场景：候选框围绕若干目标抖动
+ */
+std::vector<algo_utils::DetCandidate> makeCrowd(int count, std::mt19937* rng) {
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  std::normal_distribution<float> jitter(0.0f, 4.0f);
+  const int objects = std::max(1, count / 20);
+  std::vector<algo_utils::DetCandidate> boxes(count);
+  for (int i = 0; i < count; ++i) {
+    std::mt19937 object_rng(i % objects);
+    std::uniform_real_distribution<float> object_pos(0.0f, 1.0f);
+    float cx = object_pos(object_rng) * 1920.0f;
+    float cy = object_pos(object_rng) * 1080.0f;
+    float w = 20.0f + object_pos(object_rng) * 120.0f;
+    float h = 40.0f + object_pos(object_rng) * 200.0f;
+    auto& b = boxes[i];
+    b.x1 = cx - 0.5f * w + jitter(*rng);
+    b.y1 = cy - 0.5f * h + jitter(*rng);
+    b.x2 = cx + 0.5f * w + jitter(*rng);
+    b.y2 = cy + 0.5f * h + jitter(*rng);
+    b.score = 0.25f + 0.75f * uniform(*rng);
+    b.class_id = (i % objects) % 4;
+    b.anchor = i;
+  }
+  return boxes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? std::stoi(argv[1]) : 200;
+  std::mt19937 rng(42);
+
+  LOG_INFO("======================================");
+  LOG_INFO("  NMS Benchmark (iou 0.45, max_det 300)");
+  LOG_INFO("======================================");
+  for (int count : {100, 1000, 10000}) {
+    auto input = makeCrowd(count, &rng);
+    std::vector<algo_utils::DetCandidate> work;
+    const int runs = count >= 10000 ? std::max(1, iterations / 10) : iterations;
+
+    LOG_INFO("--------------------------------------");
+    LOG_INFO("  {} candidates ({} iterations)", count, runs);
+    LOG_INFO("{:<24} {:>10} {:>10} {:>9} {:>6} {:>8}", "mode", "p50(us)", "p99(us)", "speedup",
+             "kept", "allocs");
+
+    auto naive = measure(runs, input, &work, [](auto* boxes) {
+      return naiveNms(boxes, 0.45f, 300);
+    });
+    report("naive", naive, naive.p50_us);
+
+    algo_utils::NmsOptions options;
+    options.allow_simd = false;
+    algo_utils::NmsEngine scalar(options);
+    report("engine scalar", measure(runs, input, &work, [&](auto* boxes) {
+      return scalar.run(boxes);
+    }), naive.p50_us);
+
+    if (algo_utils::nmsUsesSimd()) {
+      options.allow_simd = true;
+      algo_utils::NmsEngine simd(options);
+      report("engine avx", measure(runs, input, &work, [&](auto* boxes) {
+        return simd.run(boxes);
+      }), naive.p50_us);
+
+      options.max_candidates = 0;
+      algo_utils::NmsEngine no_topk(options);
+      report("engine avx, no top-k", measure(runs, input, &work, [&](auto* boxes) {
+        return no_topk.run(boxes);
+      }), naive.p50_us);
+      options.max_candidates = algo_utils::NmsOptions().max_candidates;
+    }
+
+    options.method = algo_utils::NmsMethod::kSoftGaussian;
+    algo_utils::NmsEngine soft(options);
+    report("soft-nms gaussian", measure(runs, input, &work, [&](auto* boxes) {
+      return soft.run(boxes);
+    }), naive.p50_us);
+  }
+  return 0;
+}
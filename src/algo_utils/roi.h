@@ -0,0 +1,232 @@
+#pragma once
+
+/**
+ * @file roi.h
+ * @brief 感兴趣区域（ROI）推理（header-only）
+ *
+ * 每路摄像头可配置若干矩形 / 多边形 ROI。每个 ROI 先按外接矩形从原图截取（零拷贝），
+ * 只把这块区域 letterbox 到模型输入：有效分辨率更高，前处理读的像素也更少。
+ * 同一帧的多个 ROI 组成一个 batch 推理。
+ *
+ * 多边形 ROI 在模型输入空间预先栅格化为 8x8 像素一格的掩码（与 stride 8 特征图对齐），
+ * 解码时按框中心查表剔除多边形外的候选框，在 NMS 之前完成，每个候选框只需一次查表。
+ *
+ * @code
+ * algo_utils::RoiSet rois;
+ * rois.setRegions({algo_utils::roiPolygon({{100, 200}, {900, 150}, {1000, 800}})}, false);
+ * for (const auto& roi : rois.resolve(1920, 1080, 640, 640)) {
+ *   // 截取 roi.crop 做 letterbox，解码后 roi.mask.contains(cx, cy) 为 false 的框丢弃
+ * }
+ * @endcode
+ */
+
+#include "letterbox.h"
+#include "tiling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace infer_frame {
+namespace algo_utils {
+
+struct RoiPoint {
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+/**
+ * @brief 一个 ROI：多边形顶点（矩形存为 4 个顶点）
+ */
+struct RoiRegion {
+  std::vector<RoiPoint> polygon;
+  bool is_rect = false;     // 矩形不需要掩码，外接矩形即 ROI 本身
+};
+
+inline RoiRegion roiRect(float x, float y, float width, float height) {
+  RoiRegion region;
+  region.polygon = {{x, y}, {x + width, y}, {x + width, y + height}, {x, y + height}};
+  region.is_rect = true;
+  return region;
+}
+
+inline RoiRegion roiPolygon(std::vector<RoiPoint> points) {
+  RoiRegion region;
+  region.polygon = std::move(points);
+  return region;
+}
+
+/**
+ * @brief 点是否在多边形内（射线法，奇偶规则）
+ */
+inline bool pointInPolygon(const std::vector<RoiPoint>& polygon, float x, float y) {
+  bool inside = false;
+  const size_t n = polygon.size();
+  for (size_t i = 0, j = n - 1; i < n; j = i++) {
+    const RoiPoint& a = polygon[i];
+    const RoiPoint& b = polygon[j];
+    if ((a.y > y) != (b.y > y) && x < (b.x - a.x) * (y - a.y) / (b.y - a.y) + a.x) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+/**
+ * @brief 模型输入空间的多边形掩码，kCell x kCell 像素一格
+ */
+class RoiMask {
+ public:
+  static constexpr int kCell = 8;
+
+  /**
+   * @brief 栅格化：格子中心映射回原图后落在多边形内则置位
+   * @param polygon 原图像素坐标
+   * @param crop 该 ROI 在原图上的截取区域
+   * @param letterbox 截取区域 letterbox 到模型输入的参数
+   */
+  void build(const std::vector<RoiPoint>& polygon, const Tile& crop,
+             const LetterboxParams& letterbox);
+
+  void clear() { cells_.clear(); }
+
+  /**
+   * @brief 未建立掩码（矩形 ROI）时总是返回 true
+   * @param x, y 模型输入坐标
+   */
+  bool contains(float x, float y) const {
+    if (cells_.empty()) {
+      return true;
+    }
+    const int cx = std::clamp(static_cast<int>(x) / kCell, 0, cols_ - 1);
+    const int cy = std::clamp(static_cast<int>(y) / kCell, 0, rows_ - 1);
+    return cells_[static_cast<size_t>(cy) * cols_ + cx] != 0;
+  }
+
+ private:
+  int cols_ = 0;
+  int rows_ = 0;
+  std::vector<uint8_t> cells_;
+};
+
+/**
+ * @brief 解析到当前帧尺寸后的 ROI
+ */
+struct ResolvedRoi {
+  Tile crop;                // 外接矩形（裁剪到原图、起点对齐）
+  RoiMask mask;             // 多边形掩码，矩形 ROI 为空
+};
+
+/**
+ * @brief 一路摄像头的 ROI 集合，按帧尺寸 / 模型输入尺寸缓存解析结果
+ *
+ * 非线程安全，每个算法实例持有一个。
+ */
+class RoiSet {
+ public:
+  /**
+   * @param normalized true 时坐标为相对原图宽高的 [0, 1] 比例，否则为像素
+   */
+  void setRegions(std::vector<RoiRegion> regions, bool normalized);
+
+  bool empty() const { return regions_.empty(); }
+
+  /**
+   * @brief 解析为像素坐标的截取区域与掩码（尺寸不变时直接返回缓存）
+   *
+   * 完全落在原图外的 ROI 被忽略。
+   */
+  const std::vector<ResolvedRoi>& resolve(int frame_width, int frame_height, int input_width,
+                                          int input_height, int align = 2);
+
+ private:
+  std::vector<RoiRegion> regions_;
+  bool normalized_ = false;
+
+  std::vector<ResolvedRoi> resolved_;
+  int resolved_key_[4] = {0, 0, 0, 0};     // frame w / h，input w / h
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline void RoiMask::build(const std::vector<RoiPoint>& polygon, const Tile& crop,
+                           const LetterboxParams& letterbox) {
+  cols_ = (letterbox.dst_width + kCell - 1) / kCell;
+  rows_ = (letterbox.dst_height + kCell - 1) / kCell;
+  cells_.assign(static_cast<size_t>(cols_) * rows_, 0);
+  for (int r = 0; r < rows_; ++r) {
+    const float y = letterbox.toSrcY((r + 0.5f) * kCell) + crop.y;
+    for (int c = 0; c < cols_; ++c) {
+      const float x = letterbox.toSrcX((c + 0.5f) * kCell) + crop.x;
+      cells_[static_cast<size_t>(r) * cols_ + c] = pointInPolygon(polygon, x, y) ? 1 : 0;
+    }
+  }
+}
+
+inline void RoiSet::setRegions(std::vector<RoiRegion> regions, bool normalized) {
+  regions_ = std::move(regions);
+  normalized_ = normalized;
+  resolved_.clear();
+  std::fill(std::begin(resolved_key_), std::end(resolved_key_), 0);
+}
+
+inline const std::vector<ResolvedRoi>& RoiSet::resolve(int frame_width, int frame_height,
+                                                       int input_width, int input_height,
+                                                       int align) {
+  const int key[4] = {frame_width, frame_height, input_width, input_height};
+  if (std::equal(std::begin(key), std::end(key), std::begin(resolved_key_))) {
+    return resolved_;
+  }
+  std::copy(std::begin(key), std::end(key), std::begin(resolved_key_));
+  resolved_.clear();
+  align = std::max(1, align);
+
+  const float sx = normalized_ ? static_cast<float>(frame_width) : 1.0f;
+  const float sy = normalized_ ? static_cast<float>(frame_height) : 1.0f;
+  std::vector<RoiPoint> pixels;
+  for (const RoiRegion& region : regions_) {
+    if (region.polygon.size() < 3) {
+      continue;
+    }
+    pixels.clear();
+    float x1 = static_cast<float>(frame_width);
+    float y1 = static_cast<float>(frame_height);
+    float x2 = 0.0f;
+    float y2 = 0.0f;
+    for (const RoiPoint& p : region.polygon) {
+      pixels.push_back({p.x * sx, p.y * sy});
+      x1 = std::min(x1, pixels.back().x);
+      y1 = std::min(y1, pixels.back().y);
+      x2 = std::max(x2, pixels.back().x);
+      y2 = std::max(y2, pixels.back().y);
+    }
+    int left = std::max(0, static_cast<int>(std::floor(x1)));
+    int top = std::max(0, static_cast<int>(std::floor(y1)));
+    left -= left % align;
+    top -= top % align;
+    const int right = std::min(frame_width, static_cast<int>(std::ceil(x2)));
+    const int bottom = std::min(frame_height, static_cast<int>(std::ceil(y2)));
+    if (right - left <= 0 || bottom - top <= 0) {
+      continue;
+    }
+
+    ResolvedRoi roi;
+    roi.crop.x = left;
+    roi.crop.y = top;
+    roi.crop.width = right - left;
+    roi.crop.height = bottom - top;
+    if (!region.is_rect) {
+      roi.mask.build(pixels, roi.crop,
+                     computeLetterbox(roi.crop.width, roi.crop.height, input_width,
+                                      input_height));
+    }
+    resolved_.push_back(std::move(roi));
+  }
+  return resolved_;
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
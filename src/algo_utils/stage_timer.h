@@ -0,0 +1,223 @@
+#pragma once
+
+/**
+ * @file stage_timer.h
+ * @brief 插件内部分阶段计时（header-only，只依赖插件 C 接口头文件）
+ *
+ * C 插件与 C++ 插件共用，用法：
+ * @code
+ * algo_utils::StageRecorder recorder({"preprocess", "inference", "decode", "nms"});
+ *
+ * {
+ *   algo_utils::ScopedStageTimer timer(recorder, kStagePreprocess);
+ *   preprocess(...);
+ * }
+ * recorder.addFrame();
+ *
+ * AlgoStats stats;
+ * recorder.fill(&stats);            // C 接口 AlgoGetStats
+ * auto snapshot = recorder.snapshot();  // C++ 接口 getStats
+ * @endcode
+ *
+ * 记录路径只有几次 relaxed 原子操作，推理线程与查询线程可以并发。
+ */
+
+#include "../plugin/algo_plugin_interface.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace infer_frame {
+namespace algo_utils {
+
+/**
+ * @brief 单个阶段的累计统计（C++ 侧表示，与 AlgoStageStats 对应）
+ */
+struct StageStats {
+  std::string name;
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  std::array<uint64_t, ALGO_STATS_HIST_BUCKETS> histogram{};
+
+  double avgUs() const { return count > 0 ? total_ns / 1000.0 / count : 0.0; }
+
+  /**
+   * @brief 由直方图估计分位数（返回所在桶的上界，单位微秒）
+   */
+  double percentileUs(double q) const {
+    if (count == 0) {
+      return 0.0;
+    }
+    uint64_t target = static_cast<uint64_t>(q * count);
+    uint64_t seen = 0;
+    for (int i = 0; i < ALGO_STATS_HIST_BUCKETS; ++i) {
+      seen += histogram[i];
+      if (seen > target) {
+        return static_cast<double>(1ULL << i);
+      }
+    }
+    return max_ns / 1000.0;
+  }
+};
+
+/**
+ * @brief 插件累计统计快照
+ */
+struct PerfStats {
+  uint64_t frames = 0;
+  std::vector<StageStats> stages;
+};
+
+/**
+ * @brief 耗时所在直方图桶（log2 微秒）
+ */
+inline int histogramBucket(uint64_t ns) {
+  uint64_t us = ns / 1000;
+  if (us == 0) {
+    return 0;
+  }
+  int bucket = 64 - __builtin_clzll(us);
+  return std::min(bucket, ALGO_STATS_HIST_BUCKETS - 1);
+}
+
+/**
+ * @brief 分阶段耗时记录器（阶段在构造时固定）
+ */
+class StageRecorder {
+ public:
+  explicit StageRecorder(std::initializer_list<const char*> names) {
+    for (const char* name : names) {
+      if (num_stages_ == ALGO_STATS_MAX_STAGES) {
+        break;
+      }
+      names_[num_stages_++] = name;
+    }
+    reset();
+  }
+
+  StageRecorder(const StageRecorder&) = delete;
+  StageRecorder& operator=(const StageRecorder&) = delete;
+
+  int numStages() const { return num_stages_; }
+
+  void record(int stage, uint64_t ns) {
+    if (stage < 0 || stage >= num_stages_) {
+      return;
+    }
+    Counter& c = counters_[stage];
+    c.count.fetch_add(1, std::memory_order_relaxed);
+    c.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    c.histogram[histogramBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t prev = c.max_ns.load(std::memory_order_relaxed);
+    while (ns > prev &&
+           !c.max_ns.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  void addFrame() { frames_.fetch_add(1, std::memory_order_relaxed); }
+
+  void reset() {
+    frames_.store(0, std::memory_order_relaxed);
+    for (Counter& c : counters_) {
+      c.count.store(0, std::memory_order_relaxed);
+      c.total_ns.store(0, std::memory_order_relaxed);
+      c.max_ns.store(0, std::memory_order_relaxed);
+      for (auto& h : c.histogram) {
+        h.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief 填写 C 接口统计结构（AlgoGetStats）
+   */
+  void fill(AlgoStats* stats) const {
+    std::memset(stats, 0, sizeof(AlgoStats));
+    stats->frames = frames_.load(std::memory_order_relaxed);
+    stats->num_stages = num_stages_;
+    for (int i = 0; i < num_stages_; ++i) {
+      AlgoStageStats& out = stats->stages[i];
+      const Counter& c = counters_[i];
+      std::strncpy(out.name, names_[i], sizeof(out.name) - 1);
+      out.count = c.count.load(std::memory_order_relaxed);
+      out.total_ns = c.total_ns.load(std::memory_order_relaxed);
+      out.max_ns = c.max_ns.load(std::memory_order_relaxed);
+      for (int b = 0; b < ALGO_STATS_HIST_BUCKETS; ++b) {
+        out.histogram[b] = c.histogram[b].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief C++ 侧快照（AlgoPluginBase::getStats）
+   */
+  PerfStats snapshot() const {
+    AlgoStats raw;
+    fill(&raw);
+    return fromAlgoStats(raw);
+  }
+
+  static PerfStats fromAlgoStats(const AlgoStats& raw) {
+    PerfStats stats;
+    stats.frames = raw.frames;
+    int num = std::min(raw.num_stages, ALGO_STATS_MAX_STAGES);
+    for (int i = 0; i < num; ++i) {
+      const AlgoStageStats& in = raw.stages[i];
+      StageStats s;
+      s.name.assign(in.name, strnlen(in.name, sizeof(in.name)));
+      s.count = in.count;
+      s.total_ns = in.total_ns;
+      s.max_ns = in.max_ns;
+      std::copy(in.histogram, in.histogram + ALGO_STATS_HIST_BUCKETS, s.histogram.begin());
+      stats.stages.push_back(std::move(s));
+    }
+    return stats;
+  }
+
+ private:
+  struct Counter {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> max_ns;
+    std::array<std::atomic<uint64_t>, ALGO_STATS_HIST_BUCKETS> histogram;
+  };
+
+  int num_stages_ = 0;
+  std::array<const char*, ALGO_STATS_MAX_STAGES> names_{};
+  std::array<Counter, ALGO_STATS_MAX_STAGES> counters_;
+  std::atomic<uint64_t> frames_{0};
+};
+
+/**
+ * @brief RAII 阶段计时
+ */
+class ScopedStageTimer {
+ public:
+  ScopedStageTimer(StageRecorder& recorder, int stage)
+      : recorder_(recorder), stage_(stage), begin_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedStageTimer() {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin_).count();
+    recorder_.record(stage_, static_cast<uint64_t>(ns));
+  }
+
+  ScopedStageTimer(const ScopedStageTimer&) = delete;
+  ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+ private:
+  StageRecorder& recorder_;
+  int stage_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+}  // namespace algo_utils
+}  // namespace infer_frame
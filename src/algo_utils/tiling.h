@@ -0,0 +1,228 @@
+#pragma once
+
+/**
+ * @file tiling.h
+ * @brief 高分辨率图像切片推理（header-only）
+ *
+ * 4K / 8MP 图像整帧缩放到 640x640 后，小目标只剩几个像素。切片推理把原图切成互相重叠的
+ * 若干块（默认每块等于模型输入尺寸，不缩放），可选再加一张整帧缩放的全局视图（负责大目标），
+ * 一帧的所有切片作为一个 batch 推理，框映射回原图后做跨切片 NMS。
+ *
+ * 切片数可按实测耗时自适应：设置 target_latency_ms 后，TilePlanner 用每块耗时的滑动平均
+ * 估算预算内能跑几块，超出时逐步放大切片（每块覆盖更大的原图区域，再缩放到模型输入）。
+ *
+ * @code
+ * algo_utils::TilePlanner planner(options);
+ * const auto& tiles = planner.plan(3840, 2160);
+ * // ... 每块 letterbox 到 batch 的第 t 张，推理，解码 ...
+ * algo_utils::mapTileToSource(letterboxes[t], tiles[t], &candidate);
+ * planner.reportLatency(frame_ms, static_cast<int>(tiles.size()));
+ * @endcode
+ */
+
+#include "yolov8_decode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace infer_frame {
+namespace algo_utils {
+
+/**
+ * @brief 原图上的一块区域
+ */
+struct Tile {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+  bool global = false;     // 整帧全局视图
+};
+
+struct TilingOptions {
+  int tile_width = 640;             // 原图上的切片尺寸，默认等于模型输入（切片不缩放）
+  int tile_height = 640;
+  float overlap = 0.2f;             // 相邻切片最小重叠比例
+  bool global_view = true;          // 追加整帧全局视图
+  int max_tiles = 16;               // 每帧最多切片数（含全局视图）
+  float target_latency_ms = 0.0f;   // > 0 时按实测耗时自适应切片数
+  int align = 2;                    // 切片起点对齐（4:2:0 输入为 2）
+};
+
+/**
+ * @brief 按固定切片尺寸铺满原图，切片均匀分布（实际重叠 >= overlap）
+ *
+ * 只有一块时等同整帧，不再追加全局视图。
+ */
+inline void planTileGrid(int src_width, int src_height, int tile_width, int tile_height,
+                         float overlap, bool global_view, int align, std::vector<Tile>* tiles) {
+  tiles->clear();
+  if (src_width <= 0 || src_height <= 0) {
+    return;
+  }
+  align = std::max(1, align);
+  auto axis = [&](int src, int tile, std::vector<int>* starts) {
+    tile = std::min(std::max(tile, 1), src);
+    const float step = std::max(1.0f, tile * (1.0f - overlap));
+    const int count = tile >= src ? 1 : 1 + static_cast<int>(std::ceil((src - tile) / step));
+    starts->resize(count);
+    for (int i = 0; i < count; ++i) {
+      int start = count == 1 ? 0 : static_cast<int>(std::lround(
+                                       static_cast<double>(src - tile) * i / (count - 1)));
+      (*starts)[i] = start - start % align;
+    }
+    return tile;
+  };
+  std::vector<int> xs;
+  std::vector<int> ys;
+  const int w = axis(src_width, tile_width, &xs);
+  const int h = axis(src_height, tile_height, &ys);
+  // 起点向下对齐后，最后一行 / 列延伸到原图边界
+  for (size_t j = 0; j < ys.size(); ++j) {
+    for (size_t i = 0; i < xs.size(); ++i) {
+      Tile tile;
+      tile.x = xs[i];
+      tile.y = ys[j];
+      tile.width = i + 1 == xs.size() ? src_width - tile.x : w;
+      tile.height = j + 1 == ys.size() ? src_height - tile.y : h;
+      tiles->push_back(tile);
+    }
+  }
+  if (tiles->size() == 1) {
+    tiles->front().global = true;
+  } else if (global_view) {
+    Tile tile;
+    tile.width = src_width;
+    tile.height = src_height;
+    tile.global = true;
+    tiles->push_back(tile);
+  }
+}
+
+/**
+ * @brief 切片内 letterbox 坐标 -> 原图坐标
+ */
+inline void mapTileToSource(const LetterboxParams& params, const Tile& tile, DetCandidate* c) {
+  mapToSource(params, c);
+  c->x1 += tile.x;
+  c->y1 += tile.y;
+  c->x2 += tile.x;
+  c->y2 += tile.y;
+}
+
+/**
+ * @brief 框（原图坐标）是否贴着切片的内部边界
+ *
+ * 贴边的框通常是被切断的目标：重叠足够时相邻切片里有完整的框，过大的目标由全局视图负责，
+ * 合并前丢弃这类框可以避免半截框与完整框 IoU 过低而同时保留。原图边界不算内部边界。
+ */
+inline bool touchesInnerEdge(const DetCandidate& c, const Tile& tile, int src_width,
+                             int src_height, float margin = 2.0f) {
+  if (tile.global) {
+    return false;
+  }
+  return (tile.x > 0 && c.x1 <= tile.x + margin) ||
+         (tile.y > 0 && c.y1 <= tile.y + margin) ||
+         (tile.x + tile.width < src_width && c.x2 >= tile.x + tile.width - margin) ||
+         (tile.y + tile.height < src_height && c.y2 >= tile.y + tile.height - margin);
+}
+
+/**
+ * @brief 切片规划：按预算选择切片尺寸，缓存上一次结果
+ *
+ * 非线程安全，每个算法实例持有一个。
+ */
+class TilePlanner {
+ public:
+  explicit TilePlanner(const TilingOptions& options = TilingOptions()) { setOptions(options); }
+
+  const TilingOptions& options() const { return options_; }
+  void setOptions(const TilingOptions& options);
+
+  /**
+   * @brief 当前预算下的切片（预算与原图尺寸不变时直接返回缓存）
+   */
+  const std::vector<Tile>& plan(int src_width, int src_height);
+
+  /**
+   * @brief 上报一帧的实际耗时，更新切片预算
+   * @param frame_ms 前处理 + 推理 + 后处理总耗时
+   * @param num_tiles 这一帧的切片数
+   */
+  void reportLatency(double frame_ms, int num_tiles);
+
+  /**
+   * @brief 当前切片预算（含全局视图）
+   */
+  int budget() const { return budget_; }
+
+ private:
+  static constexpr double kAlpha = 0.2;      // 每块耗时滑动平均系数
+  static constexpr float kGrowStep = 1.25f;  // 超出预算时切片边长放大倍数
+
+  TilingOptions options_;
+  int budget_ = 1;
+  double tile_ms_ = 0.0;                     // 每块耗时滑动平均，0 表示尚无样本
+
+  std::vector<Tile> tiles_;
+  int planned_width_ = 0;
+  int planned_height_ = 0;
+  int planned_budget_ = 0;
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline void TilePlanner::setOptions(const TilingOptions& options) {
+  options_ = options;
+  options_.max_tiles = std::max(1, options_.max_tiles);
+  options_.overlap = std::clamp(options_.overlap, 0.0f, 0.9f);
+  budget_ = options_.max_tiles;
+  tile_ms_ = 0.0;
+  planned_budget_ = 0;
+}
+
+inline const std::vector<Tile>& TilePlanner::plan(int src_width, int src_height) {
+  if (src_width == planned_width_ && src_height == planned_height_ &&
+      budget_ == planned_budget_) {
+    return tiles_;
+  }
+  // 先按原始切片尺寸铺，超出预算就放大切片，直到放得下或退化为整帧
+  float scale = 1.0f;
+  for (;;) {
+    const int tile_width = static_cast<int>(options_.tile_width * scale);
+    const int tile_height = static_cast<int>(options_.tile_height * scale);
+    planTileGrid(src_width, src_height, tile_width, tile_height, options_.overlap,
+                 options_.global_view, options_.align, &tiles_);
+    if (static_cast<int>(tiles_.size()) <= budget_ ||
+        (tile_width >= src_width && tile_height >= src_height)) {
+      break;
+    }
+    scale *= kGrowStep;
+  }
+  planned_width_ = src_width;
+  planned_height_ = src_height;
+  planned_budget_ = budget_;
+  return tiles_;
+}
+
+inline void TilePlanner::reportLatency(double frame_ms, int num_tiles) {
+  if (options_.target_latency_ms <= 0.0f || num_tiles <= 0 || frame_ms <= 0.0) {
+    return;
+  }
+  const double sample = frame_ms / num_tiles;
+  tile_ms_ = tile_ms_ == 0.0 ? sample : tile_ms_ + kAlpha * (sample - tile_ms_);
+
+  // 超出目标立即收缩；多一块仍留有 10% 余量才增加，避免在边界来回切换
+  const double target = options_.target_latency_ms;
+  if (tile_ms_ * budget_ > target && budget_ > 1) {
+    budget_ = std::max(1, static_cast<int>(target / tile_ms_));
+  } else if (tile_ms_ * (budget_ + 1) <= 0.9 * target && budget_ < options_.max_tiles) {
+    ++budget_;
+  }
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
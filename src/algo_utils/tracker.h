@@ -0,0 +1,532 @@
+#pragma once
+
+/**
+ * @file tracker.h
+ * @brief 多目标跟踪（ByteTrack 风格，header-only）与隔帧检测调度
+ *
+ * 每条轨迹用 Kalman 滤波维护框中心、宽高比、高度及各自的速度（匀速模型），检测帧按 ByteTrack
+ * 两轮关联：
+ * 1. 高分检测与全部轨迹（含丢失的轨迹）按 IoU 关联
+ * 2. 剩余的跟踪中轨迹与低分检测关联，遮挡时分数下降的目标不会断轨
+ * 未匹配的高分检测新建轨迹，命中 min_hits 次后才输出；丢失超过 max_lost_frames 帧删除。
+ * 轨迹 ID 在一个 ByteTracker 内单调递增，不复用。
+ *
+ * 轨迹 x 检测的 IoU 矩阵用 nms.h 的 AVX 内核一次算 8 个，再按 IoU 从大到小贪心匹配
+ * （IoU 门限下与匈牙利算法的结果基本一致，开销小得多）。
+ *
+ * 非检测帧调用 propagate() 只做 Kalman 预测，输出置信度按帧衰减。DetectScheduler 决定哪些帧
+ * 运行检测：每 K 帧一次，输出轨迹的最低置信度低于阈值时提前检测；设置 detect_budget_ms 后
+ * 按实测检测耗时自适应 K。
+ *
+ * @code
+ * algo_utils::ByteTracker tracker(tracker_options);
+ * algo_utils::DetectScheduler scheduler(schedule_options);
+ * if (scheduler.shouldDetect(tracker.minConfidence())) {
+ *   // ... 检测，得到 detections，耗时 detect_ms ...
+ *   scheduler.reportLatency(detect_ms);
+ *   tracks = &tracker.update(detections);
+ * } else {
+ *   tracks = &tracker.propagate();
+ * }
+ * @endcode
+ */
+
+#include "nms.h"
+#include "yolov8_decode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace infer_frame {
+namespace algo_utils {
+
+struct TrackerOptions {
+  float high_threshold = 0.5f;        // 第一轮关联的检测分数下限
+  float low_threshold = 0.1f;         // 低于此分数的检测丢弃
+  float new_track_threshold = 0.6f;   // 新建轨迹所需分数
+  float match_iou = 0.2f;             // 第一轮关联的最小 IoU
+  float low_match_iou = 0.5f;         // 第二轮（低分检测）关联的最小 IoU
+  int min_hits = 2;                   // 新轨迹命中次数达到后才输出（首个检测帧除外）
+  int max_lost_frames = 30;           // 丢失超过此帧数删除
+  float propagate_decay = 0.95f;      // 非检测帧每帧的置信度衰减
+  bool class_aware = true;            // 只关联同类别的检测
+  bool allow_simd = true;             // false 时强制标量 IoU（测试 / 对比用）
+};
+
+/**
+ * @brief 一条输出轨迹（原图坐标）
+ */
+struct TrackBox {
+  float x1 = 0.0f;
+  float y1 = 0.0f;
+  float x2 = 0.0f;
+  float y2 = 0.0f;
+  float score = 0.0f;             // 最近一次匹配的检测分数，传播帧按 propagate_decay 衰减
+  int class_id = 0;
+  uint32_t track_id = 0;          // 从 1 开始
+  int hits = 0;                   // 累计匹配次数
+  int time_since_update = 0;      // 距最近一次匹配的帧数，0 表示本帧由检测更新
+};
+
+/**
+ * @brief 匀速模型 Kalman 滤波，观测为 (cx, cy, a, h)，a = w / h
+ *
+ * 各分量的过程 / 观测噪声互不相关，8x8 协方差退化为 4 个独立的 2x2 块（位置、速度），
+ * 预测与更新都是 4 路相同的标量运算。噪声系数与 ByteTrack / DeepSORT 相同（按框高缩放）。
+ */
+class KalmanBox {
+ public:
+  void init(const DetCandidate& box);
+  void predict();
+  void update(const DetCandidate& box);
+
+  void toBox(TrackBox* box) const;
+
+ private:
+  static constexpr float kStdPosition = 1.0f / 20.0f;
+  static constexpr float kStdVelocity = 1.0f / 160.0f;
+
+  float mean_[4] = {0.0f, 0.0f, 0.0f, 0.0f};   // cx, cy, a, h
+  float vel_[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  float p00_[4] = {0.0f, 0.0f, 0.0f, 0.0f};    // 位置方差
+  float p01_[4] = {0.0f, 0.0f, 0.0f, 0.0f};    // 位置-速度协方差
+  float p11_[4] = {0.0f, 0.0f, 0.0f, 0.0f};    // 速度方差
+
+  static void measure(const DetCandidate& box, float z[4]);
+};
+
+/**
+ * @brief ByteTrack 风格多目标跟踪
+ *
+ * 非线程安全，每路摄像头持有一个。返回的引用在下一次 update / propagate 前有效。
+ */
+class ByteTracker {
+ public:
+  explicit ByteTracker(const TrackerOptions& options = TrackerOptions()) : options_(options) {}
+
+  const TrackerOptions& options() const { return options_; }
+
+  /**
+   * @brief 修改参数（已有轨迹保留）
+   */
+  void setOptions(const TrackerOptions& options) { options_ = options; }
+
+  /**
+   * @brief 检测帧：预测、关联、更新
+   * @param detections 本帧检测结果（原图坐标，NMS 之后）
+   * @return 已确认且本帧匹配到检测的轨迹
+   */
+  const std::vector<TrackBox>& update(const std::vector<DetCandidate>& detections);
+
+  /**
+   * @brief 非检测帧：只做预测
+   * @return 最近一个检测帧仍在跟踪中的已确认轨迹（位置为预测值）
+   */
+  const std::vector<TrackBox>& propagate();
+
+  /**
+   * @brief 清空轨迹（ID 继续递增，不与之前的轨迹重复）
+   */
+  void reset();
+
+  /**
+   * @brief 当前输出轨迹中最低的置信度（匹配分数的滑动平均，传播帧按帧衰减），没有输出时返回 1
+   *
+   * 用平均而不是最近一次的分数，单帧的低分检测（短暂遮挡）不会立即触发重新检测。
+   */
+  float minConfidence() const { return min_confidence_; }
+
+  size_t numTracks() const { return tracks_.size(); }
+
+ private:
+  enum class State { kTentative, kTracked, kLost };
+
+  struct Track {
+    KalmanBox filter;
+    State state = State::kTentative;
+    uint32_t id = 0;
+    int class_id = 0;
+    float score = 0.0f;
+    float confidence = 0.0f;        // 匹配分数的滑动平均
+    int hits = 0;
+    int time_since_update = 0;
+    bool confirmed = false;
+  };
+
+  struct Match {
+    float iou;
+    int track;
+    int detection;
+  };
+
+  TrackerOptions options_;
+  std::vector<Track> tracks_;
+  std::vector<TrackBox> output_;
+  uint32_t next_id_ = 1;
+  bool seen_detections_ = false;
+  float min_confidence_ = 1.0f;
+
+  // 关联缓冲（预热后不再分配）：检测框在前（补齐到 8 的倍数），轨迹预测框在后
+  std::vector<float> x1_;
+  std::vector<float> y1_;
+  std::vector<float> x2_;
+  std::vector<float> y2_;
+  std::vector<float> area_;
+  std::vector<float> iou_;            // tracks x padded_detections
+  std::vector<Match> matches_;
+  std::vector<int> track_match_;      // 轨迹 -> 检测，-1 未匹配
+  std::vector<int> detection_match_;  // 检测 -> 轨迹，-1 未匹配
+
+  void computeIou(const std::vector<DetCandidate>& detections);
+  void associate(const std::vector<DetCandidate>& detections, bool high_round);
+  void emit(bool detection_frame);
+};
+
+struct DetectScheduleOptions {
+  int interval = 1;                   // 固定检测间隔 K（1 表示每帧检测）
+  int min_interval = 1;               // 自适应 K 的范围
+  int max_interval = 8;
+  float detect_budget_ms = 0.0f;      // 平均每帧可用于检测的耗时，> 0 时按实测耗时自适应 K
+  float min_confidence = 0.3f;        // 输出轨迹置信度低于此值时提前检测
+};
+
+/**
+ * @brief 隔帧检测调度：决定当前帧运行检测还是只传播轨迹
+ *
+ * 自适应时 K = ceil(检测耗时滑动平均 / detect_budget_ms)：超出预算立即增大 K，
+ * K - 1 仍留 10% 余量时才减小，避免在边界来回切换（与 TilePlanner 相同）。
+ */
+class DetectScheduler {
+ public:
+  explicit DetectScheduler(const DetectScheduleOptions& options = DetectScheduleOptions()) {
+    setOptions(options);
+  }
+
+  const DetectScheduleOptions& options() const { return options_; }
+  void setOptions(const DetectScheduleOptions& options);
+
+  /**
+   * @brief 每帧调用一次
+   * @param min_confidence 当前输出轨迹的最低置信度（ByteTracker::minConfidence）
+   */
+  bool shouldDetect(float min_confidence);
+
+  /**
+   * @brief 上报一次检测（前处理 + 推理 + 后处理）的耗时
+   */
+  void reportLatency(double detect_ms);
+
+  /**
+   * @brief 下一帧强制检测（参数更新、跟踪重置后调用）
+   */
+  void forceDetect() { frames_since_detect_ = interval_; }
+
+  int interval() const { return interval_; }
+
+ private:
+  static constexpr double kAlpha = 0.2;   // 检测耗时滑动平均系数
+
+  DetectScheduleOptions options_;
+  int interval_ = 1;
+  int frames_since_detect_ = 0;
+  double detect_ms_ = 0.0;                // 0 表示尚无样本
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline void KalmanBox::measure(const DetCandidate& box, float z[4]) {
+  const float w = box.x2 - box.x1;
+  const float h = std::max(box.y2 - box.y1, 1e-3f);
+  z[0] = box.x1 + 0.5f * w;
+  z[1] = box.y1 + 0.5f * h;
+  z[2] = w / h;
+  z[3] = h;
+}
+
+inline void KalmanBox::init(const DetCandidate& box) {
+  measure(box, mean_);
+  const float h = mean_[3];
+  const float pos_std[4] = {2.0f * kStdPosition * h, 2.0f * kStdPosition * h, 1e-2f,
+                            2.0f * kStdPosition * h};
+  const float vel_std[4] = {10.0f * kStdVelocity * h, 10.0f * kStdVelocity * h, 1e-5f,
+                            10.0f * kStdVelocity * h};
+  for (int i = 0; i < 4; ++i) {
+    vel_[i] = 0.0f;
+    p00_[i] = pos_std[i] * pos_std[i];
+    p01_[i] = 0.0f;
+    p11_[i] = vel_std[i] * vel_std[i];
+  }
+}
+
+inline void KalmanBox::predict() {
+  const float h = mean_[3];
+  const float q0[4] = {kStdPosition * h, kStdPosition * h, 1e-2f, kStdPosition * h};
+  const float q1[4] = {kStdVelocity * h, kStdVelocity * h, 1e-5f, kStdVelocity * h};
+  // x' = F x，P' = F P F^T + Q，F = [[1, 1], [0, 1]]
+  for (int i = 0; i < 4; ++i) {
+    mean_[i] += vel_[i];
+    p00_[i] += 2.0f * p01_[i] + p11_[i] + q0[i] * q0[i];
+    p01_[i] += p11_[i];
+    p11_[i] += q1[i] * q1[i];
+  }
+  mean_[3] = std::max(mean_[3], 1e-3f);
+}
+
+inline void KalmanBox::update(const DetCandidate& box) {
+  float z[4];
+  measure(box, z);
+  const float h = mean_[3];
+  const float r[4] = {kStdPosition * h, kStdPosition * h, 1e-1f, kStdPosition * h};
+  for (int i = 0; i < 4; ++i) {
+    const float s = p00_[i] + r[i] * r[i];
+    const float k0 = p00_[i] / s;
+    const float k1 = p01_[i] / s;
+    const float innovation = z[i] - mean_[i];
+    mean_[i] += k0 * innovation;
+    vel_[i] += k1 * innovation;
+    p11_[i] -= k1 * p01_[i];
+    p00_[i] *= 1.0f - k0;
+    p01_[i] *= 1.0f - k0;
+  }
+}
+
+inline void KalmanBox::toBox(TrackBox* box) const {
+  const float h = mean_[3];
+  const float w = mean_[2] * h;
+  box->x1 = mean_[0] - 0.5f * w;
+  box->y1 = mean_[1] - 0.5f * h;
+  box->x2 = mean_[0] + 0.5f * w;
+  box->y2 = mean_[1] + 0.5f * h;
+}
+
+inline void ByteTracker::reset() {
+  tracks_.clear();
+  output_.clear();
+  seen_detections_ = false;
+  min_confidence_ = 1.0f;
+}
+
+inline void ByteTracker::computeIou(const std::vector<DetCandidate>& detections) {
+  const int num_detections = static_cast<int>(detections.size());
+  const int num_tracks = static_cast<int>(tracks_.size());
+  const int padded = (num_detections + 7) / 8 * 8;
+  const size_t total = static_cast<size_t>(padded) + num_tracks;
+  x1_.assign(total, 0.0f);
+  y1_.assign(total, 0.0f);
+  x2_.assign(total, 0.0f);
+  y2_.assign(total, 0.0f);
+  area_.assign(total, 0.0f);
+  auto load = [&](size_t i, float x1, float y1, float x2, float y2) {
+    x1_[i] = x1;
+    y1_[i] = y1;
+    x2_[i] = x2;
+    y2_[i] = y2;
+    area_[i] = std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
+  };
+  for (int d = 0; d < num_detections; ++d) {
+    const DetCandidate& c = detections[d];
+    load(d, c.x1, c.y1, c.x2, c.y2);
+  }
+  TrackBox predicted;
+  for (int t = 0; t < num_tracks; ++t) {
+    tracks_[t].filter.toBox(&predicted);
+    load(padded + t, predicted.x1, predicted.y1, predicted.x2, predicted.y2);
+  }
+
+  iou_.resize(static_cast<size_t>(num_tracks) * padded);
+#if defined(INFER_FRAME_NMS_X86)
+  const bool use_simd = options_.allow_simd && nmsUsesSimd();
+#endif
+  for (int t = 0; t < num_tracks; ++t) {
+    float* row = iou_.data() + static_cast<size_t>(t) * padded;
+#if defined(INFER_FRAME_NMS_X86)
+    if (use_simd) {
+      // 轨迹框存放在检测框之后，复用 NMS 的 "box i 对 [begin, end)" 内核
+      nms_detail::iouRowAvx(x1_.data(), y1_.data(), x2_.data(), y2_.data(), area_.data(),
+                            padded + t, 0, padded, row);
+      continue;
+    }
+#endif
+    for (int d = 0; d < num_detections; ++d) {
+      row[d] = nms_detail::iouScalar(x1_.data(), y1_.data(), x2_.data(), y2_.data(),
+                                     area_.data(), padded + t, d);
+    }
+  }
+}
+
+inline void ByteTracker::associate(const std::vector<DetCandidate>& detections,
+                                   bool high_round) {
+  const int num_detections = static_cast<int>(detections.size());
+  const int padded = (num_detections + 7) / 8 * 8;
+  const float min_iou = high_round ? options_.match_iou : options_.low_match_iou;
+  matches_.clear();
+  for (int t = 0; t < static_cast<int>(tracks_.size()); ++t) {
+    const Track& track = tracks_[t];
+    // 第二轮只让跟踪中的轨迹匹配低分检测，丢失的轨迹只接受高分检测
+    if (track_match_[t] >= 0 || (!high_round && track.state != State::kTracked)) {
+      continue;
+    }
+    const float* row = iou_.data() + static_cast<size_t>(t) * padded;
+    for (int d = 0; d < num_detections; ++d) {
+      if (row[d] < min_iou) {
+        continue;     // 绝大多数组合不相交，先按 IoU 过滤
+      }
+      const DetCandidate& c = detections[d];
+      const bool high = c.score >= options_.high_threshold;
+      if (detection_match_[d] >= 0 || high != high_round || c.score < options_.low_threshold ||
+          (options_.class_aware && c.class_id != track.class_id)) {
+        continue;
+      }
+      matches_.push_back({row[d], t, d});
+    }
+  }
+  std::sort(matches_.begin(), matches_.end(), [](const Match& a, const Match& b) {
+    if (a.iou != b.iou) {
+      return a.iou > b.iou;
+    }
+    return a.track != b.track ? a.track < b.track : a.detection < b.detection;
+  });
+  for (const Match& m : matches_) {
+    if (track_match_[m.track] >= 0 || detection_match_[m.detection] >= 0) {
+      continue;
+    }
+    track_match_[m.track] = m.detection;
+    detection_match_[m.detection] = m.track;
+  }
+}
+
+inline const std::vector<TrackBox>& ByteTracker::update(
+    const std::vector<DetCandidate>& detections) {
+  for (Track& track : tracks_) {
+    track.filter.predict();
+    ++track.time_since_update;
+  }
+  computeIou(detections);
+  track_match_.assign(tracks_.size(), -1);
+  detection_match_.assign(detections.size(), -1);
+  associate(detections, true);
+  associate(detections, false);
+
+  const size_t num_existing = tracks_.size();
+  for (size_t t = 0; t < num_existing; ++t) {
+    Track& track = tracks_[t];
+    const int d = track_match_[t];
+    if (d < 0) {
+      // 未确认的轨迹一次未匹配即删除，已确认的转为丢失
+      if (track.state == State::kTentative) {
+        track.time_since_update = options_.max_lost_frames + 1;
+      } else {
+        track.state = State::kLost;
+      }
+      continue;
+    }
+    const DetCandidate& c = detections[d];
+    track.filter.update(c);
+    track.score = c.score;
+    track.confidence += 0.5f * (c.score - track.confidence);
+    track.time_since_update = 0;
+    ++track.hits;
+    track.confirmed = track.confirmed || track.hits >= options_.min_hits;
+    track.state = track.confirmed ? State::kTracked : State::kTentative;
+  }
+
+  // 未匹配的高分检测新建轨迹；首个检测帧的轨迹直接确认（没有历史可供验证）
+  for (size_t d = 0; d < detections.size(); ++d) {
+    const DetCandidate& c = detections[d];
+    if (detection_match_[d] >= 0 || c.score < options_.new_track_threshold) {
+      continue;
+    }
+    Track track;
+    track.filter.init(c);
+    track.id = next_id_++;
+    track.class_id = c.class_id;
+    track.score = c.score;
+    track.confidence = c.score;
+    track.hits = 1;
+    track.confirmed = !seen_detections_ || options_.min_hits <= 1;
+    track.state = track.confirmed ? State::kTracked : State::kTentative;
+    tracks_.push_back(track);
+  }
+  seen_detections_ = true;
+
+  tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(),
+                               [&](const Track& track) {
+                                 return track.time_since_update > options_.max_lost_frames;
+                               }),
+                tracks_.end());
+  emit(true);
+  return output_;
+}
+
+inline const std::vector<TrackBox>& ByteTracker::propagate() {
+  for (Track& track : tracks_) {
+    track.filter.predict();
+    ++track.time_since_update;
+  }
+  tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(),
+                               [&](const Track& track) {
+                                 return track.time_since_update > options_.max_lost_frames;
+                               }),
+                tracks_.end());
+  emit(false);
+  return output_;
+}
+
+inline void ByteTracker::emit(bool detection_frame) {
+  output_.clear();
+  min_confidence_ = 1.0f;
+  for (const Track& track : tracks_) {
+    if (!track.confirmed || track.state != State::kTracked ||
+        (detection_frame && track.time_since_update != 0)) {
+      continue;
+    }
+    const float decay = std::pow(options_.propagate_decay,
+                                 static_cast<float>(track.time_since_update));
+    min_confidence_ = std::min(min_confidence_, track.confidence * decay);
+    TrackBox box;
+    track.filter.toBox(&box);
+    box.score = track.score * decay;
+    box.class_id = track.class_id;
+    box.track_id = track.id;
+    box.hits = track.hits;
+    box.time_since_update = track.time_since_update;
+    output_.push_back(box);
+  }
+}
+
+inline void DetectScheduler::setOptions(const DetectScheduleOptions& options) {
+  options_ = options;
+  options_.min_interval = std::max(1, options_.min_interval);
+  options_.max_interval = std::max(options_.min_interval, options_.max_interval);
+  interval_ = std::clamp(options_.interval, options_.min_interval, options_.max_interval);
+  detect_ms_ = 0.0;
+  forceDetect();
+}
+
+inline bool DetectScheduler::shouldDetect(float min_confidence) {
+  const bool detect =
+      frames_since_detect_ >= interval_ || min_confidence < options_.min_confidence;
+  frames_since_detect_ = detect ? 1 : frames_since_detect_ + 1;
+  return detect;
+}
+
+inline void DetectScheduler::reportLatency(double detect_ms) {
+  if (options_.detect_budget_ms <= 0.0f || detect_ms <= 0.0) {
+    return;
+  }
+  detect_ms_ = detect_ms_ == 0.0 ? detect_ms : detect_ms_ + kAlpha * (detect_ms - detect_ms_);
+
+  const double budget = options_.detect_budget_ms;
+  if (detect_ms_ > budget * interval_ && interval_ < options_.max_interval) {
+    interval_ = std::min(options_.max_interval, static_cast<int>(std::ceil(detect_ms_ / budget)));
+  } else if (interval_ > options_.min_interval && detect_ms_ <= 0.9 * budget * (interval_ - 1)) {
+    --interval_;
+  }
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
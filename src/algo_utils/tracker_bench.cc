@@ -0,0 +1,156 @@
+/**
+ * @file tracker_bench.cc
+ * @brief 跟踪耗时与隔帧检测效果
+ *
+ * 模拟若干匀速运动的目标（检测框带高斯抖动，偶尔分数偏低模拟遮挡）：
+ *   1. 关联耗时：50 / 200 / 1000 个目标时每个检测帧 update() 的耗时，标量 vs AVX IoU
+ *   2. 隔帧检测：K = 1 / 2 / 3 / 5 时实际检测帧比例、每帧输出数、ID 切换次数
+ *      （检测框的 anchor 字段记录真实目标编号，同一目标的轨迹 ID 变化计为一次切换）
+ *
+ * 用法: tracker_bench [frames]
+ */
+
+#include "algo_utils/tracker.h"
+#include "utils/one_logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace infer_frame;
+
+namespace {
+
+struct Scene {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> vx;
+  std::vector<float> vy;
+};
+
+Scene makeScene(int objects, std::mt19937* rng) {
+  std::uniform_real_distribution<float> pos_x(0.0f, 1800.0f);
+  std::uniform_real_distribution<float> pos_y(0.0f, 900.0f);
+  std::uniform_real_distribution<float> speed(-4.0f, 4.0f);
+  Scene scene;
+  for (int i = 0; i < objects; ++i) {
+    scene.x.push_back(pos_x(*rng));
+    scene.y.push_back(pos_y(*rng));
+    scene.vx.push_back(speed(*rng));
+    scene.vy.push_back(speed(*rng) * 0.5f);
+  }
+  return scene;
+}
+
+/**
+ * @brief 第 frame 帧的检测结果（目标在画面内来回反弹）
+ */
+void detect(const Scene& scene, int frame, std::mt19937* rng,
+            std::vector<algo_utils::DetCandidate>* detections) {
+  std::normal_distribution<float> jitter(0.0f, 1.5f);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  detections->clear();
+  for (size_t i = 0; i < scene.x.size(); ++i) {
+    auto bounce = [](float p, float v, int t, float range) {
+      float q = std::fmod(std::fabs(p + v * t), 2.0f * range);
+      return q > range ? 2.0f * range - q : q;
+    };
+    algo_utils::DetCandidate c;
+    c.x1 = bounce(scene.x[i], scene.vx[i], frame, 1800.0f) + jitter(*rng);
+    c.y1 = bounce(scene.y[i], scene.vy[i], frame, 900.0f) + jitter(*rng);
+    c.x2 = c.x1 + 40.0f + static_cast<float>(i % 5) * 8.0f;
+    c.y2 = c.y1 + 90.0f + static_cast<float>(i % 3) * 20.0f;
+    c.score = uniform(*rng) < 0.05f ? 0.3f : 0.7f + 0.3f * uniform(*rng);
+    c.class_id = static_cast<int>(i % 4);
+    c.anchor = static_cast<int>(i);
+    detections->push_back(c);
+  }
+}
+
+double measureUpdate(int objects, bool allow_simd, int frames) {
+  std::mt19937 rng(7);
+  Scene scene = makeScene(objects, &rng);
+  algo_utils::TrackerOptions options;
+  options.allow_simd = allow_simd;
+  algo_utils::ByteTracker tracker(options);
+  std::vector<algo_utils::DetCandidate> detections;
+  std::vector<double> samples;
+  for (int f = 0; f < frames; ++f) {
+    detect(scene, f, &rng, &detections);
+    auto begin = std::chrono::steady_clock::now();
+    tracker.update(detections);
+    samples.push_back(
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin)
+            .count());
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int frames = argc > 1 ? std::stoi(argv[1]) : 300;
+
+  LOG_INFO("======================================");
+  LOG_INFO("  Tracker Benchmark ({} frames)", frames);
+  LOG_INFO("======================================");
+  LOG_INFO("{:<10} {:>14} {:>14}", "objects", "scalar p50(us)",
+           algo_utils::nmsUsesSimd() ? "avx p50(us)" : "-");
+  for (int objects : {50, 200, 1000}) {
+    const double scalar = measureUpdate(objects, false, frames);
+    const double simd = algo_utils::nmsUsesSimd() ? measureUpdate(objects, true, frames) : 0.0;
+    LOG_INFO("{:<10} {:>14.1f} {:>14.1f}", objects, scalar, simd);
+  }
+
+  LOG_INFO("--------------------------------------");
+  LOG_INFO("  Detect every K frames (100 objects)");
+  LOG_INFO("{:<6} {:>12} {:>14} {:>12}", "K", "detect ratio", "outputs/frame", "id switches");
+  for (int k : {1, 2, 3, 5}) {
+    std::mt19937 rng(11);
+    Scene scene = makeScene(100, &rng);
+    algo_utils::ByteTracker tracker;
+    algo_utils::DetectScheduleOptions schedule;
+    schedule.interval = k;
+    algo_utils::DetectScheduler scheduler(schedule);
+    std::vector<algo_utils::DetCandidate> detections;
+    std::map<int, uint32_t> owner;    // 真实目标 -> 最近一次关联的轨迹 ID
+    int detected = 0;
+    size_t outputs = 0;
+    int switches = 0;
+    for (int f = 0; f < frames; ++f) {
+      if (!scheduler.shouldDetect(tracker.minConfidence())) {
+        outputs += tracker.propagate().size();
+        continue;
+      }
+      ++detected;
+      detect(scene, f, &rng, &detections);
+      const auto& tracks = tracker.update(detections);
+      outputs += tracks.size();
+      // 检测帧上按最近的检测框确定轨迹对应的真实目标
+      for (const auto& track : tracks) {
+        float best = 1e30f;
+        int object = -1;
+        for (const auto& c : detections) {
+          const float dx = (c.x1 + c.x2) - (track.x1 + track.x2);
+          const float dy = (c.y1 + c.y2) - (track.y1 + track.y2);
+          if (dx * dx + dy * dy < best) {
+            best = dx * dx + dy * dy;
+            object = c.anchor;
+          }
+        }
+        auto it = owner.find(object);
+        if (it != owner.end() && it->second != track.track_id) {
+          ++switches;
+        }
+        owner[object] = track.track_id;
+      }
+    }
+    LOG_INFO("{:<6} {:>12.2f} {:>14.1f} {:>12}", k, static_cast<double>(detected) / frames,
+             static_cast<double>(outputs) / frames, switches);
+  }
+  return 0;
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+/**
+ * @file yolov8_decode.h
+ * @brief YOLOv8 输出解码（header-only，不做转置）
+ *
+ * YOLOv8 输出为 [N, 4 + C (+ 额外通道), A] 通道优先：同一通道的所有 anchor 连续。
+ * 原来的写法先 cv::transpose 成 [A, 4 + C] 再逐 anchor 扫描，整块输出要多读写一遍。
+ * 这里直接按类别行扫描：
+ *
+ * 1. 每次取 64 个 anchor，逐类别行求逐列最大值（连续读，x86 上 AVX 一次 8 个）
+ * 2. 最大值低于阈值的 anchor 直接淘汰（通常 > 99%）
+ * 3. 只对幸存 anchor 求类别下标、读取框坐标
+ *
+ * @code
+ * algo_utils::Yolov8OutputLayout layout{80, 84, 8400};
+ * std::vector<algo_utils::DetCandidate> candidates;
+ * algo_utils::decodeYolov8(output, layout, 0.25f, &candidates);
+ * for (auto& c : candidates) algo_utils::mapToSource(letterbox, &c);
+ * @endcode
+ *
+ * 候选框坐标在模型输入空间（x1, y1, x2, y2），未做 NMS。
+ *
+ * seg / pose 模型的额外通道（掩码系数、关键点）走同一条解码路径：先按类别过滤 + NMS，
+ * 再用 gatherAnchorChannels / decodeKeypoints 只读取幸存框所在 anchor 的那几列。
+ */
+
+#include "letterbox.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INFER_FRAME_DECODE_X86 1
+#endif
+
+namespace infer_frame {
+namespace algo_utils {
+
+/**
+ * @brief 单张图输出的布局（不含 batch 维）
+ */
+struct Yolov8OutputLayout {
+  int num_classes = 80;
+  int num_channels = 84;    // 4 + num_classes，seg / pose 模型后面还有掩码系数或关键点
+  int num_anchors = 8400;
+
+  size_t imageStride() const {
+    return static_cast<size_t>(num_channels) * static_cast<size_t>(num_anchors);
+  }
+  bool valid() const {
+    return num_classes > 0 && num_anchors > 0 && num_channels >= 4 + num_classes;
+  }
+};
+
+/**
+ * @brief 通过置信度过滤的候选框
+ */
+struct DetCandidate {
+  float x1 = 0.0f;
+  float y1 = 0.0f;
+  float x2 = 0.0f;
+  float y2 = 0.0f;
+  float score = 0.0f;
+  int class_id = 0;
+  int anchor = 0;          // anchor 下标，seg / pose 用来取额外通道
+};
+
+/**
+ * @brief pose 关键点
+ */
+struct Keypoint {
+  float x = 0.0f;
+  float y = 0.0f;
+  float score = 0.0f;      // 可见性（导出模型中已做 sigmoid）
+};
+
+namespace yolov8_decode_detail {
+
+constexpr int kTile = 64;
+
+/**
+ * @brief 标量实现：[a0, a0 + count) 列的逐类别最大值
+ */
+inline void tileMaxScalar(const float* class_rows, int64_t stride, int num_classes, int64_t a0,
+                          int count, float* max_out) {
+  const float* row = class_rows + a0;
+  std::copy(row, row + count, max_out);
+  for (int c = 1; c < num_classes; ++c) {
+    row = class_rows + c * stride + a0;
+    for (int i = 0; i < count; ++i) {
+      max_out[i] = std::max(max_out[i], row[i]);
+    }
+  }
+}
+
+#if defined(INFER_FRAME_DECODE_X86)
+
+inline bool cpuHasAvx() {
+  static const bool supported = __builtin_cpu_supports("avx");
+  return supported;
+}
+
+/**
+ * @brief AVX 实现：kTile 列的逐类别最大值，8 个累加器常驻寄存器
+ * @return 至少一列达到阈值
+ */
+__attribute__((target("avx"))) inline bool tileMaxAvx(const float* class_rows, int64_t stride,
+                                                      int num_classes, int64_t a0,
+                                                      float threshold, float* max_out) {
+  const float* row = class_rows + a0;
+  __m256 acc[8];
+  for (int k = 0; k < 8; ++k) {
+    acc[k] = _mm256_loadu_ps(row + 8 * k);
+  }
+  for (int c = 1; c < num_classes; ++c) {
+    row = class_rows + c * stride + a0;
+    for (int k = 0; k < 8; ++k) {
+      acc[k] = _mm256_max_ps(acc[k], _mm256_loadu_ps(row + 8 * k));
+    }
+  }
+  const __m256 vthreshold = _mm256_set1_ps(threshold);
+  int any = 0;
+  for (int k = 0; k < 8; ++k) {
+    any |= _mm256_movemask_ps(_mm256_cmp_ps(acc[k], vthreshold, _CMP_GE_OQ));
+    _mm256_storeu_ps(max_out + 8 * k, acc[k]);
+  }
+  return any != 0;
+}
+
+#endif  // INFER_FRAME_DECODE_X86
+
+/**
+ * @brief 幸存 anchor 的类别下标（取最大值首次出现的类别）
+ */
+inline int argmaxColumn(const float* class_rows, int64_t stride, int num_classes, int64_t anchor,
+                        float best) {
+  for (int c = 0; c < num_classes; ++c) {
+    if (class_rows[c * stride + anchor] == best) {
+      return c;
+    }
+  }
+  return 0;
+}
+
+inline void emitCandidate(const float* output, int64_t stride, int64_t anchor, float score,
+                          int class_id, std::vector<DetCandidate>* candidates) {
+  const float cx = output[anchor];
+  const float cy = output[stride + anchor];
+  const float half_w = 0.5f * output[2 * stride + anchor];
+  const float half_h = 0.5f * output[3 * stride + anchor];
+  DetCandidate c;
+  c.x1 = cx - half_w;
+  c.y1 = cy - half_h;
+  c.x2 = cx + half_w;
+  c.y2 = cy + half_h;
+  c.score = score;
+  c.class_id = class_id;
+  c.anchor = static_cast<int>(anchor);
+  candidates->push_back(c);
+}
+
+}  // namespace yolov8_decode_detail
+
+/**
+ * @brief 当前 CPU 是否使用向量化实现
+ */
+inline bool yolov8DecodeUsesSimd() {
+#if defined(INFER_FRAME_DECODE_X86)
+  return yolov8_decode_detail::cpuHasAvx();
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief 解码单张图输出，候选框追加到 candidates（按 anchor 顺序）
+ *
+ * @param output 单张图输出首地址，[num_channels, num_anchors]
+ * @param conf_threshold 类别最大分数 >= 阈值的 anchor 保留
+ * @param allow_simd false 时强制标量实现（测试 / 对比用）
+ * @return 新增候选框数量
+ */
+inline size_t decodeYolov8(const float* output, const Yolov8OutputLayout& layout,
+                           float conf_threshold, std::vector<DetCandidate>* candidates,
+                           bool allow_simd = true) {
+  using namespace yolov8_decode_detail;
+  if (!output || !candidates || !layout.valid()) {
+    return 0;
+  }
+  const size_t before = candidates->size();
+  const int64_t stride = layout.num_anchors;
+  const float* class_rows = output + 4 * stride;
+  const bool use_simd = allow_simd && yolov8DecodeUsesSimd();
+  float tile_max[kTile];
+
+  for (int64_t a0 = 0; a0 < stride; a0 += kTile) {
+    const int count = static_cast<int>(std::min<int64_t>(kTile, stride - a0));
+#if defined(INFER_FRAME_DECODE_X86)
+    if (use_simd && count == kTile) {
+      if (!tileMaxAvx(class_rows, stride, layout.num_classes, a0, conf_threshold, tile_max)) {
+        continue;
+      }
+    } else {
+      tileMaxScalar(class_rows, stride, layout.num_classes, a0, count, tile_max);
+    }
+#else
+    (void)use_simd;
+    tileMaxScalar(class_rows, stride, layout.num_classes, a0, count, tile_max);
+#endif
+    for (int i = 0; i < count; ++i) {
+      if (tile_max[i] >= conf_threshold) {
+        const int64_t anchor = a0 + i;
+        int class_id = argmaxColumn(class_rows, stride, layout.num_classes, anchor, tile_max[i]);
+        emitCandidate(output, stride, anchor, tile_max[i], class_id, candidates);
+      }
+    }
+  }
+  return candidates->size() - before;
+}
+
+/**
+ * @brief 解码 batch 输出 [batch, num_channels, num_anchors]，每张图一组候选框
+ */
+inline void decodeYolov8Batch(const float* output, int batch, const Yolov8OutputLayout& layout,
+                              float conf_threshold,
+                              std::vector<std::vector<DetCandidate>>* per_image,
+                              bool allow_simd = true) {
+  per_image->resize(std::max(0, batch));
+  for (int n = 0; n < batch; ++n) {
+    (*per_image)[n].clear();
+    decodeYolov8(output + n * layout.imageStride(), layout, conf_threshold, &(*per_image)[n],
+                 allow_simd);
+  }
+}
+
+/**
+ * @brief 模型输入坐标 -> 原图坐标（去掉 letterbox 缩放与填充，裁剪到原图范围）
+ */
+inline void mapToSource(const LetterboxParams& params, DetCandidate* c) {
+  const float max_x = static_cast<float>(params.src_width);
+  const float max_y = static_cast<float>(params.src_height);
+  c->x1 = std::clamp(params.toSrcX(c->x1), 0.0f, max_x);
+  c->y1 = std::clamp(params.toSrcY(c->y1), 0.0f, max_y);
+  c->x2 = std::clamp(params.toSrcX(c->x2), 0.0f, max_x);
+  c->y2 = std::clamp(params.toSrcY(c->y2), 0.0f, max_y);
+}
+
+/**
+ * @brief 读取一个 anchor 的 count 个通道（从 first_channel 起）
+ *
+ * 每个通道跨 num_anchors 读一个值；只对 NMS 之后的幸存框调用，开销与框数成正比。
+ */
+inline void gatherAnchorChannels(const float* output, const Yolov8OutputLayout& layout,
+                                 int anchor, int first_channel, int count, float* out) {
+  const int64_t stride = layout.num_anchors;
+  const float* column = output + static_cast<int64_t>(first_channel) * stride + anchor;
+  for (int i = 0; i < count; ++i) {
+    out[i] = column[i * stride];
+  }
+}
+
+/**
+ * @brief 解码 pose 候选框的关键点（坐标在模型输入空间）
+ *
+ * 关键点通道紧跟在类别通道之后，每个关键点 [x, y, visibility]。
+ */
+inline void decodeKeypoints(const float* output, const Yolov8OutputLayout& layout,
+                            const DetCandidate& c, int num_keypoints, Keypoint* keypoints) {
+  static_assert(sizeof(Keypoint) == 3 * sizeof(float), "Keypoint must be packed x, y, score");
+  gatherAnchorChannels(output, layout, c.anchor, 4 + layout.num_classes, 3 * num_keypoints,
+                       reinterpret_cast<float*>(keypoints));
+}
+
+/**
+ * @brief 关键点模型输入坐标 -> 原图坐标
+ */
+inline void mapToSource(const LetterboxParams& params, Keypoint* k) {
+  k->x = std::clamp(params.toSrcX(k->x), 0.0f, static_cast<float>(params.src_width));
+  k->y = std::clamp(params.toSrcY(k->y), 0.0f, static_cast<float>(params.src_height));
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
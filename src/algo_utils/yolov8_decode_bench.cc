@@ -0,0 +1,128 @@
+/**
+ * @file yolov8_decode_bench.cc
+ * @brief YOLOv8 输出解码耗时对比：转置后逐 anchor 扫描 vs 通道优先直接解码
+ *
+ * 对比项（输出 [N, 84, 8400]，模拟真实分布：绝大多数 anchor 分数很低）：
+ *   1. 转置：先转成 [8400, 84] 再逐 anchor 求最大类别（docs/runV8V11_code_analysis.md 的写法）
+ *   2. 直接解码，标量
+ *   3. 直接解码，AVX（CPU 支持时）
+ *
+ * 用法: yolov8_decode_bench [iterations] [batch]
+ */
+
+#include "algo_utils/yolov8_decode.h"
+#include "algo_utils/bench_stats.h"
+#include "utils/one_logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace infer_frame;
+
+namespace {
+
+using algo_utils::LatencySummary;
+using algo_utils::measure;
+
+void report(const std::string& mode, const LatencySummary& s, double baseline_p50) {
+  LOG_INFO("{:<18} {:>10.1f} {:>10.1f} {:>10.1f} {:>8.2f}x", mode, s.mean_us, s.p50_us, s.p99_us,
+           baseline_p50 / s.p50_us);
+}
+
+/**
+ * @brief 转置基线：[C, A] -> [A, C] 后逐 anchor 扫描
+ */
+void decodeTransposed(const float* output, int batch, const algo_utils::Yolov8OutputLayout& layout,
+                      float conf_threshold, std::vector<float>* transposed,
+                      std::vector<std::vector<algo_utils::DetCandidate>>* per_image) {
+  const int channels = layout.num_channels;
+  const int anchors = layout.num_anchors;
+  transposed->resize(layout.imageStride());
+  per_image->resize(batch);
+  for (int n = 0; n < batch; ++n) {
+    const float* src = output + n * layout.imageStride();
+    for (int c = 0; c < channels; ++c) {
+      for (int a = 0; a < anchors; ++a) {
+        (*transposed)[static_cast<size_t>(a) * channels + c] =
+            src[static_cast<size_t>(c) * anchors + a];
+      }
+    }
+    auto& candidates = (*per_image)[n];
+    candidates.clear();
+    for (int a = 0; a < anchors; ++a) {
+      const float* row = transposed->data() + static_cast<size_t>(a) * channels;
+      int best = 0;
+      for (int c = 1; c < layout.num_classes; ++c) {
+        if (row[4 + c] > row[4 + best]) {
+          best = c;
+        }
+      }
+      if (row[4 + best] >= conf_threshold) {
+        algo_utils::DetCandidate candidate;
+        candidate.x1 = row[0] - 0.5f * row[2];
+        candidate.y1 = row[1] - 0.5f * row[3];
+        candidate.x2 = row[0] + 0.5f * row[2];
+        candidate.y2 = row[1] + 0.5f * row[3];
+        candidate.score = row[4 + best];
+        candidate.class_id = best;
+        candidate.anchor = a;
+        candidates.push_back(candidate);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? std::stoi(argv[1]) : 500;
+  int batch = argc > 2 ? std::stoi(argv[2]) : 1;
+  const float conf_threshold = 0.25f;
+
+  algo_utils::Yolov8OutputLayout layout;
+  std::vector<float> output(layout.imageStride() * batch);
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  for (auto& v : output) {
+    float x = uniform(rng);
+    v = x * x * x * x * 0.2f;
+  }
+  // 每帧约 100 个 anchor 过阈值
+  for (int n = 0; n < batch; ++n) {
+    float* image = output.data() + n * layout.imageStride();
+    for (int k = 0; k < 100; ++k) {
+      image[(4 + k % layout.num_classes) * layout.num_anchors + k * 83] = 0.8f;
+    }
+  }
+
+  std::vector<std::vector<algo_utils::DetCandidate>> per_image;
+  std::vector<float> transposed;
+
+  LOG_INFO("======================================");
+  LOG_INFO("  YOLOv8 Decode Benchmark");
+  LOG_INFO("======================================");
+  LOG_INFO("output [{}, {}, {}], {} iterations", batch, layout.num_channels, layout.num_anchors,
+           iterations);
+  LOG_INFO("{:<18} {:>10} {:>10} {:>10} {:>9}", "mode", "mean(us)", "p50(us)", "p99(us)",
+           "speedup");
+
+  auto baseline = measure(iterations, [&]() {
+    decodeTransposed(output.data(), batch, layout, conf_threshold, &transposed, &per_image);
+  });
+  report("transpose", baseline, baseline.p50_us);
+  report("direct scalar", measure(iterations, [&]() {
+    algo_utils::decodeYolov8Batch(output.data(), batch, layout, conf_threshold, &per_image, false);
+  }), baseline.p50_us);
+  if (algo_utils::yolov8DecodeUsesSimd()) {
+    report("direct avx", measure(iterations, [&]() {
+      algo_utils::decodeYolov8Batch(output.data(), batch, layout, conf_threshold, &per_image);
+    }), baseline.p50_us);
+  } else {
+    LOG_INFO("AVX not supported on this CPU, skip SIMD path");
+  }
+  LOG_INFO("candidates per frame: {}", per_image.empty() ? 0 : per_image[0].size());
+  return 0;
+}
@@ -0,0 +1,406 @@
+#pragma once
+
+/**
+ * @file yolov8_mask.h
+ * @brief YOLOv8-seg 实例掩码的延迟组装与编码（header-only）
+ *
+ * YOLOv8-seg 有两个输出：[4 + C + P, A]（P = 32 个掩码系数）与原型 [P, H/4, W/4]。
+ * 常见写法先把所有候选的系数矩阵乘原型得到整图掩码，再按框裁剪，
+ * 绝大部分计算落在被 NMS 淘汰的框和框外区域。这里只在 NMS 之后对幸存框组装：
+ *
+ * 1. 系数只读取幸存框所在 anchor 的 P 列（gatherAnchorChannels）
+ * 2. 系数 x 原型只在框对应的原型裁剪区内累加（x86 上 AVX 一次 8 个像素）
+ * 3. sigmoid(v) > 0.5 等价于 v > 0，不计算 sigmoid
+ * 4. 在原图分辨率下按双线性插值的 logit 阈值化，逐行直接编码为 RLE / 位图，不生成整图掩码。
+ *    一行内落在同一对原型列之间的原图像素，logit 随 x 线性变化，符号至多变一次：
+ *    两列同号时整段同号，异号时二分找分界，每行开销与原型列数成正比而不是原图宽度
+ *
+ * @code
+ * algo_utils::MaskAssembler assembler;
+ * algo_utils::gatherAnchorChannels(output, layout, c.anchor, 4 + num_classes, 32, coeffs);
+ * algo_utils::MaskRegion region = assembler.assemble(coeffs, protos, proto_layout, c, letterbox);
+ * assembler.encodeRle(&runs);   // 原图上 region 范围内的掩码
+ * @endcode
+ */
+
+#include "letterbox.h"
+#include "yolov8_decode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INFER_FRAME_MASK_X86 1
+#endif
+
+namespace infer_frame {
+namespace algo_utils {
+
+/**
+ * @brief 掩码原型输出布局（不含 batch 维）
+ */
+struct MaskProtoLayout {
+  int num_protos = 32;
+  int width = 160;          // 模型输入宽 / 4
+  int height = 160;
+
+  size_t planeSize() const { return static_cast<size_t>(width) * static_cast<size_t>(height); }
+};
+
+/**
+ * @brief 掩码在原图上覆盖的区域
+ */
+struct MaskRegion {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+
+  bool empty() const { return width <= 0 || height <= 0; }
+  size_t pixels() const { return empty() ? 0 : static_cast<size_t>(width) * height; }
+};
+
+namespace mask_detail {
+
+/**
+ * @brief 标量实现：acc[i] += coeff * proto[i]
+ */
+inline void accumulateScalar(const float* proto, float coeff, int count, float* acc) {
+  for (int i = 0; i < count; ++i) {
+    acc[i] += coeff * proto[i];
+  }
+}
+
+#if defined(INFER_FRAME_MASK_X86)
+
+inline bool cpuHasAvx() {
+  static const bool supported = __builtin_cpu_supports("avx");
+  return supported;
+}
+
+/**
+ * @brief AVX 实现：一次 8 个像素，尾部走标量
+ */
+__attribute__((target("avx"))) inline void accumulateAvx(const float* proto, float coeff,
+                                                         int count, float* acc) {
+  const __m256 c = _mm256_set1_ps(coeff);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 v = _mm256_mul_ps(c, _mm256_loadu_ps(proto + i));
+    _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), v));
+  }
+  accumulateScalar(proto + i, coeff, count - i, acc + i);
+}
+
+#endif  // INFER_FRAME_MASK_X86
+
+/**
+ * @brief 原图像素 -> 原型裁剪区内的插值位置（下标 + 权重）
+ */
+struct Tap {
+  int i0 = 0;
+  int i1 = 0;
+  float w = 0.0f;           // i1 的权重
+};
+
+/**
+ * @brief 一行中的前景区间 [begin, end)（区域内列坐标）
+ */
+struct Span {
+  int begin = 0;
+  int end = 0;
+};
+
+}  // namespace mask_detail
+
+/**
+ * @brief 当前 CPU 是否使用向量化实现
+ */
+inline bool maskUsesSimd() {
+#if defined(INFER_FRAME_MASK_X86)
+  return mask_detail::cpuHasAvx();
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief 单个实例掩码的组装器（缓冲在实例间复用，非线程安全）
+ */
+class MaskAssembler {
+ public:
+  explicit MaskAssembler(bool allow_simd = true) : allow_simd_(allow_simd) {}
+
+  /**
+   * @brief 组装一个实例的掩码 logit（只覆盖框对应的原型裁剪区）
+   *
+   * @param coefficients num_protos 个掩码系数
+   * @param protos 原型 [num_protos, height, width]
+   * @param box 模型输入坐标的框（NMS 之后）
+   * @param letterbox 模型输入 <-> 原图映射（dst_width / dst_height 为模型输入尺寸）
+   * @return 原图上的掩码区域（框在原图外时为空）
+   */
+  MaskRegion assemble(const float* coefficients, const float* protos,
+                      const MaskProtoLayout& layout, const DetCandidate& box,
+                      const LetterboxParams& letterbox);
+
+  /**
+   * @brief 行优先 RLE：uint32 计数，从背景开始交替（与 ALGO_MASK_RLE 一致）
+   * @return 前景像素数
+   */
+  size_t encodeRle(std::vector<uint32_t>* runs);
+
+  /**
+   * @brief 行优先位图：每像素 1 bit，高位在前，每行按字节对齐（与 ALGO_MASK_BITMASK 一致）
+   * @return 前景像素数
+   */
+  size_t encodeBitmask(std::vector<uint8_t>* bits);
+
+  const MaskRegion& region() const { return region_; }
+
+  /**
+   * @brief 最近一次 assemble 实际计算的原型像素数（裁剪区面积）
+   */
+  size_t protoPixels() const { return static_cast<size_t>(crop_w_) * crop_h_; }
+
+ private:
+  bool allow_simd_;
+  MaskRegion region_;
+  int crop_w_ = 0;
+  int crop_h_ = 0;
+  std::vector<float> logits_;                 // [crop_h, crop_w]
+  std::vector<mask_detail::Tap> x_taps_;      // 每个原图列
+  std::vector<mask_detail::Tap> y_taps_;      // 每个原图行
+  std::vector<int> column_start_;             // [crop_w + 1]：i0 >= i 的第一个原图列
+  std::vector<float> row_;                    // 竖直方向插值后的一行 logit
+  std::vector<mask_detail::Span> spans_;      // 一行的前景区间
+
+  /**
+   * @brief 逐行阈值化，fn(int y, const Span* spans, size_t count) 处理每一行的前景区间
+   * @return 前景像素数
+   */
+  template <typename Fn>
+  size_t scanRows(Fn&& fn);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline MaskRegion MaskAssembler::assemble(const float* coefficients, const float* protos,
+                                          const MaskProtoLayout& layout,
+                                          const DetCandidate& box,
+                                          const LetterboxParams& letterbox) {
+  region_ = MaskRegion();
+  crop_w_ = crop_h_ = 0;
+  if (!coefficients || !protos || layout.width <= 0 || layout.height <= 0 ||
+      letterbox.scale <= 0.0f || letterbox.dst_width <= 0 || letterbox.dst_height <= 0) {
+    return region_;
+  }
+
+  // 原图上的掩码区域：框映射回原图后取整、裁剪
+  const int sx1 = std::max(0, static_cast<int>(std::floor(letterbox.toSrcX(box.x1))));
+  const int sy1 = std::max(0, static_cast<int>(std::floor(letterbox.toSrcY(box.y1))));
+  const int sx2 =
+      std::min(letterbox.src_width, static_cast<int>(std::ceil(letterbox.toSrcX(box.x2))));
+  const int sy2 =
+      std::min(letterbox.src_height, static_cast<int>(std::ceil(letterbox.toSrcY(box.y2))));
+  if (sx2 <= sx1 || sy2 <= sy1) {
+    return region_;
+  }
+
+  // 原图像素中心 -> 原型坐标：(s + 0.5) * scale + pad 为模型输入坐标，再除以原型 stride
+  const float fx = static_cast<float>(layout.width) / letterbox.dst_width;
+  const float fy = static_cast<float>(layout.height) / letterbox.dst_height;
+  auto protoX = [&](int sx) {
+    return ((sx + 0.5f) * letterbox.scale + letterbox.pad_x) * fx - 0.5f;
+  };
+  auto protoY = [&](int sy) {
+    return ((sy + 0.5f) * letterbox.scaleY() + letterbox.pad_y) * fy - 0.5f;
+  };
+  const int px0 = std::clamp(static_cast<int>(std::floor(protoX(sx1))), 0, layout.width - 1);
+  const int py0 = std::clamp(static_cast<int>(std::floor(protoY(sy1))), 0, layout.height - 1);
+  const int px1 = std::clamp(static_cast<int>(std::floor(protoX(sx2 - 1))) + 1, 0,
+                             layout.width - 1);
+  const int py1 = std::clamp(static_cast<int>(std::floor(protoY(sy2 - 1))) + 1, 0,
+                             layout.height - 1);
+  crop_w_ = px1 - px0 + 1;
+  crop_h_ = py1 - py0 + 1;
+
+  // 系数 x 原型，只算裁剪区：逐原型平面按行累加（连续读）
+  logits_.assign(static_cast<size_t>(crop_w_) * crop_h_, 0.0f);
+  const bool use_simd = allow_simd_ && maskUsesSimd();
+  for (int k = 0; k < layout.num_protos; ++k) {
+    const float coeff = coefficients[k];
+    const float* plane = protos + k * layout.planeSize();
+    for (int y = 0; y < crop_h_; ++y) {
+      const float* src = plane + static_cast<size_t>(py0 + y) * layout.width + px0;
+      float* acc = logits_.data() + static_cast<size_t>(y) * crop_w_;
+#if defined(INFER_FRAME_MASK_X86)
+      if (use_simd) {
+        mask_detail::accumulateAvx(src, coeff, crop_w_, acc);
+        continue;
+      }
+#else
+      (void)use_simd;
+#endif
+      mask_detail::accumulateScalar(src, coeff, crop_w_, acc);
+    }
+  }
+
+  // 原图行 / 列的插值位置（边界外钳到裁剪区边缘）
+  auto makeTaps = [](float p, int origin, int extent) {
+    mask_detail::Tap tap;
+    const float local = std::clamp(p - origin, 0.0f, static_cast<float>(extent - 1));
+    tap.i0 = static_cast<int>(local);
+    tap.i1 = std::min(tap.i0 + 1, extent - 1);
+    tap.w = local - tap.i0;
+    return tap;
+  };
+  region_.x = sx1;
+  region_.y = sy1;
+  region_.width = sx2 - sx1;
+  region_.height = sy2 - sy1;
+  x_taps_.resize(region_.width);
+  y_taps_.resize(region_.height);
+  for (int i = 0; i < region_.width; ++i) {
+    x_taps_[i] = makeTaps(protoX(sx1 + i), px0, crop_w_);
+  }
+  for (int i = 0; i < region_.height; ++i) {
+    y_taps_[i] = makeTaps(protoY(sy1 + i), py0, crop_h_);
+  }
+  // 按原型列分组（i0 随原图列单调不减）
+  column_start_.assign(crop_w_ + 1, region_.width);
+  for (int i = region_.width - 1; i >= 0; --i) {
+    column_start_[x_taps_[i].i0] = i;
+  }
+  for (int i = crop_w_ - 1; i >= 0; --i) {
+    column_start_[i] = std::min(column_start_[i], column_start_[i + 1]);
+  }
+  return region_;
+}
+
+template <typename Fn>
+size_t MaskAssembler::scanRows(Fn&& fn) {
+  row_.resize(crop_w_);
+  size_t foreground = 0;
+  auto positive = [&](int x) {
+    const mask_detail::Tap& tx = x_taps_[x];
+    return row_[tx.i0] + tx.w * (row_[tx.i1] - row_[tx.i0]) > 0.0f;    // sigmoid(v) > 0.5
+  };
+  for (int y = 0; y < region_.height; ++y) {
+    const mask_detail::Tap& ty = y_taps_[y];
+    const float* r0 = logits_.data() + static_cast<size_t>(ty.i0) * crop_w_;
+    const float* r1 = logits_.data() + static_cast<size_t>(ty.i1) * crop_w_;
+    for (int x = 0; x < crop_w_; ++x) {
+      row_[x] = r0[x] + ty.w * (r1[x] - r0[x]);
+    }
+
+    spans_.clear();
+    bool inside = false;
+    auto toggle = [&](int x) {
+      if (inside) {
+        spans_.back().end = x;
+        foreground += static_cast<size_t>(x - spans_.back().begin);
+      } else {
+        spans_.push_back({x, x});
+      }
+      inside = !inside;
+    };
+    for (int i = 0; i < crop_w_; ++i) {
+      int lo = column_start_[i];
+      int hi = column_start_[i + 1] - 1;
+      if (lo > hi) {
+        continue;
+      }
+      // 两个原型列同号时整个区间同号，不需要逐列计算
+      const bool left = row_[i] > 0.0f;
+      if (left == (row_[std::min(i + 1, crop_w_ - 1)] > 0.0f)) {
+        if (left != inside) {
+          toggle(lo);
+        }
+        continue;
+      }
+      const bool first = positive(lo);
+      const bool last = positive(hi);
+      if (first != inside) {
+        toggle(lo);
+      }
+      if (first != last) {
+        // 区间内线性，二分找第一个与末端同号的列
+        while (hi - lo > 1) {
+          const int mid = (lo + hi) / 2;
+          (positive(mid) == last ? hi : lo) = mid;
+        }
+        toggle(hi);
+      }
+    }
+    if (inside) {
+      toggle(region_.width);
+    }
+    fn(y, spans_.data(), spans_.size());
+  }
+  return foreground;
+}
+
+inline size_t MaskAssembler::encodeRle(std::vector<uint32_t>* runs) {
+  runs->clear();
+  if (region_.empty()) {
+    return 0;
+  }
+  // 游程跨行连续：last 为上一个前景区间结束的全局像素下标
+  const size_t width = static_cast<size_t>(region_.width);
+  size_t last = 0;
+  size_t foreground = scanRows([&](int y, const mask_detail::Span* spans, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      const size_t begin = y * width + spans[i].begin;
+      const size_t end = y * width + spans[i].end;
+      if (!runs->empty() && begin == last) {
+        runs->back() += static_cast<uint32_t>(end - begin);    // 接上一行行尾的前景
+      } else {
+        runs->push_back(static_cast<uint32_t>(begin - last));
+        runs->push_back(static_cast<uint32_t>(end - begin));
+      }
+      last = end;
+    }
+  });
+  if (last < region_.pixels()) {
+    runs->push_back(static_cast<uint32_t>(region_.pixels() - last));
+  }
+  return foreground;
+}
+
+inline size_t MaskAssembler::encodeBitmask(std::vector<uint8_t>* bits) {
+  bits->clear();
+  if (region_.empty()) {
+    return 0;
+  }
+  const size_t row_bytes = (static_cast<size_t>(region_.width) + 7) / 8;
+  bits->assign(row_bytes * region_.height, 0);
+  uint8_t* data = bits->data();
+  return scanRows([&](int y, const mask_detail::Span* spans, size_t count) {
+    uint8_t* row = data + row_bytes * y;
+    for (size_t i = 0; i < count; ++i) {
+      int x = spans[i].begin;
+      for (; x < spans[i].end && (x & 7); ++x) {
+        row[x >> 3] |= static_cast<uint8_t>(0x80 >> (x & 7));
+      }
+      const int full_end = spans[i].end & ~7;
+      if (x < full_end) {
+        std::memset(row + (x >> 3), 0xFF, static_cast<size_t>(full_end - x) >> 3);
+        x = full_end;
+      }
+      for (; x < spans[i].end; ++x) {
+        row[x >> 3] |= static_cast<uint8_t>(0x80 >> (x & 7));
+      }
+    }
+  });
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * @file yolov8_postprocess.h
+ * @brief YOLOv8 检测后处理：解码 + 按类别 NMS + 映射回原图（header-only）
+ *
+ * 阈值每次调用传入，插件在线更新的 conf_threshold / nms_threshold 从下一帧起生效。
+ *
+ * @code
+ * algo_utils::NmsEngine nms;
+ * std::vector<std::vector<algo_utils::DetCandidate>> detections;
+ * algo_utils::postprocessYolov8(output, batch, layout, 0.25f, 0.45f, letterboxes.data(), &nms,
+ *                               &detections);
+ * @endcode
+ */
+
+#include "letterbox.h"
+#include "nms.h"
+#include "yolov8_decode.h"
+
+#include <vector>
+
+namespace infer_frame {
+namespace algo_utils {
+
+/**
+ * @brief 后处理 batch 输出 [batch, num_channels, num_anchors]
+ *
+ * @param letterboxes 各帧前处理参数（至少 batch 个），nullptr 时框保留在模型输入坐标
+ * @param nms 调用者持有的 NmsEngine（内部缓冲跨帧复用），IoU 阈值改为 nms_threshold
+ * @param detections 每帧一组检测框，按分数降序
+ */
+inline void postprocessYolov8(const float* output, int batch, const Yolov8OutputLayout& layout,
+                              float conf_threshold, float nms_threshold,
+                              const LetterboxParams* letterboxes, NmsEngine* nms,
+                              std::vector<std::vector<DetCandidate>>* detections) {
+  decodeYolov8Batch(output, batch, layout, conf_threshold, detections);
+
+  NmsOptions nms_options = nms->options();
+  nms_options.iou_threshold = nms_threshold;
+  nms->setOptions(nms_options);
+  for (int n = 0; n < batch; ++n) {
+    std::vector<DetCandidate>& boxes = (*detections)[n];
+    nms->run(&boxes);
+    if (letterboxes) {
+      for (DetCandidate& candidate : boxes) {
+        mapToSource(letterboxes[n], &candidate);
+      }
+    }
+  }
+}
+
+}  // namespace algo_utils
+}  // namespace infer_frame
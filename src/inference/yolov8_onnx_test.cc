@@ -3,6 +3,7 @@
  * @brief 使用真实 YOLOv8 ONNX 模型测试后端推理
  */
 
+#include "algo_utils/letterbox.h"
 #include "inference/backend_factory.h"
 #include "inference/base/types.h"
 #include "utils/one_logger.hpp"
@@ -15,39 +16,17 @@ using namespace infer_frame::base;
 
 /**
  * @brief 预处理图像为 YOLOv8 输入格式
- * @param image 输入图像
+ * @param image 输入图像（BGR）
  * @param input_tensor 输出 Tensor (1, 3, 640, 640)
+ * @return letterbox 参数，用于把检测框映射回原图
  */
-void preprocessImage(const cv::Mat& image, Tensor* input_tensor) {
+algo_utils::LetterboxParams preprocessImage(const cv::Mat& image, Tensor* input_tensor) {
     // YOLOv8 输入：[1, 3, 640, 640], RGB, 归一化到 [0, 1]
+    // 单遍完成等比缩放 + 填充 + BGR->RGB + 归一化 + HWC->CHW
     const int input_h = 640;
     const int input_w = 640;
-    
-    // Resize 和填充
-    cv::Mat resized;
-    cv::resize(image, resized, cv::Size(input_w, input_h));
-    
-    // BGR -> RGB
-    cv::Mat rgb;
-    cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
-    
-    // 归一化并转换为 CHW 格式
-    rgb.convertTo(rgb, CV_32F, 1.0 / 255.0);
-    
-    // 将数据拷贝到 Tensor (使用模板方法 getPtr<float>())
-    float* data_ptr = input_tensor->getPtr<float>();
-    int channels = 3;
-    int img_area = input_h * input_w;
-    
-    // OpenCV Mat 是 HWC 格式，需要转为 CHW
-    for (int c = 0; c < channels; c++) {
-        for (int h = 0; h < input_h; h++) {
-            for (int w = 0; w < input_w; w++) {
-                int dst_idx = c * img_area + h * input_w + w;
-                data_ptr[dst_idx] = rgb.at<cv::Vec3f>(h, w)[c];
-            }
-        }
-    }
+    return algo_utils::letterboxToPlanar(image.data, image.cols, image.rows, image.step,
+                                         input_tensor->getPtr<float>(), input_w, input_h);
 }
 
 /**
@@ -169,8 +148,9 @@ int main() {
     LOG_INFO("Created input tensor: shape=[1,3,640,640]");
     
     // 预处理
-    preprocessImage(test_image, input_tensor);
-    LOG_INFO("✓ Image preprocessed");
+    auto letterbox = preprocessImage(test_image, input_tensor);
+    LOG_INFO("✓ Image preprocessed (scale {:.4f}, pad {}x{})", letterbox.scale,
+             letterbox.pad_x, letterbox.pad_y);
     
     // 创建输出 Tensor 占位符
     std::vector<Tensor*> inputs = {input_tensor};
@@ -12,6 +12,10 @@
 
 #include "utils/one_logger.hpp"
 
+#ifdef INFER_FRAME_HAS_STATIC_PLUGINS
+#include "plugin/plugin_loader.h"
+#endif
+
 // 定义构建类型字符串
 #ifdef CMAKE_BUILD_TYPE
     #define STRINGIFY(x) #x
@@ -69,6 +73,12 @@ public:
         // 初始化推理服务
         service_impl_ = std::make_unique<InferenceServiceImpl>();
         
+#ifdef INFER_FRAME_HAS_STATIC_PLUGINS
+        // 编译进主程序的插件（-DINFER_FRAME_STATIC_PLUGINS）不经过 dlopen
+        auto static_plugins = plugin_loader_.loadStaticPlugins();
+        LOG_INFO("Static plugins loaded: {}", static_plugins.size());
+#endif
+        
         // TODO: 当 proto 编译完成后启用 gRPC 服务器
         // ServerBuilder builder;
         // builder.AddListeningPort(server_address_, 
@@ -91,6 +101,9 @@ public:
         }
         
         // TODO: server_->Shutdown();
+#ifdef INFER_FRAME_HAS_STATIC_PLUGINS
+        plugin_loader_.unloadAll();
+#endif
         LOG_INFO("Server stopped");
     }
     
@@ -112,6 +125,9 @@ private:
     std::string server_address_;
     std::unique_ptr<InferenceServiceImpl> service_impl_;
     std::unique_ptr<Server> server_;
+#ifdef INFER_FRAME_HAS_STATIC_PLUGINS
+    infer_frame::plugin::PluginLoader plugin_loader_;
+#endif
 };
 
 void printUsage(const char* program_name) {
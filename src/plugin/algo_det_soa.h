@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @file algo_det_soa.h
+ * @brief 紧凑检测结果（AlgoDetSoA）的写入、调用者侧缓冲与旧格式适配
+ *
+ * - 插件侧：pushDetBox 直接写入调用者的数组，超出容量只计数
+ * - 主程序侧：DetSoABuffer 在多帧间复用，配合 inferWithRetry（algo_result_buffer.h）扩容
+ * - 适配：detSoAToLegacy / legacyToDetSoA 在 AlgoDetSoA 与 AlgoDetResult 之间转换，
+ *   类别名称只在转换为旧格式时按 ClassNameTable 填入
+ */
+
+#include "algo_plugin_interface.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace infer_frame {
+namespace plugin {
+
+/**
+ * @brief 插件发布的类别名称表（AlgoInfo::class_names）
+ */
+struct ClassNameTable {
+  const char* const* names = nullptr;
+  int count = 0;
+
+  /**
+   * @brief 类别名称，越界或无表时返回空串
+   */
+  const char* name(int class_id) const {
+    if (!names || class_id < 0 || class_id >= count || !names[class_id]) {
+      return "";
+    }
+    return names[class_id];
+  }
+};
+
+/**
+ * @brief 检查调用者提供的 AlgoDetSoA（capacity > 0 时所有数组必须非空）
+ */
+inline bool validDetSoA(const AlgoDetSoA* result) {
+  if (!result || result->capacity < 0) {
+    return false;
+  }
+  return result->capacity == 0 || (result->x1 && result->y1 && result->x2 && result->y2 &&
+                                   result->score && result->class_id);
+}
+
+/**
+ * @brief 追加一个框：容量内写入，超出只累加 num_boxes（调用者据此判断 BUFFER_TOO_SMALL）
+ */
+inline void pushDetBox(AlgoDetSoA* result, float x1, float y1, float x2, float y2, float score,
+                       int class_id) {
+  const int i = result->num_boxes++;
+  if (i >= result->capacity) {
+    return;
+  }
+  result->x1[i] = x1;
+  result->y1[i] = y1;
+  result->x2[i] = x2;
+  result->y2[i] = y2;
+  result->score[i] = score;
+  result->class_id[i] = static_cast<int16_t>(class_id);
+}
+
+/**
+ * @brief 紧凑结果 -> 旧格式（boxes 以 new[] 分配，由 AlgoFreeDetResult 释放）
+ *
+ * 只转换容量内的框。
+ */
+inline AlgoStatus detSoAToLegacy(const AlgoDetSoA& soa, const ClassNameTable& names,
+                                 AlgoDetResult* result) {
+  result->boxes = nullptr;
+  result->num_boxes = 0;
+  result->timestamp = soa.timestamp;
+  const int count = std::min(soa.num_boxes, soa.capacity);
+  if (count <= 0) {
+    return ALGO_STATUS_SUCCESS;
+  }
+  result->boxes = new (std::nothrow) AlgoDetBox[count];
+  if (!result->boxes) {
+    return ALGO_STATUS_ERROR_OUT_OF_MEMORY;
+  }
+  for (int i = 0; i < count; ++i) {
+    AlgoDetBox& box = result->boxes[i];
+    box.x1 = soa.x1[i];
+    box.y1 = soa.y1[i];
+    box.x2 = soa.x2[i];
+    box.y2 = soa.y2[i];
+    box.score = soa.score[i];
+    box.class_id = soa.class_id[i];
+    std::strncpy(box.class_name, names.name(box.class_id), sizeof(box.class_name) - 1);
+    box.class_name[sizeof(box.class_name) - 1] = '\0';
+  }
+  result->num_boxes = count;
+  return ALGO_STATUS_SUCCESS;
+}
+
+/**
+ * @brief 旧格式 -> 紧凑结果（只导出 AlgoInferDetection 的插件）
+ * @return 容量不足时回填 num_boxes 并返回 BUFFER_TOO_SMALL
+ */
+inline AlgoStatus legacyToDetSoA(const AlgoDetResult& legacy, AlgoDetSoA* result) {
+  result->num_boxes = 0;
+  result->timestamp = legacy.timestamp;
+  for (int i = 0; i < legacy.num_boxes; ++i) {
+    const AlgoDetBox& box = legacy.boxes[i];
+    pushDetBox(result, box.x1, box.y1, box.x2, box.y2, box.score, box.class_id);
+  }
+  return result->num_boxes > result->capacity ? ALGO_STATUS_ERROR_BUFFER_TOO_SMALL
+                                              : ALGO_STATUS_SUCCESS;
+}
+
+/**
+ * @brief 紧凑检测结果缓冲（坐标与分数共用一块连续内存）
+ */
+class DetSoABuffer {
+ public:
+  using Result = AlgoDetSoA;
+
+  explicit DetSoABuffer(int capacity = 300) { resize(std::max(capacity, 1)); }
+
+  AlgoDetSoA* view() {
+    const size_t n = class_ids_.size();
+    result_.x1 = floats_.data();
+    result_.y1 = result_.x1 + n;
+    result_.x2 = result_.y1 + n;
+    result_.y2 = result_.x2 + n;
+    result_.score = result_.y2 + n;
+    result_.class_id = class_ids_.data();
+    result_.capacity = static_cast<int>(n);
+    result_.num_boxes = 0;
+    result_.timestamp = 0;
+    return &result_;
+  }
+
+  void grow() {
+    resize(std::max<size_t>(class_ids_.size() * 2, result_.num_boxes));
+  }
+
+  const AlgoDetSoA& result() const { return result_; }
+
+  /**
+   * @brief 容量内的框数
+   */
+  int size() const { return std::min(result_.num_boxes, result_.capacity); }
+
+ private:
+  std::vector<float> floats_;         // x1 | y1 | x2 | y2 | score
+  std::vector<int16_t> class_ids_;
+  AlgoDetSoA result_{};
+
+  void resize(size_t capacity) {
+    floats_.resize(capacity * 5);
+    class_ids_.resize(capacity);
+  }
+};
+
+}  // namespace plugin
+}  // namespace infer_frame
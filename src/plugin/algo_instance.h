@@ -0,0 +1,241 @@
+#pragma once
+
+#include "plugin/plugin_loader_c.h"
+#include "utils/one_logger.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace infer_frame {
+namespace plugin {
+
+/**
+ * @brief 一个已初始化的 C 插件算法实例（工作流中的一个算法节点）
+ *
+ * 负责保存当前初始化参数，并在参数更新时选择代价最低的方式：
+ * - 模型路径 / Backend / 设备不变：调用 AlgoSetParams 在线更新，推理不中断
+ * - 其他情况，或插件不支持在线更新：创建并初始化新实例，成功后替换旧实例
+ *
+ * AlgoSetParams 是合并语义（未出现的字段保持当前值），而 update() 传入的是完整配置：
+ * 新配置删掉了当前配置中的字段时改为重新加载，使该字段回到插件默认值。
+ *
+ * UpdateWorkflow 对每个算法节点调用 update()，只改阈值时不会黑屏。
+ *
+ * 线程安全：infer 与 update 可并发。重新加载时新旧两个实例短暂共存，新实例初始化成功后
+ * 才替换句柄并释放旧实例；初始化失败时旧实例保持不变，摄像头继续使用旧参数推理。
+ */
+class AlgoInstance {
+ public:
+  AlgoInstance(PluginLoaderC& loader, const std::string& plugin_name)
+      : loader_(loader), plugin_name_(plugin_name) {}
+
+  ~AlgoInstance() { release(); }
+
+  // 禁止拷贝和赋值
+  AlgoInstance(const AlgoInstance&) = delete;
+  AlgoInstance& operator=(const AlgoInstance&) = delete;
+
+  /**
+   * @brief 创建并初始化算法实例
+   */
+  AlgoStatus init(const AlgoInitParam* param);
+
+  /**
+   * @brief 应用新的初始化参数（在线更新优先，必要时重新加载）
+   * @param param 新参数
+   * @param reloaded 输出：是否发生了模型重新加载
+   * @return 状态码
+   */
+  AlgoStatus update(const AlgoInitParam* param, bool* reloaded = nullptr);
+
+  /**
+   * @brief 执行推理（目标检测）
+   */
+  AlgoStatus inferDetection(const AlgoTensor* input, AlgoDetResult* result) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!handle_) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    return loader_.inferDetection(handle_, plugin_name_, input, result);
+  }
+
+  void freeDetResult(AlgoDetResult* result) { loader_.freeDetResult(plugin_name_, result); }
+
+  /**
+   * @brief 执行推理（紧凑检测结果，数组由调用者分配，类别名称见 classNames()）
+   */
+  AlgoStatus inferDetectionSoA(const AlgoTensor* input, AlgoDetSoA* result) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!handle_) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    return loader_.inferDetectionSoA(handle_, plugin_name_, input, result);
+  }
+
+  ClassNameTable classNames() const { return loader_.getClassNames(plugin_name_); }
+
+  /**
+   * @brief 反初始化并销毁实例
+   */
+  void release();
+
+  AlgoHandle handle() const { return handle_; }
+  const std::string& pluginName() const { return plugin_name_; }
+
+ private:
+  PluginLoaderC& loader_;
+  std::string plugin_name_;
+  AlgoHandle handle_ = nullptr;
+  std::shared_mutex mutex_;           // 推理共享，重新加载独占
+  std::mutex update_mutex_;           // 串行化 update()
+
+  // 当前生效的参数
+  std::string model_path_;
+  std::string config_json_;
+  AlgoBackendType backend_ = ALGO_BACKEND_UNKNOWN;
+  int device_id_ = 0;
+
+  AlgoStatus initLocked(const AlgoInitParam* param);
+  AlgoStatus createInitialized(const AlgoInitParam* param, AlgoHandle* handle);
+  void saveParam(const AlgoInitParam* param);
+  static bool removesKeys(const std::string& current_json, const std::string& new_json);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline AlgoStatus AlgoInstance::init(const AlgoInitParam* param) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return initLocked(param);
+}
+
+inline AlgoStatus AlgoInstance::update(const AlgoInitParam* param, bool* reloaded) {
+  if (reloaded) {
+    *reloaded = false;
+  }
+  if (!param || !param->model_path) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+
+  // 1. 只有算法参数变化：在线更新，推理线程不受影响
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    bool same_model = handle_ && model_path_ == param->model_path &&
+                      backend_ == param->backend && device_id_ == param->device_id;
+    std::string config_json = param->config_json ? param->config_json : "";
+    if (same_model && config_json == config_json_) {
+      return ALGO_STATUS_SUCCESS;
+    }
+    if (same_model && !removesKeys(config_json_, config_json)) {
+      AlgoStatus status = loader_.setParams(handle_, plugin_name_, config_json.c_str());
+      if (status == ALGO_STATUS_SUCCESS) {
+        lock.unlock();
+        std::unique_lock<std::shared_mutex> write_lock(mutex_);
+        config_json_ = config_json;
+        LOG_INFO("Algo params updated online: {}", plugin_name_);
+        return ALGO_STATUS_SUCCESS;
+      }
+      if (status != ALGO_STATUS_ERROR_NOT_SUPPORTED &&
+          status != ALGO_STATUS_ERROR_RELOAD_REQUIRED) {
+        return status;
+      }
+    }
+  }
+
+  // 2. 模型相关参数变化或插件不支持在线更新：先初始化新实例，成功后再替换旧实例
+  LOG_WARN("Reloading algo {} to apply new params", plugin_name_);
+  AlgoHandle handle = nullptr;
+  AlgoStatus status = createInitialized(param, &handle);
+  if (status != ALGO_STATUS_SUCCESS) {
+    LOG_ERROR("Reload of algo {} failed ({}), keeping current instance", plugin_name_,
+              static_cast<int>(status));
+    return status;
+  }
+  AlgoHandle old_handle = nullptr;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    old_handle = handle_;
+    handle_ = handle;
+    saveParam(param);
+  }
+  if (old_handle) {
+    loader_.deinitAlgo(old_handle, plugin_name_);
+    loader_.destroyAlgoInstance(old_handle, plugin_name_);
+  }
+  if (reloaded) {
+    *reloaded = true;
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+inline void AlgoInstance::release() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (handle_) {
+    loader_.deinitAlgo(handle_, plugin_name_);
+    loader_.destroyAlgoInstance(handle_, plugin_name_);
+    handle_ = nullptr;
+  }
+}
+
+inline AlgoStatus AlgoInstance::initLocked(const AlgoInitParam* param) {
+  if (!param || !param->model_path) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (handle_) {
+    return ALGO_STATUS_ERROR_ALREADY_INITIALIZED;
+  }
+
+  AlgoHandle handle = nullptr;
+  AlgoStatus status = createInitialized(param, &handle);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+
+  handle_ = handle;
+  saveParam(param);
+  return ALGO_STATUS_SUCCESS;
+}
+
+inline AlgoStatus AlgoInstance::createInitialized(const AlgoInitParam* param,
+                                                  AlgoHandle* handle) {
+  *handle = loader_.createAlgoInstance(plugin_name_);
+  if (!*handle) {
+    return ALGO_STATUS_ERROR_OUT_OF_MEMORY;
+  }
+  AlgoStatus status = loader_.initAlgo(*handle, plugin_name_, param);
+  if (status != ALGO_STATUS_SUCCESS) {
+    loader_.destroyAlgoInstance(*handle, plugin_name_);
+    *handle = nullptr;
+  }
+  return status;
+}
+
+inline void AlgoInstance::saveParam(const AlgoInitParam* param) {
+  model_path_ = param->model_path;
+  config_json_ = param->config_json ? param->config_json : "";
+  backend_ = param->backend;
+  device_id_ = param->device_id;
+}
+
+inline bool AlgoInstance::removesKeys(const std::string& current_json,
+                                      const std::string& new_json) {
+  nlohmann::json current = nlohmann::json::parse(current_json, nullptr, false);
+  nlohmann::json next = nlohmann::json::parse(new_json.empty() ? "{}" : new_json, nullptr, false);
+  if (!current.is_object() || !next.is_object()) {
+    return false;     // 非法配置交给插件校验
+  }
+  for (auto it = current.begin(); it != current.end(); ++it) {
+    if (!next.contains(it.key())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
@@ -0,0 +1,731 @@
+#pragma once
+
+/**
+ * @file algo_pipeline.h
+ * @brief 编译期组合的算法流水线：AlgoPipeline<Pre, Infer, Post>
+ *
+ * 前处理 / 模型推理 / 后处理以策略类型（policy）组合，Tensor 形状与类别数都是编译期常量：
+ * - 各阶段之间直接传 float 缓冲，没有虚函数和 base::Tensor 间接层
+ * - 循环边界是常量，编译器可以展开、向量化，并针对具体模型（如 640x640 80 类 YOLOv8）特化
+ * - 相邻阶段的形状在编译期检查（static_assert）
+ *
+ * 阶段约定：
+ * @code
+ * struct Pre {
+ *   using OutputShape = FixedShape<1, 3, 640, 640>;
+ *   static const AlgoInputCaps* inputCaps();
+ *   AlgoStatus run(const AlgoTensor& input, float* output, FrameContext* ctx);
+ * };
+ * struct Infer {
+ *   using InputShape = FixedShape<1, 3, 640, 640>;
+ *   using OutputShape = FixedShape<1, 84, 8400>;
+ *   AlgoStatus run(const float* input, float* output);
+ * };
+ * struct Post {
+ *   using InputShape = FixedShape<1, 84, 8400>;
+ *   static constexpr int kMaxDetections = 300;
+ *   // 用 pushDetBox 写入调用者的数组（超出容量只计数），最多 kMaxDetections 个框
+ *   void run(const float* output, const FrameContext& ctx, AlgoDetSoA* out);
+ * };
+ * @endcode
+ * 可选成员（存在时自动调用）：
+ * - AlgoStatus init(const AlgoInitParam*) / void deinit()：某阶段 init 失败时，
+ *   之前已初始化的阶段按相反顺序 deinit
+ * - AlgoStatus configure(const nlohmann::json& params, bool initial)：解析 config_json，
+ *   initial 为 false 时是在线更新（AlgoSetParams），需要重新加载模型的参数应返回
+ *   ALGO_STATUS_ERROR_RELOAD_REQUIRED
+ * - AlgoStatus validate(const nlohmann::json& params)：在线更新前只校验不修改；
+ *   提供 configure 的阶段要么可拷贝（在副本上 configure 校验），要么提供 validate
+ * - Infer / Post 的 AuxShape：模型的第二个输出（如 seg 模型的掩码原型），
+ *   此时 Infer::run(input, output, aux)，两者的 AuxShape 必须一致
+ * - Post::runSegmentation(output, aux, ctx, AlgoSegResult*) / Post::runPose(output, ctx,
+ *   AlgoPoseResult*)：类型化结果（缓冲由调用者分配），对应 inferSegmentation / inferPose
+ *
+ * 检测结果以紧凑格式（AlgoDetSoA）直接写入调用者缓冲；旧格式 AlgoDetResult 经 detSoAToLegacy
+ * 转换，类别名称取自流水线的 AlgoInfo::class_names。
+ *
+ * 组合出的流水线通过 ALGO_PIPELINE_EXPORT_C 导出为 C 插件（分割 / 姿态另加
+ * ALGO_PIPELINE_EXPORT_SEG_C / ALGO_PIPELINE_EXPORT_POSE_C），
+ * 或通过 AlgoPipelinePlugin（algo_pipeline_plugin.h）包装为 C++ 插件。
+ */
+
+#include "algo_det_soa.h"
+#include "algo_plugin_interface.h"
+#include "plugin_abi.h"
+#include "../algo_utils/stage_timer.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace infer_frame {
+namespace plugin {
+
+/**
+ * @brief 编译期固定形状
+ */
+template <int64_t... Dims>
+struct FixedShape {
+  static constexpr int kNdim = sizeof...(Dims);
+  static constexpr int64_t kNumel = (Dims * ...);
+  static constexpr int64_t kDims[kNdim] = {Dims...};
+
+  static_assert(kNdim > 0 && kNdim <= 8, "AlgoTensor supports 1..8 dims");
+
+  /**
+   * @brief 填写 float Tensor 描述
+   */
+  static void describe(AlgoTensor* tensor, const char* name, void* data) {
+    *tensor = AlgoTensor{};
+    std::strncpy(tensor->name, name, sizeof(tensor->name) - 1);
+    tensor->data_type = ALGO_DATA_TYPE_FLOAT32;
+    tensor->ndim = kNdim;
+    for (int i = 0; i < kNdim; ++i) {
+      tensor->shape[i] = kDims[i];
+    }
+    tensor->size = static_cast<size_t>(kNumel) * sizeof(float);
+    tensor->data = data;
+  }
+
+  static bool matches(const AlgoTensor& tensor) {
+    if (tensor.ndim != kNdim) {
+      return false;
+    }
+    for (int i = 0; i < kNdim; ++i) {
+      if (tensor.shape[i] != kDims[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <typename A, typename B>
+struct SameShape : std::false_type {};
+
+template <int64_t... Dims>
+struct SameShape<FixedShape<Dims...>, FixedShape<Dims...>> : std::true_type {};
+
+/**
+ * @brief 单帧上下文：前处理产生，后处理用于把坐标映射回原图
+ */
+struct FrameContext {
+  int src_width = 0;
+  int src_height = 0;
+  float scale = 1.0f;    // 原图 -> 模型输入的缩放比例
+  float pad_x = 0.0f;    // 模型输入中左侧填充
+  float pad_y = 0.0f;    // 模型输入中上方填充
+};
+
+namespace pipeline_detail {
+
+template <typename T, typename = void>
+struct HasInit : std::false_type {};
+template <typename T>
+struct HasInit<T, std::void_t<decltype(std::declval<T&>().init(
+                      std::declval<const AlgoInitParam*>()))>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasDeinit : std::false_type {};
+template <typename T>
+struct HasDeinit<T, std::void_t<decltype(std::declval<T&>().deinit())>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasConfigure : std::false_type {};
+template <typename T>
+struct HasConfigure<T, std::void_t<decltype(std::declval<T&>().configure(
+                           std::declval<const nlohmann::json&>(), true))>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasValidate : std::false_type {};
+template <typename T>
+struct HasValidate<T, std::void_t<decltype(std::declval<T&>().validate(
+                          std::declval<const nlohmann::json&>()))>> : std::true_type {};
+
+template <typename T>
+struct DependentFalse : std::false_type {};
+
+template <typename T, typename = void>
+struct AuxShapeOf {
+  using type = void;
+};
+template <typename T>
+struct AuxShapeOf<T, std::void_t<typename T::AuxShape>> {
+  using type = typename T::AuxShape;
+};
+
+template <typename T, typename = void>
+struct HasSegmentation : std::false_type {};
+template <typename T>
+struct HasSegmentation<T, std::void_t<decltype(&T::runSegmentation)>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasPose : std::false_type {};
+template <typename T>
+struct HasPose<T, std::void_t<decltype(&T::runPose)>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasTrack : std::false_type {};
+template <typename T>
+struct HasTrack<T, std::void_t<decltype(std::declval<T&>().inferTrack(
+                       std::declval<const AlgoTensor*>(), std::declval<AlgoTrackResult*>()))>>
+    : std::true_type {};
+
+template <typename Stage>
+AlgoStatus initStage(Stage& stage, const AlgoInitParam* param) {
+  if constexpr (HasInit<Stage>::value) {
+    return stage.init(param);
+  } else {
+    (void)stage;
+    (void)param;
+    return ALGO_STATUS_SUCCESS;
+  }
+}
+
+template <typename Stage>
+void deinitStage(Stage& stage) {
+  if constexpr (HasDeinit<Stage>::value) {
+    stage.deinit();
+  } else {
+    (void)stage;
+  }
+}
+
+template <typename Stage>
+AlgoStatus configureStage(Stage& stage, const nlohmann::json& params, bool initial) {
+  if constexpr (HasConfigure<Stage>::value) {
+    return stage.configure(params, initial);
+  } else {
+    (void)stage;
+    (void)params;
+    (void)initial;
+    return ALGO_STATUS_SUCCESS;
+  }
+}
+
+/**
+ * @brief 在线更新前校验参数，不修改 stage
+ */
+template <typename Stage>
+AlgoStatus validateStage(const Stage& stage, const nlohmann::json& params) {
+  if constexpr (!HasConfigure<Stage>::value) {
+    (void)stage;
+    (void)params;
+    return ALGO_STATUS_SUCCESS;
+  } else if constexpr (HasValidate<Stage>::value) {
+    return const_cast<Stage&>(stage).validate(params);
+  } else if constexpr (std::is_copy_constructible<Stage>::value) {
+    Stage copy = stage;
+    return copy.configure(params, false);
+  } else {
+    static_assert(DependentFalse<Stage>::value,
+                  "stages with configure() must be copyable or provide validate()");
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+}
+
+}  // namespace pipeline_detail
+
+/**
+ * @brief 前处理 -> 推理 -> 后处理 的编译期组合
+ *
+ * 一个实例对应一个算法句柄；推理与参数更新可并发（参数在帧之间切换）。
+ */
+template <typename Pre, typename Infer, typename Post>
+class AlgoPipeline {
+ public:
+  using InputShape = typename Pre::OutputShape;
+  using OutputShape = typename Infer::OutputShape;
+  using AuxShape = typename pipeline_detail::AuxShapeOf<Infer>::type;   // 无第二输出时为 void
+  static constexpr bool kHasAux = !std::is_void<AuxShape>::value;
+
+  static_assert(SameShape<typename Pre::OutputShape, typename Infer::InputShape>::value,
+                "Pre::OutputShape must match Infer::InputShape");
+  static_assert(SameShape<typename Infer::OutputShape, typename Post::InputShape>::value,
+                "Infer::OutputShape must match Post::InputShape");
+  static_assert(std::is_same<AuxShape, typename pipeline_detail::AuxShapeOf<Post>::type>::value,
+                "Infer::AuxShape must match Post::AuxShape");
+  static_assert(Post::kMaxDetections > 0, "Post::kMaxDetections must be positive");
+  static constexpr int kMaxDetections = Post::kMaxDetections;
+
+  enum Stage { kStagePreprocess = 0, kStageInference, kStagePostprocess };
+
+  AlgoPipeline() = default;
+  AlgoPipeline(const AlgoPipeline&) = delete;
+  AlgoPipeline& operator=(const AlgoPipeline&) = delete;
+
+  AlgoStatus init(const AlgoInitParam* param);
+  AlgoStatus setParams(const char* config_json);
+  AlgoStatus deinit();
+
+  /**
+   * @brief 检测，紧凑结果（数组由调用者分配，容量不足时回填 num_boxes 并返回 BUFFER_TOO_SMALL）
+   */
+  AlgoStatus inferDetectionSoA(const AlgoTensor* input, AlgoDetSoA* result);
+
+  /**
+   * @brief 检测，旧格式结果（经内部紧凑缓冲转换，info 提供类别名称，可为 nullptr）
+   */
+  AlgoStatus inferDetection(const AlgoTensor* input, AlgoDetResult* result,
+                            const AlgoInfo* info = nullptr);
+
+  /**
+   * @brief 分割 / 姿态（Post 提供 runSegmentation / runPose 时可用，否则 NOT_SUPPORTED）
+   *
+   * 结果缓冲由调用者分配，容量不足时回填所需数量并返回 BUFFER_TOO_SMALL。
+   */
+  AlgoStatus inferSegmentation(const AlgoTensor* input, AlgoSegResult* result);
+  AlgoStatus inferPose(const AlgoTensor* input, AlgoPoseResult* result);
+
+  /**
+   * @brief 只运行前处理与推理，原始输出写入调用者缓冲（有 AuxShape 时 outputs[1] 为第二输出，
+   * 调用者只给一个输出时第二输出写入内部缓冲）
+   */
+  AlgoStatus inferTensors(const AlgoTensor* inputs, int num_inputs, AlgoTensor* outputs,
+                          int num_outputs);
+
+  AlgoStatus getOutputInfo(AlgoTensor* outputs, int* num_outputs) const;
+
+  const AlgoInputCaps* getInputCaps() const {
+    return initialized_.load(std::memory_order_acquire) ? Pre::inputCaps() : nullptr;
+  }
+
+  void getStats(AlgoStats* stats) const { recorder_.fill(stats); }
+  algo_utils::PerfStats snapshotStats() const { return recorder_.snapshot(); }
+
+  bool isInitialized() const { return initialized_.load(std::memory_order_acquire); }
+
+  static void freeDetResult(AlgoDetResult* result) {
+    if (result && result->boxes) {
+      delete[] result->boxes;
+      result->boxes = nullptr;
+      result->num_boxes = 0;
+    }
+  }
+
+ private:
+  Pre pre_;
+  Infer infer_;
+  Post post_;
+
+  std::atomic<bool> initialized_{false};     // 写入在 mutex_ 内；无锁的查询接口只读它
+  std::unique_ptr<float[]> input_buffer_;     // Pre -> Infer
+  std::unique_ptr<float[]> output_buffer_;    // Infer -> Post
+  std::unique_ptr<float[]> aux_buffer_;       // Infer -> Post 第二输出（kHasAux）
+  DetSoABuffer boxes_{kMaxDetections};        // 旧格式路径的 Post 输出
+  std::mutex mutex_;                          // 推理与参数更新互斥，更新在帧之间生效
+
+  algo_utils::StageRecorder recorder_{"preprocess", "inference", "postprocess"};
+
+  AlgoStatus configure(const char* config_json, bool initial);
+  void releaseStages();
+  AlgoStatus runPreInfer(const AlgoTensor& input, float* output, float* aux, FrameContext* ctx);
+
+  /**
+   * @brief 前处理 + 推理 + post(ctx)（类型化结果的公共路径）
+   */
+  template <typename PostFn>
+  AlgoStatus runTyped(const AlgoTensor* input, PostFn&& post);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::init(const AlgoInitParam* param) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (initialized_) {
+    return ALGO_STATUS_ERROR_ALREADY_INITIALIZED;
+  }
+  if (!param || !param->model_path) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  AlgoStatus status = configure(param->config_json, true);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  if ((status = pipeline_detail::initStage(pre_, param)) != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  if ((status = pipeline_detail::initStage(infer_, param)) != ALGO_STATUS_SUCCESS) {
+    pipeline_detail::deinitStage(pre_);
+    return status;
+  }
+  if ((status = pipeline_detail::initStage(post_, param)) != ALGO_STATUS_SUCCESS) {
+    pipeline_detail::deinitStage(infer_);
+    pipeline_detail::deinitStage(pre_);
+    return status;
+  }
+
+  input_buffer_.reset(new (std::nothrow) float[InputShape::kNumel]);
+  output_buffer_.reset(new (std::nothrow) float[OutputShape::kNumel]);
+  bool allocated = input_buffer_ && output_buffer_;
+  if constexpr (kHasAux) {
+    aux_buffer_.reset(new (std::nothrow) float[AuxShape::kNumel]);
+    allocated = allocated && aux_buffer_;
+  }
+  if (!allocated) {
+    releaseStages();
+    return ALGO_STATUS_ERROR_OUT_OF_MEMORY;
+  }
+
+  recorder_.reset();
+  initialized_.store(true, std::memory_order_release);
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::setParams(const char* config_json) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!initialized_) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  return configure(config_json, false);
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::configure(const char* config_json, bool initial) {
+  if (!config_json || config_json[0] == '\0') {
+    return ALGO_STATUS_SUCCESS;
+  }
+  nlohmann::json params = nlohmann::json::parse(config_json, nullptr, false);
+  if (params.is_discarded() || !params.is_object()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  // 在线更新时先让每个阶段校验（副本上 configure 或 validate），全部接受后再提交，避免部分生效
+  AlgoStatus status;
+  if (!initial &&
+      ((status = pipeline_detail::validateStage(pre_, params)) != ALGO_STATUS_SUCCESS ||
+       (status = pipeline_detail::validateStage(infer_, params)) != ALGO_STATUS_SUCCESS ||
+       (status = pipeline_detail::validateStage(post_, params)) != ALGO_STATUS_SUCCESS)) {
+    return status;
+  }
+
+  if ((status = pipeline_detail::configureStage(pre_, params, initial)) != ALGO_STATUS_SUCCESS ||
+      (status = pipeline_detail::configureStage(infer_, params, initial)) != ALGO_STATUS_SUCCESS ||
+      (status = pipeline_detail::configureStage(post_, params, initial)) != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::deinit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!initialized_) {
+    return ALGO_STATUS_SUCCESS;
+  }
+  initialized_.store(false, std::memory_order_release);
+  releaseStages();
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Pre, typename Infer, typename Post>
+void AlgoPipeline<Pre, Infer, Post>::releaseStages() {
+  pipeline_detail::deinitStage(post_);
+  pipeline_detail::deinitStage(infer_);
+  pipeline_detail::deinitStage(pre_);
+  input_buffer_.reset();
+  output_buffer_.reset();
+  aux_buffer_.reset();
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::runPreInfer(const AlgoTensor& input, float* output,
+                                                        float* aux, FrameContext* ctx) {
+  {
+    algo_utils::ScopedStageTimer timer(recorder_, kStagePreprocess);
+    AlgoStatus status = pre_.run(input, input_buffer_.get(), ctx);
+    if (status != ALGO_STATUS_SUCCESS) {
+      return status;
+    }
+  }
+  algo_utils::ScopedStageTimer timer(recorder_, kStageInference);
+  if constexpr (kHasAux) {
+    return infer_.run(input_buffer_.get(), output, aux);
+  } else {
+    (void)aux;
+    return infer_.run(input_buffer_.get(), output);
+  }
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::inferDetectionSoA(const AlgoTensor* input,
+                                                              AlgoDetSoA* result) {
+  if (!input || !input->data || !validDetSoA(result)) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  result->num_boxes = 0;
+  result->timestamp = 0;
+  return runTyped(input, [&](const FrameContext& ctx) {
+    post_.run(output_buffer_.get(), ctx, result);
+    return result->num_boxes > result->capacity ? ALGO_STATUS_ERROR_BUFFER_TOO_SMALL
+                                                : ALGO_STATUS_SUCCESS;
+  });
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::inferDetection(const AlgoTensor* input,
+                                                           AlgoDetResult* result,
+                                                           const AlgoInfo* info) {
+  if (!input || !input->data || !result) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  result->boxes = nullptr;
+  result->num_boxes = 0;
+  result->timestamp = 0;
+
+  // 内部缓冲在锁内使用；Post 保证不超过 kMaxDetections 个框
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!initialized_) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  FrameContext ctx;
+  AlgoStatus status = runPreInfer(*input, output_buffer_.get(), aux_buffer_.get(), &ctx);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  AlgoDetSoA* boxes = boxes_.view();
+  {
+    algo_utils::ScopedStageTimer timer(recorder_, kStagePostprocess);
+    post_.run(output_buffer_.get(), ctx, boxes);
+  }
+  // C 接口约定结果由插件分配、AlgoFreeDetResult 释放
+  ClassNameTable names;
+  if (info) {
+    names = {info->class_names, info->num_classes};
+  }
+  if ((status = detSoAToLegacy(*boxes, names, result)) != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  recorder_.addFrame();
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Pre, typename Infer, typename Post>
+template <typename PostFn>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::runTyped(const AlgoTensor* input, PostFn&& post) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!initialized_) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  FrameContext ctx;
+  AlgoStatus status = runPreInfer(*input, output_buffer_.get(), aux_buffer_.get(), &ctx);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  {
+    algo_utils::ScopedStageTimer timer(recorder_, kStagePostprocess);
+    status = post(ctx);
+  }
+  if (status == ALGO_STATUS_SUCCESS) {
+    recorder_.addFrame();
+  }
+  return status;
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::inferSegmentation(const AlgoTensor* input,
+                                                              AlgoSegResult* result) {
+  if constexpr (pipeline_detail::HasSegmentation<Post>::value) {
+    if (!input || !input->data || !result) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    result->num_instances = 0;
+    result->mask_used = 0;
+    return runTyped(input, [&](const FrameContext& ctx) {
+      return post_.runSegmentation(output_buffer_.get(), aux_buffer_.get(), ctx, result);
+    });
+  } else {
+    (void)input;
+    (void)result;
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::inferPose(const AlgoTensor* input,
+                                                      AlgoPoseResult* result) {
+  if constexpr (pipeline_detail::HasPose<Post>::value) {
+    if (!input || !input->data || !result) {
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    result->num_instances = 0;
+    result->num_keypoints = 0;
+    return runTyped(input, [&](const FrameContext& ctx) {
+      return post_.runPose(output_buffer_.get(), ctx, result);
+    });
+  } else {
+    (void)input;
+    (void)result;
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::inferTensors(const AlgoTensor* inputs, int num_inputs,
+                                                         AlgoTensor* outputs, int num_outputs) {
+  if (!inputs || num_inputs != 1 || !inputs[0].data || !outputs || num_outputs < 1) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!initialized_) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+
+  // 输出缓冲由调用者分配，容量不足时回填所需字节数
+  size_t capacity = outputs[0].size;
+  void* data = outputs[0].data;
+  OutputShape::describe(&outputs[0], "output0", data);
+  if (!data || capacity < outputs[0].size) {
+    return ALGO_STATUS_ERROR_BUFFER_TOO_SMALL;
+  }
+  float* aux = aux_buffer_.get();
+  if constexpr (kHasAux) {
+    if (num_outputs >= 2) {
+      size_t aux_capacity = outputs[1].size;
+      void* aux_data = outputs[1].data;
+      AuxShape::describe(&outputs[1], "output1", aux_data);
+      if (!aux_data || aux_capacity < outputs[1].size) {
+        return ALGO_STATUS_ERROR_BUFFER_TOO_SMALL;
+      }
+      aux = static_cast<float*>(aux_data);
+    }
+  }
+
+  FrameContext ctx;
+  AlgoStatus status = runPreInfer(inputs[0], static_cast<float*>(data), aux, &ctx);
+  if (status == ALGO_STATUS_SUCCESS) {
+    recorder_.addFrame();
+  }
+  return status;
+}
+
+template <typename Pre, typename Infer, typename Post>
+AlgoStatus AlgoPipeline<Pre, Infer, Post>::getOutputInfo(AlgoTensor* outputs,
+                                                          int* num_outputs) const {
+  // 输出形状是编译期常量，不访问受 mutex_ 保护的状态，只需确认已初始化
+  if (!initialized_.load(std::memory_order_acquire)) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  if (!outputs || !num_outputs) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  constexpr int kNumOutputs = kHasAux ? 2 : 1;
+  if (*num_outputs < kNumOutputs) {
+    *num_outputs = kNumOutputs;
+    return ALGO_STATUS_ERROR_BUFFER_TOO_SMALL;
+  }
+  OutputShape::describe(&outputs[0], "output0", nullptr);
+  if constexpr (kHasAux) {
+    AuxShape::describe(&outputs[1], "output1", nullptr);
+  }
+  *num_outputs = kNumOutputs;
+  return ALGO_STATUS_SUCCESS;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
+
+/**
+ * @brief 把流水线导出为 C 插件（在插件 .cpp 中使用一次）
+ *
+ * @param pipeline_class 流水线类型，需提供 static const AlgoInfo* info()
+ *        （info()->class_names 用于旧格式 AlgoInferDetection 的类别名称）
+ *
+ * @code
+ * struct MyPipeline : infer_frame::plugin::AlgoPipeline<MyPre, MyInfer, MyPost> {
+ *   static const AlgoInfo* info();
+ * };
+ * ALGO_PIPELINE_EXPORT_C(MyPipeline)
+ * @endcode
+ */
+#define ALGO_PIPELINE_EXPORT_C(pipeline_class) \
+  extern "C" { \
+  const AlgoInfo* AlgoGetInfo() { return pipeline_class::info(); } \
+  int AlgoNegotiateAbiVersion(int host_abi_version) { \
+    return infer_frame::plugin::negotiateAbiVersion(host_abi_version); \
+  } \
+  AlgoHandle AlgoCreate() { \
+    return reinterpret_cast<AlgoHandle>(new (std::nothrow) pipeline_class()); \
+  } \
+  AlgoStatus AlgoInit(AlgoHandle handle, const AlgoInitParam* param) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->init(param); \
+  } \
+  AlgoStatus AlgoInferDetection(AlgoHandle handle, const AlgoTensor* input, \
+                                AlgoDetResult* result) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    AlgoTensor legacy; \
+    return reinterpret_cast<pipeline_class*>(handle)->inferDetection( \
+        infer_frame::plugin::hostTensor(input, &legacy), result, pipeline_class::info()); \
+  } \
+  AlgoStatus AlgoInferDetectionSoA(AlgoHandle handle, const AlgoTensor* input, \
+                                   AlgoDetSoA* result) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->inferDetectionSoA(input, result); \
+  } \
+  AlgoStatus AlgoInferTensors(AlgoHandle handle, const AlgoTensor* inputs, int num_inputs, \
+                              AlgoTensor* outputs, int num_outputs) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->inferTensors(inputs, num_inputs, outputs, \
+                                                                   num_outputs); \
+  } \
+  AlgoStatus AlgoGetOutputInfo(AlgoHandle handle, AlgoTensor* outputs, int* num_outputs) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->getOutputInfo(outputs, num_outputs); \
+  } \
+  const AlgoInputCaps* AlgoGetInputCaps(AlgoHandle handle) { \
+    if (!handle) return nullptr; \
+    return reinterpret_cast<pipeline_class*>(handle)->getInputCaps(); \
+  } \
+  AlgoStatus AlgoSetParams(AlgoHandle handle, const char* config_json) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->setParams(config_json); \
+  } \
+  AlgoStatus AlgoGetStats(AlgoHandle handle, AlgoStats* stats) { \
+    if (!handle || !stats) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    reinterpret_cast<pipeline_class*>(handle)->getStats(stats); \
+    return ALGO_STATUS_SUCCESS; \
+  } \
+  AlgoStatus AlgoDeinit(AlgoHandle handle) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->deinit(); \
+  } \
+  void AlgoDestroy(AlgoHandle handle) { delete reinterpret_cast<pipeline_class*>(handle); } \
+  void AlgoFreeDetResult(AlgoDetResult* result) { pipeline_class::freeDetResult(result); } \
+  }
+
+/**
+ * @brief 导出 AlgoInferSegmentation（与 ALGO_PIPELINE_EXPORT_C 一起使用）
+ */
+#define ALGO_PIPELINE_EXPORT_SEG_C(pipeline_class) \
+  extern "C" { \
+  AlgoStatus AlgoInferSegmentation(AlgoHandle handle, const AlgoTensor* input, \
+                                   AlgoSegResult* result) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->inferSegmentation(input, result); \
+  } \
+  }
+
+/**
+ * @brief 导出 AlgoInferPose（与 ALGO_PIPELINE_EXPORT_C 一起使用）
+ */
+#define ALGO_PIPELINE_EXPORT_POSE_C(pipeline_class) \
+  extern "C" { \
+  AlgoStatus AlgoInferPose(AlgoHandle handle, const AlgoTensor* input, \
+                           AlgoPoseResult* result) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->inferPose(input, result); \
+  } \
+  }
@@ -0,0 +1,302 @@
+#pragma once
+
+/**
+ * @file algo_pipeline_plugin.h
+ * @brief 把 AlgoPipeline 包装为 C++ 插件（AlgoPluginBase）
+ *
+ * @code
+ * using YOLOv8PipelinePlugin = AlgoPipelinePlugin<yolov8::Yolov8CocoPipeline>;
+ * REGISTER_ALGO_PLUGIN(YOLOv8PipelinePlugin)
+ * @endcode
+ *
+ * infer() 输出模型原始 Tensor（前处理 + 推理，与直接输出检测框 Tensor 的 YOLOv8Plugin 不同）；
+ * 检测框可在静态链接时直接调用 inferDetectionSoA() / inferDetection()（类型为 final，
+ * 调用不经过虚函数），跟踪流水线（tracking_pipeline.h）实现基类的 inferTrack()，
+ * 分割 / 姿态流水线另有 inferSegmentation() / inferPose()。
+ */
+
+#include "plugin/algo_pipeline.h"
+#include "plugin/algo_plugin_base.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace infer_frame {
+namespace plugin {
+
+template <typename Pipeline>
+class AlgoPipelinePlugin final : public AlgoPluginBase {
+ public:
+  AlgoPipelinePlugin() = default;
+  ~AlgoPipelinePlugin() override { pipeline_.deinit(); }
+
+  AlgoInfo getInfo() const override;
+
+  base::Status init(const std::string& model_path, const backend::BackendConfig& backend_config,
+                    const std::map<std::string, std::string>& algo_params) override;
+
+  base::Status updateParams(const std::map<std::string, std::string>& algo_params) override;
+
+  base::Status infer(std::vector<base::Tensor*>& inputs,
+                     std::vector<base::Tensor*>& outputs) override;
+
+  base::Status inferBatch(const std::vector<std::vector<base::Tensor*>>& batch_inputs,
+                          std::vector<std::vector<base::Tensor*>>& batch_outputs) override;
+
+  base::Status deinit() override;
+
+  bool isInitialized() const override { return pipeline_.isInitialized(); }
+
+  algo_utils::PerfStats getStats() const override { return pipeline_.snapshotStats(); }
+
+  /**
+   * @brief 完整检测（前处理 + 推理 + 后处理），紧凑结果缓冲由调用者分配，
+   * 类别名称见 Pipeline::info()->class_names
+   */
+  AlgoStatus inferDetectionSoA(const AlgoTensor* input, AlgoDetSoA* result) {
+    return pipeline_.inferDetectionSoA(input, result);
+  }
+
+  /**
+   * @brief 完整检测，旧格式结果（含类别名称），用 Pipeline::freeDetResult 释放
+   */
+  AlgoStatus inferDetection(const AlgoTensor* input, AlgoDetResult* result) {
+    return pipeline_.inferDetection(input, result, Pipeline::info());
+  }
+
+  /**
+   * @brief 跟踪（Pipeline 为 TrackingPipeline 时可用，否则 NOT_SUPPORTED），结果缓冲由调用者分配
+   */
+  AlgoStatus inferTrack(const AlgoTensor* input, AlgoTrackResult* result) override {
+    if constexpr (pipeline_detail::HasTrack<Pipeline>::value) {
+      return pipeline_.inferTrack(input, result);
+    } else {
+      (void)input;
+      (void)result;
+      return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+    }
+  }
+
+  /**
+   * @brief 分割 / 姿态（Pipeline 的后处理提供对应结果时可用），结果缓冲由调用者分配
+   */
+  AlgoStatus inferSegmentation(const AlgoTensor* input, AlgoSegResult* result) {
+    return pipeline_.inferSegmentation(input, result);
+  }
+  AlgoStatus inferPose(const AlgoTensor* input, AlgoPoseResult* result) {
+    return pipeline_.inferPose(input, result);
+  }
+
+  Pipeline& pipeline() { return pipeline_; }
+
+ private:
+  Pipeline pipeline_;
+
+  static base::Status toStatus(AlgoStatus status, const char* what);
+  static AlgoBackendType toAlgoBackend(backend::BackendType type);
+  static std::string toConfigJson(const std::map<std::string, std::string>& algo_params);
+  static bool describeInput(base::Tensor* tensor, AlgoTensor* view);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+template <typename Pipeline>
+AlgoInfo AlgoPipelinePlugin<Pipeline>::getInfo() const {
+  const ::AlgoInfo* c_info = Pipeline::info();
+  AlgoInfo info;
+  info.name = c_info->name;
+  info.version = c_info->version;
+  info.description = c_info->description;
+  info.author = c_info->author;
+  switch (c_info->type) {
+    case ALGO_TYPE_DETECTION: info.type = AlgoType::kDetection; break;
+    case ALGO_TYPE_CLASSIFICATION: info.type = AlgoType::kClassification; break;
+    case ALGO_TYPE_SEGMENTATION: info.type = AlgoType::kSegmentation; break;
+    case ALGO_TYPE_OCR: info.type = AlgoType::kOCR; break;
+    case ALGO_TYPE_POSE: info.type = AlgoType::kPose; break;
+    case ALGO_TYPE_TRACK: info.type = AlgoType::kTracking; break;
+    default: info.type = AlgoType::kCustom; break;
+  }
+  for (int i = 0; i < c_info->num_backends; ++i) {
+    switch (c_info->supported_backends[i]) {
+      case ALGO_BACKEND_TENSORRT:
+        info.supported_backends.push_back(backend::BackendType::kTensorRT);
+        break;
+      case ALGO_BACKEND_ONNXRUNTIME:
+        info.supported_backends.push_back(backend::BackendType::kONNXRuntime);
+        break;
+      case ALGO_BACKEND_OPENVINO:
+        info.supported_backends.push_back(backend::BackendType::kOpenVINO);
+        break;
+      case ALGO_BACKEND_RKNN:
+        info.supported_backends.push_back(backend::BackendType::kRKNN);
+        break;
+      default:
+        break;
+    }
+  }
+  return info;
+}
+
+template <typename Pipeline>
+base::Status AlgoPipelinePlugin<Pipeline>::init(
+    const std::string& model_path, const backend::BackendConfig& backend_config,
+    const std::map<std::string, std::string>& algo_params) {
+  std::string config_json = toConfigJson(algo_params);
+  AlgoInitParam param;
+  param.model_path = model_path.c_str();
+  param.backend = toAlgoBackend(backend_config.backend_type);
+  param.device_id = backend_config.device_id;
+  param.config_json = config_json.c_str();
+  return toStatus(pipeline_.init(&param), "init");
+}
+
+template <typename Pipeline>
+base::Status AlgoPipelinePlugin<Pipeline>::updateParams(
+    const std::map<std::string, std::string>& algo_params) {
+  std::string config_json = toConfigJson(algo_params);
+  AlgoStatus status = pipeline_.setParams(config_json.c_str());
+  if (status == ALGO_STATUS_ERROR_RELOAD_REQUIRED) {
+    return base::Status::NotImplemented("Params require model reload");
+  }
+  return toStatus(status, "updateParams");
+}
+
+template <typename Pipeline>
+base::Status AlgoPipelinePlugin<Pipeline>::infer(std::vector<base::Tensor*>& inputs,
+                                                 std::vector<base::Tensor*>& outputs) {
+  if (inputs.empty() || outputs.empty() || !outputs[0]) {
+    return base::Status::InvalidParam("AlgoPipelinePlugin needs one input and one output tensor");
+  }
+  AlgoTensor input;
+  if (!describeInput(inputs[0], &input)) {
+    return base::Status::InvalidParam("Unsupported input tensor layout");
+  }
+
+  // 输出 Tensor 由调用者按 Pipeline::OutputShape（及 AuxShape）分配
+  AlgoTensor output[2];
+  int num_outputs = 1;
+  Pipeline::OutputShape::describe(&output[0], "output0", outputs[0]->getData());
+  if constexpr (Pipeline::kHasAux) {
+    if (outputs.size() >= 2 && outputs[1]) {
+      Pipeline::AuxShape::describe(&output[1], "output1", outputs[1]->getData());
+      num_outputs = 2;
+    }
+  }
+  return toStatus(pipeline_.inferTensors(&input, 1, output, num_outputs), "infer");
+}
+
+template <typename Pipeline>
+base::Status AlgoPipelinePlugin<Pipeline>::inferBatch(
+    const std::vector<std::vector<base::Tensor*>>& batch_inputs,
+    std::vector<std::vector<base::Tensor*>>& batch_outputs) {
+  if (batch_outputs.size() != batch_inputs.size()) {
+    return base::Status::InvalidParam("batch_outputs must be pre-allocated per frame");
+  }
+  for (size_t i = 0; i < batch_inputs.size(); ++i) {
+    auto inputs = batch_inputs[i];
+    auto status = infer(inputs, batch_outputs[i]);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return base::Status::OK();
+}
+
+template <typename Pipeline>
+base::Status AlgoPipelinePlugin<Pipeline>::deinit() {
+  return toStatus(pipeline_.deinit(), "deinit");
+}
+
+template <typename Pipeline>
+base::Status AlgoPipelinePlugin<Pipeline>::toStatus(AlgoStatus status, const char* what) {
+  switch (status) {
+    case ALGO_STATUS_SUCCESS:
+      return base::Status::OK();
+    case ALGO_STATUS_ERROR_INVALID_PARAM:
+      return base::Status::InvalidParam(std::string(what) + ": invalid param");
+    case ALGO_STATUS_ERROR_NOT_INITIALIZED:
+      return base::Status::NotInitialized(std::string(what) + ": not initialized");
+    case ALGO_STATUS_ERROR_NOT_SUPPORTED:
+      return base::Status::NotImplemented(std::string(what) + ": not supported");
+    default:
+      return base::Status::InferenceError(std::string(what) + " failed, status " +
+                                          std::to_string(static_cast<int>(status)));
+  }
+}
+
+template <typename Pipeline>
+AlgoBackendType AlgoPipelinePlugin<Pipeline>::toAlgoBackend(backend::BackendType type) {
+  switch (type) {
+    case backend::BackendType::kTensorRT: return ALGO_BACKEND_TENSORRT;
+    case backend::BackendType::kONNXRuntime: return ALGO_BACKEND_ONNXRUNTIME;
+    case backend::BackendType::kOpenVINO: return ALGO_BACKEND_OPENVINO;
+    case backend::BackendType::kMNN: return ALGO_BACKEND_MNN;
+    case backend::BackendType::kNCNN: return ALGO_BACKEND_NCNN;
+    case backend::BackendType::kTNN: return ALGO_BACKEND_TNN;
+    case backend::BackendType::kRKNN: return ALGO_BACKEND_RKNN;
+    case backend::BackendType::kAscendCL: return ALGO_BACKEND_ASCENDCL;
+    case backend::BackendType::kCoreML: return ALGO_BACKEND_COREML;
+    default: return ALGO_BACKEND_UNKNOWN;
+  }
+}
+
+template <typename Pipeline>
+std::string AlgoPipelinePlugin<Pipeline>::toConfigJson(
+    const std::map<std::string, std::string>& algo_params) {
+  // C++ 接口参数都是字符串，能解析为数字的按数字传给各阶段
+  nlohmann::json j = nlohmann::json::object();
+  for (const auto& pair : algo_params) {
+    const std::string& value = pair.second;
+    char* end = nullptr;
+    double number = std::strtod(value.c_str(), &end);
+    if (!value.empty() && end == value.c_str() + value.size()) {
+      if (value.find_first_of(".eE") == std::string::npos) {
+        j[pair.first] = static_cast<int64_t>(number);
+      } else {
+        j[pair.first] = number;
+      }
+    } else {
+      j[pair.first] = value;
+    }
+  }
+  return j.dump();
+}
+
+template <typename Pipeline>
+bool AlgoPipelinePlugin<Pipeline>::describeInput(base::Tensor* tensor, AlgoTensor* view) {
+  if (!tensor || !tensor->getData()) {
+    return false;
+  }
+  const auto& desc = tensor->getDesc();
+  if (desc.shape_.size() != 4) {
+    return false;
+  }
+  *view = AlgoTensor{};
+  view->ndim = 4;
+  size_t numel = 1;
+  for (int i = 0; i < 4; ++i) {
+    view->shape[i] = desc.shape_[i];
+    numel *= static_cast<size_t>(desc.shape_[i]);
+  }
+  if (desc.data_type_.code_ == base::kDataTypeCodeFp) {
+    // 已预处理的 NCHW float
+    view->data_type = ALGO_DATA_TYPE_FLOAT32;
+    view->pixel_format = ALGO_PIXEL_FORMAT_RGB_PLANAR;
+    view->size = numel * sizeof(float);
+  } else {
+    // 解码器输出的 NHWC BGR uint8
+    view->data_type = ALGO_DATA_TYPE_UINT8;
+    view->pixel_format = ALGO_PIXEL_FORMAT_BGR;
+    view->size = numel;
+  }
+  view->data = tensor->getData();
+  return true;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
@@ -3,6 +3,8 @@
 #include "inference/base/status.h"
 #include "inference/base/types.h"
 #include "inference/backend_interface.h"
+#include "algo_utils/stage_timer.h"
+#include "plugin/algo_plugin_interface.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -138,6 +140,46 @@ class AlgoPluginBase {
   virtual std::vector<backend::BackendType> getSupportedBackends() const {
     return getInfo().supported_backends;
   }
+  
+  /**
+   * @brief 获取累计性能计数（各阶段耗时、调用次数、耗时直方图）
+   * @return 性能计数，默认为空（插件未统计）
+   */
+  virtual algo_utils::PerfStats getStats() const {
+    return algo_utils::PerfStats();
+  }
+  
+  /**
+   * @brief 在线更新算法参数（不重新加载模型）
+   * 
+   * 插件需保证参数在帧之间原子切换：正在处理的帧继续使用旧参数，
+   * 下一帧开始使用新参数。
+   * 
+   * 合并语义：algo_params 中的参数覆盖当前值，未出现的参数保持当前值（不恢复默认值）；
+   * 需要恢复默认值时调用者应走 deinit() + init()。
+   * 
+   * 新增虚函数一律追加在类末尾，已编译插件的虚表前部布局不变。
+   * 
+   * @param algo_params 需要修改的参数
+   * @return Status 成功；kErrorNotImplemented 表示不支持在线更新
+   *         或参数需要重新加载模型，调用者应回退到 deinit() + init()；
+   *         kErrorInvalidParam 表示取值非法，当前参数不变
+   */
+  virtual base::Status updateParams(const std::map<std::string, std::string>& algo_params) {
+    return base::Status::NotImplemented("Online parameter update not supported");
+  }
+  
+  /**
+   * @brief 跟踪一帧（跟踪类插件实现，见 tracking_pipeline.h）
+   * 
+   * @param input 输入图像
+   * @param result 结果缓冲（由调用者分配），容量不足时回填 num_objects
+   * @return ALGO_STATUS_SUCCESS；ALGO_STATUS_ERROR_NOT_SUPPORTED 表示插件不支持跟踪；
+   *         ALGO_STATUS_ERROR_BUFFER_TOO_SMALL 表示结果被截断
+   */
+  virtual AlgoStatus inferTrack(const AlgoTensor* input, AlgoTrackResult* result) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
 };
 
 /**
@@ -18,6 +18,23 @@ extern "C" {
 #include <stdint.h>
 #include <stddef.h>
 
+/**
+ * @brief 接口 ABI 版本（结构体追加字段时递增，见 AlgoNegotiateAbiVersion）
+ *
+ * - 1：初始版本（未导出 AlgoNegotiateAbiVersion 的插件 / 未调用它的主程序）
+ * - 2：AlgoTensor 追加 pixel_format、row_stride
+ * - 3：AlgoInfo 追加 class_names、num_classes
+ */
+#define ALGO_ABI_VERSION 3
+
+// 追加字段的默认值：C++ 调用者声明结构体时即取默认值，旧代码不填写也按旧语义解释；
+// C 调用者需自行清零
+#ifdef __cplusplus
+#define ALGO_FIELD_DEFAULT(value) = value
+#else
+#define ALGO_FIELD_DEFAULT(value)
+#endif
+
 // ============================================================================
 // 基础类型定义
 // ============================================================================
@@ -35,6 +52,10 @@ typedef enum {
   ALGO_STATUS_ERROR_MODEL_LOAD = 6,
   ALGO_STATUS_ERROR_INFERENCE = 7,
   ALGO_STATUS_ERROR_BACKEND_NOT_SUPPORTED = 8,
+  ALGO_STATUS_ERROR_BUFFER_TOO_SMALL = 9,     // 调用者提供的缓冲不足，所需数量已回填
+  ALGO_STATUS_ERROR_NOT_SUPPORTED = 10,       // 插件未导出该可选接口
+  ALGO_STATUS_ERROR_RELOAD_REQUIRED = 11,     // 参数需要重新加载模型才能生效（AlgoSetParams）
+  ALGO_STATUS_ERROR_DROPPED = 12,             // 过载时被调度器丢弃（未推理），不是插件错误
   ALGO_STATUS_ERROR_UNKNOWN = 99
 } AlgoStatus;
 
@@ -80,8 +101,28 @@ typedef enum {
   ALGO_DATA_TYPE_UNKNOWN = 99
 } AlgoDataType;
 
+/**
+ * @brief 图像像素格式（决定 AlgoTensor 的内存布局）
+ *
+ * - BGR / RGB：交错存储，shape = [1, H, W, 3]
+ * - RGB_PLANAR：平面存储，shape = [1, 3, H, W]
+ * - NV12 / I420：shape = [1, H, W]（亮度尺寸），Y 平面之后紧跟色度平面，
+ *   NV12 为 UV 交错平面，I420 为 U、V 两个平面，仅支持 UINT8
+ */
+typedef enum {
+  ALGO_PIXEL_FORMAT_UNKNOWN = 0,  // 非图像 Tensor，或旧版主程序未填写（按 shape 解释）
+  ALGO_PIXEL_FORMAT_BGR = 1,
+  ALGO_PIXEL_FORMAT_RGB = 2,
+  ALGO_PIXEL_FORMAT_RGB_PLANAR = 3,
+  ALGO_PIXEL_FORMAT_NV12 = 4,
+  ALGO_PIXEL_FORMAT_I420 = 5
+} AlgoPixelFormat;
+
 /**
  * @brief Tensor 结构
+ *
+ * pixel_format / row_stride 为 ABI 版本 2 追加的字段：旧版主程序传入的结构体没有这两个
+ * 字段，插件只有在主程序通过 AlgoNegotiateAbiVersion 声明版本 >= 2 后才读取它们。
  */
 typedef struct {
   char name[64];              // Tensor 名称
@@ -90,8 +131,32 @@ typedef struct {
   int64_t shape[8];           // 最多 8 维
   void* data;                 // 数据指针
   size_t size;                // 数据字节数
+  // ABI 版本 2：图像格式（非图像 Tensor 为 UNKNOWN）
+  AlgoPixelFormat pixel_format ALGO_FIELD_DEFAULT(ALGO_PIXEL_FORMAT_UNKNOWN);
+  int row_stride ALGO_FIELD_DEFAULT(0);   // 首平面每行字节数（含对齐填充），0 表示紧密排列
 } AlgoTensor;
 
+/**
+ * @brief 插件可接受的一种输入格式
+ */
+typedef struct {
+  AlgoPixelFormat pixel_format;
+  AlgoDataType data_type;
+  int width;                  // 0 表示任意尺寸，非 0 表示要求主程序已缩放到该尺寸
+  int height;
+} AlgoInputFormat;
+
+/**
+ * @brief 插件输入能力（formats 按插件偏好降序排列）
+ */
+typedef struct {
+  const AlgoInputFormat* formats;
+  int num_formats;
+  int max_width;              // 任意尺寸输入的上限，0 表示不限
+  int max_height;
+  int size_align;             // 宽高需满足的对齐（YUV 输入通常为 2）
+} AlgoInputCaps;
+
 /**
  * @brief 检测框结构
  */
@@ -111,6 +176,191 @@ typedef struct {
   int64_t timestamp;          // 时间戳
 } AlgoDetResult;
 
+/**
+ * @brief 紧凑检测结果（结构数组，所有数组由调用者分配，各 capacity 个元素）
+ *
+ * 每个框 22 字节（AlgoDetBox 为 92 字节），插件直接写入调用者的数组，主程序按列读取，
+ * 没有逐框拷贝。类别名称不随结果返回，由 AlgoInfo::class_names 每个插件发布一次。
+ * 容量不足时 num_boxes 回填为所需数量并返回 ALGO_STATUS_ERROR_BUFFER_TOO_SMALL。
+ */
+typedef struct {
+  float* x1;                  // 边界框坐标
+  float* y1;
+  float* x2;
+  float* y2;
+  float* score;               // 置信度
+  int16_t* class_id;          // 类别 ID（AlgoInfo::class_names 的下标）
+  int capacity;
+  int num_boxes;
+  int64_t timestamp;          // 时间戳
+} AlgoDetSoA;
+
+// ============================================================================
+// 类型化结果（所有缓冲均由调用者分配，插件只负责填充）
+//
+// 约定：缓冲容量不足时插件返回 ALGO_STATUS_ERROR_BUFFER_TOO_SMALL，
+// 并把 num_* / *_used 字段设置为所需数量，调用者扩容后重试。
+// ============================================================================
+
+/**
+ * @brief 分类结果条目
+ */
+typedef struct {
+  int class_id;               // 类别 ID
+  float score;                // 置信度
+} AlgoClsItem;
+
+/**
+ * @brief 分类结果（top-k，按置信度降序）
+ */
+typedef struct {
+  AlgoClsItem* items;         // 调用者分配
+  int capacity;               // items 容量，即 top-k 的 k
+  int num_items;              // 实际写入数量
+} AlgoClsResult;
+
+/**
+ * @brief 掩码编码方式
+ */
+typedef enum {
+  ALGO_MASK_RLE = 0,          // 行优先游程编码：uint32 计数，从背景开始交替
+  ALGO_MASK_BITMASK = 1       // 行优先位图：每像素 1 bit（高位在前），每行按字节对齐
+} AlgoMaskEncoding;
+
+/**
+ * @brief 分割实例（掩码只覆盖 mask_x/mask_y 起始的局部区域）
+ */
+typedef struct {
+  float x1, y1, x2, y2;       // 边界框坐标
+  float score;                // 置信度
+  int class_id;               // 类别 ID
+  int mask_x, mask_y;         // 掩码区域左上角（原图坐标）
+  int mask_width, mask_height;  // 掩码区域尺寸
+  uint32_t mask_offset;       // 在 mask_data 中的起始字节
+  uint32_t mask_length;       // 掩码字节数
+} AlgoSegInstance;
+
+/**
+ * @brief 分割结果
+ */
+typedef struct {
+  AlgoMaskEncoding encoding;  // 输入：调用者期望的编码
+  AlgoSegInstance* instances; // 调用者分配
+  int instance_capacity;
+  int num_instances;
+  void* mask_data;            // 所有实例的掩码连续存放（调用者分配）
+  size_t mask_capacity;       // 字节
+  size_t mask_used;           // 字节
+} AlgoSegResult;
+
+/**
+ * @brief 关键点
+ */
+typedef struct {
+  float x, y;                 // 坐标
+  float score;                // 可见性/置信度
+} AlgoKeypoint;
+
+/**
+ * @brief 姿态实例
+ */
+typedef struct {
+  float x1, y1, x2, y2;       // 边界框坐标
+  float score;                // 置信度
+  int class_id;               // 类别 ID
+  uint32_t keypoint_offset;   // 在 keypoints 数组中的起始下标
+} AlgoPoseInstance;
+
+/**
+ * @brief 姿态结果（所有实例的关键点连续存放）
+ */
+typedef struct {
+  AlgoPoseInstance* instances;  // 调用者分配
+  int instance_capacity;
+  int num_instances;
+  AlgoKeypoint* keypoints;    // 调用者分配
+  int keypoint_capacity;
+  int num_keypoints;
+  int keypoints_per_instance; // 每个实例的关键点数（如 COCO 为 17）
+} AlgoPoseResult;
+
+/**
+ * @brief 文本行（四边形顺时针：左上、右上、右下、左下）
+ */
+typedef struct {
+  float points[8];            // x0,y0,x1,y1,x2,y2,x3,y3
+  float score;                // 识别置信度
+  uint32_t text_offset;       // 在 text_data 中的起始字节
+  uint32_t text_length;       // UTF-8 字节数（不含结尾 0）
+} AlgoTextLine;
+
+/**
+ * @brief OCR 结果
+ */
+typedef struct {
+  AlgoTextLine* lines;        // 调用者分配
+  int line_capacity;
+  int num_lines;
+  char* text_data;            // 所有文本行 UTF-8 连续存放（调用者分配）
+  size_t text_capacity;       // 字节
+  size_t text_used;           // 字节
+} AlgoOcrResult;
+
+/**
+ * @brief 跟踪目标
+ */
+typedef struct {
+  float x1, y1, x2, y2;       // 边界框坐标（非检测帧为预测位置）
+  float score;                // 最近一次检测的置信度，非检测帧按帧衰减
+  int class_id;               // 类别 ID
+  uint32_t track_id;          // 轨迹 ID（同一实例内稳定且不复用，从 1 开始）
+  int time_since_update;      // 距最近一次匹配到检测的帧数，0 表示本帧由检测更新
+} AlgoTrackObject;
+
+/**
+ * @brief 跟踪结果
+ *
+ * 每次调用都会推进跟踪状态：容量不足时只写入前 object_capacity 个目标，
+ * num_objects 回填为所需数量，调用者扩容后从下一帧起生效（不要用同一帧重试）。
+ */
+typedef struct {
+  AlgoTrackObject* objects;   // 调用者分配
+  int object_capacity;
+  int num_objects;
+  int detected;               // 1 表示本帧运行了检测，0 表示只做了轨迹传播
+  int detect_interval;        // 当前检测间隔 K（自适应时随负载变化）
+} AlgoTrackResult;
+
+// ============================================================================
+// 性能计数（插件内部各阶段耗时，累计值，由主程序做差分）
+// ============================================================================
+
+#define ALGO_STATS_MAX_STAGES 8
+#define ALGO_STATS_HIST_BUCKETS 32
+
+/**
+ * @brief 单个阶段的累计耗时
+ *
+ * histogram 按 log2 微秒分桶：桶 0 为 < 1us，桶 i 为 [2^(i-1), 2^i) us，
+ * 最后一个桶包含所有更长的耗时。
+ */
+typedef struct {
+  char name[32];              // 阶段名称，如 "preprocess" / "inference" / "decode" / "nms"
+  uint64_t count;             // 调用次数
+  uint64_t total_ns;          // 累计耗时
+  uint64_t max_ns;            // 最大单次耗时
+  uint64_t histogram[ALGO_STATS_HIST_BUCKETS];
+} AlgoStageStats;
+
+/**
+ * @brief 插件性能计数
+ */
+typedef struct {
+  uint64_t frames;            // 累计处理帧数
+  int num_stages;
+  AlgoStageStats stages[ALGO_STATS_MAX_STAGES];
+} AlgoStats;
+
 /**
  * @brief 算法信息
  */
@@ -122,6 +372,9 @@ typedef struct {
   char author[64];            // 作者
   AlgoBackendType* supported_backends;  // 支持的 Backend 列表
   int num_backends;           // Backend 数量
+  // 以下字段自 ABI 版本 3 起存在：主程序只在协商版本 >= 3 时读取（PluginLoaderC::getClassNames）
+  const char* const* class_names;  // 类别名称表，按 class_id 索引，可为 NULL
+  int num_classes;            // class_names 元素数
 } AlgoInfo;
 
 /**
@@ -191,6 +444,101 @@ void AlgoDestroy(AlgoHandle handle);
  */
 void AlgoFreeDetResult(AlgoDetResult* result);
 
+// ============================================================================
+// 可选导出函数（插件按算法类型选择实现，加载器按需解析）
+// ============================================================================
+
+/**
+ * @brief ABI 版本协商（可选）：主程序加载插件后立即调用一次
+ *
+ * 插件记录 min(host_abi_version, ALGO_ABI_VERSION)，之后按该版本解释主程序传入的结构体；
+ * 未被调用时按版本 1 解释（旧版主程序）。未导出该函数的插件视为版本 1。
+ * 除 AlgoInferDetection 外的可选接口只有版本 >= 2 的主程序才会调用，始终使用完整结构体。
+ * @param host_abi_version 主程序编译时的 ALGO_ABI_VERSION
+ * @return 插件编译时的 ALGO_ABI_VERSION
+ */
+int AlgoNegotiateAbiVersion(int host_abi_version);
+
+/**
+ * @brief 查询输入能力（可选）：未导出时主程序按 BGR UINT8 任意尺寸送帧
+ * @param handle 算法句柄（需已初始化，固定尺寸取决于模型）
+ * @return 能力描述，由插件持有，在 AlgoDeinit 前有效
+ */
+const AlgoInputCaps* AlgoGetInputCaps(AlgoHandle handle);
+
+/**
+ * @brief 在线更新算法参数（可选）：不重新加载模型，下一帧开始生效
+ * @param handle 算法句柄（需已初始化）
+ * @param config_json 与 AlgoInitParam.config_json 格式相同，只需包含要修改的字段
+ *        （合并语义：未出现的字段保持当前值，不恢复默认值）
+ * @return 状态码；包含必须重新加载模型才能生效的参数（如输入尺寸）时返回
+ *         ALGO_STATUS_ERROR_RELOAD_REQUIRED（参数不生效），主程序应回退到 AlgoDeinit + AlgoInit
+ */
+AlgoStatus AlgoSetParams(AlgoHandle handle, const char* config_json);
+
+/**
+ * @brief 获取累计性能计数（可选）
+ * @param handle 算法句柄
+ * @param stats 输出，调用者分配
+ * @return 状态码
+ */
+AlgoStatus AlgoGetStats(AlgoHandle handle, AlgoStats* stats);
+
+/**
+ * @brief 查询原始输出 Tensor 信息（可选）
+ * @param handle 算法句柄（需已初始化）
+ * @param outputs 输出描述数组：填充 name/data_type/ndim/shape/size，data 置 NULL
+ * @param num_outputs 输入为数组容量，输出为实际数量
+ * @return 状态码
+ */
+AlgoStatus AlgoGetOutputInfo(AlgoHandle handle, AlgoTensor* outputs, int* num_outputs);
+
+/**
+ * @brief 通用 Tensor 推理（可选）：原样返回模型输出，不做后处理
+ * @param handle 算法句柄
+ * @param inputs 输入 Tensor 数组
+ * @param num_inputs 输入数量
+ * @param outputs 输出 Tensor 数组，data/size 由调用者分配，插件填充形状并写入数据
+ * @param num_outputs 输出数量
+ * @return 状态码（size 不足时回填所需字节数并返回 BUFFER_TOO_SMALL）
+ */
+AlgoStatus AlgoInferTensors(AlgoHandle handle, const AlgoTensor* inputs, int num_inputs,
+                            AlgoTensor* outputs, int num_outputs);
+
+/**
+ * @brief 执行推理（目标检测，紧凑结果，可选）
+ * @param result 数组由调用者分配；类别名称见 AlgoInfo::class_names
+ * @return 状态码（容量不足时回填 num_boxes 并返回 BUFFER_TOO_SMALL）
+ */
+AlgoStatus AlgoInferDetectionSoA(AlgoHandle handle, const AlgoTensor* input, AlgoDetSoA* result);
+
+/**
+ * @brief 执行推理（图像分类，可选）
+ */
+AlgoStatus AlgoInferClassification(AlgoHandle handle, const AlgoTensor* input,
+                                   AlgoClsResult* result);
+
+/**
+ * @brief 执行推理（分割，可选）
+ */
+AlgoStatus AlgoInferSegmentation(AlgoHandle handle, const AlgoTensor* input,
+                                 AlgoSegResult* result);
+
+/**
+ * @brief 执行推理（姿态估计，可选）
+ */
+AlgoStatus AlgoInferPose(AlgoHandle handle, const AlgoTensor* input, AlgoPoseResult* result);
+
+/**
+ * @brief 执行推理（文字识别，可选）
+ */
+AlgoStatus AlgoInferOcr(AlgoHandle handle, const AlgoTensor* input, AlgoOcrResult* result);
+
+/**
+ * @brief 执行跟踪（可选）：每 K 帧运行一次检测，其余帧只传播轨迹，每帧都有输出
+ */
+AlgoStatus AlgoInferTrack(AlgoHandle handle, const AlgoTensor* input, AlgoTrackResult* result);
+
 #ifdef __cplusplus
 }
 #endif
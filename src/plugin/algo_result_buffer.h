@@ -0,0 +1,231 @@
+#pragma once
+
+/**
+ * @file algo_result_buffer.h
+ * @brief 类型化结果的调用者侧缓冲（C 接口结果缓冲由调用者分配）
+ *
+ * 用法：
+ *   plugin::SegResultBuffer buffer(64, 1 << 20);
+ *   AlgoStatus status = plugin::inferWithRetry(buffer, [&](AlgoSegResult* r) {
+ *     return loader.inferSegmentation(handle, name, &input, r);
+ *   });
+ *
+ * 缓冲在多帧间复用，只有插件返回 ALGO_STATUS_ERROR_BUFFER_TOO_SMALL 时才扩容。
+ * 紧凑检测结果的缓冲 DetSoABuffer 见 algo_det_soa.h，同样可用于 inferWithRetry。
+ */
+
+#include "plugin/algo_det_soa.h"
+#include "plugin/algo_plugin_interface.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace infer_frame {
+namespace plugin {
+
+/**
+ * @brief 分类结果缓冲
+ */
+class ClsResultBuffer {
+ public:
+  using Result = AlgoClsResult;
+
+  explicit ClsResultBuffer(int top_k = 5) : items_(top_k) {}
+
+  AlgoClsResult* view() {
+    result_.items = items_.data();
+    result_.capacity = static_cast<int>(items_.size());
+    result_.num_items = 0;
+    return &result_;
+  }
+
+  void grow() {
+    items_.resize(std::max<size_t>(items_.size() * 2, result_.num_items));
+  }
+
+  const AlgoClsResult& result() const { return result_; }
+
+ private:
+  std::vector<AlgoClsItem> items_;
+  AlgoClsResult result_{};
+};
+
+/**
+ * @brief 分割结果缓冲
+ */
+class SegResultBuffer {
+ public:
+  using Result = AlgoSegResult;
+
+  SegResultBuffer(int max_instances = 64, size_t mask_bytes = 1 << 20,
+                  AlgoMaskEncoding encoding = ALGO_MASK_RLE)
+      : instances_(max_instances), masks_(mask_bytes), encoding_(encoding) {}
+
+  AlgoSegResult* view() {
+    result_.encoding = encoding_;
+    result_.instances = instances_.data();
+    result_.instance_capacity = static_cast<int>(instances_.size());
+    result_.num_instances = 0;
+    result_.mask_data = masks_.data();
+    result_.mask_capacity = masks_.size();
+    result_.mask_used = 0;
+    return &result_;
+  }
+
+  void grow() {
+    instances_.resize(std::max<size_t>(instances_.size(), result_.num_instances));
+    masks_.resize(std::max(masks_.size() * 2, result_.mask_used));
+  }
+
+  const AlgoSegResult& result() const { return result_; }
+
+  /**
+   * @brief 把实例掩码解码为 mask_width x mask_height 的 0/1 字节图
+   */
+  bool decodeMask(int index, std::vector<uint8_t>& out) const;
+
+ private:
+  std::vector<AlgoSegInstance> instances_;
+  std::vector<uint8_t> masks_;
+  AlgoMaskEncoding encoding_;
+  AlgoSegResult result_{};
+};
+
+/**
+ * @brief 姿态结果缓冲
+ */
+class PoseResultBuffer {
+ public:
+  using Result = AlgoPoseResult;
+
+  PoseResultBuffer(int max_instances = 64, int keypoints_per_instance = 17)
+      : instances_(max_instances), keypoints_(max_instances * keypoints_per_instance) {}
+
+  AlgoPoseResult* view() {
+    result_.instances = instances_.data();
+    result_.instance_capacity = static_cast<int>(instances_.size());
+    result_.num_instances = 0;
+    result_.keypoints = keypoints_.data();
+    result_.keypoint_capacity = static_cast<int>(keypoints_.size());
+    result_.num_keypoints = 0;
+    result_.keypoints_per_instance = 0;
+    return &result_;
+  }
+
+  void grow() {
+    instances_.resize(std::max<size_t>(instances_.size(), result_.num_instances));
+    keypoints_.resize(std::max<size_t>(keypoints_.size(), result_.num_keypoints));
+  }
+
+  const AlgoPoseResult& result() const { return result_; }
+
+ private:
+  std::vector<AlgoPoseInstance> instances_;
+  std::vector<AlgoKeypoint> keypoints_;
+  AlgoPoseResult result_{};
+};
+
+/**
+ * @brief OCR 结果缓冲
+ */
+class OcrResultBuffer {
+ public:
+  using Result = AlgoOcrResult;
+
+  OcrResultBuffer(int max_lines = 128, size_t text_bytes = 16 * 1024)
+      : lines_(max_lines), text_(text_bytes) {}
+
+  AlgoOcrResult* view() {
+    result_.lines = lines_.data();
+    result_.line_capacity = static_cast<int>(lines_.size());
+    result_.num_lines = 0;
+    result_.text_data = text_.data();
+    result_.text_capacity = text_.size();
+    result_.text_used = 0;
+    return &result_;
+  }
+
+  void grow() {
+    lines_.resize(std::max<size_t>(lines_.size(), result_.num_lines));
+    text_.resize(std::max(text_.size() * 2, result_.text_used));
+  }
+
+  const AlgoOcrResult& result() const { return result_; }
+
+  std::string text(int index) const {
+    const AlgoTextLine& line = result_.lines[index];
+    return std::string(result_.text_data + line.text_offset, line.text_length);
+  }
+
+ private:
+  std::vector<AlgoTextLine> lines_;
+  std::vector<char> text_;
+  AlgoOcrResult result_{};
+};
+
+/**
+ * @brief 调用插件，缓冲不足时按回填的数量扩容并重试一次
+ * @param buffer 结果缓冲（ClsResultBuffer / SegResultBuffer / ...）
+ * @param call   形如 AlgoStatus(Buffer::Result*) 的调用
+ */
+template <typename Buffer, typename Call>
+AlgoStatus inferWithRetry(Buffer& buffer, Call&& call) {
+  AlgoStatus status = call(buffer.view());
+  if (status == ALGO_STATUS_ERROR_BUFFER_TOO_SMALL) {
+    buffer.grow();
+    status = call(buffer.view());
+  }
+  return status;
+}
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline bool SegResultBuffer::decodeMask(int index, std::vector<uint8_t>& out) const {
+  if (index < 0 || index >= result_.num_instances) {
+    return false;
+  }
+  const AlgoSegInstance& inst = result_.instances[index];
+  size_t pixels = static_cast<size_t>(inst.mask_width) * inst.mask_height;
+  out.assign(pixels, 0);
+
+  const uint8_t* data = static_cast<const uint8_t*>(result_.mask_data) + inst.mask_offset;
+  if (result_.encoding == ALGO_MASK_BITMASK) {
+    size_t row_bytes = (static_cast<size_t>(inst.mask_width) + 7) / 8;
+    if (row_bytes * inst.mask_height > inst.mask_length) {
+      return false;
+    }
+    for (int y = 0; y < inst.mask_height; ++y) {
+      const uint8_t* row = data + row_bytes * y;
+      for (int x = 0; x < inst.mask_width; ++x) {
+        out[static_cast<size_t>(y) * inst.mask_width + x] = (row[x >> 3] >> (7 - (x & 7))) & 1;
+      }
+    }
+    return true;
+  }
+
+  // RLE：uint32 计数，从背景开始交替
+  size_t num_runs = inst.mask_length / sizeof(uint32_t);
+  size_t pos = 0;
+  uint8_t value = 0;
+  for (size_t i = 0; i < num_runs; ++i) {
+    uint32_t run;
+    std::memcpy(&run, data + i * sizeof(uint32_t), sizeof(uint32_t));
+    if (pos + run > pixels) {
+      return false;
+    }
+    if (value) {
+      std::memset(out.data() + pos, 1, run);
+    }
+    pos += run;
+    value ^= 1;
+  }
+  return pos == pixels;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
@@ -0,0 +1,228 @@
+#pragma once
+
+/**
+ * @file format_negotiation.h
+ * @brief 主程序与插件之间的输入格式协商
+ *
+ * 解码器原生输出通常是 NV12/I420（硬解）或 BGR（软解 + videoconvert），
+ * 插件内部最终需要 RGB 平面 float。协商的目标是让主程序只做必要的转换：
+ *
+ *   1. 插件通过 AlgoGetInputCaps 声明可接受的格式（按偏好排序）
+ *   2. 主程序列出解码器能直接给出的格式
+ *   3. negotiateInputFormat 按主程序侧转换代价（读写字节数）选出最便宜的组合，
+ *      代价相同时取插件偏好靠前的格式
+ *
+ * 插件未导出 AlgoGetInputCaps 时退化为旧行为：BGR UINT8 任意尺寸。
+ */
+
+#include "plugin/algo_plugin_interface.h"
+
+#include <cstring>
+#include <vector>
+
+namespace infer_frame {
+namespace plugin {
+
+/**
+ * @brief 协商结果
+ */
+struct InputPlan {
+  AlgoPixelFormat source_format = ALGO_PIXEL_FORMAT_UNKNOWN;  // 从解码器取的格式
+  AlgoInputFormat target{};              // 交给插件的格式
+  int width = 0;                         // 交给插件的尺寸
+  int height = 0;
+  double cost = 0.0;                     // 主程序侧转换代价（每帧读写字节数）
+  int preference = 0;                    // target 在插件列表中的位置
+
+  /**
+   * @brief 解码器输出可直接交给插件，无需任何转换
+   */
+  bool passthrough() const { return cost == 0.0; }
+};
+
+inline const char* pixelFormatName(AlgoPixelFormat format) {
+  switch (format) {
+    case ALGO_PIXEL_FORMAT_BGR: return "BGR";
+    case ALGO_PIXEL_FORMAT_RGB: return "RGB";
+    case ALGO_PIXEL_FORMAT_RGB_PLANAR: return "RGB_PLANAR";
+    case ALGO_PIXEL_FORMAT_NV12: return "NV12";
+    case ALGO_PIXEL_FORMAT_I420: return "I420";
+    default: return "UNKNOWN";
+  }
+}
+
+inline bool isYuvFormat(AlgoPixelFormat format) {
+  return format == ALGO_PIXEL_FORMAT_NV12 || format == ALGO_PIXEL_FORMAT_I420;
+}
+
+inline size_t dataTypeBytes(AlgoDataType data_type) {
+  switch (data_type) {
+    case ALGO_DATA_TYPE_FLOAT32:
+    case ALGO_DATA_TYPE_INT32: return 4;
+    case ALGO_DATA_TYPE_FLOAT16: return 2;
+    default: return 1;
+  }
+}
+
+/**
+ * @brief 图像字节数
+ * @param row_stride 首平面每行字节数，0 表示紧密排列
+ *
+ * YUV 4:2:0 的色度平面为 ceil(H/2) 行：NV12 与亮度同跨度，I420 的 U / V 各为半跨度
+ * （紧密排列时为 ceil(W/2)），与 letterbox_yuv.h 的 nv12Image / i420Image 布局一致。
+ */
+inline size_t imageBytes(AlgoPixelFormat format, AlgoDataType data_type, int width, int height,
+                         int row_stride = 0) {
+  size_t w = static_cast<size_t>(width);
+  size_t h = static_cast<size_t>(height);
+  if (isYuvFormat(format)) {
+    size_t stride = row_stride > 0 ? static_cast<size_t>(row_stride) : w;
+    size_t chroma_rows = (h + 1) / 2;
+    if (format == ALGO_PIXEL_FORMAT_NV12) {
+      return stride * h + stride * chroma_rows;
+    }
+    size_t chroma_stride = row_stride > 0 ? stride / 2 : (w + 1) / 2;
+    return stride * h + 2 * chroma_stride * chroma_rows;
+  }
+  size_t pixel = 3 * dataTypeBytes(data_type);
+  if (format != ALGO_PIXEL_FORMAT_RGB_PLANAR && row_stride > 0) {
+    return static_cast<size_t>(row_stride) * h;
+  }
+  return w * h * pixel;
+}
+
+/**
+ * @brief 按像素格式填写图像 Tensor 的 shape/size
+ */
+inline void describeImageTensor(AlgoTensor* tensor, const char* name, AlgoPixelFormat format,
+                                AlgoDataType data_type, int width, int height, void* data,
+                                int row_stride = 0) {
+  *tensor = AlgoTensor{};
+  std::strncpy(tensor->name, name, sizeof(tensor->name) - 1);
+  tensor->data_type = data_type;
+  tensor->pixel_format = format;
+  tensor->row_stride = row_stride;
+  tensor->shape[0] = 1;
+  if (isYuvFormat(format)) {
+    tensor->ndim = 3;
+    tensor->shape[1] = height;
+    tensor->shape[2] = width;
+  } else if (format == ALGO_PIXEL_FORMAT_RGB_PLANAR) {
+    tensor->ndim = 4;
+    tensor->shape[1] = 3;
+    tensor->shape[2] = height;
+    tensor->shape[3] = width;
+  } else {
+    tensor->ndim = 4;
+    tensor->shape[1] = height;
+    tensor->shape[2] = width;
+    tensor->shape[3] = 3;
+  }
+  tensor->data = data;
+  tensor->size = imageBytes(format, data_type, width, height, row_stride);
+}
+
+/**
+ * @brief 主程序把 source 转成 target 的代价估计（读写字节数，色彩空间转换按 2 倍计）
+ * @return 代价，主程序无法完成该转换时返回 -1
+ */
+inline double conversionCost(AlgoPixelFormat source, int src_width, int src_height,
+                             const AlgoInputFormat& target) {
+  const int dst_width = target.width > 0 ? target.width : src_width;
+  const int dst_height = target.height > 0 ? target.height : src_height;
+  const bool resize = dst_width != src_width || dst_height != src_height;
+  const bool same_format = source == target.pixel_format &&
+                           target.data_type == ALGO_DATA_TYPE_UINT8;
+  if (same_format && !resize) {
+    return 0.0;
+  }
+  // RGB 系不转回 YUV：没有解码器会这样输出，也没有插件值得这样要
+  if (!isYuvFormat(source) && isYuvFormat(target.pixel_format)) {
+    return -1.0;
+  }
+  if (isYuvFormat(target.pixel_format) && target.data_type != ALGO_DATA_TYPE_UINT8) {
+    return -1.0;
+  }
+
+  double cost = 0.0;
+  if (resize) {
+    // 先在源格式上缩放：读一遍原图，写一遍缩放结果
+    cost += static_cast<double>(imageBytes(source, ALGO_DATA_TYPE_UINT8, src_width, src_height));
+    cost += static_cast<double>(imageBytes(source, ALGO_DATA_TYPE_UINT8, dst_width, dst_height));
+  }
+  if (!same_format) {
+    double read = static_cast<double>(imageBytes(source, ALGO_DATA_TYPE_UINT8, dst_width,
+                                                 dst_height));
+    double write = static_cast<double>(imageBytes(target.pixel_format, target.data_type,
+                                                  dst_width, dst_height));
+    double factor = isYuvFormat(source) && !isYuvFormat(target.pixel_format) ? 2.0 : 1.0;
+    cost += (read + write) * factor;
+  }
+  return cost;
+}
+
+/**
+ * @brief 插件未声明能力时的默认输入（旧版主程序行为）
+ */
+inline const AlgoInputCaps* legacyInputCaps() {
+  static const AlgoInputFormat formats[] = {
+    {ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8, 0, 0},
+  };
+  static const AlgoInputCaps caps = {formats, 1, 0, 0, 1};
+  return &caps;
+}
+
+/**
+ * @brief 选出代价最低的 (解码器格式, 插件格式) 组合
+ * @param caps 插件能力，nullptr 表示插件未导出 AlgoGetInputCaps
+ * @param source_formats 解码器可直接输出的格式（按解码器偏好排序）
+ * @param width 解码尺寸
+ * @param height 解码尺寸
+ * @param plan 输出
+ * @return 是否找到可行组合
+ */
+inline bool negotiateInputFormat(const AlgoInputCaps* caps,
+                                 const std::vector<AlgoPixelFormat>& source_formats,
+                                 int width, int height, InputPlan* plan) {
+  if (!caps || caps->num_formats <= 0 || !caps->formats) {
+    caps = legacyInputCaps();
+  }
+
+  bool found = false;
+  for (int i = 0; i < caps->num_formats; ++i) {
+    const AlgoInputFormat& target = caps->formats[i];
+    const int dst_width = target.width > 0 ? target.width : width;
+    const int dst_height = target.height > 0 ? target.height : height;
+    if (target.width == 0) {
+      if ((caps->max_width > 0 && dst_width > caps->max_width) ||
+          (caps->max_height > 0 && dst_height > caps->max_height)) {
+        continue;
+      }
+      if (caps->size_align > 1 &&
+          (dst_width % caps->size_align != 0 || dst_height % caps->size_align != 0)) {
+        continue;
+      }
+    }
+
+    for (AlgoPixelFormat source : source_formats) {
+      double cost = conversionCost(source, width, height, target);
+      if (cost < 0.0) {
+        continue;
+      }
+      // 代价相同时保留先遍历到的组合（插件偏好优先，其次解码器偏好）
+      if (!found || cost < plan->cost) {
+        plan->source_format = source;
+        plan->target = target;
+        plan->width = dst_width;
+        plan->height = dst_height;
+        plan->cost = cost;
+        plan->preference = i;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
@@ -0,0 +1,182 @@
+#pragma once
+
+/**
+ * @file motion_gated_detector.h
+ * @brief 一路摄像头的运动门控检测：画面静止时复用上一次结果
+ *
+ * 在调用插件之前做运动检测（algo_utils::MotionGate），静止帧不调用插件，
+ * 直接返回上一次推理的检测框。结果由主程序持有（拷贝到 std::vector），
+ * 不跨 .so 边界分配 / 释放。
+ *
+ * 摄像头配置（AddCameraRequest.config）：
+ * - motion_gate: "off" / "diff" / "background"（默认 off）
+ * - motion_threshold: 降采样亮度差阈值（灵敏度，默认 15）
+ * - motion_min_ratio: 判为运动的变化格子比例（默认 0.002）
+ * - motion_refresh_s: 静止时强制推理间隔（秒，默认 5）
+ */
+
+#include "algo_utils/motion_gate.h"
+#include "plugin/algo_instance.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace infer_frame {
+namespace plugin {
+
+class MotionGatedDetector {
+ public:
+  /**
+   * @param instance 共享的算法实例，生命周期长于本对象
+   * @param enabled false 时每帧都推理
+   */
+  MotionGatedDetector(AlgoInstance& instance, bool enabled,
+                      const algo_utils::MotionGateOptions& options =
+                          algo_utils::MotionGateOptions())
+      : instance_(instance), enabled_(enabled), gate_(options) {}
+
+  /**
+   * @brief 从摄像头配置解析门控参数
+   * @return 解析失败返回 false，enabled / options 保持不变
+   */
+  static bool parseConfig(const std::map<std::string, std::string>& config, bool* enabled,
+                          algo_utils::MotionGateOptions* options);
+
+  /**
+   * @brief 推理一帧
+   * @param timestamp_ms 帧时间戳（强制刷新间隔按它计算）
+   * @param boxes 输出检测框
+   * @param reused 输出：是否复用了上一次结果
+   */
+  AlgoStatus infer(const AlgoTensor* input, int64_t timestamp_ms, std::vector<AlgoDetBox>* boxes,
+                   bool* reused = nullptr);
+
+  /**
+   * @brief 缓存失效（算法参数更新后调用），下一帧强制推理
+   */
+  void invalidate() {
+    has_last_ = false;
+    gate_.reset();
+  }
+
+  /**
+   * @brief 门控计数，skipRatio() 即跳过推理的帧比例
+   */
+  algo_utils::MotionGateStats stats() const { return gate_.stats(); }
+
+ private:
+  AlgoInstance& instance_;
+  bool enabled_;
+  algo_utils::MotionGate gate_;
+  std::vector<AlgoDetBox> last_boxes_;
+  bool has_last_ = false;
+
+  bool shouldInfer(const AlgoTensor* input, int64_t timestamp_ms);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline bool MotionGatedDetector::parseConfig(const std::map<std::string, std::string>& config,
+                                             bool* enabled,
+                                             algo_utils::MotionGateOptions* options) {
+  // 先解析到副本，全部合法后再写回，失败时不留下部分更新
+  bool parsed_enabled = *enabled;
+  algo_utils::MotionGateOptions parsed = *options;
+  auto it = config.find("motion_gate");
+  if (it != config.end()) {
+    if (it->second == "off") {
+      parsed_enabled = false;
+    } else if (it->second == "diff") {
+      parsed_enabled = true;
+      parsed.method = algo_utils::MotionMethod::kFrameDiff;
+    } else if (it->second == "background") {
+      parsed_enabled = true;
+      parsed.method = algo_utils::MotionMethod::kBackground;
+    } else {
+      return false;
+    }
+  }
+  try {
+    if ((it = config.find("motion_threshold")) != config.end()) {
+      parsed.pixel_threshold = std::stoi(it->second);
+    }
+    if ((it = config.find("motion_min_ratio")) != config.end()) {
+      parsed.min_changed_ratio = std::stof(it->second);
+    }
+    if ((it = config.find("motion_refresh_s")) != config.end()) {
+      parsed.refresh_interval_ms = static_cast<int64_t>(std::stod(it->second) * 1000.0);
+    }
+  } catch (const std::exception& e) {
+    LOG_WARN("Invalid motion gate config: {}", e.what());
+    return false;
+  }
+  if (parsed.pixel_threshold < 0 || parsed.pixel_threshold >= 255 ||
+      parsed.min_changed_ratio < 0.0f) {
+    return false;
+  }
+  *enabled = parsed_enabled;
+  *options = parsed;
+  return true;
+}
+
+inline bool MotionGatedDetector::shouldInfer(const AlgoTensor* input, int64_t timestamp_ms) {
+  if (!enabled_ || !input->data || input->data_type != ALGO_DATA_TYPE_UINT8) {
+    return true;
+  }
+  const auto* data = static_cast<const uint8_t*>(input->data);
+  switch (input->pixel_format) {
+    case ALGO_PIXEL_FORMAT_NV12:
+    case ALGO_PIXEL_FORMAT_I420: {
+      const int width = static_cast<int>(input->shape[2]);
+      const size_t stride = input->row_stride > 0 ? static_cast<size_t>(input->row_stride)
+                                                  : static_cast<size_t>(width);
+      return gate_.shouldInfer(data, width, static_cast<int>(input->shape[1]), stride,
+                               timestamp_ms);
+    }
+    case ALGO_PIXEL_FORMAT_BGR:
+    case ALGO_PIXEL_FORMAT_RGB: {
+      const int width = static_cast<int>(input->shape[2]);
+      const size_t stride = input->row_stride > 0 ? static_cast<size_t>(input->row_stride)
+                                                  : static_cast<size_t>(width) * 3;
+      return gate_.shouldInferInterleaved(data, width, static_cast<int>(input->shape[1]), stride,
+                                          timestamp_ms);
+    }
+    default:
+      return true;    // 已预处理的输入无法廉价判断
+  }
+}
+
+inline AlgoStatus MotionGatedDetector::infer(const AlgoTensor* input, int64_t timestamp_ms,
+                                             std::vector<AlgoDetBox>* boxes, bool* reused) {
+  if (!input || !boxes) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  // 门控每帧都要看到画面才能维护参考图；没有可复用的结果时照常推理
+  const bool motion = shouldInfer(input, timestamp_ms);
+  const bool run = motion || !has_last_;
+  if (reused) {
+    *reused = !run;
+  }
+  if (!run) {
+    *boxes = last_boxes_;
+    return ALGO_STATUS_SUCCESS;
+  }
+
+  AlgoDetResult result = {};
+  AlgoStatus status = instance_.inferDetection(input, &result);
+  if (status != ALGO_STATUS_SUCCESS) {
+    has_last_ = false;
+    return status;
+  }
+  last_boxes_.assign(result.boxes, result.boxes + result.num_boxes);
+  instance_.freeDetResult(&result);
+  has_last_ = true;
+  *boxes = last_boxes_;
+  return ALGO_STATUS_SUCCESS;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * @file plugin_abi.h
+ * @brief 插件侧 ABI 版本协商（AlgoNegotiateAbiVersion）
+ *
+ * 主程序加载插件后调用 AlgoNegotiateAbiVersion 声明自己的 ALGO_ABI_VERSION；
+ * 旧版主程序不调用，插件按版本 1 解释传入的结构体。插件在旧入口（AlgoInferDetection）
+ * 上用 hostTensor 取得按协商版本解释后的输入，不会读到旧版结构体之后的内存。
+ *
+ * @code
+ * int AlgoNegotiateAbiVersion(int host_abi_version) {
+ *   return infer_frame::plugin::negotiateAbiVersion(host_abi_version);
+ * }
+ * AlgoStatus AlgoInferDetection(AlgoHandle handle, const AlgoTensor* input, ...) {
+ *   AlgoTensor legacy;
+ *   return impl->infer(infer_frame::plugin::hostTensor(input, &legacy), result);
+ * }
+ * @endcode
+ */
+
+#include "algo_plugin_interface.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace infer_frame {
+namespace plugin {
+
+/**
+ * @brief 主程序声明的 ABI 版本（每个插件 .so 一份，未协商时为 1）
+ */
+inline std::atomic<int>& hostAbiVersion() {
+  static std::atomic<int> version{1};
+  return version;
+}
+
+/**
+ * @brief 记录主程序版本，返回插件版本
+ */
+inline int negotiateAbiVersion(int host_abi_version) {
+  hostAbiVersion().store(std::max(1, std::min(host_abi_version, ALGO_ABI_VERSION)),
+                         std::memory_order_relaxed);
+  return ALGO_ABI_VERSION;
+}
+
+/**
+ * @brief 按协商版本解释主程序传入的 AlgoTensor
+ *
+ * 版本 1 的主程序只分配到 size 为止：拷贝这部分到 scratch，追加字段取默认值。
+ * @return 可安全读取全部字段的 Tensor（input 本身或 scratch）
+ */
+inline const AlgoTensor* hostTensor(const AlgoTensor* input, AlgoTensor* scratch) {
+  if (!input || hostAbiVersion().load(std::memory_order_relaxed) >= 2) {
+    return input;
+  }
+  *scratch = AlgoTensor();
+  std::memcpy(static_cast<void*>(scratch), input, offsetof(AlgoTensor, pixel_format));
+  return scratch;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "plugin/algo_plugin_base.h"
+#include "plugin/plugin_registry.h"
 #include "utils/one_logger.hpp"
 #include <string>
 #include <vector>
@@ -61,6 +62,15 @@ class PluginLoader {
   std::vector<std::shared_ptr<AlgoPluginBase>> loadPluginsFromDir(
       const std::string& plugin_dir);
   
+  /**
+   * @brief 创建所有静态链接进主程序的插件（INFER_FRAME_STATIC_PLUGINS）
+   * 
+   * 与动态插件一起按名称管理；同名的动态插件已加载时跳过静态版本。
+   * 
+   * @return 成功创建的插件列表
+   */
+  std::vector<std::shared_ptr<AlgoPluginBase>> loadStaticPlugins();
+  
   /**
    * @brief 卸载指定插件
    * 
@@ -88,14 +98,32 @@ class PluginLoader {
    */
   std::shared_ptr<AlgoPluginBase> getPlugin(const std::string& plugin_name);
   
+  /**
+   * @brief 按具体类型获取静态链接的插件
+   * 
+   * 返回具体类型的指针：Plugin 声明为 final 时，经它的 infer / inferBatch 调用是直接调用，
+   * 开启 LTO 时可以内联进调用方（经 AlgoPluginBase 的调用仍是虚调用）。
+   * 
+   * @code
+   * loader.loadStaticPlugins();
+   * auto yolo = loader.getStaticPlugin<YOLOv8Plugin>("YOLOv8");
+   * yolo->infer(inputs, outputs);  // 不经虚表
+   * @endcode
+   * 
+   * @return 未找到、不是静态插件或类型不符时返回 nullptr
+   */
+  template <typename Plugin>
+  std::shared_ptr<Plugin> getStaticPlugin(const std::string& plugin_name);
+  
  private:
   /**
    * @brief 插件句柄信息
    */
   struct PluginHandle {
-    void* dl_handle;                           // dlopen 返回的句柄
+    void* dl_handle;                           // dlopen 返回的句柄（静态插件为 nullptr）
     std::shared_ptr<AlgoPluginBase> instance;  // 插件实例
     std::string path;                          // 插件文件路径
+    const void* type_tag = nullptr;            // 静态插件的具体类型（staticPluginTypeTag）
   };
   
   std::map<std::string, PluginHandle> loaded_plugins_;  // 已加载的插件
@@ -196,6 +224,43 @@ PluginLoader::loadPluginsFromDir(const std::string& plugin_dir) {
   return plugins;
 }
 
+inline std::vector<std::shared_ptr<AlgoPluginBase>> PluginLoader::loadStaticPlugins() {
+  std::vector<std::shared_ptr<AlgoPluginBase>> plugins;
+  auto factories = StaticPluginRegistry::instance().factories();
+  
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& factory : factories) {
+    try {
+      auto plugin = factory.create();
+      if (!plugin) {
+        LOG_ERROR("Static plugin factory returned nullptr: {}", factory.class_name);
+        continue;
+      }
+      
+      auto info = plugin->getInfo();
+      if (loaded_plugins_.count(info.name)) {
+        LOG_WARN("Plugin {} already loaded, skip static version", info.name);
+        continue;
+      }
+      LOG_INFO("Static plugin loaded: {} v{} ({})", info.name, info.version,
+               factory.class_name);
+      
+      PluginHandle handle;
+      handle.dl_handle = nullptr;
+      handle.instance = plugin;
+      handle.path = "static:" + factory.class_name;
+      handle.type_tag = factory.type_tag;
+      loaded_plugins_[info.name] = handle;
+      plugins.push_back(plugin);
+    } catch (const std::exception& e) {
+      LOG_ERROR("Exception while creating static plugin {}: {}", factory.class_name,
+                e.what());
+    }
+  }
+  
+  return plugins;
+}
+
 inline bool PluginLoader::unloadPlugin(const std::string& plugin_name) {
   std::lock_guard<std::mutex> lock(mutex_);
   
@@ -256,6 +321,18 @@ inline std::shared_ptr<AlgoPluginBase> PluginLoader::getPlugin(
   return nullptr;
 }
 
+template <typename Plugin>
+std::shared_ptr<Plugin> PluginLoader::getStaticPlugin(const std::string& plugin_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end() || it->second.type_tag != staticPluginTypeTag<Plugin>()) {
+    return nullptr;
+  }
+  
+  return std::static_pointer_cast<Plugin>(it->second.instance);
+}
+
 inline bool PluginLoader::isValidPluginFile(const std::string& filename) const {
   // 检查文件扩展名是否为 .so
   return filename.size() > 3 && 
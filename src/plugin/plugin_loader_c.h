@@ -1,14 +1,17 @@
 #pragma once
 
+#include "plugin/algo_det_soa.h"
 #include "plugin/algo_plugin_interface.h"
 #include "utils/one_logger.hpp"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <dlfcn.h>
+#include <sys/stat.h>
 
 namespace infer_frame {
 namespace plugin {
@@ -59,7 +62,7 @@ class PluginLoaderC {
    * @param plugin_name 插件名称
    * @return 插件信息，未找到返回 nullptr
    */
-  const AlgoInfo* getPluginInfo(const std::string& plugin_name);
+  const ::AlgoInfo* getPluginInfo(const std::string& plugin_name);
   
   /**
    * @brief 创建算法实例
@@ -88,6 +91,84 @@ class PluginLoaderC {
   AlgoStatus inferDetection(AlgoHandle handle, const std::string& plugin_name,
                            const AlgoTensor* input, AlgoDetResult* result);
   
+  /**
+   * @brief 释放检测结果（由插件分配的内存必须由插件释放）
+   * @param plugin_name 插件名称
+   * @param result 检测结果
+   */
+  void freeDetResult(const std::string& plugin_name, AlgoDetResult* result);
+  
+  /**
+   * @brief 执行推理（紧凑检测结果，数组由调用者分配）
+   *
+   * 插件导出 AlgoInferDetectionSoA 时直接写入调用者的数组；只导出 AlgoInferDetection 时
+   * 取旧格式结果转换后立即交还插件释放。
+   * @return 容量不足时回填 num_boxes 并返回 ALGO_STATUS_ERROR_BUFFER_TOO_SMALL
+   */
+  AlgoStatus inferDetectionSoA(AlgoHandle handle, const std::string& plugin_name,
+                               const AlgoTensor* input, AlgoDetSoA* result);
+  
+  /**
+   * @brief 插件发布的类别名称表（协商 ABI 版本 < 3 的插件没有该字段，返回空表）
+   */
+  ClassNameTable getClassNames(const std::string& plugin_name);
+  
+  /**
+   * @brief 在线更新算法参数（可选接口）
+   * @return 插件未实现时返回 ALGO_STATUS_ERROR_NOT_SUPPORTED，
+   *         参数需要重新加载模型时返回 ALGO_STATUS_ERROR_RELOAD_REQUIRED
+   */
+  AlgoStatus setParams(AlgoHandle handle, const std::string& plugin_name,
+                       const char* config_json);
+  
+  /**
+   * @brief 获取累计性能计数（可选接口）
+   * @return 插件未实现时返回 ALGO_STATUS_ERROR_NOT_SUPPORTED
+   */
+  AlgoStatus getStats(AlgoHandle handle, const std::string& plugin_name, AlgoStats* stats);
+  
+  /**
+   * @brief 查询输入能力（可选接口）
+   * @return 插件未实现时返回 nullptr（按 BGR UINT8 送帧）
+   */
+  const AlgoInputCaps* getInputCaps(AlgoHandle handle, const std::string& plugin_name);
+  
+  /**
+   * @brief 查询原始输出 Tensor 信息（可选接口）
+   * @param outputs 输出描述数组
+   * @param num_outputs 输入为数组容量，输出为实际数量
+   * @return 插件未实现时返回 ALGO_STATUS_ERROR_NOT_SUPPORTED
+   */
+  AlgoStatus getOutputInfo(AlgoHandle handle, const std::string& plugin_name,
+                           AlgoTensor* outputs, int* num_outputs);
+  
+  /**
+   * @brief 通用 Tensor 推理（可选接口，输出缓冲由调用者分配）
+   */
+  AlgoStatus inferTensors(AlgoHandle handle, const std::string& plugin_name,
+                          const AlgoTensor* inputs, int num_inputs,
+                          AlgoTensor* outputs, int num_outputs);
+  
+  /**
+   * @brief 类型化推理（可选接口，结果缓冲由调用者分配）
+   */
+  AlgoStatus inferClassification(AlgoHandle handle, const std::string& plugin_name,
+                                 const AlgoTensor* input, AlgoClsResult* result);
+  AlgoStatus inferSegmentation(AlgoHandle handle, const std::string& plugin_name,
+                               const AlgoTensor* input, AlgoSegResult* result);
+  AlgoStatus inferPose(AlgoHandle handle, const std::string& plugin_name,
+                       const AlgoTensor* input, AlgoPoseResult* result);
+  AlgoStatus inferOcr(AlgoHandle handle, const std::string& plugin_name,
+                      const AlgoTensor* input, AlgoOcrResult* result);
+  AlgoStatus inferTrack(AlgoHandle handle, const std::string& plugin_name,
+                        const AlgoTensor* input, AlgoTrackResult* result);
+  
+  /**
+   * @brief 插件是否导出指定符号（用于按能力选择调用路径）
+   * @param symbol 导出函数名，如 "AlgoInferTensors"
+   */
+  bool hasFunction(const std::string& plugin_name, const std::string& symbol);
+  
   /**
    * @brief 反初始化算法
    * @param handle 算法句柄
@@ -112,13 +193,28 @@ class PluginLoaderC {
     std::string path;       // 插件文件路径
     
     // 函数指针（参考 VSE）
-    const AlgoInfo* (*getInfo)();
+    const ::AlgoInfo* (*getInfo)();
     AlgoHandle (*create)();
     AlgoStatus (*init)(AlgoHandle, const AlgoInitParam*);
     AlgoStatus (*inferDetection)(AlgoHandle, const AlgoTensor*, AlgoDetResult*);
     AlgoStatus (*deinit)(AlgoHandle);
     void (*destroy)(AlgoHandle);
     void (*freeDetResult)(AlgoDetResult*);
+    
+    int abi_version;        // 协商后的 ABI 版本（未导出 AlgoNegotiateAbiVersion 时为 1）
+    
+    // 可选函数（未导出时为 nullptr）
+    const AlgoInputCaps* (*getInputCaps)(AlgoHandle);
+    AlgoStatus (*getStats)(AlgoHandle, AlgoStats*);
+    AlgoStatus (*setParams)(AlgoHandle, const char*);
+    AlgoStatus (*getOutputInfo)(AlgoHandle, AlgoTensor*, int*);
+    AlgoStatus (*inferTensors)(AlgoHandle, const AlgoTensor*, int, AlgoTensor*, int);
+    AlgoStatus (*inferClassification)(AlgoHandle, const AlgoTensor*, AlgoClsResult*);
+    AlgoStatus (*inferSegmentation)(AlgoHandle, const AlgoTensor*, AlgoSegResult*);
+    AlgoStatus (*inferPose)(AlgoHandle, const AlgoTensor*, AlgoPoseResult*);
+    AlgoStatus (*inferOcr)(AlgoHandle, const AlgoTensor*, AlgoOcrResult*);
+    AlgoStatus (*inferTrack)(AlgoHandle, const AlgoTensor*, AlgoTrackResult*);
+    AlgoStatus (*inferDetectionSoA)(AlgoHandle, const AlgoTensor*, AlgoDetSoA*);
   };
   
   std::map<std::string, PluginHandle> loaded_plugins_;
@@ -133,6 +229,11 @@ class PluginLoaderC {
    * @brief 从 .so 文件中加载函数指针
    */
   bool loadFunctions(PluginHandle& handle);
+  
+  /**
+   * @brief 解析单个符号，未导出时返回 nullptr（不影响后续 dlerror 判断）
+   */
+  static void* loadSymbol(void* dl_handle, const char* symbol);
 };
 
 // ============================================================================
@@ -170,7 +271,7 @@ inline bool PluginLoaderC::loadPlugin(const std::string& plugin_path) {
   }
   
   // 获取插件信息
-  const AlgoInfo* info = handle.getInfo();
+  const ::AlgoInfo* info = handle.getInfo();
   if (!info) {
     LOG_ERROR("Failed to get plugin info");
     dlclose(handle.dl_handle);
@@ -180,7 +281,8 @@ inline bool PluginLoaderC::loadPlugin(const std::string& plugin_path) {
   std::string plugin_name = info->name;
   loaded_plugins_[plugin_name] = handle;
   
-  LOG_INFO("Plugin loaded successfully: {} v{}", info->name, info->version);
+  LOG_INFO("Plugin loaded successfully: {} v{} (ABI {})", info->name, info->version,
+           handle.abi_version);
   return true;
 }
 
@@ -224,7 +326,7 @@ inline std::vector<std::string> PluginLoaderC::getLoadedPlugins() const {
   return names;
 }
 
-inline const AlgoInfo* PluginLoaderC::getPluginInfo(const std::string& plugin_name) {
+inline const ::AlgoInfo* PluginLoaderC::getPluginInfo(const std::string& plugin_name) {
   std::lock_guard<std::mutex> lock(mutex_);
   
   auto it = loaded_plugins_.find(plugin_name);
@@ -268,9 +370,234 @@ inline AlgoStatus PluginLoaderC::inferDetection(AlgoHandle handle, const std::st
     return ALGO_STATUS_ERROR_INVALID_PARAM;
   }
   
+  if (!it->second.inferDetection) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
   return it->second.inferDetection(handle, input, result);
 }
 
+inline void PluginLoaderC::freeDetResult(const std::string& plugin_name, AlgoDetResult* result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end() || !it->second.freeDetResult) {
+    return;
+  }
+  
+  it->second.freeDetResult(result);
+}
+
+inline AlgoStatus PluginLoaderC::setParams(AlgoHandle handle, const std::string& plugin_name,
+                                           const char* config_json) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.setParams) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.setParams(handle, config_json);
+}
+
+inline AlgoStatus PluginLoaderC::getStats(AlgoHandle handle, const std::string& plugin_name,
+                                          AlgoStats* stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.getStats) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.getStats(handle, stats);
+}
+
+inline const AlgoInputCaps* PluginLoaderC::getInputCaps(AlgoHandle handle,
+                                                       const std::string& plugin_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end() || !it->second.getInputCaps) {
+    return nullptr;
+  }
+  
+  return it->second.getInputCaps(handle);
+}
+
+inline AlgoStatus PluginLoaderC::getOutputInfo(AlgoHandle handle, const std::string& plugin_name,
+                                               AlgoTensor* outputs, int* num_outputs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.getOutputInfo) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.getOutputInfo(handle, outputs, num_outputs);
+}
+
+inline AlgoStatus PluginLoaderC::inferTensors(AlgoHandle handle, const std::string& plugin_name,
+                                              const AlgoTensor* inputs, int num_inputs,
+                                              AlgoTensor* outputs, int num_outputs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.inferTensors) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.inferTensors(handle, inputs, num_inputs, outputs, num_outputs);
+}
+
+inline AlgoStatus PluginLoaderC::inferClassification(AlgoHandle handle,
+                                                     const std::string& plugin_name,
+                                                     const AlgoTensor* input,
+                                                     AlgoClsResult* result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.inferClassification) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.inferClassification(handle, input, result);
+}
+
+inline AlgoStatus PluginLoaderC::inferSegmentation(AlgoHandle handle,
+                                                   const std::string& plugin_name,
+                                                   const AlgoTensor* input,
+                                                   AlgoSegResult* result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.inferSegmentation) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.inferSegmentation(handle, input, result);
+}
+
+inline AlgoStatus PluginLoaderC::inferPose(AlgoHandle handle, const std::string& plugin_name,
+                                           const AlgoTensor* input, AlgoPoseResult* result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.inferPose) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.inferPose(handle, input, result);
+}
+
+inline AlgoStatus PluginLoaderC::inferOcr(AlgoHandle handle, const std::string& plugin_name,
+                                          const AlgoTensor* input, AlgoOcrResult* result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.inferOcr) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.inferOcr(handle, input, result);
+}
+
+inline AlgoStatus PluginLoaderC::inferDetectionSoA(AlgoHandle handle,
+                                                   const std::string& plugin_name,
+                                                   const AlgoTensor* input, AlgoDetSoA* result) {
+  if (!validDetSoA(result)) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  const PluginHandle& plugin = it->second;
+  if (plugin.inferDetectionSoA) {
+    return plugin.inferDetectionSoA(handle, input, result);
+  }
+  if (!plugin.inferDetection) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  // 旧插件：结果由插件分配，转换后在同一把锁内交还插件释放
+  AlgoDetResult legacy = {};
+  AlgoStatus status = plugin.inferDetection(handle, input, &legacy);
+  if (status == ALGO_STATUS_SUCCESS) {
+    status = legacyToDetSoA(legacy, result);
+  }
+  if (legacy.boxes) {
+    plugin.freeDetResult(&legacy);
+  }
+  return status;
+}
+
+inline ClassNameTable PluginLoaderC::getClassNames(const std::string& plugin_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  // ABI 版本 3 之前的 AlgoInfo 没有 class_names / num_classes 字段，不能读取
+  if (it == loaded_plugins_.end() || it->second.abi_version < 3) {
+    return {};
+  }
+  const ::AlgoInfo* info = it->second.getInfo();
+  if (!info || !info->class_names || info->num_classes <= 0) {
+    return {};
+  }
+  return {info->class_names, info->num_classes};
+}
+
+inline AlgoStatus PluginLoaderC::inferTrack(AlgoHandle handle, const std::string& plugin_name,
+                                            const AlgoTensor* input, AlgoTrackResult* result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (!it->second.inferTrack) {
+    return ALGO_STATUS_ERROR_NOT_SUPPORTED;
+  }
+  
+  return it->second.inferTrack(handle, input, result);
+}
+
+inline bool PluginLoaderC::hasFunction(const std::string& plugin_name, const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  
+  auto it = loaded_plugins_.find(plugin_name);
+  if (it == loaded_plugins_.end()) {
+    return false;
+  }
+  
+  return loadSymbol(it->second.dl_handle, symbol.c_str()) != nullptr;
+}
+
 inline AlgoStatus PluginLoaderC::deinitAlgo(AlgoHandle handle, const std::string& plugin_name) {
   std::lock_guard<std::mutex> lock(mutex_);
   
@@ -298,25 +625,57 @@ inline bool PluginLoaderC::fileExists(const std::string& path) const {
   return (stat(path.c_str(), &buffer) == 0);
 }
 
+inline void* PluginLoaderC::loadSymbol(void* dl_handle, const char* symbol) {
+  dlerror();  // 清除之前的错误状态
+  void* fn = dlsym(dl_handle, symbol);
+  if (dlerror() != nullptr) {
+    return nullptr;
+  }
+  return fn;
+}
+
 inline bool PluginLoaderC::loadFunctions(PluginHandle& handle) {
-  // 加载所有必需的函数（参考 VSE）
-  handle.getInfo = (decltype(handle.getInfo))dlsym(handle.dl_handle, "AlgoGetInfo");
-  handle.create = (decltype(handle.create))dlsym(handle.dl_handle, "AlgoCreate");
-  handle.init = (decltype(handle.init))dlsym(handle.dl_handle, "AlgoInit");
-  handle.inferDetection = (decltype(handle.inferDetection))dlsym(handle.dl_handle, "AlgoInferDetection");
-  handle.deinit = (decltype(handle.deinit))dlsym(handle.dl_handle, "AlgoDeinit");
-  handle.destroy = (decltype(handle.destroy))dlsym(handle.dl_handle, "AlgoDestroy");
-  handle.freeDetResult = (decltype(handle.freeDetResult))dlsym(handle.dl_handle, "AlgoFreeDetResult");
-  
-  const char* dlsym_error = dlerror();
-  if (dlsym_error) {
-    LOG_ERROR("Cannot load symbols: {}", dlsym_error);
+  // 生命周期函数必须导出（参考 VSE）
+  handle.getInfo = (decltype(handle.getInfo))loadSymbol(handle.dl_handle, "AlgoGetInfo");
+  handle.create = (decltype(handle.create))loadSymbol(handle.dl_handle, "AlgoCreate");
+  handle.init = (decltype(handle.init))loadSymbol(handle.dl_handle, "AlgoInit");
+  handle.deinit = (decltype(handle.deinit))loadSymbol(handle.dl_handle, "AlgoDeinit");
+  handle.destroy = (decltype(handle.destroy))loadSymbol(handle.dl_handle, "AlgoDestroy");
+  
+  if (!handle.getInfo || !handle.create || !handle.init || !handle.deinit || !handle.destroy) {
+    LOG_ERROR("Missing required functions in plugin");
     return false;
   }
   
-  if (!handle.getInfo || !handle.create || !handle.init || 
-      !handle.inferDetection || !handle.deinit || !handle.destroy) {
-    LOG_ERROR("Missing required functions in plugin");
+  // 声明主程序的 ABI 版本，插件据此解释传入的结构体
+  auto negotiate = (int (*)(int))loadSymbol(handle.dl_handle, "AlgoNegotiateAbiVersion");
+  handle.abi_version = negotiate ? std::min(negotiate(ALGO_ABI_VERSION), ALGO_ABI_VERSION) : 1;
+  
+  // 推理函数按算法类型导出，逐个解析
+  handle.inferDetection = (decltype(handle.inferDetection))loadSymbol(handle.dl_handle, "AlgoInferDetection");
+  handle.freeDetResult = (decltype(handle.freeDetResult))loadSymbol(handle.dl_handle, "AlgoFreeDetResult");
+  handle.getInputCaps = (decltype(handle.getInputCaps))loadSymbol(handle.dl_handle, "AlgoGetInputCaps");
+  handle.setParams = (decltype(handle.setParams))loadSymbol(handle.dl_handle, "AlgoSetParams");
+  handle.getStats = (decltype(handle.getStats))loadSymbol(handle.dl_handle, "AlgoGetStats");
+  handle.getOutputInfo = (decltype(handle.getOutputInfo))loadSymbol(handle.dl_handle, "AlgoGetOutputInfo");
+  handle.inferTensors = (decltype(handle.inferTensors))loadSymbol(handle.dl_handle, "AlgoInferTensors");
+  handle.inferClassification = (decltype(handle.inferClassification))loadSymbol(handle.dl_handle, "AlgoInferClassification");
+  handle.inferSegmentation = (decltype(handle.inferSegmentation))loadSymbol(handle.dl_handle, "AlgoInferSegmentation");
+  handle.inferPose = (decltype(handle.inferPose))loadSymbol(handle.dl_handle, "AlgoInferPose");
+  handle.inferOcr = (decltype(handle.inferOcr))loadSymbol(handle.dl_handle, "AlgoInferOcr");
+  handle.inferTrack = (decltype(handle.inferTrack))loadSymbol(handle.dl_handle, "AlgoInferTrack");
+  handle.inferDetectionSoA = (decltype(handle.inferDetectionSoA))loadSymbol(
+      handle.dl_handle, "AlgoInferDetectionSoA");
+  
+  if (handle.inferDetection && !handle.freeDetResult) {
+    LOG_ERROR("Plugin exports AlgoInferDetection without AlgoFreeDetResult");
+    return false;
+  }
+  
+  if (!handle.inferDetection && !handle.inferTensors && !handle.inferClassification &&
+      !handle.inferSegmentation && !handle.inferPose && !handle.inferOcr &&
+      !handle.inferTrack && !handle.inferDetectionSoA) {
+    LOG_ERROR("Plugin exports no inference function");
     return false;
   }
   
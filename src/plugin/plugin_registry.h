@@ -2,18 +2,101 @@
 
 #include "plugin/algo_plugin_base.h"
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 /**
  * @file plugin_registry.h
  * @brief 插件注册宏定义
  * 
  * 每个算法插件必须使用 REGISTER_ALGO_PLUGIN 宏来注册。
- * 该宏会生成导出函数 createAlgoPlugin，供 PluginLoader 调用。
+ * - 动态模式（默认）：生成导出函数 createAlgoPlugin，供 PluginLoader 通过 dlsym 调用
+ * - 静态模式（编译定义 INFER_FRAME_STATIC_PLUGIN）：插件直接链接进主程序，
+ *   宏改为在 StaticPluginRegistry 中登记工厂函数，由 PluginLoader::loadStaticPlugins 创建
+ *
+ * 静态模式下多个插件链接进同一个程序，不再导出同名的 createAlgoPlugin。
+ * 登记时同时记录插件的具体类型，主程序可用 PluginLoader::getStaticPlugin<T>() 取回
+ * 具体类型的实例：插件类声明为 final 时，经具体类型的调用不再是虚调用。
  */
 
 namespace infer_frame {
 namespace plugin {
 
+/**
+ * @brief 插件具体类型的标识（每个类型一个静态对象的地址，不依赖 RTTI）
+ */
+template <typename Plugin>
+const void* staticPluginTypeTag() {
+  static const char tag = 0;
+  return &tag;
+}
+
+/**
+ * @brief 静态链接插件的工厂
+ */
+struct StaticPluginFactory {
+  std::string class_name;
+  CreateAlgoPluginFunc create;
+  const void* type_tag;                // staticPluginTypeTag<插件类>()
+};
+
+/**
+ * @brief 静态链接插件的工厂登记表
+ *
+ * 登记发生在静态初始化阶段（main 之前），之后只读。
+ */
+class StaticPluginRegistry {
+ public:
+  static StaticPluginRegistry& instance() {
+    static StaticPluginRegistry registry;
+    return registry;
+  }
+
+  void add(const char* class_name, CreateAlgoPluginFunc create, const void* type_tag) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    factories_.push_back({class_name, create, type_tag});
+  }
+
+  /**
+   * @brief 已登记的工厂列表
+   */
+  std::vector<StaticPluginFactory> factories() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return factories_;
+  }
+
+ private:
+  StaticPluginRegistry() = default;
+
+  std::vector<StaticPluginFactory> factories_;
+  mutable std::mutex mutex_;
+};
+
+/**
+ * @brief 静态初始化时登记工厂函数
+ */
+struct StaticPluginRegistrar {
+  StaticPluginRegistrar(const char* class_name, CreateAlgoPluginFunc create,
+                        const void* type_tag) {
+    StaticPluginRegistry::instance().add(class_name, create, type_tag);
+  }
+};
+
+#define INFER_FRAME_PLUGIN_CONCAT_IMPL(a, b) a##b
+#define INFER_FRAME_PLUGIN_CONCAT(a, b) INFER_FRAME_PLUGIN_CONCAT_IMPL(a, b)
+
+#define INFER_FRAME_STATIC_PLUGIN_REGISTER(plugin_class) \
+  namespace { \
+  const infer_frame::plugin::StaticPluginRegistrar \
+      INFER_FRAME_PLUGIN_CONCAT(static_plugin_registrar_, __LINE__)( \
+          #plugin_class, \
+          []() -> std::shared_ptr<infer_frame::plugin::AlgoPluginBase> { \
+            return std::make_shared<plugin_class>(); \
+          }, \
+          infer_frame::plugin::staticPluginTypeTag<plugin_class>()); \
+  }
+
 /**
  * @brief 插件注册宏
  * 
@@ -30,6 +113,15 @@ namespace plugin {
  * 
  * @param plugin_class 插件类名
  */
+#if defined(INFER_FRAME_STATIC_PLUGIN)
+
+#define REGISTER_ALGO_PLUGIN(plugin_class) INFER_FRAME_STATIC_PLUGIN_REGISTER(plugin_class)
+
+#define REGISTER_ALGO_PLUGIN_WITH_VERSION(plugin_class, major_ver, minor_ver, patch_ver) \
+  INFER_FRAME_STATIC_PLUGIN_REGISTER(plugin_class)
+
+#else
+
 #define REGISTER_ALGO_PLUGIN(plugin_class) \
   extern "C" { \
     std::shared_ptr<infer_frame::plugin::AlgoPluginBase> createAlgoPlugin() { \
@@ -58,5 +150,7 @@ namespace plugin {
     } \
   }
 
+#endif  // INFER_FRAME_STATIC_PLUGIN
+
 }  // namespace plugin
 }  // namespace infer_frame
@@ -0,0 +1,897 @@
+#pragma once
+
+#include "plugin/algo_plugin_interface.h"
+#include "plugin/sandbox_shm.h"
+#include "utils/one_logger.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace infer_frame {
+namespace plugin {
+
+/**
+ * @brief 插件沙箱配置
+ */
+struct PluginSandboxConfig {
+  std::string worker_path;             // worker 可执行文件，空则取主程序同目录下的 infer_frame_plugin_worker
+  uint32_t num_slots = 4;              // 共享内存帧槽数量（同时在途的帧数）
+  size_t input_capacity = 3840 * 2160 * 3;  // 单帧输入最大字节数
+  uint32_t max_boxes = 1024;           // 单帧最多返回的检测框
+  int spin_us = 50;                    // 主进程等待结果时，转入 futex 休眠前的自旋时间
+  int worker_spin_us = 200;            // worker 空闲后的自旋时间，连续帧到达时避免 futex 唤醒延迟
+  int worker_cpu = -1;                 // worker 绑定的 CPU 核（与送帧线程分开），-1 不绑定
+  int liveness_check_ms = 20;          // 等待期间检查 worker 存活的间隔
+  int infer_timeout_ms = 10000;        // 单帧在 worker 中处理超过该时间视为卡死，杀掉并重启 worker；0 不限
+  int init_timeout_ms = 120000;        // 模型加载超时（超时后同样杀掉并重启 worker）
+  int max_restarts = 5;                // restart_window_sec 内最多重启次数
+  int restart_window_sec = 60;
+};
+
+/**
+ * @brief 主进程侧直接写入的共享内存帧（零拷贝路径）
+ */
+struct SandboxFrame {
+  int slot = -1;                       // Slot 索引，-1 表示获取失败
+  void* data = nullptr;                // 可直接写入的输入缓冲
+  size_t capacity = 0;                 // 缓冲字节数
+
+  bool valid() const { return slot >= 0; }
+};
+
+/**
+ * @brief 沙箱统计信息
+ */
+struct SandboxStats {
+  uint64_t frames = 0;                 // 完成的帧数
+  uint64_t zero_copy_frames = 0;       // 走零拷贝路径的帧数
+  uint64_t copied_bytes = 0;           // 回退路径拷贝的字节数
+  uint64_t restarts = 0;               // worker 重启次数
+  uint64_t failed_frames = 0;          // 失败的帧（含因 worker 崩溃 / 卡死丢失的帧）
+  uint64_t hung_frames = 0;            // 超过 infer_timeout_ms 未完成、worker 被杀掉的帧
+  double avg_overhead_us = 0.0;        // 平均每帧隔离开销（往返时间 - 插件耗时）
+  double max_overhead_us = 0.0;
+};
+
+/**
+ * @brief 进程外插件沙箱（架构 §5.1 故障隔离）
+ *
+ * 每个 PluginSandbox 对应一个 worker 进程，worker 内部通过 PluginLoaderC
+ * 加载插件 .so。插件崩溃只会杀死 worker，沙箱检测到后自动重启 worker
+ * 并重放初始化参数，其他摄像头不受影响。插件卡死（死锁、死循环）时，单帧处理超过
+ * infer_timeout_ms 即杀掉 worker 并按同样的限频策略重启，该帧返回 ALGO_STATUS_ERROR_INFERENCE；
+ * 初始化 / 参数更新期间 worker 退出或超时也走同一条重启路径。
+ *
+ * 帧通过 memfd 共享内存环传递：
+ * - 零拷贝：acquireFrame() 返回共享内存中的缓冲，解码器直接写入后调用 inferDetection()
+ * - 兼容：传入普通 AlgoTensor 时退化为一次 memcpy
+ *
+ * 隔离开销（往返时间 - 插件耗时）来自两次进程间交接。多核上两端先自旋再休眠，只在对方
+ * 已经休眠时才发 FUTEX_WAKE，worker 可用 worker_cpu 绑到独立的核，连续送帧时交接只是一次
+ * 缓存行传递；单核上自旋关闭，每帧两次 futex 唤醒加调度切换，1 vCPU 实测约 18~25 us。
+ * 多核数据由 plugin_sandbox_bench 测量（输出核数与是否自旋）：数微秒的目标只在多核自旋路径上
+ * 成立，单核是有意保留的偏差。对每帧数毫秒的推理都可以忽略，但不适合微秒级的小模型。
+ *
+ * 使用示例:
+ * @code
+ * PluginSandbox sandbox;
+ * sandbox.start("./algorithm/yolov8_plugin.so");
+ * sandbox.init(&init_param);
+ *
+ * SandboxFrame frame = sandbox.acquireFrame();
+ * decodeInto(frame.data, frame.capacity);          // 解码器直接写共享内存
+ * AlgoTensor input = makeTensor(frame.data, ...);
+ * AlgoDetResult result;
+ * sandbox.inferDetection(&input, &result);         // 自动识别零拷贝帧
+ * sandbox.freeDetResult(&result);
+ * @endcode
+ */
+class PluginSandbox {
+ public:
+  explicit PluginSandbox(const PluginSandboxConfig& config = PluginSandboxConfig());
+  ~PluginSandbox();
+
+  // 禁止拷贝和赋值
+  PluginSandbox(const PluginSandbox&) = delete;
+  PluginSandbox& operator=(const PluginSandbox&) = delete;
+
+  /**
+   * @brief 创建共享内存并启动 worker 进程
+   * @param plugin_path 插件 .so 文件路径
+   * @return 是否成功
+   */
+  bool start(const std::string& plugin_path);
+
+  /**
+   * @brief 初始化算法（worker 确认初始化成功后参数才会被保存，worker 重启后自动重放）
+   * @param param 初始化参数
+   * @return 状态码（worker 上报的初始化结果）
+   */
+  AlgoStatus init(const AlgoInitParam* param);
+
+  /**
+   * @brief 在线更新算法参数（不重启 worker、不重新加载模型）
+   *
+   * 更新会被记录，worker 崩溃重启后在初始化之后依次重放。
+   * @return 插件不支持在线更新时返回 ALGO_STATUS_ERROR_NOT_SUPPORTED，
+   *         参数需要重新加载模型时返回 ALGO_STATUS_ERROR_RELOAD_REQUIRED
+   */
+  AlgoStatus setParams(const char* config_json);
+
+  /**
+   * @brief 插件输入能力（init 成功后由 worker 上报）
+   * @return 插件未声明时返回 nullptr
+   */
+  const AlgoInputCaps* getInputCaps() const;
+
+  /**
+   * @brief 获取一个共享内存帧缓冲，调用者直接写入帧数据
+   * @return 帧缓冲，无空闲 Slot 时 valid() 为 false
+   */
+  SandboxFrame acquireFrame();
+
+  /**
+   * @brief 归还未提交的帧缓冲
+   */
+  void releaseFrame(const SandboxFrame& frame);
+
+  /**
+   * @brief 执行推理
+   *
+   * input->data 指向 acquireFrame() 返回的缓冲时走零拷贝路径，
+   * 否则拷贝到空闲 Slot。结果由 freeDetResult() 释放。
+   * 零拷贝帧无论成功与否都会被归还，调用者不需要再 releaseFrame()。
+   */
+  AlgoStatus inferDetection(const AlgoTensor* input, AlgoDetResult* result);
+
+  /**
+   * @brief 释放 inferDetection 返回的检测结果
+   */
+  void freeDetResult(AlgoDetResult* result);
+
+  /**
+   * @brief 通知 worker 退出并回收共享内存
+   */
+  void stop();
+
+  /**
+   * @brief worker 是否在运行
+   */
+  bool isRunning() const { return running_.load(); }
+
+  /**
+   * @brief 插件名称（由 worker 加载插件后上报）
+   */
+  std::string getPluginName() const;
+
+  SandboxStats getStats() const;
+
+  void resetStats();
+
+ private:
+  PluginSandboxConfig config_;
+  std::string plugin_path_;
+
+  int shm_fd_ = -1;
+  size_t shm_size_ = 0;
+  sandbox::ShmHeader* header_ = nullptr;
+  pid_t worker_pid_ = -1;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> failed_{false};    // 重启次数超限，放弃
+  std::atomic<uint32_t> generation_{0};
+  std::atomic<uint64_t> seq_{0};
+
+  // 保存的初始化参数（重启后重放）；has_init_param_ 在推理路径上无锁读取
+  std::atomic<bool> has_init_param_{false};
+  std::string model_path_;
+  std::string config_json_;
+  bool has_config_json_ = false;
+  AlgoBackendType backend_ = ALGO_BACKEND_UNKNOWN;
+  int device_id_ = 0;
+  std::vector<std::string> param_updates_;  // init 之后成功应用的在线参数更新
+
+  std::vector<AlgoInputFormat> input_formats_;
+  AlgoInputCaps input_caps_{};
+
+  mutable std::mutex restart_mutex_;   // 保护 worker 重启与初始化
+  std::deque<int64_t> restart_times_;
+
+  mutable std::mutex stats_mutex_;
+  SandboxStats stats_;
+  double total_overhead_us_ = 0.0;
+
+  bool createShm();
+  bool spawnWorker();
+  void reapWorker(int timeout_ms);
+  AlgoStatus sendInit();
+  AlgoStatus sendSetParams(const std::string& config_json);
+  AlgoStatus waitCtrl(int timeout_ms);
+  void ringDoorbell();
+  int findSlotByData(const void* data) const;
+  void releaseSlotOf(const void* data);
+  int acquireSlot();
+  void checkWorker(uint32_t observed_generation, bool hung);
+  void handleWorkerExit(int wstatus);
+  void restartWorker();
+  void recordFrame(int64_t roundtrip_ns, int64_t worker_ns, bool zero_copy, size_t copied);
+  std::string resolveWorkerPath() const;
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline PluginSandbox::PluginSandbox(const PluginSandboxConfig& config) : config_(config) {
+  if (config_.num_slots == 0) {
+    config_.num_slots = 1;
+  }
+  // 单核上主进程与 worker 抢同一个 CPU，自旋只会推迟对方运行
+  if (std::thread::hardware_concurrency() <= 1) {
+    config_.spin_us = 0;
+    config_.worker_spin_us = 0;
+  }
+}
+
+inline PluginSandbox::~PluginSandbox() {
+  stop();
+}
+
+inline bool PluginSandbox::start(const std::string& plugin_path) {
+  std::lock_guard<std::mutex> lock(restart_mutex_);
+
+  if (running_.load()) {
+    LOG_WARN("Plugin sandbox already running: {}", plugin_path_);
+    return false;
+  }
+
+  plugin_path_ = plugin_path;
+  if (!createShm()) {
+    return false;
+  }
+
+  if (!spawnWorker()) {
+    return false;
+  }
+
+  running_.store(true);
+  failed_.store(false);
+  LOG_INFO("Plugin sandbox started: {} (pid {}, {} slots, {} MB shm)",
+           plugin_path_, worker_pid_, config_.num_slots, shm_size_ / (1024 * 1024));
+  return true;
+}
+
+inline AlgoStatus PluginSandbox::init(const AlgoInitParam* param) {
+  if (!param || !param->model_path) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  std::lock_guard<std::mutex> lock(restart_mutex_);
+  if (!running_.load() || failed_.load() || worker_pid_ <= 0) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+
+  // worker 收到初始化请求后会先反初始化，失败时 worker 处于未初始化状态，不再重放旧参数
+  has_init_param_.store(false);
+  model_path_ = param->model_path;
+  has_config_json_ = param->config_json != nullptr;
+  config_json_ = has_config_json_ ? param->config_json : "";
+  backend_ = param->backend;
+  device_id_ = param->device_id;
+  param_updates_.clear();
+
+  AlgoStatus status = sendInit();
+  has_init_param_.store(status == ALGO_STATUS_SUCCESS);
+  if (worker_pid_ <= 0) {
+    // worker 在初始化期间退出或超时被杀：重启一个未初始化的 worker
+    restartWorker();
+  }
+  return status;
+}
+
+inline AlgoStatus PluginSandbox::setParams(const char* config_json) {
+  if (!config_json) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  std::lock_guard<std::mutex> lock(restart_mutex_);
+  if (!running_.load() || failed_.load() || !has_init_param_.load()) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+
+  AlgoStatus status = sendSetParams(config_json);
+  if (status == ALGO_STATUS_SUCCESS) {
+    param_updates_.push_back(config_json);
+  } else if (worker_pid_ <= 0) {
+    // worker 在更新参数时退出：重启并重放初始化与此前成功的更新（不含本次）
+    restartWorker();
+  }
+  return status;
+}
+
+inline const AlgoInputCaps* PluginSandbox::getInputCaps() const {
+  std::lock_guard<std::mutex> lock(restart_mutex_);
+  return input_caps_.num_formats > 0 ? &input_caps_ : nullptr;
+}
+
+inline SandboxFrame PluginSandbox::acquireFrame() {
+  SandboxFrame frame;
+  if (!running_.load() || failed_.load()) {
+    return frame;
+  }
+
+  int slot = acquireSlot();
+  if (slot < 0) {
+    return frame;
+  }
+
+  frame.slot = slot;
+  frame.data = sandbox::slotInput(sandbox::slotAt(header_, slot));
+  frame.capacity = header_->input_capacity;
+  return frame;
+}
+
+inline void PluginSandbox::releaseFrame(const SandboxFrame& frame) {
+  if (!frame.valid() || !header_) {
+    return;
+  }
+  sandbox::slotAt(header_, frame.slot)->state.store(sandbox::kSlotFree,
+                                                    std::memory_order_release);
+}
+
+inline AlgoStatus PluginSandbox::inferDetection(const AlgoTensor* input, AlgoDetResult* result) {
+  if (!input || !result) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  result->boxes = nullptr;
+  result->num_boxes = 0;
+  result->timestamp = 0;
+
+  if (!running_.load() || failed_.load() || !has_init_param_.load()) {
+    releaseSlotOf(input->data);
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  if (input->size > header_->input_capacity) {
+    LOG_ERROR("Frame too large for sandbox slot: {} > {}", input->size, header_->input_capacity);
+    releaseSlotOf(input->data);
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  int64_t begin_ns = sandbox::monotonicNs();
+
+  // 1. 找到 Slot：零拷贝帧直接使用，否则拷贝到空闲 Slot
+  bool zero_copy = true;
+  int index = findSlotByData(input->data);
+  if (index < 0) {
+    zero_copy = false;
+    index = acquireSlot();
+    if (index < 0) {
+      return ALGO_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+    if (input->size > 0) {
+      std::memcpy(sandbox::slotInput(sandbox::slotAt(header_, index)), input->data, input->size);
+    }
+  }
+
+  // 2. 提交请求
+  sandbox::SlotHeader* slot = sandbox::slotAt(header_, index);
+  slot->tensor = *input;
+  slot->tensor.data = nullptr;
+  slot->status = ALGO_STATUS_ERROR_UNKNOWN;
+  slot->num_boxes = 0;
+  slot->truncated = 0;
+  slot->seq = seq_.fetch_add(1) + 1;
+  uint32_t generation = generation_.load();
+  slot->state.store(sandbox::kSlotRequest, std::memory_order_release);
+  ringDoorbell();
+
+  // 3. 等待完成：先自旋，再 futex 休眠，超时则检查 worker 存活；
+  //    worker 处理本帧超过 infer_timeout_ms（从观察到 Processing 起算）视为卡死
+  const int64_t spin_ns = static_cast<int64_t>(config_.spin_us) * 1000;
+  const int64_t timeout_ns = static_cast<int64_t>(config_.infer_timeout_ms) * 1000000;
+  int64_t processing_since = 0;
+  uint32_t state = slot->state.load(std::memory_order_acquire);
+  while (state != sandbox::kSlotDone) {
+    state = sandbox::spinWhileEqual(&slot->state, state, spin_ns);
+    if (state == sandbox::kSlotDone) {
+      break;
+    }
+    if (sandbox::futexWaitFlagged(&slot->state, state, &slot->host_waiting,
+                                  config_.liveness_check_ms) == ETIMEDOUT) {
+      bool hung = false;
+      if (timeout_ns > 0 &&
+          slot->state.load(std::memory_order_acquire) == sandbox::kSlotProcessing) {
+        const int64_t now = sandbox::monotonicNs();
+        processing_since = processing_since > 0 ? processing_since : now;
+        hung = now - processing_since > timeout_ns;
+      }
+      checkWorker(generation, hung);
+      generation = generation_.load();
+      if (failed_.load()) {
+        // 已放弃重启：没有 worker 会再处理这个请求
+        uint32_t expected = sandbox::kSlotRequest;
+        slot->status = ALGO_STATUS_ERROR_INFERENCE;
+        slot->num_boxes = 0;
+        slot->state.compare_exchange_strong(expected, sandbox::kSlotDone,
+                                            std::memory_order_acq_rel);
+      }
+    }
+    state = slot->state.load(std::memory_order_acquire);
+  }
+
+  // 4. 读取结果（结果很小，拷贝到堆上后立即归还 Slot）
+  AlgoStatus status = static_cast<AlgoStatus>(slot->status);
+  if (status == ALGO_STATUS_SUCCESS && slot->num_boxes > 0) {
+    result->num_boxes = slot->num_boxes;
+    result->boxes = new AlgoDetBox[slot->num_boxes];
+    std::memcpy(result->boxes, sandbox::slotBoxes(header_, slot),
+                sizeof(AlgoDetBox) * slot->num_boxes);
+  }
+  if (status == ALGO_STATUS_SUCCESS) {
+    result->timestamp = slot->timestamp;
+  }
+  if (slot->truncated) {
+    LOG_WARN("Sandbox result truncated to {} boxes", header_->max_boxes);
+  }
+  int64_t worker_ns = slot->worker_end_ns - slot->worker_begin_ns;
+  slot->state.store(sandbox::kSlotFree, std::memory_order_release);
+
+  int64_t roundtrip_ns = sandbox::monotonicNs() - begin_ns;
+  if (status == ALGO_STATUS_SUCCESS) {
+    recordFrame(roundtrip_ns, worker_ns, zero_copy, zero_copy ? 0 : input->size);
+  } else {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.failed_frames++;
+  }
+  return status;
+}
+
+inline void PluginSandbox::freeDetResult(AlgoDetResult* result) {
+  if (result && result->boxes) {
+    delete[] result->boxes;
+    result->boxes = nullptr;
+    result->num_boxes = 0;
+  }
+}
+
+inline void PluginSandbox::stop() {
+  std::lock_guard<std::mutex> lock(restart_mutex_);
+
+  if (header_ && worker_pid_ > 0) {
+    header_->ctrl_state.store(sandbox::kCtrlShutdown, std::memory_order_release);
+    ringDoorbell();
+    reapWorker(2000);
+  }
+
+  if (header_) {
+    munmap(header_, shm_size_);
+    header_ = nullptr;
+  }
+  if (shm_fd_ >= 0) {
+    close(shm_fd_);
+    shm_fd_ = -1;
+  }
+
+  if (running_.exchange(false)) {
+    LOG_INFO("Plugin sandbox stopped: {}", plugin_path_);
+  }
+}
+
+inline std::string PluginSandbox::getPluginName() const {
+  if (!header_ || !header_->worker_ready.load()) {
+    return "";
+  }
+  return std::string(header_->plugin_name);
+}
+
+inline SandboxStats PluginSandbox::getStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+inline void PluginSandbox::resetStats() {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  uint64_t restarts = stats_.restarts;
+  stats_ = SandboxStats();
+  stats_.restarts = restarts;
+  total_overhead_us_ = 0.0;
+}
+
+inline bool PluginSandbox::createShm() {
+  shm_size_ = sandbox::shmTotalSize(config_.num_slots, config_.input_capacity,
+                                    config_.max_boxes);
+
+  // memfd 带 MFD_CLOEXEC，避免泄漏给主进程启动的其他子进程；
+  // spawnWorker() 在 fork 出的子进程中清除该标志后再 exec，worker 通过参数拿到 fd 号
+  shm_fd_ = static_cast<int>(syscall(SYS_memfd_create, "infer_frame_sandbox", MFD_CLOEXEC));
+  if (shm_fd_ < 0) {
+    LOG_ERROR("memfd_create failed: {}", strerror(errno));
+    return false;
+  }
+  if (ftruncate(shm_fd_, static_cast<off_t>(shm_size_)) != 0) {
+    LOG_ERROR("ftruncate shm failed: {}", strerror(errno));
+    close(shm_fd_);
+    shm_fd_ = -1;
+    return false;
+  }
+
+  void* addr = mmap(nullptr, shm_size_, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0);
+  if (addr == MAP_FAILED) {
+    LOG_ERROR("mmap shm failed: {}", strerror(errno));
+    close(shm_fd_);
+    shm_fd_ = -1;
+    return false;
+  }
+
+  header_ = new (addr) sandbox::ShmHeader();
+  header_->magic = sandbox::kShmMagic;
+  header_->version = sandbox::kShmVersion;
+  header_->num_slots = config_.num_slots;
+  header_->max_boxes = config_.max_boxes;
+  header_->input_capacity = config_.input_capacity;
+  header_->slot_stride = sandbox::slotStride(config_.input_capacity, config_.max_boxes);
+  header_->slots_offset = sandbox::alignUp(sizeof(sandbox::ShmHeader), sandbox::kShmAlign) +
+                          sandbox::kCtrlPayloadSize;
+  header_->worker_spin_ns = static_cast<int64_t>(config_.worker_spin_us) * 1000;
+  header_->worker_ready.store(0);
+  header_->doorbell.store(0);
+  header_->worker_waiting.store(0);
+  header_->ctrl_state.store(sandbox::kCtrlIdle);
+
+  for (uint32_t i = 0; i < config_.num_slots; ++i) {
+    sandbox::SlotHeader* slot = new (sandbox::slotAt(header_, i)) sandbox::SlotHeader();
+    slot->state.store(sandbox::kSlotFree);
+    slot->host_waiting.store(0);
+  }
+  return true;
+}
+
+inline std::string PluginSandbox::resolveWorkerPath() const {
+  if (!config_.worker_path.empty()) {
+    return config_.worker_path;
+  }
+
+  char exe[PATH_MAX] = {0};
+  ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+  std::string dir = ".";
+  if (len > 0) {
+    std::string path(exe, static_cast<size_t>(len));
+    size_t pos = path.rfind('/');
+    if (pos != std::string::npos) {
+      dir = path.substr(0, pos);
+    }
+  }
+  return dir + "/infer_frame_plugin_worker";
+}
+
+inline bool PluginSandbox::spawnWorker() {
+  // 在 fork 之前准备好参数，子进程中只调用 async-signal-safe 函数
+  std::string worker = resolveWorkerPath();
+  std::string fd_arg = std::to_string(shm_fd_);
+  pid_t parent = getpid();
+  std::vector<char*> argv = {
+      const_cast<char*>(worker.c_str()),
+      const_cast<char*>("--plugin"), const_cast<char*>(plugin_path_.c_str()),
+      const_cast<char*>("--shm-fd"), const_cast<char*>(fd_arg.c_str()),
+      nullptr};
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (config_.worker_cpu >= 0) {
+    CPU_SET(config_.worker_cpu, &cpus);
+  }
+
+  header_->worker_ready.store(0);
+  header_->worker_waiting.store(0);
+  header_->ctrl_state.store(sandbox::kCtrlIdle);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    LOG_ERROR("fork plugin worker failed: {}", strerror(errno));
+    return false;
+  }
+
+  if (pid == 0) {
+    // 主进程退出时 worker 随之退出
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent) {
+      _exit(127);
+    }
+    // 绑核失败（核不存在或不在 cpuset 内）不影响运行
+    if (config_.worker_cpu >= 0) {
+      sched_setaffinity(0, sizeof(cpus), &cpus);
+    }
+    int fd_flags = fcntl(shm_fd_, F_GETFD);
+    if (fd_flags < 0 || fcntl(shm_fd_, F_SETFD, fd_flags & ~FD_CLOEXEC) != 0) {
+      _exit(127);
+    }
+    execv(argv[0], argv.data());
+    _exit(127);
+  }
+
+  worker_pid_ = pid;
+  return true;
+}
+
+inline void PluginSandbox::reapWorker(int timeout_ms) {
+  if (worker_pid_ <= 0) {
+    return;
+  }
+
+  int64_t deadline = sandbox::monotonicNs() + static_cast<int64_t>(timeout_ms) * 1000000;
+  int wstatus = 0;
+  while (waitpid(worker_pid_, &wstatus, WNOHANG) == 0) {
+    if (sandbox::monotonicNs() > deadline) {
+      LOG_WARN("Plugin worker {} did not exit, killing", worker_pid_);
+      kill(worker_pid_, SIGKILL);
+      waitpid(worker_pid_, &wstatus, 0);
+      break;
+    }
+    usleep(1000);
+  }
+  worker_pid_ = -1;
+}
+
+inline AlgoStatus PluginSandbox::sendInit() {
+  // 调用者持有 restart_mutex_
+  size_t path_len = model_path_.size();
+  size_t json_len = has_config_json_ ? config_json_.size() + 1 : 0;
+  if (path_len + 1 + json_len > sandbox::kCtrlPayloadSize) {
+    LOG_ERROR("Sandbox init params too large");
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  char* payload = sandbox::ctrlPayload(header_);
+  std::memcpy(payload, model_path_.c_str(), path_len + 1);
+  if (has_config_json_) {
+    std::memcpy(payload + path_len + 1, config_json_.c_str(), json_len);
+  }
+  header_->model_path_len = static_cast<uint32_t>(path_len);
+  header_->config_json_len = static_cast<uint32_t>(json_len);
+  header_->backend = backend_;
+  header_->device_id = device_id_;
+  header_->ctrl_status = ALGO_STATUS_ERROR_UNKNOWN;
+  header_->ctrl_state.store(sandbox::kCtrlInitRequest, std::memory_order_release);
+  ringDoorbell();
+
+  AlgoStatus status = waitCtrl(config_.init_timeout_ms);
+  if (status != ALGO_STATUS_SUCCESS) {
+    LOG_ERROR("Sandbox init failed with status: {}", static_cast<int>(status));
+    return status;
+  }
+
+  input_formats_.assign(header_->input_formats,
+                        header_->input_formats + header_->num_input_formats);
+  input_caps_.formats = input_formats_.data();
+  input_caps_.num_formats = static_cast<int>(input_formats_.size());
+  input_caps_.max_width = header_->max_width;
+  input_caps_.max_height = header_->max_height;
+  input_caps_.size_align = header_->size_align;
+
+  // worker 重启后重放在线参数更新
+  for (const std::string& update : param_updates_) {
+    if (sendSetParams(update) != ALGO_STATUS_SUCCESS && worker_pid_ <= 0) {
+      return ALGO_STATUS_ERROR_MODEL_LOAD;  // worker 在重放期间退出
+    }
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+inline AlgoStatus PluginSandbox::sendSetParams(const std::string& config_json) {
+  // 调用者持有 restart_mutex_
+  if (config_json.size() + 1 > sandbox::kCtrlPayloadSize) {
+    LOG_ERROR("Sandbox params too large");
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  std::memcpy(sandbox::ctrlPayload(header_), config_json.c_str(), config_json.size() + 1);
+  header_->ctrl_status = ALGO_STATUS_ERROR_UNKNOWN;
+  header_->ctrl_state.store(sandbox::kCtrlSetParamsRequest, std::memory_order_release);
+  ringDoorbell();
+  return waitCtrl(config_.init_timeout_ms);
+}
+
+inline AlgoStatus PluginSandbox::waitCtrl(int timeout_ms) {
+  int64_t deadline = sandbox::monotonicNs() + static_cast<int64_t>(timeout_ms) * 1000000;
+  while (true) {
+    uint32_t state = header_->ctrl_state.load(std::memory_order_acquire);
+    if (state == sandbox::kCtrlInitDone || state == sandbox::kCtrlInitFailed) {
+      AlgoStatus status = static_cast<AlgoStatus>(header_->ctrl_status);
+      header_->ctrl_state.store(sandbox::kCtrlIdle, std::memory_order_release);
+      return status;
+    }
+
+    // 调用者持有 restart_mutex_；worker_pid_ <= 0 时不能调用 waitpid（会回收其他子进程）
+    if (worker_pid_ <= 0) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    int wstatus = 0;
+    if (waitpid(worker_pid_, &wstatus, WNOHANG) == worker_pid_) {
+      handleWorkerExit(wstatus);
+      return ALGO_STATUS_ERROR_MODEL_LOAD;
+    }
+    if (sandbox::monotonicNs() > deadline) {
+      LOG_ERROR("Sandbox control command timeout after {} ms, killing worker {}", timeout_ms,
+                worker_pid_);
+      kill(worker_pid_, SIGKILL);
+      waitpid(worker_pid_, &wstatus, 0);
+      handleWorkerExit(wstatus);
+      return ALGO_STATUS_ERROR_MODEL_LOAD;
+    }
+    sandbox::futexWait(&header_->ctrl_state, state, config_.liveness_check_ms);
+  }
+}
+
+inline void PluginSandbox::ringDoorbell() {
+  // worker 仍在自旋或处理其他帧时不需要系统调用
+  header_->doorbell.fetch_add(1);
+  sandbox::futexWakeIfWaiting(&header_->doorbell, &header_->worker_waiting);
+}
+
+inline int PluginSandbox::findSlotByData(const void* data) const {
+  for (uint32_t i = 0; i < header_->num_slots; ++i) {
+    sandbox::SlotHeader* slot = sandbox::slotAt(header_, i);
+    if (data == sandbox::slotInput(slot) &&
+        slot->state.load(std::memory_order_acquire) == sandbox::kSlotFilling) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+inline void PluginSandbox::releaseSlotOf(const void* data) {
+  // 提前返回时归还调用者通过 acquireFrame() 占用的 Slot，避免永久停留在 Filling
+  if (!header_ || !data) {
+    return;
+  }
+  int index = findSlotByData(data);
+  if (index >= 0) {
+    sandbox::slotAt(header_, index)->state.store(sandbox::kSlotFree, std::memory_order_release);
+  }
+}
+
+inline int PluginSandbox::acquireSlot() {
+  // Slot 数量很少，线性扫描即可；全部占用时短暂等待
+  int64_t deadline = sandbox::monotonicNs() + 1000000000LL;
+  while (sandbox::monotonicNs() < deadline) {
+    for (uint32_t i = 0; i < header_->num_slots; ++i) {
+      uint32_t expected = sandbox::kSlotFree;
+      if (sandbox::slotAt(header_, i)->state.compare_exchange_strong(
+              expected, sandbox::kSlotFilling, std::memory_order_acq_rel)) {
+        return static_cast<int>(i);
+      }
+    }
+    std::this_thread::yield();
+  }
+  LOG_WARN("No free sandbox slot for plugin {}", plugin_path_);
+  return -1;
+}
+
+inline void PluginSandbox::checkWorker(uint32_t observed_generation, bool hung) {
+  std::lock_guard<std::mutex> lock(restart_mutex_);
+
+  // 其他线程已经完成了重启
+  if (generation_.load() != observed_generation || worker_pid_ <= 0 || !header_) {
+    return;
+  }
+
+  int wstatus = 0;
+  if (hung) {
+    LOG_ERROR("Plugin worker {} did not finish a frame within {} ms, killing, plugin: {}",
+              worker_pid_, config_.infer_timeout_ms, plugin_path_);
+    kill(worker_pid_, SIGKILL);
+    waitpid(worker_pid_, &wstatus, 0);
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    stats_.hung_frames++;
+  } else if (waitpid(worker_pid_, &wstatus, WNOHANG) != worker_pid_) {
+    return;  // worker 仍在运行（插件只是比较慢）
+  }
+
+  handleWorkerExit(wstatus);
+  restartWorker();
+}
+
+inline void PluginSandbox::handleWorkerExit(int wstatus) {
+  // 调用者持有 restart_mutex_，worker 已被回收
+  if (WIFSIGNALED(wstatus)) {
+    LOG_ERROR("Plugin worker {} crashed (signal {}), plugin: {}",
+              worker_pid_, WTERMSIG(wstatus), plugin_path_);
+  } else {
+    LOG_ERROR("Plugin worker {} exited (code {}), plugin: {}",
+              worker_pid_, WEXITSTATUS(wstatus), plugin_path_);
+  }
+  worker_pid_ = -1;
+  generation_.fetch_add(1);
+
+  // 正在处理的帧视为失败；已提交未处理的帧保留，由新 worker 继续处理
+  for (uint32_t i = 0; i < header_->num_slots; ++i) {
+    sandbox::SlotHeader* slot = sandbox::slotAt(header_, i);
+    if (slot->state.load(std::memory_order_acquire) == sandbox::kSlotProcessing) {
+      slot->status = ALGO_STATUS_ERROR_INFERENCE;
+      slot->num_boxes = 0;
+      slot->worker_begin_ns = slot->worker_end_ns = 0;
+      slot->state.store(sandbox::kSlotDone, std::memory_order_release);
+      sandbox::futexWakeAll(&slot->state);
+    }
+  }
+}
+
+inline void PluginSandbox::restartWorker() {
+  // 调用者持有 restart_mutex_。重放初始化时 worker 再次退出（waitCtrl 回收并清空 worker_pid_）
+  // 则继续按限频重试；重放被插件拒绝则放弃
+  while (!failed_.load() && worker_pid_ <= 0) {
+    int64_t now = sandbox::monotonicNs();
+    int64_t window = static_cast<int64_t>(config_.restart_window_sec) * 1000000000LL;
+    while (!restart_times_.empty() && now - restart_times_.front() > window) {
+      restart_times_.pop_front();
+    }
+    if (static_cast<int>(restart_times_.size()) >= config_.max_restarts) {
+      LOG_ERROR("Plugin {} restarted {} times in {}s, giving up",
+                plugin_path_, restart_times_.size(), config_.restart_window_sec);
+      failed_.store(true);
+      break;
+    }
+    restart_times_.push_back(now);
+
+    if (!spawnWorker()) {
+      failed_.store(true);
+      break;
+    }
+    if (has_init_param_.load() && sendInit() != ALGO_STATUS_SUCCESS) {
+      if (worker_pid_ > 0) {
+        failed_.store(true);
+      }
+      continue;
+    }
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    stats_.restarts++;
+    LOG_INFO("Plugin worker restarted: {} (pid {})", plugin_path_, worker_pid_);
+  }
+
+  // 放弃时让所有等待中的请求失败返回
+  if (failed_.load()) {
+    for (uint32_t i = 0; i < header_->num_slots; ++i) {
+      sandbox::SlotHeader* slot = sandbox::slotAt(header_, i);
+      if (slot->state.load(std::memory_order_acquire) == sandbox::kSlotRequest) {
+        slot->status = ALGO_STATUS_ERROR_INFERENCE;
+        slot->num_boxes = 0;
+        slot->worker_begin_ns = slot->worker_end_ns = 0;
+        slot->state.store(sandbox::kSlotDone, std::memory_order_release);
+        sandbox::futexWakeAll(&slot->state);
+      }
+    }
+  }
+}
+
+inline void PluginSandbox::recordFrame(int64_t roundtrip_ns, int64_t worker_ns,
+                                       bool zero_copy, size_t copied) {
+  double overhead_us = static_cast<double>(roundtrip_ns - worker_ns) / 1000.0;
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  stats_.frames++;
+  if (zero_copy) {
+    stats_.zero_copy_frames++;
+  }
+  stats_.copied_bytes += copied;
+  total_overhead_us_ += overhead_us;
+  stats_.avg_overhead_us = total_overhead_us_ / static_cast<double>(stats_.frames);
+  if (overhead_us > stats_.max_overhead_us) {
+    stats_.max_overhead_us = overhead_us;
+  }
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
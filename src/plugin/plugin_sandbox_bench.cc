@@ -0,0 +1,131 @@
+/**
+ * @file plugin_sandbox_bench.cc
+ * @brief 插件隔离模式开销测试：进程内 PluginLoaderC vs PluginSandbox（拷贝/零拷贝）
+ *
+ * 用法: plugin_sandbox_bench [plugin.so] [frames] [worker_cpu]
+ *
+ * 隔离开销与核数强相关：多核上两端自旋、worker 可绑到独立的核（worker_cpu），
+ * 单核上自旋关闭、每帧走 futex 唤醒。输出中打印核数与是否自旋，便于对比不同机器的数据。
+ */
+
+#include "algo_utils/bench_stats.h"
+#include "plugin/format_negotiation.h"
+#include "plugin/plugin_loader_c.h"
+#include "plugin/plugin_sandbox.h"
+#include "utils/one_logger.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace infer_frame;
+using algo_utils::elapsedUs;
+using algo_utils::LatencySummary;
+using algo_utils::summarize;
+
+int main(int argc, char** argv) {
+  std::string plugin_path = argc > 1 ? argv[1] : "./algorithm/yolov8_plugin.so";
+  int frames = argc > 2 ? std::stoi(argv[2]) : 1000;
+  int worker_cpu = argc > 3 ? std::stoi(argv[3]) : -1;
+
+  AlgoInitParam init_param;
+  init_param.model_path = "/path/to/yolov8.engine";
+  init_param.backend = ALGO_BACKEND_TENSORRT;
+  init_param.device_id = 0;
+  init_param.config_json = "{}";
+
+  std::vector<float> frame_data(3 * 640 * 640, 0.5f);
+  AlgoTensor input;
+  plugin::describeImageTensor(&input, "images", ALGO_PIXEL_FORMAT_RGB_PLANAR,
+                              ALGO_DATA_TYPE_FLOAT32, 640, 640, frame_data.data());
+
+  // 1. 进程内基线
+  std::vector<double> inproc_us;
+  {
+    plugin::PluginLoaderC loader;
+    if (!loader.loadPlugin(plugin_path)) {
+      return 1;
+    }
+    std::string name = loader.getLoadedPlugins().front();
+    AlgoHandle handle = loader.createAlgoInstance(name);
+    loader.initAlgo(handle, name, &init_param);
+    for (int i = 0; i < frames; ++i) {
+      AlgoDetResult result;
+      auto begin = std::chrono::steady_clock::now();
+      loader.inferDetection(handle, name, &input, &result);
+      loader.freeDetResult(name, &result);
+      inproc_us.push_back(elapsedUs(begin));
+    }
+    loader.deinitAlgo(handle, name);
+    loader.destroyAlgoInstance(handle, name);
+  }
+
+  // 2. 隔离模式
+  plugin::PluginSandboxConfig config;
+  config.input_capacity = input.size;
+  config.worker_cpu = worker_cpu;
+  plugin::PluginSandbox sandbox(config);
+  if (!sandbox.start(plugin_path) || sandbox.init(&init_param) != ALGO_STATUS_SUCCESS) {
+    LOG_ERROR("Failed to start plugin sandbox");
+    return 1;
+  }
+
+  // 2.1 拷贝路径：普通内存中的帧
+  std::vector<double> copy_us;
+  for (int i = 0; i < frames; ++i) {
+    AlgoDetResult result;
+    auto begin = std::chrono::steady_clock::now();
+    sandbox.inferDetection(&input, &result);
+    sandbox.freeDetResult(&result);
+    copy_us.push_back(elapsedUs(begin));
+  }
+  plugin::SandboxStats copy_stats = sandbox.getStats();
+  sandbox.resetStats();
+
+  // 2.2 零拷贝路径：帧直接写入共享内存
+  std::vector<double> zero_copy_us;
+  for (int i = 0; i < frames; ++i) {
+    plugin::SandboxFrame frame = sandbox.acquireFrame();
+    if (!frame.valid()) {
+      break;
+    }
+    std::memcpy(frame.data, frame_data.data(), input.size);  // 模拟解码器写入
+    AlgoTensor shm_input = input;
+    shm_input.data = frame.data;
+
+    AlgoDetResult result;
+    auto begin = std::chrono::steady_clock::now();
+    sandbox.inferDetection(&shm_input, &result);
+    sandbox.freeDetResult(&result);
+    zero_copy_us.push_back(elapsedUs(begin));
+  }
+  plugin::SandboxStats stats = sandbox.getStats();
+  sandbox.stop();
+
+  LatencySummary inproc = summarize(inproc_us);
+  LatencySummary copy = summarize(copy_us);
+  LatencySummary zero_copy = summarize(zero_copy_us);
+
+  LOG_INFO("======================================");
+  LOG_INFO("  Plugin Sandbox Overhead ({} frames)", frames);
+  LOG_INFO("======================================");
+  unsigned cores = std::thread::hardware_concurrency();
+  LOG_INFO("cores: {}, spinning: {}, worker cpu: {}", cores, cores > 1 ? "on" : "off (futex only)",
+           worker_cpu >= 0 ? std::to_string(worker_cpu) : std::string("unpinned"));
+  LOG_INFO("{:<18} {:>10} {:>10} {:>10}", "mode", "mean(us)", "p50(us)", "p99(us)");
+  LOG_INFO("{:<18} {:>10.2f} {:>10.2f} {:>10.2f}", "in-process", inproc.mean_us, inproc.p50_us,
+           inproc.p99_us);
+  LOG_INFO("{:<18} {:>10.2f} {:>10.2f} {:>10.2f}", "sandbox (copy)", copy.mean_us, copy.p50_us,
+           copy.p99_us);
+  LOG_INFO("{:<18} {:>10.2f} {:>10.2f} {:>10.2f}", "sandbox (0-copy)", zero_copy.mean_us,
+           zero_copy.p50_us, zero_copy.p99_us);
+  LOG_INFO("Isolation overhead (roundtrip - plugin time):");
+  LOG_INFO("  copy      avg {:.2f} us, max {:.2f} us, copied {} MB", copy_stats.avg_overhead_us,
+           copy_stats.max_overhead_us, copy_stats.copied_bytes / (1024 * 1024));
+  LOG_INFO("  zero-copy avg {:.2f} us, max {:.2f} us, frames {}", stats.avg_overhead_us,
+           stats.max_overhead_us, stats.zero_copy_frames);
+
+  return 0;
+}
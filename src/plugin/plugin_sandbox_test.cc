@@ -0,0 +1,145 @@
+/**
+ * @file plugin_sandbox_test.cc
+ * @brief PluginSandbox 故障恢复测试：初始化 / 参数更新 / 推理期间 worker 崩溃或卡死
+ *
+ * 用法: plugin_sandbox_test [sandbox_test_plugin.so] [infer_frame_plugin_worker]
+ */
+
+#include "plugin/algo_plugin_interface.h"
+#include "plugin/plugin_sandbox.h"
+#include "utils/one_logger.hpp"
+
+#include <chrono>
+#include <string>
+
+using namespace infer_frame;
+
+// 失败的检查数，非 0 时进程以 1 退出
+int g_failed_tests = 0;
+
+void printTestResult(const std::string& test_name, bool passed) {
+  if (passed) {
+    LOG_INFO("✓ {}", test_name);
+  } else {
+    LOG_ERROR("✗ {}", test_name);
+    ++g_failed_tests;
+  }
+}
+
+/**
+ * @brief 送入一帧，首字节决定故障注入插件的行为（0 正常，1 卡死，2 崩溃）
+ */
+AlgoStatus inferFrame(plugin::PluginSandbox* sandbox, unsigned char mode, int* num_boxes) {
+  unsigned char data[64] = {mode};
+  AlgoTensor input = AlgoTensor{};
+  input.data_type = ALGO_DATA_TYPE_UINT8;
+  input.ndim = 1;
+  input.shape[0] = sizeof(data);
+  input.data = data;
+  input.size = sizeof(data);
+
+  AlgoDetResult result;
+  AlgoStatus status = sandbox->inferDetection(&input, &result);
+  *num_boxes = result.num_boxes;
+  sandbox->freeDetResult(&result);
+  return status;
+}
+
+bool inferOk(plugin::PluginSandbox* sandbox) {
+  int num_boxes = 0;
+  return inferFrame(sandbox, 0, &num_boxes) == ALGO_STATUS_SUCCESS && num_boxes == 1;
+}
+
+int main(int argc, char** argv) {
+  LOG_INFO("======================================");
+  LOG_INFO("  Plugin Sandbox Recovery Test");
+  LOG_INFO("======================================");
+
+  std::string plugin_path = argc > 1 ? argv[1] : "./sandbox_test_plugin.so";
+
+  plugin::PluginSandboxConfig config;
+  config.worker_path = argc > 2 ? argv[2] : "";
+  config.input_capacity = 4096;
+  config.infer_timeout_ms = 200;
+  config.max_restarts = 10;
+
+  AlgoInitParam good_param = AlgoInitParam{};
+  good_param.model_path = "model.bin";
+  good_param.config_json = "{}";
+  AlgoInitParam crash_param = good_param;
+  crash_param.model_path = "crash.bin";
+
+  // 测试 1: 初始化期间崩溃
+  LOG_INFO("\n[Test 1] Worker crashes during init...");
+  plugin::PluginSandbox sandbox(config);
+  if (!sandbox.start(plugin_path)) {
+    printTestResult("Start sandbox", false);
+    return 1;
+  }
+  AlgoStatus status = sandbox.init(&crash_param);
+  printTestResult("Init crash reported", status != ALGO_STATUS_SUCCESS);
+  printTestResult("Worker restarted after init crash", sandbox.getStats().restarts == 1);
+  status = sandbox.init(&good_param);
+  printTestResult("Init after restart", status == ALGO_STATUS_SUCCESS);
+  printTestResult("Infer after init crash", inferOk(&sandbox));
+
+  // 测试 2: 参数更新期间崩溃，重启后重放初始化
+  LOG_INFO("\n[Test 2] Worker crashes during setParams...");
+  printTestResult("Set params", sandbox.setParams("{\"conf_threshold\": 0.5}") ==
+                                    ALGO_STATUS_SUCCESS);
+  status = sandbox.setParams("{\"crash\": true}");
+  printTestResult("SetParams crash reported", status != ALGO_STATUS_SUCCESS);
+  printTestResult("Worker restarted after setParams crash", sandbox.getStats().restarts == 2);
+  printTestResult("Infer after setParams crash", inferOk(&sandbox));
+
+  // 测试 3: 单帧卡死，超过 infer_timeout_ms 后杀掉并重启
+  LOG_INFO("\n[Test 3] Worker hangs on a frame...");
+  int num_boxes = -1;
+  auto begin = std::chrono::steady_clock::now();
+  status = inferFrame(&sandbox, 1, &num_boxes);
+  auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - begin).count();
+  LOG_INFO("Hung frame returned after {} ms", elapsed_ms);
+  printTestResult("Hung frame fails", status == ALGO_STATUS_ERROR_INFERENCE && num_boxes == 0);
+  printTestResult("Hung frame bounded by deadline", elapsed_ms >= 200 && elapsed_ms < 5000);
+  plugin::SandboxStats stats = sandbox.getStats();
+  printTestResult("Hung worker restarted", stats.hung_frames == 1 && stats.restarts == 3);
+  printTestResult("Infer after hang", inferOk(&sandbox));
+
+  // 测试 4: 单帧崩溃
+  LOG_INFO("\n[Test 4] Worker crashes on a frame...");
+  status = inferFrame(&sandbox, 2, &num_boxes);
+  printTestResult("Crashed frame fails", status == ALGO_STATUS_ERROR_INFERENCE);
+  stats = sandbox.getStats();
+  printTestResult("Crashed worker restarted", stats.restarts == 4 && stats.hung_frames == 1);
+  printTestResult("Infer after crash", inferOk(&sandbox));
+  sandbox.stop();
+
+  // 测试 5: 超过重启次数上限后放弃
+  LOG_INFO("\n[Test 5] Giving up after max_restarts...");
+  config.max_restarts = 1;
+  plugin::PluginSandbox limited(config);
+  bool started = limited.start(plugin_path) && limited.init(&good_param) == ALGO_STATUS_SUCCESS;
+  printTestResult("Start limited sandbox", started);
+  if (started) {
+    inferFrame(&limited, 2, &num_boxes);
+    printTestResult("First crash restarts", inferOk(&limited));
+    status = inferFrame(&limited, 2, &num_boxes);
+    printTestResult("Second crash fails", status == ALGO_STATUS_ERROR_INFERENCE);
+    status = inferFrame(&limited, 0, &num_boxes);
+    printTestResult("Sandbox gives up", status == ALGO_STATUS_ERROR_NOT_INITIALIZED &&
+                                            limited.init(&good_param) ==
+                                                ALGO_STATUS_ERROR_NOT_INITIALIZED);
+  }
+  limited.stop();
+
+  LOG_INFO("\n======================================");
+  if (g_failed_tests > 0) {
+    LOG_ERROR("  {} test(s) failed", g_failed_tests);
+  } else {
+    LOG_INFO("  All tests completed!");
+  }
+  LOG_INFO("======================================");
+
+  return g_failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file plugin_static_bench.cc
+ * @brief 插件调用路径开销测试：动态加载（dlopen）vs 静态链接
+ *
+ * 本程序把 YOLOv8 C 插件源码直接编译进来，并用一个 final 的 C++ 插件（StaticBenchPlugin）
+ * 包装它、经 REGISTER_ALGO_PLUGIN 的静态登记进入 StaticPluginRegistry；
+ * 同时 dlopen 同一插件的 .so（动态路径），对比每帧开销：
+ *   1. PluginLoaderC：按名称查表 + 加锁 + 函数指针间接调用（现有主程序路径）
+ *   2. dlsym 函数指针：只有跨 .so 的间接调用
+ *   3. 静态登记 + PluginLoader::getPlugin：经 AlgoPluginBase 的虚调用
+ *   4. 静态登记 + PluginLoader::getStaticPlugin<T>：具体 final 类型，直接调用
+ *   5. 直接调用 C 接口：基线，开启 ENABLE_LTO 时可跨插件边界内联
+ *
+ * 用法: plugin_static_bench [plugin.so] [frames]
+ */
+
+#include "algo_utils/bench_stats.h"
+#include "plugin/format_negotiation.h"
+#include "plugin/plugin_loader.h"
+#include "plugin/plugin_loader_c.h"
+#include "plugin/plugin_registry.h"
+#include "utils/one_logger.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace infer_frame;
+using algo_utils::LatencySummary;
+using algo_utils::sampleUs;
+using algo_utils::summarize;
+
+namespace {
+
+/**
+ * @brief 把编译进来的 C 插件包装为 C++ 插件，只用于测量注册表两条调用路径的开销
+ *
+ * infer() 忽略 Tensor 参数，对 setInput() 给定的帧调用 C 接口。
+ */
+class StaticBenchPlugin final : public plugin::AlgoPluginBase {
+ public:
+  ~StaticBenchPlugin() override { deinit(); }
+
+  plugin::AlgoInfo getInfo() const override {
+    plugin::AlgoInfo info;
+    info.name = "StaticBench";
+    info.version = "1.0.0";
+    info.type = plugin::AlgoType::kDetection;
+    info.description = "YOLOv8 C plugin wrapped for the static registry benchmark";
+    return info;
+  }
+
+  base::Status init(const std::string& model_path, const backend::BackendConfig&,
+                    const std::map<std::string, std::string>&) override {
+    AlgoInitParam param = {};
+    param.model_path = model_path.c_str();
+    param.backend = ALGO_BACKEND_TENSORRT;
+    param.config_json = "{}";
+    handle_ = AlgoCreate();
+    if (AlgoInit(handle_, &param) != ALGO_STATUS_SUCCESS) {
+      deinit();
+      return base::Status::ModelLoadError("YOLOv8 C plugin init failed");
+    }
+    return base::Status::OK();
+  }
+
+  void setInput(const AlgoTensor* input) { input_ = input; }
+
+  base::Status infer(std::vector<base::Tensor*>&, std::vector<base::Tensor*>&) override {
+    AlgoDetResult result = {};
+    AlgoStatus status = AlgoInferDetection(handle_, input_, &result);
+    AlgoFreeDetResult(&result);
+    return status == ALGO_STATUS_SUCCESS ? base::Status::OK() : base::Status::InferenceError();
+  }
+
+  base::Status inferBatch(const std::vector<std::vector<base::Tensor*>>& batch_inputs,
+                          std::vector<std::vector<base::Tensor*>>& batch_outputs) override {
+    std::vector<base::Tensor*> inputs;
+    for (size_t i = 0; i < batch_inputs.size(); ++i) {
+      batch_outputs.emplace_back();
+      base::Status status = infer(inputs, batch_outputs.back());
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return base::Status::OK();
+  }
+
+  base::Status deinit() override {
+    if (handle_) {
+      AlgoDeinit(handle_);
+      AlgoDestroy(handle_);
+      handle_ = nullptr;
+    }
+    return base::Status::OK();
+  }
+
+  bool isInitialized() const override { return handle_ != nullptr; }
+
+ private:
+  AlgoHandle handle_ = nullptr;
+  const AlgoTensor* input_ = nullptr;
+};
+
+}  // namespace
+
+// 与 INFER_FRAME_STATIC_PLUGIN 下的 REGISTER_ALGO_PLUGIN 相同的登记方式
+INFER_FRAME_STATIC_PLUGIN_REGISTER(StaticBenchPlugin)
+
+int main(int argc, char** argv) {
+  std::string plugin_path = argc > 1 ? argv[1] : "./algorithm/yolov8_plugin.so";
+  int frames = argc > 2 ? std::stoi(argv[2]) : 10000;
+
+  AlgoInitParam init_param;
+  init_param.model_path = "/path/to/yolov8.engine";
+  init_param.backend = ALGO_BACKEND_TENSORRT;
+  init_param.device_id = 0;
+  init_param.config_json = "{}";
+
+  std::vector<float> frame_data(3 * 640 * 640, 0.5f);
+  AlgoTensor input;
+  plugin::describeImageTensor(&input, "images", ALGO_PIXEL_FORMAT_RGB_PLANAR,
+                              ALGO_DATA_TYPE_FLOAT32, 640, 640, frame_data.data());
+
+  // 1. 动态加载：PluginLoaderC
+  std::vector<double> loader_us;
+  std::vector<double> dlsym_us;
+  {
+    plugin::PluginLoaderC loader;
+    if (!loader.loadPlugin(plugin_path)) {
+      return 1;
+    }
+    std::string name = loader.getLoadedPlugins().front();
+    AlgoHandle handle = loader.createAlgoInstance(name);
+    loader.initAlgo(handle, name, &init_param);
+    loader_us = sampleUs(frames, [&]() {
+      AlgoDetResult result = {};
+      loader.inferDetection(handle, name, &input, &result);
+      loader.freeDetResult(name, &result);
+    });
+    loader.deinitAlgo(handle, name);
+    loader.destroyAlgoInstance(handle, name);
+  }
+
+  // 2. 动态加载：直接使用 dlsym 得到的函数指针
+  {
+    void* dl_handle = dlopen(plugin_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!dl_handle) {
+      LOG_ERROR("Failed to load plugin: {}", dlerror());
+      return 1;
+    }
+    auto create = reinterpret_cast<AlgoHandle (*)()>(dlsym(dl_handle, "AlgoCreate"));
+    auto init = reinterpret_cast<AlgoStatus (*)(AlgoHandle, const AlgoInitParam*)>(
+        dlsym(dl_handle, "AlgoInit"));
+    auto infer = reinterpret_cast<AlgoStatus (*)(AlgoHandle, const AlgoTensor*, AlgoDetResult*)>(
+        dlsym(dl_handle, "AlgoInferDetection"));
+    auto free_result = reinterpret_cast<void (*)(AlgoDetResult*)>(
+        dlsym(dl_handle, "AlgoFreeDetResult"));
+    auto deinit = reinterpret_cast<AlgoStatus (*)(AlgoHandle)>(dlsym(dl_handle, "AlgoDeinit"));
+    auto destroy = reinterpret_cast<void (*)(AlgoHandle)>(dlsym(dl_handle, "AlgoDestroy"));
+    if (!create || !init || !infer || !free_result || !deinit || !destroy) {
+      LOG_ERROR("Plugin {} misses required symbols", plugin_path);
+      dlclose(dl_handle);
+      return 1;
+    }
+
+    AlgoHandle handle = create();
+    init(handle, &init_param);
+    dlsym_us = sampleUs(frames, [&]() {
+      AlgoDetResult result = {};
+      infer(handle, &input, &result);
+      free_result(&result);
+    });
+    deinit(handle);
+    destroy(handle);
+    dlclose(dl_handle);
+  }
+
+  // 3. 静态登记：PluginLoader 创建，分别经基类（虚调用）与具体类型（直接调用）
+  std::vector<double> registry_us;
+  std::vector<double> typed_us;
+  {
+    plugin::PluginLoader loader;
+    loader.loadStaticPlugins();
+    std::shared_ptr<plugin::AlgoPluginBase> base_plugin = loader.getPlugin("StaticBench");
+    std::shared_ptr<StaticBenchPlugin> typed = loader.getStaticPlugin<StaticBenchPlugin>(
+        "StaticBench");
+    if (!base_plugin || !typed ||
+        !typed->init(init_param.model_path, backend::BackendConfig(), {}).ok()) {
+      LOG_ERROR("Failed to create the statically registered bench plugin");
+      return 1;
+    }
+    typed->setInput(&input);
+
+    std::vector<base::Tensor*> inputs;
+    std::vector<base::Tensor*> outputs;
+    registry_us = sampleUs(frames, [&]() { base_plugin->infer(inputs, outputs); });
+    typed_us = sampleUs(frames, [&]() { typed->infer(inputs, outputs); });
+  }
+
+  // 4. 直接调用编译进本程序的 C 接口
+  std::vector<double> static_us;
+  {
+    AlgoHandle handle = AlgoCreate();
+    AlgoInit(handle, &init_param);
+    static_us = sampleUs(frames, [&]() {
+      AlgoDetResult result = {};
+      AlgoInferDetection(handle, &input, &result);
+      AlgoFreeDetResult(&result);
+    });
+    AlgoDeinit(handle);
+    AlgoDestroy(handle);
+  }
+
+  LatencySummary loader = summarize(loader_us);
+  LatencySummary dlsym_path = summarize(dlsym_us);
+  LatencySummary registry = summarize(registry_us);
+  LatencySummary typed = summarize(typed_us);
+  LatencySummary static_path = summarize(static_us);
+
+  LOG_INFO("======================================");
+  LOG_INFO("  Plugin Call Path Overhead ({} frames)", frames);
+  LOG_INFO("======================================");
+  LOG_INFO("{:<18} {:>10} {:>10} {:>10}", "mode", "mean(us)", "p50(us)", "p99(us)");
+  LOG_INFO("{:<18} {:>10.3f} {:>10.3f} {:>10.3f}", "dynamic (loader)", loader.mean_us,
+           loader.p50_us, loader.p99_us);
+  LOG_INFO("{:<18} {:>10.3f} {:>10.3f} {:>10.3f}", "dynamic (dlsym)", dlsym_path.mean_us,
+           dlsym_path.p50_us, dlsym_path.p99_us);
+  LOG_INFO("{:<18} {:>10.3f} {:>10.3f} {:>10.3f}", "static (virtual)", registry.mean_us,
+           registry.p50_us, registry.p99_us);
+  LOG_INFO("{:<18} {:>10.3f} {:>10.3f} {:>10.3f}", "static (typed)", typed.mean_us,
+           typed.p50_us, typed.p99_us);
+  LOG_INFO("{:<18} {:>10.3f} {:>10.3f} {:>10.3f}", "static (C call)", static_path.mean_us,
+           static_path.p50_us, static_path.p99_us);
+  LOG_INFO("Per-frame overhead vs direct C call (p50):");
+  LOG_INFO("  loader {:.3f} us, dlsym {:.3f} us, virtual {:.3f} us, typed {:.3f} us",
+           loader.p50_us - static_path.p50_us, dlsym_path.p50_us - static_path.p50_us,
+           registry.p50_us - static_path.p50_us, typed.p50_us - static_path.p50_us);
+
+  return 0;
+}
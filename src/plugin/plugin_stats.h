@@ -0,0 +1,215 @@
+#pragma once
+
+/**
+ * @file plugin_stats.h
+ * @brief 插件性能计数汇总（按 摄像头 × 插件）
+ *
+ * 插件（AlgoGetStats / AlgoPluginBase::getStats）只提供自身生命周期内的累计值，
+ * 主程序定期采样后交给 PluginStatsAggregator：
+ * - 相邻两次采样做差得到区间统计（用于实时监控）
+ * - 插件重启导致计数回退时以新值为基线继续累加，总量不丢失
+ * - 可按插件跨摄像头合并，定位耗时集中在哪个阶段
+ */
+
+#include "algo_utils/stage_timer.h"
+#include "utils/one_logger.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace infer_frame {
+namespace plugin {
+
+class PluginStatsAggregator {
+ public:
+  /**
+   * @brief 更新一次采样
+   * @param camera_id 摄像头 ID
+   * @param plugin_name 插件名称
+   * @param cumulative 插件上报的累计值
+   */
+  void update(const std::string& camera_id, const std::string& plugin_name,
+              const algo_utils::PerfStats& cumulative);
+
+  /**
+   * @brief C 接口插件采样
+   */
+  void update(const std::string& camera_id, const std::string& plugin_name,
+              const AlgoStats& cumulative) {
+    update(camera_id, plugin_name, algo_utils::StageRecorder::fromAlgoStats(cumulative));
+  }
+
+  /**
+   * @brief 累计统计（跨插件重启）
+   */
+  algo_utils::PerfStats total(const std::string& camera_id,
+                              const std::string& plugin_name) const;
+
+  /**
+   * @brief 最近两次采样之间的增量
+   */
+  algo_utils::PerfStats interval(const std::string& camera_id,
+                                 const std::string& plugin_name) const;
+
+  /**
+   * @brief 指定插件在所有摄像头上的累计统计
+   */
+  algo_utils::PerfStats totalByPlugin(const std::string& plugin_name) const;
+
+  /**
+   * @brief 已采样的 (摄像头, 插件) 列表
+   */
+  std::vector<std::pair<std::string, std::string>> keys() const;
+
+  /**
+   * @brief 移除摄像头的全部统计（摄像头删除时调用）
+   */
+  void removeCamera(const std::string& camera_id);
+
+  /**
+   * @brief 打印每个 (摄像头, 插件) 最近区间的各阶段耗时
+   */
+  void logSummary() const;
+
+ private:
+  using Key = std::pair<std::string, std::string>;
+
+  struct Entry {
+    algo_utils::PerfStats last_raw;     // 上次采样的插件原始累计值
+    algo_utils::PerfStats total;        // 跨重启累计
+    algo_utils::PerfStats last_delta;   // 最近区间
+  };
+
+  std::map<Key, Entry> entries_;
+  mutable std::mutex mutex_;
+
+  static algo_utils::PerfStats diff(const algo_utils::PerfStats& now,
+                                    const algo_utils::PerfStats& prev);
+  static void accumulate(algo_utils::PerfStats& into, const algo_utils::PerfStats& delta);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline void PluginStatsAggregator::update(const std::string& camera_id,
+                                          const std::string& plugin_name,
+                                          const algo_utils::PerfStats& cumulative) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  Entry& entry = entries_[Key(camera_id, plugin_name)];
+  entry.last_delta = diff(cumulative, entry.last_raw);
+  accumulate(entry.total, entry.last_delta);
+  entry.last_raw = cumulative;
+}
+
+inline algo_utils::PerfStats PluginStatsAggregator::total(const std::string& camera_id,
+                                                          const std::string& plugin_name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(Key(camera_id, plugin_name));
+  return it != entries_.end() ? it->second.total : algo_utils::PerfStats();
+}
+
+inline algo_utils::PerfStats PluginStatsAggregator::interval(
+    const std::string& camera_id, const std::string& plugin_name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(Key(camera_id, plugin_name));
+  return it != entries_.end() ? it->second.last_delta : algo_utils::PerfStats();
+}
+
+inline algo_utils::PerfStats PluginStatsAggregator::totalByPlugin(
+    const std::string& plugin_name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  algo_utils::PerfStats merged;
+  for (const auto& pair : entries_) {
+    if (pair.first.second == plugin_name) {
+      accumulate(merged, pair.second.total);
+    }
+  }
+  return merged;
+}
+
+inline std::vector<std::pair<std::string, std::string>> PluginStatsAggregator::keys() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Key> result;
+  for (const auto& pair : entries_) {
+    result.push_back(pair.first);
+  }
+  return result;
+}
+
+inline void PluginStatsAggregator::removeCamera(const std::string& camera_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->first.first == camera_id) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+inline void PluginStatsAggregator::logSummary() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& pair : entries_) {
+    const algo_utils::PerfStats& delta = pair.second.last_delta;
+    LOG_INFO("[{}][{}] {} frames", pair.first.first, pair.first.second, delta.frames);
+    for (const auto& stage : delta.stages) {
+      LOG_INFO("  {:<12} calls {:>8}  avg {:>9.1f} us  p50 <{:>7.0f} us  p99 <{:>7.0f} us",
+               stage.name, stage.count, stage.avgUs(), stage.percentileUs(0.5),
+               stage.percentileUs(0.99));
+    }
+  }
+}
+
+inline algo_utils::PerfStats PluginStatsAggregator::diff(const algo_utils::PerfStats& now,
+                                                         const algo_utils::PerfStats& prev) {
+  // 帧数回退说明插件被重启（或统计被重置），新值本身就是增量
+  if (now.frames < prev.frames) {
+    return now;
+  }
+
+  algo_utils::PerfStats delta;
+  delta.frames = now.frames - prev.frames;
+  for (const auto& stage : now.stages) {
+    algo_utils::StageStats d = stage;
+    auto it = std::find_if(prev.stages.begin(), prev.stages.end(),
+                           [&](const algo_utils::StageStats& s) { return s.name == stage.name; });
+    if (it != prev.stages.end() && it->count <= stage.count) {
+      d.count -= it->count;
+      d.total_ns -= it->total_ns;
+      for (int b = 0; b < ALGO_STATS_HIST_BUCKETS; ++b) {
+        d.histogram[b] -= std::min(d.histogram[b], it->histogram[b]);
+      }
+      // 最大值无法做差，保留插件生命周期内的最大值
+    }
+    delta.stages.push_back(std::move(d));
+  }
+  return delta;
+}
+
+inline void PluginStatsAggregator::accumulate(algo_utils::PerfStats& into,
+                                              const algo_utils::PerfStats& delta) {
+  into.frames += delta.frames;
+  for (const auto& stage : delta.stages) {
+    auto it = std::find_if(into.stages.begin(), into.stages.end(),
+                           [&](const algo_utils::StageStats& s) { return s.name == stage.name; });
+    if (it == into.stages.end()) {
+      into.stages.push_back(stage);
+      continue;
+    }
+    it->count += stage.count;
+    it->total_ns += stage.total_ns;
+    it->max_ns = std::max(it->max_ns, stage.max_ns);
+    for (int b = 0; b < ALGO_STATS_HIST_BUCKETS; ++b) {
+      it->histogram[b] += stage.histogram[b];
+    }
+  }
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
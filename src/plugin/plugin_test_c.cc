@@ -1,20 +1,205 @@
 #include "plugin/plugin_loader_c.h"
 #include "plugin/algo_plugin_interface.h"
+#include "plugin/format_negotiation.h"
+#include "plugin/plugin_abi.h"
+#include "plugin/plugin_stats.h"
+#include "plugin/algo_instance.h"
+#include "plugin/algo_result_buffer.h"
+#include "plugin/motion_gated_detector.h"
+#include "plugin/tracking_pipeline.h"
+#include "algo_utils/letterbox.h"
+#include "algo_utils/nms.h"
+#include "algo_utils/roi.h"
+#include "algo_utils/tiling.h"
+#include "algo_utils/yolov8_decode.h"
+#include "algo_utils/yolov8_mask.h"
+#include "algo_utils/yolov8_postprocess.h"
 #include "utils/one_logger.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <cstddef>
 #include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 using namespace infer_frame;
 
+// 失败的检查数，非 0 时进程以 1 退出
+int g_failed_tests = 0;
+
 void printTestResult(const std::string& test_name, bool passed) {
   if (passed) {
     LOG_INFO("✓ {}", test_name);
   } else {
     LOG_ERROR("✗ {}", test_name);
+    ++g_failed_tests;
+  }
+}
+
+/**
+ * @brief YOLOv8 C 插件的模拟模型在每块区域输出的目标（模型输入坐标，见 yolov8_plugin_c.cpp）
+ */
+const algo_utils::DetCandidate kSimulatedObjects[] = {
+  {100.0f, 150.0f, 300.0f, 400.0f, 0.95f, 0, 0},    // person
+  {200.0f, 100.0f, 450.0f, 350.0f, 0.88f, 2, 1},    // car
+};
+
+/**
+ * @brief 按插件的流程独立计算预期结果：每块区域的模拟目标经掩码筛选、letterbox 与切片偏移
+ *        映射回原图，有全局视图时剔除贴内部边界的框，最后跨区域 NMS
+ */
+std::vector<algo_utils::DetCandidate> expectedDetections(
+    const std::vector<algo_utils::Tile>& tiles,
+    const std::vector<const algo_utils::RoiMask*>& masks, int frame_width, int frame_height) {
+  std::vector<algo_utils::DetCandidate> expected;
+  const bool cull_edges = tiles.size() > 1 && tiles.back().global;
+  for (size_t t = 0; t < tiles.size(); ++t) {
+    const algo_utils::LetterboxParams letterbox =
+        algo_utils::computeLetterbox(tiles[t].width, tiles[t].height, 640, 640);
+    for (algo_utils::DetCandidate candidate : kSimulatedObjects) {
+      if (masks[t] && !masks[t]->contains(0.5f * (candidate.x1 + candidate.x2),
+                                          0.5f * (candidate.y1 + candidate.y2))) {
+        continue;
+      }
+      algo_utils::mapTileToSource(letterbox, tiles[t], &candidate);
+      if (cull_edges &&
+          algo_utils::touchesInnerEdge(candidate, tiles[t], frame_width, frame_height)) {
+        continue;
+      }
+      expected.push_back(candidate);
+    }
+  }
+  algo_utils::NmsEngine nms;
+  nms.run(&expected);
+  return expected;
+}
+
+/**
+ * @brief 插件结果与预期逐框一致（按左上角排序后比较类别与坐标）
+ */
+bool sameDetections(std::vector<algo_utils::DetCandidate> expected, const AlgoDetResult& result) {
+  if (result.num_boxes != static_cast<int>(expected.size())) {
+    return false;
+  }
+  std::vector<AlgoDetBox> boxes(result.boxes, result.boxes + result.num_boxes);
+  auto by_corner = [](const auto& a, const auto& b) {
+    return a.x1 != b.x1 ? a.x1 < b.x1 : a.y1 < b.y1;
+  };
+  std::sort(expected.begin(), expected.end(), by_corner);
+  std::sort(boxes.begin(), boxes.end(), by_corner);
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    if (boxes[i].class_id != expected[i].class_id ||
+        std::fabs(boxes[i].x1 - expected[i].x1) > 0.5f ||
+        std::fabs(boxes[i].y1 - expected[i].y1) > 0.5f ||
+        std::fabs(boxes[i].x2 - expected[i].x2) > 0.5f ||
+        std::fabs(boxes[i].y2 - expected[i].y2) > 0.5f) {
+      return false;
+    }
   }
+  return true;
 }
 
+/**
+ * @brief 逐像素计算实例掩码（整图系数 x 原型 + 双线性插值 + logit 阈值），作为 MaskAssembler
+ *        的参照；返回 region 范围内每像素 0 / 1
+ */
+std::vector<uint8_t> bruteForceMask(const float* coefficients, const float* protos,
+                                    const algo_utils::MaskProtoLayout& layout,
+                                    const algo_utils::DetCandidate& box,
+                                    const algo_utils::LetterboxParams& letterbox,
+                                    algo_utils::MaskRegion* region) {
+  const int sx1 = std::max(0, static_cast<int>(std::floor(letterbox.toSrcX(box.x1))));
+  const int sy1 = std::max(0, static_cast<int>(std::floor(letterbox.toSrcY(box.y1))));
+  const int sx2 =
+      std::min(letterbox.src_width, static_cast<int>(std::ceil(letterbox.toSrcX(box.x2))));
+  const int sy2 =
+      std::min(letterbox.src_height, static_cast<int>(std::ceil(letterbox.toSrcY(box.y2))));
+  *region = {sx1, sy1, sx2 - sx1, sy2 - sy1};
+  std::vector<uint8_t> mask(region->pixels(), 0);
+  if (region->empty()) {
+    return mask;
+  }
+  auto logit = [&](int x, int y) {
+    float sum = 0.0f;
+    for (int k = 0; k < layout.num_protos; ++k) {
+      sum += coefficients[k] * protos[k * layout.planeSize() + y * layout.width + x];
+    }
+    return sum;
+  };
+  const float fx = static_cast<float>(layout.width) / letterbox.dst_width;
+  const float fy = static_cast<float>(layout.height) / letterbox.dst_height;
+  for (int y = 0; y < region->height; ++y) {
+    const float py = std::clamp(
+        ((sy1 + y + 0.5f) * letterbox.scale + letterbox.pad_y) * fy - 0.5f, 0.0f,
+        static_cast<float>(layout.height - 1));
+    const int y0 = static_cast<int>(py);
+    const int y1 = std::min(y0 + 1, layout.height - 1);
+    const float wy = py - y0;
+    for (int x = 0; x < region->width; ++x) {
+      const float px = std::clamp(
+          ((sx1 + x + 0.5f) * letterbox.scale + letterbox.pad_x) * fx - 0.5f, 0.0f,
+          static_cast<float>(layout.width - 1));
+      const int x0 = static_cast<int>(px);
+      const int x1 = std::min(x0 + 1, layout.width - 1);
+      const float left = logit(x0, y0) + wy * (logit(x0, y1) - logit(x0, y0));
+      const float right = logit(x1, y0) + wy * (logit(x1, y1) - logit(x1, y0));
+      mask[static_cast<size_t>(y) * region->width + x] =
+          left + (px - x0) * (right - left) > 0.0f ? 1 : 0;
+    }
+  }
+  return mask;
+}
+
+/**
+ * @brief RLE（从背景开始交替）还原为逐像素 0 / 1，游程总长不等于 pixels 时返回空
+ */
+std::vector<uint8_t> decodeRle(const std::vector<uint32_t>& runs, size_t pixels) {
+  std::vector<uint8_t> mask;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    mask.insert(mask.end(), runs[i], static_cast<uint8_t>(i & 1));
+  }
+  return mask.size() == pixels ? mask : std::vector<uint8_t>();
+}
+
+/**
+ * @brief 按脚本输出检测框、不读图像的检测流水线，用于验证 TrackingPipeline 的关联行为
+ */
+class ScriptedDetector {
+ public:
+  static constexpr int kMaxDetections = 8;
+
+  AlgoStatus init(const AlgoInitParam*) {
+    initialized_ = true;
+    return ALGO_STATUS_SUCCESS;
+  }
+  AlgoStatus setParams(const char*) { return ALGO_STATUS_SUCCESS; }
+  AlgoStatus deinit() {
+    initialized_ = false;
+    return ALGO_STATUS_SUCCESS;
+  }
+  bool isInitialized() const { return initialized_; }
+
+  void setDetections(std::vector<algo_utils::DetCandidate> detections) {
+    detections_ = std::move(detections);
+  }
+
+  AlgoStatus inferDetectionSoA(const AlgoTensor*, AlgoDetSoA* result) {
+    result->num_boxes = 0;
+    for (const algo_utils::DetCandidate& d : detections_) {
+      plugin::pushDetBox(result, d.x1, d.y1, d.x2, d.y2, d.score, d.class_id);
+    }
+    return ALGO_STATUS_SUCCESS;
+  }
+
+ private:
+  bool initialized_ = false;
+  std::vector<algo_utils::DetCandidate> detections_;
+};
+
 int main(int argc, char** argv) {
   LOG_INFO("======================================");
   LOG_INFO("  Plugin System Test (C Interface)");
@@ -83,6 +268,33 @@ int main(int argc, char** argv) {
     LOG_ERROR("Init failed with status: {}", static_cast<int>(status));
   }
   
+  // 测试 4.1: 输入格式协商（解码器可输出 NV12 或 BGR）
+  LOG_INFO("\n[Test 4.1] Negotiating input format...");
+  plugin::InputPlan plan;
+  bool negotiated = plugin::negotiateInputFormat(
+      loader.getInputCaps(handle, "YOLOv8"),
+      {ALGO_PIXEL_FORMAT_NV12, ALGO_PIXEL_FORMAT_BGR}, 1920, 1080, &plan);
+  if (negotiated) {
+    LOG_INFO("Decoder {} -> plugin {} {}x{}, host cost {:.1f} MB/frame{}",
+             plugin::pixelFormatName(plan.source_format),
+             plugin::pixelFormatName(plan.target.pixel_format), plan.width, plan.height,
+             plan.cost / (1024 * 1024), plan.passthrough() ? " (passthrough)" : "");
+  }
+  // 插件接受任意尺寸 NV12：解码器输出原样交给插件
+  printTestResult("Negotiate input format",
+                  negotiated && plan.source_format == ALGO_PIXEL_FORMAT_NV12 &&
+                  plan.target.pixel_format == ALGO_PIXEL_FORMAT_NV12 &&
+                  plan.target.data_type == ALGO_DATA_TYPE_UINT8 && plan.width == 1920 &&
+                  plan.height == 1080 && plan.passthrough());
+  // 未导出 AlgoGetInputCaps 的插件：退化为 BGR 任意尺寸
+  plugin::InputPlan legacy_plan;
+  negotiated = plugin::negotiateInputFormat(
+      nullptr, {ALGO_PIXEL_FORMAT_NV12, ALGO_PIXEL_FORMAT_BGR}, 1920, 1080, &legacy_plan);
+  printTestResult("Negotiate input format (legacy plugin)",
+                  negotiated && legacy_plan.source_format == ALGO_PIXEL_FORMAT_BGR &&
+                  legacy_plan.target.pixel_format == ALGO_PIXEL_FORMAT_BGR &&
+                  legacy_plan.passthrough());
+  
   // 测试 5: 执行推理
   LOG_INFO("\n[Test 5] Running inference...");
   
@@ -113,6 +325,567 @@ int main(int argc, char** argv) {
     }
   }
   
+  // 测试 5.0: 旧版（ABI 1）主程序只分配到 size 为止，追加字段按默认值解释
+  {
+    LOG_INFO("\n[Test 5.0] Interpreting ABI 1 tensor...");
+    const size_t legacy_size = offsetof(AlgoTensor, pixel_format);
+    std::unique_ptr<char[]> legacy_buffer(new char[legacy_size]);
+    std::memcpy(legacy_buffer.get(), &input, legacy_size);
+    AlgoTensor scratch;
+    const AlgoTensor* legacy = plugin::hostTensor(
+        reinterpret_cast<const AlgoTensor*>(legacy_buffer.get()), &scratch);
+    printTestResult("ABI 1 tensor", legacy == &scratch && legacy->ndim == 4 &&
+                    legacy->shape[3] == 640 && legacy->data == input.data &&
+                    legacy->pixel_format == ALGO_PIXEL_FORMAT_UNKNOWN &&
+                    legacy->row_stride == 0);
+  }
+  
+  // 测试 5.1: 通用 Tensor 推理（可选接口，输出缓冲由调用者分配）
+  if (loader.hasFunction("YOLOv8", "AlgoInferTensors")) {
+    LOG_INFO("\n[Test 5.1] Running tensor-in/tensor-out inference...");
+    AlgoTensor output;
+    int num_outputs = 1;
+    status = loader.getOutputInfo(handle, "YOLOv8", &output, &num_outputs);
+    std::vector<uint8_t> output_data(status == ALGO_STATUS_SUCCESS ? output.size : 0);
+    output.data = output_data.data();
+    if (status == ALGO_STATUS_SUCCESS) {
+      status = loader.inferTensors(handle, "YOLOv8", &input, 1, &output, 1);
+    }
+    bool shape_ok = output.ndim == 3 && output.shape[0] == 1 && output.shape[1] == 84 &&
+                    output.shape[2] == 8400 && output.size == 84 * 8400 * sizeof(float);
+    // 原始输出解码后应与同一输入的 AlgoInferDetection 结果一致
+    std::vector<algo_utils::DetCandidate> decoded;
+    if (status == ALGO_STATUS_SUCCESS && shape_ok) {
+      algo_utils::decodeYolov8(static_cast<const float*>(output.data), {80, 84, 8400}, 0.25f,
+                               &decoded);
+    }
+    bool same = static_cast<int>(decoded.size()) == result.num_boxes && !decoded.empty();
+    for (int i = 0; same && i < result.num_boxes; ++i) {
+      same = decoded[i].class_id == result.boxes[i].class_id &&
+             decoded[i].score == result.boxes[i].score && decoded[i].x1 == result.boxes[i].x1 &&
+             decoded[i].y2 == result.boxes[i].y2;
+    }
+    printTestResult("Infer tensors", status == ALGO_STATUS_SUCCESS && shape_ok && same);
+    if (status == ALGO_STATUS_SUCCESS) {
+      LOG_INFO("Output {}: [{}, {}, {}], {} bytes, {} anchors above threshold", output.name,
+               output.shape[0], output.shape[1], output.shape[2], output.size, decoded.size());
+    }
+  }
+  
+  // 测试 5.2: 分阶段性能计数（可选接口）
+  AlgoStats stats;
+  if (loader.getStats(handle, "YOLOv8", &stats) == ALGO_STATUS_SUCCESS) {
+    LOG_INFO("\n[Test 5.2] Querying plugin stage stats...");
+    plugin::PluginStatsAggregator aggregator;
+    aggregator.update("camera_test", "YOLOv8", stats);
+    algo_utils::PerfStats total = aggregator.total("camera_test", "YOLOv8");
+    printTestResult("Plugin stats", total.frames > 0 && !total.stages.empty());
+    aggregator.logSummary();
+  }
+  
+  // 测试 5.3: 在线更新阈值（不重新加载模型）
+  {
+    LOG_INFO("\n[Test 5.3] Updating params online...");
+    plugin::AlgoInstance instance(loader, "YOLOv8");
+    AlgoInitParam param = init_param;
+    param.config_json = R"({"conf_threshold": 0.25})";
+    instance.init(&param);
+    
+    param.config_json = R"({"conf_threshold": 0.9})";
+    bool reloaded = true;
+    status = instance.update(&param, &reloaded);
+    
+    AlgoDetResult filtered;
+    instance.inferDetection(&input, &filtered);
+    printTestResult("Update params without reload",
+                    status == ALGO_STATUS_SUCCESS && !reloaded && filtered.num_boxes == 1);
+    instance.freeDetResult(&filtered);
+    
+    param.config_json = R"({"conf_threshold": 0.9, "input_width": 1280, "input_height": 1280})";
+    status = instance.update(&param, &reloaded);
+    printTestResult("Update input size with reload", status == ALGO_STATUS_SUCCESS && reloaded);
+
+    // 新实例初始化失败：保留旧实例，继续按旧参数推理
+    std::vector<uint8_t> frame(plugin::imageBytes(ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8,
+                                                  640, 480), 114);
+    AlgoTensor bgr;
+    plugin::describeImageTensor(&bgr, "images", ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8,
+                                640, 480, frame.data());
+    const AlgoHandle before = instance.handle();
+    param.backend = ALGO_BACKEND_OPENVINO;
+    status = instance.update(&param, &reloaded);
+    AlgoDetResult kept;
+    AlgoStatus infer_status = instance.inferDetection(&bgr, &kept);
+    printTestResult("Failed reload keeps instance",
+                    status == ALGO_STATUS_ERROR_BACKEND_NOT_SUPPORTED && !reloaded &&
+                    instance.handle() == before && infer_status == ALGO_STATUS_SUCCESS &&
+                    kept.num_boxes == 1);
+    instance.freeDetResult(&kept);
+
+    // 删掉字段：合并语义下在线更新无法恢复默认值，改为重新加载（conf 回到 0.25）
+    param.backend = init_param.backend;
+    param.config_json = R"({"input_width": 1280, "input_height": 1280})";
+    status = instance.update(&param, &reloaded);
+    AlgoDetResult restored;
+    infer_status = instance.inferDetection(&bgr, &restored);
+    printTestResult("Removed param restores default",
+                    status == ALGO_STATUS_SUCCESS && reloaded &&
+                    infer_status == ALGO_STATUS_SUCCESS && restored.num_boxes == 2);
+    instance.freeDetResult(&restored);
+  }
+  
+  // 测试 5.4: 硬解码 NV12 直接推理（插件内部 letterbox，不转 BGR）
+  {
+    LOG_INFO("\n[Test 5.4] Running inference on NV12 input...");
+    const int width = 1920;
+    const int height = 1080;
+    std::vector<uint8_t> frame(plugin::imageBytes(ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8,
+                                                  width, height), 128);
+    AlgoTensor nv12;
+    plugin::describeImageTensor(&nv12, "images", ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8,
+                                width, height, frame.data());
+    AlgoDetResult nv12_result;
+    status = loader.inferDetection(handle, "YOLOv8", &nv12, &nv12_result);
+    printTestResult("Inference (NV12)", status == ALGO_STATUS_SUCCESS);
+    
+    // 声明的尺寸超出缓冲、或行跨度小于一行像素时拒绝，而不是越界读取
+    AlgoTensor truncated = nv12;
+    truncated.size = frame.size() - width;
+    AlgoDetResult rejected;
+    AlgoStatus truncated_status = loader.inferDetection(handle, "YOLOv8", &truncated, &rejected);
+    AlgoTensor narrow;
+    plugin::describeImageTensor(&narrow, "images", ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8,
+                                width / 2, height / 2, frame.data(), width / 2 * 3 - 1);
+    AlgoStatus narrow_status = loader.inferDetection(handle, "YOLOv8", &narrow, &rejected);
+    printTestResult("Reject undersized input",
+                    truncated_status == ALGO_STATUS_ERROR_INVALID_PARAM &&
+                        narrow_status == ALGO_STATUS_ERROR_INVALID_PARAM);
+    if (status == ALGO_STATUS_SUCCESS) {
+      loader.freeDetResult("YOLOv8", &nv12_result);
+    }
+  }
+  
+  // 测试 5.5: 4K 切片推理（重叠切片 + 全局视图作为一个 batch，跨切片 NMS）
+  {
+    LOG_INFO("\n[Test 5.5] Running tiled inference on 4K input...");
+    plugin::AlgoInstance instance(loader, "YOLOv8");
+    AlgoInitParam param = init_param;
+    param.config_json = R"({"tiling": true, "tile_overlap": 0.2, "max_tiles": 16})";
+    AlgoStatus init_status = instance.init(&param);
+    
+    const int width = 3840;
+    const int height = 2160;
+    std::vector<uint8_t> frame(plugin::imageBytes(ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8,
+                                                  width, height), 114);
+    AlgoTensor bgr;
+    plugin::describeImageTensor(&bgr, "images", ALGO_PIXEL_FORMAT_BGR, ALGO_DATA_TYPE_UINT8,
+                                width, height, frame.data());
+    AlgoDetResult tiled;
+    status = instance.inferDetection(&bgr, &tiled);
+    
+    // 同样的切片规划：每块切片与全局视图各有模拟目标，映射回原图后跨切片合并
+    algo_utils::TilingOptions tiling;
+    tiling.overlap = 0.2f;
+    tiling.max_tiles = 16;
+    algo_utils::TilePlanner planner(tiling);
+    const std::vector<algo_utils::Tile>& tiles = planner.plan(width, height);
+    std::vector<const algo_utils::RoiMask*> no_masks(tiles.size(), nullptr);
+    std::vector<algo_utils::DetCandidate> expected =
+        expectedDetections(tiles, no_masks, width, height);
+    printTestResult("Inference (tiled 4K)",
+                    init_status == ALGO_STATUS_SUCCESS && status == ALGO_STATUS_SUCCESS &&
+                        tiles.size() > 2 && sameDetections(expected, tiled));
+    if (status == ALGO_STATUS_SUCCESS) {
+      LOG_INFO("Tiles: {}, boxes after merge: {}", tiles.size(), tiled.num_boxes);
+      instance.freeDetResult(&tiled);
+    }
+  }
+  
+  // 测试 5.6: ROI 推理（矩形 + 多边形 ROI 组成一个 batch，多边形外的框在解码时剔除）
+  {
+    LOG_INFO("\n[Test 5.6] Running ROI-restricted inference...");
+    plugin::AlgoInstance instance(loader, "YOLOv8");
+    AlgoInitParam param = init_param;
+    param.config_json = R"({"rois": [{"rect": [0.05, 0.1, 0.3, 0.3]},
+                                     {"polygon": [[0.5, 0.2], [0.9, 0.2], [0.7, 0.9]]}],
+                            "roi_normalized": true})";
+    AlgoStatus init_status = instance.init(&param);
+    
+    const int width = 1920;
+    const int height = 1080;
+    std::vector<uint8_t> frame(plugin::imageBytes(ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8,
+                                                  width, height), 128);
+    AlgoTensor nv12;
+    plugin::describeImageTensor(&nv12, "images", ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8,
+                                width, height, frame.data());
+    AlgoDetResult roi_result;
+    status = instance.inferDetection(&nv12, &roi_result);
+    
+    // 每个 ROI 的外接矩形是一块区域；多边形外的框（按模型输入坐标的中心）被剔除
+    algo_utils::RoiSet rois;
+    rois.setRegions({algo_utils::roiRect(0.05f, 0.1f, 0.3f, 0.3f),
+                     algo_utils::roiPolygon({{0.5f, 0.2f}, {0.9f, 0.2f}, {0.7f, 0.9f}})},
+                    true);
+    std::vector<algo_utils::Tile> crops;
+    std::vector<const algo_utils::RoiMask*> masks;
+    for (const auto& roi : rois.resolve(width, height, 640, 640)) {
+      crops.push_back(roi.crop);
+      masks.push_back(&roi.mask);
+    }
+    std::vector<algo_utils::DetCandidate> expected =
+        expectedDetections(crops, masks, width, height);
+    printTestResult("Inference (ROI)",
+                    init_status == ALGO_STATUS_SUCCESS && status == ALGO_STATUS_SUCCESS &&
+                        crops.size() == 2 && sameDetections(expected, roi_result));
+    if (status == ALGO_STATUS_SUCCESS) {
+      LOG_INFO("ROI boxes: {} (expected {})", roi_result.num_boxes, expected.size());
+      instance.freeDetResult(&roi_result);
+    }
+  }
+  
+  // 测试 5.7: 运动门控（静止画面复用上一次结果，不调用插件）
+  {
+    LOG_INFO("\n[Test 5.7] Running motion-gated inference...");
+    plugin::AlgoInstance instance(loader, "YOLOv8");
+    AlgoInitParam param = init_param;
+    instance.init(&param);
+    
+    bool enabled = false;
+    algo_utils::MotionGateOptions gate_options;
+    bool parsed = plugin::MotionGatedDetector::parseConfig(
+        {{"motion_gate", "diff"}, {"motion_refresh_s", "5"}}, &enabled, &gate_options);
+    plugin::MotionGatedDetector detector(instance, enabled, gate_options);
+    
+    const int width = 1920;
+    const int height = 1080;
+    std::vector<uint8_t> frame(plugin::imageBytes(ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8,
+                                                  width, height), 128);
+    AlgoTensor nv12;
+    plugin::describeImageTensor(&nv12, "images", ALGO_PIXEL_FORMAT_NV12, ALGO_DATA_TYPE_UINT8,
+                                width, height, frame.data());
+    std::vector<AlgoDetBox> boxes;
+    bool first_reused = true;
+    bool second_reused = false;
+    status = detector.infer(&nv12, 0, &boxes, &first_reused);
+    if (status == ALGO_STATUS_SUCCESS) {
+      status = detector.infer(&nv12, 40, &boxes, &second_reused);
+    }
+    algo_utils::MotionGateStats gate_stats = detector.stats();
+    printTestResult("Motion gate skips static frame",
+                    parsed && status == ALGO_STATUS_SUCCESS && !first_reused && second_reused &&
+                        gate_stats.skipped == 1);
+    
+    // 非法配置整体拒绝：前面合法的键也不生效
+    bool rejected_enabled = false;
+    algo_utils::MotionGateOptions rejected_options;
+    const int default_threshold = rejected_options.pixel_threshold;
+    bool rejected = !plugin::MotionGatedDetector::parseConfig(
+        {{"motion_gate", "diff"}, {"motion_threshold", "300"}}, &rejected_enabled,
+        &rejected_options);
+    printTestResult("Invalid motion gate config leaves options unchanged",
+                    rejected && !rejected_enabled &&
+                        rejected_options.pixel_threshold == default_threshold);
+    LOG_INFO("Motion gate skip ratio: {:.2f} (simd: {})", gate_stats.skipRatio(),
+             algo_utils::motionGateUsesSimd());
+  }
+  
+  // 测试 5.8: 紧凑检测结果（调用者数组，类别名称表由插件发布一次）
+  {
+    LOG_INFO("\n[Test 5.8] Running inference with compact SoA result...");
+    plugin::AlgoInstance instance(loader, "YOLOv8");
+    AlgoInitParam param = init_param;
+    instance.init(&param);
+    
+    AlgoDetResult legacy = {};
+    AlgoStatus legacy_status = instance.inferDetection(&input, &legacy);
+    plugin::DetSoABuffer buffer(1);    // 容量不足，inferWithRetry 扩容后重试
+    status = plugin::inferWithRetry(buffer, [&](AlgoDetSoA* r) {
+      return instance.inferDetectionSoA(&input, r);
+    });
+    const AlgoDetSoA& soa = buffer.result();
+    plugin::ClassNameTable names = instance.classNames();
+    bool same = legacy_status == ALGO_STATUS_SUCCESS && soa.num_boxes == legacy.num_boxes;
+    for (int i = 0; same && i < soa.num_boxes; ++i) {
+      same = soa.x1[i] == legacy.boxes[i].x1 && soa.class_id[i] == legacy.boxes[i].class_id &&
+             std::strcmp(names.name(soa.class_id[i]), legacy.boxes[i].class_name) == 0;
+    }
+    printTestResult("SoA result matches legacy result",
+                    status == ALGO_STATUS_SUCCESS && same && names.count == 80 &&
+                        std::strcmp(names.name(0), "person") == 0);
+    for (int i = 0; i < buffer.size(); ++i) {
+      LOG_INFO("  [{}] {} - score: {:.2f}", i, names.name(soa.class_id[i]), soa.score[i]);
+    }
+    if (legacy_status == ALGO_STATUS_SUCCESS) {
+      instance.freeDetResult(&legacy);
+    }
+  }
+  
+  // 测试 5.9: AVX2 letterbox 与标量逐位一致（奇数尺寸、带行填充的 stride、多段并行、拉伸）
+  {
+    LOG_INFO("\n[Test 5.9] Comparing AVX2 letterbox with scalar...");
+    const int sizes[][4] = {{637, 361, 640, 640}, {1001, 999, 321, 257}, {13, 7, 640, 384},
+                            {1921, 1081, 640, 640}};
+    bool identical = true;
+    for (const auto& size : sizes) {
+      const int width = size[0];
+      const int height = size[1];
+      const size_t stride = static_cast<size_t>(width) * 3 + 13;
+      std::vector<uint8_t> image(stride * height);
+      for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+      }
+      const size_t plane = static_cast<size_t>(size[2]) * size[3];
+      for (bool keep_aspect : {true, false}) {
+        std::vector<float> scalar(3 * plane);
+        std::vector<float> simd(3 * plane);
+        std::vector<float> banded(3 * plane);
+        algo_utils::LetterboxOptions options;
+        options.keep_aspect = keep_aspect;
+        options.allow_simd = false;
+        algo_utils::LetterboxParams params = algo_utils::letterboxToPlanar(
+            image.data(), width, height, stride, scalar.data(), size[2], size[3], options);
+        options.allow_simd = true;
+        algo_utils::letterboxToPlanar(image.data(), width, height, stride, simd.data(), size[2],
+                                      size[3], options);
+        options.num_threads = 3;
+        algo_utils::letterboxToPlanar(image.data(), width, height, stride, banded.data(),
+                                      size[2], size[3], options);
+        // 拉伸：无填充，原图四角映射到输出四角
+        const bool geometry = keep_aspect ||
+            (params.pad_x == 0 && params.pad_y == 0 && params.new_width == size[2] &&
+             params.new_height == size[3] && std::abs(params.toSrcX(size[2]) - width) < 1e-2f &&
+             std::abs(params.toSrcY(size[3]) - height) < 1e-2f);
+        identical = identical && geometry &&
+                    std::memcmp(scalar.data(), simd.data(), scalar.size() * sizeof(float)) == 0 &&
+                    std::memcmp(scalar.data(), banded.data(), scalar.size() * sizeof(float)) == 0;
+      }
+    }
+    printTestResult("AVX2 letterbox matches scalar (letterbox and stretch)", identical);
+    LOG_INFO("Letterbox simd: {}", algo_utils::letterboxUsesSimd());
+  }
+  
+  // 测试 5.10: 跟踪流水线：轨迹 ID 跨帧稳定，短暂遮挡后重新关联到原轨迹
+  {
+    LOG_INFO("\n[Test 5.10] Tracking objects across frames...");
+    plugin::TrackingPipeline<ScriptedDetector> tracking;
+    AlgoInitParam param = {};
+    param.config_json = "{\"detect_interval\": 1}";
+    AlgoStatus track_status = tracking.init(&param);
+    
+    uint8_t pixel = 0;
+    AlgoTensor frame = {};
+    frame.data = &pixel;
+    AlgoTrackObject objects[8];
+    AlgoTrackResult result = {objects, 8, 0, 0, 0};
+    uint32_t first_id[2] = {0, 0};
+    bool stable = true;
+    bool hidden_while_occluded = true;
+    bool reacquired = false;
+    for (int k = 0; k < 14 && track_status == ALGO_STATUS_SUCCESS; ++k) {
+      // 目标 0（person）每帧右移 6 像素，第 6..8 帧被遮挡；目标 1（car）每帧下移 4 像素
+      const bool occluded = k >= 6 && k <= 8;
+      const float dx = 6.0f * k;
+      const float dy = 4.0f * k;
+      std::vector<algo_utils::DetCandidate> detections;
+      if (!occluded) {
+        detections.push_back({100.0f + dx, 100.0f, 200.0f + dx, 300.0f, 0.9f, 0, 0});
+      }
+      detections.push_back({400.0f, 120.0f + dy, 520.0f, 220.0f + dy, 0.85f, 2, 1});
+      tracking.setDetections(detections);
+      track_status = tracking.inferTrack(&frame, &result);
+      
+      bool seen[2] = {false, false};
+      for (int i = 0; i < result.num_objects; ++i) {
+        const int object = objects[i].class_id == 0 ? 0 : 1;
+        seen[object] = true;
+        if (first_id[object] == 0) {
+          first_id[object] = objects[i].track_id;
+        }
+        stable = stable && objects[i].track_id == first_id[object];
+      }
+      stable = stable && seen[1] && (occluded || seen[0]);
+      hidden_while_occluded = hidden_while_occluded && !(occluded && seen[0]);
+      reacquired = k > 8 && seen[0];
+    }
+    printTestResult("Track IDs stable across frames and occlusion",
+                    track_status == ALGO_STATUS_SUCCESS && stable && hidden_while_occluded &&
+                        reacquired && first_id[0] != 0 && first_id[1] != 0 &&
+                        first_id[0] != first_id[1]);
+    LOG_INFO("Track ids: person {}, car {}", first_id[0], first_id[1]);
+    tracking.deinit();
+  }
+  
+  // 测试 5.11: 实例掩码：延迟组装与逐像素计算一致，RLE / 位图还原后相同
+  {
+    LOG_INFO("\n[Test 5.11] Assembling instance masks...");
+    const algo_utils::MaskProtoLayout layout{8, 40, 32};
+    const algo_utils::LetterboxParams letterbox = algo_utils::computeLetterbox(333, 250, 160, 128);
+    std::vector<float> protos(layout.num_protos * layout.planeSize());
+    uint32_t seed = 12345;
+    auto uniform = [&seed] {
+      seed = seed * 1664525u + 1013904223u;
+      return static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;    // [-1, 1)
+    };
+    for (float& v : protos) {
+      v = uniform();
+    }
+    // 普通框、越过原图右下边界的框、小于一个原型像素的框
+    const algo_utils::DetCandidate boxes[] = {
+      {20.5f, 18.0f, 90.25f, 70.0f, 0.9f, 0, 0},
+      {120.0f, 80.0f, 175.0f, 140.0f, 0.8f, 1, 1},
+      {60.2f, 40.1f, 61.0f, 41.3f, 0.7f, 2, 2},
+    };
+    algo_utils::MaskAssembler scalar(false);
+    algo_utils::MaskAssembler simd(true);
+    bool matches = true;
+    size_t foreground = 0;
+    for (const algo_utils::DetCandidate& box : boxes) {
+      float coefficients[8];
+      for (float& c : coefficients) {
+        c = uniform();
+      }
+      algo_utils::MaskRegion expected_region;
+      const std::vector<uint8_t> expected =
+          bruteForceMask(coefficients, protos.data(), layout, box, letterbox, &expected_region);
+      for (algo_utils::MaskAssembler* assembler : {&scalar, &simd}) {
+        const algo_utils::MaskRegion region =
+            assembler->assemble(coefficients, protos.data(), layout, box, letterbox);
+        std::vector<uint32_t> runs;
+        std::vector<uint8_t> bits;
+        const size_t rle_count = assembler->encodeRle(&runs);
+        const size_t bit_count = assembler->encodeBitmask(&bits);
+        const size_t row_bytes = (static_cast<size_t>(region.width) + 7) / 8;
+        std::vector<uint8_t> unpacked(region.pixels());
+        for (size_t i = 0; i < unpacked.size(); ++i) {
+          const size_t x = i % region.width;
+          const size_t y = i / region.width;
+          unpacked[i] = (bits[y * row_bytes + x / 8] >> (7 - x % 8)) & 1;
+        }
+        const size_t expected_count = std::count(expected.begin(), expected.end(), 1);
+        matches = matches && region.x == expected_region.x && region.y == expected_region.y &&
+                  region.width == expected_region.width &&
+                  region.height == expected_region.height &&
+                  decodeRle(runs, region.pixels()) == expected && unpacked == expected &&
+                  rle_count == expected_count && bit_count == expected_count;
+      }
+      foreground += std::count(expected.begin(), expected.end(), 1);
+    }
+    printTestResult("Lazy mask matches brute force (RLE and bitmask)",
+                    matches && foreground > 0);
+    LOG_INFO("Mask foreground pixels: {} (simd: {})", foreground, algo_utils::maskUsesSimd());
+  }
+  
+  // 测试 5.12: 姿态关键点：NMS 幸存框读取自己 anchor 的关键点，映射回原图
+  {
+    LOG_INFO("\n[Test 5.12] Decoding pose keypoints...");
+    constexpr int kKeypoints = 17;
+    const algo_utils::Yolov8OutputLayout layout{1, 5 + 3 * kKeypoints, 96};
+    const algo_utils::LetterboxParams letterbox = algo_utils::computeLetterbox(320, 200, 160, 128);
+    std::vector<float> output(layout.imageStride(), 0.0f);
+    auto set = [&](int channel, int anchor, float value) {
+      output[static_cast<size_t>(channel) * layout.num_anchors + anchor] = value;
+    };
+    // anchor 21 与 anchor 70 是同一个人（后者分数低、被 NMS 抑制），关键点各不相同
+    const int anchors[] = {21, 70};
+    const float scores[] = {0.9f, 0.6f};
+    for (int n = 0; n < 2; ++n) {
+      set(0, anchors[n], 80.0f + n);
+      set(1, anchors[n], 60.0f);
+      set(2, anchors[n], 40.0f);
+      set(3, anchors[n], 80.0f);
+      set(4, anchors[n], scores[n]);
+      for (int k = 0; k < kKeypoints; ++k) {
+        set(5 + 3 * k, anchors[n], 50.0f + 3.0f * k + 100.0f * n);
+        set(6 + 3 * k, anchors[n], 25.0f + 4.0f * k);
+        set(7 + 3 * k, anchors[n], 0.5f + 0.01f * k);
+      }
+    }
+    std::vector<algo_utils::DetCandidate> candidates;
+    algo_utils::decodeYolov8(output.data(), layout, 0.25f, &candidates);
+    algo_utils::NmsEngine nms;
+    nms.run(&candidates);
+    bool decoded = candidates.size() == 1 && candidates[0].anchor == 21;
+    if (decoded) {
+      algo_utils::Keypoint keypoints[kKeypoints];
+      algo_utils::decodeKeypoints(output.data(), layout, candidates[0], kKeypoints, keypoints);
+      for (int k = 0; k < kKeypoints; ++k) {
+        algo_utils::mapToSource(letterbox, &keypoints[k]);
+        const float x = std::clamp(letterbox.toSrcX(50.0f + 3.0f * k), 0.0f, 320.0f);
+        const float y = std::clamp(letterbox.toSrcY(25.0f + 4.0f * k), 0.0f, 200.0f);
+        decoded = decoded && std::fabs(keypoints[k].x - x) < 1e-4f &&
+                  std::fabs(keypoints[k].y - y) < 1e-4f &&
+                  keypoints[k].score == 0.5f + 0.01f * k;
+      }
+    }
+    printTestResult("Pose keypoints follow the surviving anchor", decoded);
+  }
+  
+  // 测试 5.13: 共享执行器：任务异常计入所属 TaskGroup 并交给错误回调
+  {
+    LOG_INFO("\n[Test 5.13] Reporting task exceptions...");
+    std::atomic<int> reported{0};
+    TaskExecutorOptions executor_options;
+    executor_options.num_workers = 2;
+    executor_options.on_task_error = [&reported](const char* what) {
+      reported.fetch_add(std::strcmp(what, "bad frame") == 0 ? 1 : 100);
+    };
+    TaskExecutor executor(executor_options);
+    TaskGroup group;
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 8; ++i) {
+      executor.submit(group, [&completed, i] {
+        if (i == 3) {
+          throw std::runtime_error("bad frame");
+        }
+        completed.fetch_add(1);
+      });
+    }
+    executor.wait(group);
+    printTestResult("Task exceptions reported",
+                    group.failed() == 1 && completed.load() == 7 && reported.load() == 1 &&
+                        executor.stats().failed == 1);
+  }
+  
+  // 测试 5.14: YOLOv8Plugin 的后处理：在线更新的 conf / nms 阈值改变输出
+  {
+    LOG_INFO("\n[Test 5.14] Post-processing with updated thresholds...");
+    const algo_utils::Yolov8OutputLayout layout{2, 6, 64};
+    const algo_utils::LetterboxParams letterbox = algo_utils::computeLetterbox(640, 480, 640, 640);
+    std::vector<float> output(layout.imageStride(), 0.0f);
+    auto set_box = [&](int anchor, float cx, float cy, float size, int class_id, float score) {
+      const float values[] = {cx, cy, size, size};
+      for (int c = 0; c < 4; ++c) {
+        output[static_cast<size_t>(c) * layout.num_anchors + anchor] = values[c];
+      }
+      output[static_cast<size_t>(4 + class_id) * layout.num_anchors + anchor] = score;
+    };
+    // anchor 3 与 anchor 10 同类、IoU 约 0.78；anchor 40 是另一类的低分框
+    set_box(3, 100.0f, 200.0f, 80.0f, 0, 0.9f);
+    set_box(10, 110.0f, 200.0f, 80.0f, 0, 0.5f);
+    set_box(40, 300.0f, 300.0f, 40.0f, 1, 0.3f);
+    
+    algo_utils::NmsEngine nms;
+    std::vector<std::vector<algo_utils::DetCandidate>> detections;
+    auto count = [&](float conf_threshold, float nms_threshold) {
+      algo_utils::postprocessYolov8(output.data(), 1, layout, conf_threshold, nms_threshold,
+                                    &letterbox, &nms, &detections);
+      return detections.size() == 1 ? detections[0].size() : size_t(0);
+    };
+    const size_t defaults = count(0.25f, 0.45f);
+    const algo_utils::DetCandidate top = detections[0].empty() ? algo_utils::DetCandidate()
+                                                               : detections[0][0];
+    const size_t strict_conf = count(0.4f, 0.45f);
+    const size_t loose_nms = count(0.25f, 0.8f);
+    LOG_INFO("Boxes: default {}, conf 0.4 -> {}, nms 0.8 -> {}", defaults, strict_conf,
+             loose_nms);
+    printTestResult("Post-process honours thresholds",
+                    defaults == 2 && strict_conf == 1 && loose_nms == 3);
+    printTestResult("Post-process maps boxes to source",
+                    top.score == 0.9f && top.class_id == 0 &&
+                        std::fabs(top.x1 - letterbox.toSrcX(60.0f)) < 1e-4f &&
+                        std::fabs(top.y1 - letterbox.toSrcY(160.0f)) < 1e-4f);
+  }
+    
   // 测试 6: 反初始化
   LOG_INFO("\n[Test 6] Deinitializing...");
   status = loader.deinitAlgo(handle, "YOLOv8");
@@ -129,8 +902,12 @@ int main(int argc, char** argv) {
   printTestResult("Unload plugin", unload_success);
   
   LOG_INFO("\n======================================");
-  LOG_INFO("  All tests completed!");
+  if (g_failed_tests > 0) {
+    LOG_ERROR("  {} test(s) failed", g_failed_tests);
+  } else {
+    LOG_INFO("  All tests completed!");
+  }
   LOG_INFO("======================================");
   
-  return 0;
+  return g_failed_tests > 0 ? 1 : 0;
 }
@@ -0,0 +1,227 @@
+/**
+ * @file plugin_worker.cc
+ * @brief 插件沙箱 worker 进程（由 PluginSandbox fork/exec 启动）
+ *
+ * 用法: infer_frame_plugin_worker --plugin <path.so> --shm-fd <fd>
+ *
+ * worker 在独立进程中加载插件，从共享内存 Slot 中原地读取帧、
+ * 执行推理并把检测结果写回同一个 Slot。插件崩溃只影响本进程。
+ */
+
+#include "plugin/plugin_loader_c.h"
+#include "plugin/sandbox_shm.h"
+#include "utils/one_logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace infer_frame::plugin;
+
+namespace {
+
+constexpr int kIdleWaitMs = 100;
+
+bool handleInit(PluginLoaderC& loader, const std::string& plugin_name,
+                AlgoHandle handle, sandbox::ShmHeader* header) {
+  const char* payload = sandbox::ctrlPayload(header);
+
+  AlgoInitParam param;
+  param.model_path = payload;
+  param.config_json = header->config_json_len > 0 ? payload + header->model_path_len + 1
+                                                  : nullptr;
+  param.backend = static_cast<AlgoBackendType>(header->backend);
+  param.device_id = header->device_id;
+
+  // 重复初始化（例如主进程更新参数）时先反初始化
+  loader.deinitAlgo(handle, plugin_name);
+  AlgoStatus status = loader.initAlgo(handle, plugin_name, &param);
+
+  // 上报输入能力，主进程据此协商送帧格式
+  const AlgoInputCaps* caps = status == ALGO_STATUS_SUCCESS
+                                  ? loader.getInputCaps(handle, plugin_name) : nullptr;
+  header->num_input_formats = 0;
+  if (caps && caps->formats) {
+    int num = std::min(caps->num_formats, sandbox::kMaxInputFormats);
+    std::memcpy(header->input_formats, caps->formats, sizeof(AlgoInputFormat) * num);
+    header->num_input_formats = num;
+    header->max_width = caps->max_width;
+    header->max_height = caps->max_height;
+    header->size_align = caps->size_align;
+  }
+
+  header->ctrl_status = status;
+  header->ctrl_state.store(status == ALGO_STATUS_SUCCESS ? sandbox::kCtrlInitDone
+                                                         : sandbox::kCtrlInitFailed,
+                           std::memory_order_release);
+  sandbox::futexWakeAll(&header->ctrl_state);
+  return status == ALGO_STATUS_SUCCESS;
+}
+
+void handleSetParams(PluginLoaderC& loader, const std::string& plugin_name,
+                     AlgoHandle handle, sandbox::ShmHeader* header) {
+  AlgoStatus status = loader.setParams(handle, plugin_name, sandbox::ctrlPayload(header));
+  header->ctrl_status = status;
+  header->ctrl_state.store(status == ALGO_STATUS_SUCCESS ? sandbox::kCtrlInitDone
+                                                         : sandbox::kCtrlInitFailed,
+                           std::memory_order_release);
+  sandbox::futexWakeAll(&header->ctrl_state);
+}
+
+void handleSlot(PluginLoaderC& loader, const std::string& plugin_name,
+                AlgoHandle handle, sandbox::ShmHeader* header, sandbox::SlotHeader* slot) {
+  slot->worker_begin_ns = sandbox::monotonicNs();
+
+  // 帧数据就在共享内存中，直接把指针交给插件
+  AlgoTensor input = slot->tensor;
+  input.data = sandbox::slotInput(slot);
+
+  AlgoDetResult result;
+  result.boxes = nullptr;
+  result.num_boxes = 0;
+  result.timestamp = 0;
+  AlgoStatus status = loader.inferDetection(handle, plugin_name, &input, &result);
+
+  int num = 0;
+  if (status == ALGO_STATUS_SUCCESS && result.boxes && result.num_boxes > 0) {
+    num = std::min(result.num_boxes, static_cast<int>(header->max_boxes));
+    std::memcpy(sandbox::slotBoxes(header, slot), result.boxes, sizeof(AlgoDetBox) * num);
+  }
+  slot->truncated = result.num_boxes > num ? 1 : 0;
+  slot->num_boxes = num;
+  slot->timestamp = result.timestamp;
+  slot->status = status;
+  loader.freeDetResult(plugin_name, &result);
+
+  slot->worker_end_ns = sandbox::monotonicNs();
+  slot->state.store(sandbox::kSlotDone);
+  sandbox::futexWakeIfWaiting(&slot->state, &slot->host_waiting);
+}
+
+/**
+ * @brief 未初始化（或初始化失败）时直接完成请求，主进程不会一直等待
+ */
+void rejectSlot(sandbox::SlotHeader* slot, AlgoStatus status) {
+  slot->worker_begin_ns = slot->worker_end_ns = sandbox::monotonicNs();
+  slot->num_boxes = 0;
+  slot->truncated = 0;
+  slot->timestamp = 0;
+  slot->status = status;
+  slot->state.store(sandbox::kSlotDone);
+  sandbox::futexWakeIfWaiting(&slot->state, &slot->host_waiting);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string plugin_path;
+  int shm_fd = -1;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--plugin" && i + 1 < argc) {
+      plugin_path = argv[++i];
+    } else if (arg == "--shm-fd" && i + 1 < argc) {
+      shm_fd = std::stoi(argv[++i]);
+    }
+  }
+
+  if (plugin_path.empty() || shm_fd < 0) {
+    LOG_ERROR("Usage: {} --plugin <path.so> --shm-fd <fd>", argv[0]);
+    return 2;
+  }
+
+  // 1. 映射共享内存
+  struct stat st;
+  if (fstat(shm_fd, &st) != 0 || st.st_size <= 0) {
+    LOG_ERROR("Invalid sandbox shm fd: {}", shm_fd);
+    return 2;
+  }
+  void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, shm_fd, 0);
+  if (addr == MAP_FAILED) {
+    LOG_ERROR("mmap sandbox shm failed: {}", strerror(errno));
+    return 2;
+  }
+  auto* header = static_cast<sandbox::ShmHeader*>(addr);
+  if (header->magic != sandbox::kShmMagic || header->version != sandbox::kShmVersion) {
+    LOG_ERROR("Sandbox shm magic/version mismatch");
+    return 2;
+  }
+
+  // 2. 在本进程内加载插件
+  PluginLoaderC loader;
+  if (!loader.loadPlugin(plugin_path)) {
+    return 3;
+  }
+  std::vector<std::string> names = loader.getLoadedPlugins();
+  if (names.empty()) {
+    return 3;
+  }
+  const std::string plugin_name = names.front();
+  const AlgoInfo* info = loader.getPluginInfo(plugin_name);
+  snprintf(header->plugin_name, sizeof(header->plugin_name), "%s", info->name);
+  snprintf(header->plugin_version, sizeof(header->plugin_version), "%s", info->version);
+
+  AlgoHandle handle = loader.createAlgoInstance(plugin_name);
+  if (!handle) {
+    LOG_ERROR("Failed to create algorithm instance in worker");
+    return 3;
+  }
+  header->worker_ready.store(1, std::memory_order_release);
+  LOG_INFO("Plugin worker ready: {} (pid {})", plugin_name, getpid());
+
+  // 3. 服务循环：轮询控制通道与所有 Slot，无事可做时在门铃上休眠
+  // 重启后的 worker 在收到重放的初始化之前保留已提交的帧；初始化失败后直接拒绝
+  bool initialized = false;
+  bool init_attempted = false;
+  uint32_t next = 0;
+  while (true) {
+    uint32_t bell = header->doorbell.load(std::memory_order_acquire);
+
+    uint32_t ctrl = header->ctrl_state.load(std::memory_order_acquire);
+    if (ctrl == sandbox::kCtrlShutdown) {
+      break;
+    }
+    if (ctrl == sandbox::kCtrlInitRequest) {
+      initialized = handleInit(loader, plugin_name, handle, header);
+      init_attempted = true;
+    } else if (ctrl == sandbox::kCtrlSetParamsRequest) {
+      // 在两帧之间执行，不会与 handleSlot 并发
+      handleSetParams(loader, plugin_name, handle, header);
+    }
+
+    bool worked = false;
+    for (uint32_t n = 0; init_attempted && n < header->num_slots; ++n) {
+      uint32_t index = (next + n) % header->num_slots;
+      sandbox::SlotHeader* slot = sandbox::slotAt(header, index);
+      uint32_t expected = sandbox::kSlotRequest;
+      if (slot->state.compare_exchange_strong(expected, sandbox::kSlotProcessing,
+                                              std::memory_order_acq_rel)) {
+        if (initialized) {
+          handleSlot(loader, plugin_name, handle, header, slot);
+        } else {
+          rejectSlot(slot, ALGO_STATUS_ERROR_NOT_INITIALIZED);
+        }
+        next = index + 1;
+        worked = true;
+      }
+    }
+
+    if (!worked) {
+      if (sandbox::spinWhileEqual(&header->doorbell, bell, header->worker_spin_ns) == bell) {
+        sandbox::futexWaitFlagged(&header->doorbell, bell, &header->worker_waiting, kIdleWaitMs);
+      }
+    }
+  }
+
+  loader.deinitAlgo(handle, plugin_name);
+  loader.destroyAlgoInstance(handle, plugin_name);
+  loader.unloadAll();
+  munmap(addr, static_cast<size_t>(st.st_size));
+  LOG_INFO("Plugin worker exit: {}", plugin_name);
+  return 0;
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+/**
+ * @file sandbox_shm.h
+ * @brief 插件沙箱共享内存布局（主进程与 worker 进程共用）
+ *
+ * 内存布局（memfd 映射，两端地址不同，因此只保存偏移量）：
+ *
+ *   ┌──────────────┬──────────────────┬────────┬────────┬─────┐
+ *   │ ShmHeader    │ 控制区 payload    │ Slot 0 │ Slot 1 │ ... │
+ *   └──────────────┴──────────────────┴────────┴────────┴─────┘
+ *
+ *   Slot = [SlotHeader][输入帧数据 input_capacity][AlgoDetBox x max_boxes]
+ *
+ * 帧数据由主进程直接写入 Slot 输入区（零拷贝），worker 原地推理，
+ * 检测结果写回同一个 Slot 的结果区。同步使用共享内存上的 futex。
+ */
+
+#include "plugin/algo_plugin_interface.h"
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infer_frame {
+namespace plugin {
+namespace sandbox {
+
+constexpr uint32_t kShmMagic = 0x49465342;   // "IFSB"
+constexpr uint32_t kShmVersion = 3;
+constexpr size_t kCtrlPayloadSize = 64 * 1024;
+constexpr size_t kShmAlign = 64;
+constexpr int kMaxInputFormats = 16;
+
+/**
+ * @brief Slot 状态（同时作为 futex 字）
+ */
+enum SlotState : uint32_t {
+  kSlotFree = 0,         // 空闲
+  kSlotFilling = 1,      // 主进程占用，正在写入帧数据
+  kSlotRequest = 2,      // 已提交，等待 worker 处理
+  kSlotProcessing = 3,   // worker 处理中
+  kSlotDone = 4          // 处理完成，结果可读
+};
+
+/**
+ * @brief 控制通道状态
+ */
+enum CtrlState : uint32_t {
+  kCtrlIdle = 0,
+  kCtrlInitRequest = 1,   // 主进程请求初始化（参数在控制区 payload）
+  kCtrlInitDone = 2,      // 命令执行完成（初始化 / 参数更新）
+  kCtrlInitFailed = 3,    // 命令执行失败，状态码在 ctrl_status
+  kCtrlShutdown = 4,      // 主进程请求 worker 退出
+  kCtrlSetParamsRequest = 5  // 主进程请求在线更新参数（JSON 在控制区 payload 起始处）
+};
+
+/**
+ * @brief 共享内存头
+ */
+struct alignas(kShmAlign) ShmHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t max_boxes;
+  uint64_t slot_stride;              // 单个 Slot 总字节数
+  uint64_t input_capacity;           // 单帧输入区字节数
+  uint64_t slots_offset;             // Slot 0 相对映射起始地址的偏移
+  int64_t worker_spin_ns;            // worker 空闲后继续自旋的时间
+
+  // worker 加载插件后填写
+  char plugin_name[64];
+  char plugin_version[32];
+  std::atomic<uint32_t> worker_ready;
+
+  // 门铃：有新请求或控制命令时 +1，worker 在此 futex 等待
+  alignas(kShmAlign) std::atomic<uint32_t> doorbell;
+  std::atomic<uint32_t> worker_waiting;   // worker 在门铃上 futex 休眠时为 1
+
+  // 控制通道
+  alignas(kShmAlign) std::atomic<uint32_t> ctrl_state;
+  int32_t ctrl_status;
+  int32_t backend;
+  int32_t device_id;
+  uint32_t model_path_len;           // payload 内 [0, model_path_len) 为模型路径
+  uint32_t config_json_len;          // 紧随其后为 config_json（0 表示 NULL）
+
+  // 初始化成功后 worker 填写的插件输入能力（num_input_formats 为 0 表示插件未声明）
+  int32_t num_input_formats;
+  int32_t max_width;
+  int32_t max_height;
+  int32_t size_align;
+  AlgoInputFormat input_formats[kMaxInputFormats];
+};
+
+/**
+ * @brief Slot 头（每帧一个请求/响应）
+ */
+struct alignas(kShmAlign) SlotHeader {
+  std::atomic<uint32_t> state;
+  std::atomic<uint32_t> host_waiting;     // 主进程在 state 上 futex 休眠时为 1
+  int32_t status;                    // AlgoStatus
+  uint64_t seq;                      // 提交序号
+
+  // 输入描述（tensor.data 在 worker 侧重写为本 Slot 的输入区地址）
+  AlgoTensor tensor;
+
+  // 结果
+  int32_t num_boxes;
+  int32_t truncated;                 // 结果数超过 max_boxes 时置 1
+  int64_t timestamp;
+
+  // worker 侧计时（CLOCK_MONOTONIC，两进程可直接比较）
+  int64_t worker_begin_ns;
+  int64_t worker_end_ns;
+};
+
+inline constexpr size_t alignUp(size_t value, size_t align) {
+  return (value + align - 1) / align * align;
+}
+
+inline size_t slotStride(size_t input_capacity, uint32_t max_boxes) {
+  return alignUp(sizeof(SlotHeader), kShmAlign) +
+         alignUp(input_capacity, kShmAlign) +
+         alignUp(sizeof(AlgoDetBox) * max_boxes, kShmAlign);
+}
+
+inline size_t shmTotalSize(uint32_t num_slots, size_t input_capacity, uint32_t max_boxes) {
+  return alignUp(sizeof(ShmHeader), kShmAlign) + kCtrlPayloadSize +
+         slotStride(input_capacity, max_boxes) * num_slots;
+}
+
+inline char* ctrlPayload(ShmHeader* header) {
+  return reinterpret_cast<char*>(header) + alignUp(sizeof(ShmHeader), kShmAlign);
+}
+
+inline SlotHeader* slotAt(ShmHeader* header, uint32_t index) {
+  char* base = reinterpret_cast<char*>(header) + header->slots_offset;
+  return reinterpret_cast<SlotHeader*>(base + header->slot_stride * index);
+}
+
+inline char* slotInput(SlotHeader* slot) {
+  return reinterpret_cast<char*>(slot) + alignUp(sizeof(SlotHeader), kShmAlign);
+}
+
+inline AlgoDetBox* slotBoxes(ShmHeader* header, SlotHeader* slot) {
+  return reinterpret_cast<AlgoDetBox*>(slotInput(slot) +
+                                       alignUp(header->input_capacity, kShmAlign));
+}
+
+inline int64_t monotonicNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// ============================================================================
+// 跨进程 futex（共享内存上不能使用 FUTEX_PRIVATE_FLAG）
+// ============================================================================
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+/**
+ * @brief 当 *word == expected 时休眠，直到被唤醒或超时
+ * @return 0 表示被唤醒（或值已变化），ETIMEDOUT 表示超时
+ */
+inline int futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+  struct timespec ts;
+  ts.tv_sec = timeout_ms / 1000;
+  ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+  long ret = syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT,
+                     expected, timeout_ms >= 0 ? &ts : nullptr, nullptr, 0);
+  if (ret == -1 && errno == ETIMEDOUT) {
+    return ETIMEDOUT;
+  }
+  return 0;
+}
+
+inline void futexWakeAll(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+/**
+ * @brief 带休眠标记的 futexWait：先置 *waiting 再复查 *word
+ *
+ * 唤醒方先以 seq_cst 修改 *word 再读 *waiting（futexWakeIfWaiting），两边至少有一方能看到
+ * 对方的写入，因此对方仍在自旋或运行时可以省掉 FUTEX_WAKE 系统调用而不会丢失唤醒。
+ * 每个 futex 字只允许一个等待者。
+ */
+inline int futexWaitFlagged(std::atomic<uint32_t>* word, uint32_t expected,
+                            std::atomic<uint32_t>* waiting, int timeout_ms) {
+  waiting->store(1);
+  int ret = 0;
+  if (word->load() == expected) {
+    ret = futexWait(word, expected, timeout_ms);
+  }
+  waiting->store(0);
+  return ret;
+}
+
+/**
+ * @brief 只在对方已经（或即将）休眠时唤醒，调用前 *word 的修改必须是 seq_cst
+ */
+inline void futexWakeIfWaiting(std::atomic<uint32_t>* word, std::atomic<uint32_t>* waiting) {
+  if (waiting->load() != 0) {
+    futexWakeAll(word);
+  }
+}
+
+/**
+ * @brief 自旋等待 *word 离开 current，超过 spin_ns 后返回（由调用者转入 futex 休眠）
+ * @return 最新观察到的值
+ */
+inline uint32_t spinWhileEqual(std::atomic<uint32_t>* word, uint32_t current, int64_t spin_ns) {
+  int64_t deadline = monotonicNs() + spin_ns;
+  uint32_t value = word->load(std::memory_order_acquire);
+  while (value == current && monotonicNs() < deadline) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+    value = word->load(std::memory_order_acquire);
+  }
+  return value;
+}
+
+}  // namespace sandbox
+}  // namespace plugin
+}  // namespace infer_frame
@@ -0,0 +1,106 @@
+/**
+ * @file sandbox_test_plugin.cc
+ * @brief plugin_sandbox_test 使用的故障注入插件
+ *
+ * - AlgoInit：model_path 含 "crash" 时 abort
+ * - AlgoSetParams：config_json 含 "crash" 时 abort
+ * - AlgoInferDetection：输入首字节为 1 时永久卡死，为 2 时 abort，否则返回 1 个检测框
+ */
+
+#include "plugin/algo_plugin_interface.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+constexpr unsigned char kFrameHang = 1;
+constexpr unsigned char kFrameCrash = 2;
+
+AlgoInfo sandbox_test_info = {
+  "SandboxTest",                             // name
+  "1.0.0",                                   // version
+  ALGO_TYPE_DETECTION,                       // type
+  "Fault injection plugin for PluginSandbox tests",  // description
+  "infer-frame",                             // author
+  nullptr,                                   // supported_backends
+  0,                                         // num_backends
+  nullptr,                                   // class_names
+  0                                          // num_classes
+};
+
+}  // namespace
+
+extern "C" {
+
+const AlgoInfo* AlgoGetInfo() {
+  return &sandbox_test_info;
+}
+
+AlgoHandle AlgoCreate() {
+  return reinterpret_cast<AlgoHandle>(new int(0));
+}
+
+AlgoStatus AlgoInit(AlgoHandle handle, const AlgoInitParam* param) {
+  if (!handle || !param || !param->model_path) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (std::strstr(param->model_path, "crash")) {
+    std::abort();
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+AlgoStatus AlgoSetParams(AlgoHandle handle, const char* config_json) {
+  if (!handle || !config_json) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (std::strstr(config_json, "crash")) {
+    std::abort();
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+AlgoStatus AlgoInferDetection(AlgoHandle handle, const AlgoTensor* input, AlgoDetResult* result) {
+  if (!handle || !input || !input->data || input->size == 0 || !result) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+
+  unsigned char mode = *static_cast<const unsigned char*>(input->data);
+  if (mode == kFrameHang) {
+    while (true) {
+      pause();
+    }
+  }
+  if (mode == kFrameCrash) {
+    std::abort();
+  }
+
+  result->boxes = new AlgoDetBox[1];
+  std::memset(result->boxes, 0, sizeof(AlgoDetBox));
+  result->boxes[0].x2 = 1.0f;
+  result->boxes[0].y2 = 1.0f;
+  result->boxes[0].score = 1.0f;
+  result->num_boxes = 1;
+  result->timestamp = 0;
+  return ALGO_STATUS_SUCCESS;
+}
+
+AlgoStatus AlgoDeinit(AlgoHandle handle) {
+  return handle ? ALGO_STATUS_SUCCESS : ALGO_STATUS_ERROR_INVALID_PARAM;
+}
+
+void AlgoDestroy(AlgoHandle handle) {
+  delete reinterpret_cast<int*>(handle);
+}
+
+void AlgoFreeDetResult(AlgoDetResult* result) {
+  if (result && result->boxes) {
+    delete[] result->boxes;
+    result->boxes = nullptr;
+    result->num_boxes = 0;
+  }
+}
+
+}  // extern "C"
@@ -0,0 +1,318 @@
+#pragma once
+
+/**
+ * @file tracking_pipeline.h
+ * @brief 检测流水线 + 多目标跟踪：每 K 帧检测一次，其余帧传播轨迹（ALGO_TYPE_TRACK）
+ *
+ * TrackingPipeline<Detector> 包装任意 AlgoPipeline 检测流水线：检测帧运行完整的前处理 / 推理 /
+ * 后处理并用 ByteTracker 关联，非检测帧只做 Kalman 预测（不读图像），每帧都有输出。
+ * 检测间隔由 DetectScheduler 决定：固定 K、轨迹置信度过低时提前检测、或按实测检测耗时自适应。
+ *
+ * 两种插件形式：
+ * - C 插件：ALGO_PIPELINE_EXPORT_C + ALGO_TRACK_EXPORT_C，AlgoInferTrack 输出带轨迹 ID 的结果，
+ *   AlgoInferDetection / AlgoInferDetectionSoA 输出同一批轨迹框（不含 ID）
+ * - C++ 插件：AlgoPipelinePlugin<TrackingPipeline<...>>::inferTrack
+ *
+ * 跟踪参数与检测参数放在同一个 config_json 中（检测阶段忽略不认识的字段）：
+ * @code
+ * {"conf_threshold": 0.1,                  // ByteTrack 需要低分检测参与第二轮关联
+ *  "detect_interval": 3,                   // 固定 K
+ *  "detect_budget_ms": 10,                 // > 0 时按检测耗时自适应 K
+ *  "detect_interval_max": 8,
+ *  "track_min_confidence": 0.3,            // 轨迹置信度低于此值时提前检测
+ *  "track_high_threshold": 0.5, "track_new_threshold": 0.6,
+ *  "track_match_iou": 0.2, "track_max_lost": 30, "track_min_hits": 2}
+ * @endcode
+ */
+
+#include "algo_pipeline.h"
+#include "../algo_utils/tracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace infer_frame {
+namespace plugin {
+
+template <typename Detector>
+class TrackingPipeline : public Detector {
+ public:
+  AlgoStatus init(const AlgoInitParam* param);
+  AlgoStatus setParams(const char* config_json);
+  AlgoStatus deinit();
+
+  /**
+   * @brief 跟踪一帧（结果缓冲由调用者分配）
+   */
+  AlgoStatus inferTrack(const AlgoTensor* input, AlgoTrackResult* result);
+
+  /**
+   * @brief 与 inferTrack 相同的一步跟踪，以检测框形式输出（不含轨迹 ID）
+   */
+  AlgoStatus inferDetectionSoA(const AlgoTensor* input, AlgoDetSoA* result);
+  AlgoStatus inferDetection(const AlgoTensor* input, AlgoDetResult* result,
+                            const AlgoInfo* info = nullptr);
+
+  int detectInterval() const { return scheduler_.interval(); }
+
+ private:
+  std::mutex track_mutex_;    // 跟踪状态；检测流水线有自己的锁
+  algo_utils::ByteTracker tracker_;
+  algo_utils::DetectScheduler scheduler_;
+  DetSoABuffer boxes_{Detector::kMaxDetections};    // 检测流水线输出
+  std::vector<algo_utils::DetCandidate> detections_;
+  bool detected_ = false;     // 最近一步是否运行了检测
+
+  AlgoStatus step(const AlgoTensor* input, const std::vector<algo_utils::TrackBox>** tracks);
+
+  /**
+   * @brief 解析跟踪参数（未出现的字段保持原值）
+   */
+  static AlgoStatus parseConfig(const char* config_json, algo_utils::TrackerOptions* tracker,
+                                algo_utils::DetectScheduleOptions* schedule);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::parseConfig(const char* config_json,
+                                                   algo_utils::TrackerOptions* tracker,
+                                                   algo_utils::DetectScheduleOptions* schedule) {
+  if (!config_json || config_json[0] == '\0') {
+    return ALGO_STATUS_SUCCESS;
+  }
+  nlohmann::json params = nlohmann::json::parse(config_json, nullptr, false);
+  if (params.is_discarded() || !params.is_object()) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  try {
+    schedule->interval = params.value("detect_interval", schedule->interval);
+    schedule->min_interval = params.value("detect_interval_min", schedule->min_interval);
+    schedule->max_interval = params.value("detect_interval_max", schedule->max_interval);
+    schedule->detect_budget_ms = params.value("detect_budget_ms", schedule->detect_budget_ms);
+    schedule->min_confidence = params.value("track_min_confidence", schedule->min_confidence);
+    tracker->high_threshold = params.value("track_high_threshold", tracker->high_threshold);
+    tracker->low_threshold = params.value("track_low_threshold", tracker->low_threshold);
+    tracker->new_track_threshold =
+        params.value("track_new_threshold", tracker->new_track_threshold);
+    tracker->match_iou = params.value("track_match_iou", tracker->match_iou);
+    tracker->max_lost_frames = params.value("track_max_lost", tracker->max_lost_frames);
+    tracker->min_hits = params.value("track_min_hits", tracker->min_hits);
+  } catch (const nlohmann::json::exception&) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  if (schedule->interval < 1 || schedule->min_interval < 1 ||
+      schedule->max_interval < schedule->min_interval || schedule->detect_budget_ms < 0.0f ||
+      tracker->low_threshold > tracker->high_threshold || tracker->max_lost_frames < 0 ||
+      tracker->match_iou < 0.0f || tracker->match_iou > 1.0f) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::init(const AlgoInitParam* param) {
+  std::lock_guard<std::mutex> lock(track_mutex_);
+  algo_utils::TrackerOptions tracker = tracker_.options();
+  algo_utils::DetectScheduleOptions schedule = scheduler_.options();
+  AlgoStatus status = parseConfig(param ? param->config_json : nullptr, &tracker, &schedule);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  if ((status = Detector::init(param)) != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  tracker_.setOptions(tracker);
+  tracker_.reset();
+  scheduler_.setOptions(schedule);
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::setParams(const char* config_json) {
+  std::lock_guard<std::mutex> lock(track_mutex_);
+  algo_utils::TrackerOptions tracker = tracker_.options();
+  algo_utils::DetectScheduleOptions schedule = scheduler_.options();
+  AlgoStatus status = parseConfig(config_json, &tracker, &schedule);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  if ((status = Detector::setParams(config_json)) != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  // 已有轨迹保留，下一帧重新检测
+  tracker_.setOptions(tracker);
+  scheduler_.setOptions(schedule);
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::deinit() {
+  std::lock_guard<std::mutex> lock(track_mutex_);
+  tracker_.reset();
+  return Detector::deinit();
+}
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::step(const AlgoTensor* input,
+                                            const std::vector<algo_utils::TrackBox>** tracks) {
+  detected_ = scheduler_.shouldDetect(tracker_.minConfidence());
+  if (!detected_) {
+    *tracks = &tracker_.propagate();
+    return ALGO_STATUS_SUCCESS;
+  }
+
+  // 检测框最多 kMaxDetections 个，缓冲容量固定，直接读取列数组
+  const auto begin = std::chrono::steady_clock::now();
+  AlgoDetSoA* result = boxes_.view();
+  AlgoStatus status = Detector::inferDetectionSoA(input, result);
+  if (status != ALGO_STATUS_SUCCESS) {
+    scheduler_.forceDetect();
+    return status;
+  }
+  scheduler_.reportLatency(
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin)
+          .count());
+
+  detections_.resize(result->num_boxes);
+  for (int i = 0; i < result->num_boxes; ++i) {
+    algo_utils::DetCandidate& c = detections_[i];
+    c.x1 = result->x1[i];
+    c.y1 = result->y1[i];
+    c.x2 = result->x2[i];
+    c.y2 = result->y2[i];
+    c.score = result->score[i];
+    c.class_id = result->class_id[i];
+    c.anchor = i;
+  }
+  *tracks = &tracker_.update(detections_);
+  return ALGO_STATUS_SUCCESS;
+}
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::inferTrack(const AlgoTensor* input,
+                                                  AlgoTrackResult* result) {
+  if (!input || !input->data || !result || (result->object_capacity > 0 && !result->objects)) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  result->num_objects = 0;
+
+  std::lock_guard<std::mutex> lock(track_mutex_);
+  if (!this->isInitialized()) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  const std::vector<algo_utils::TrackBox>* tracks = nullptr;
+  AlgoStatus status = step(input, &tracks);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+
+  const int count = static_cast<int>(tracks->size());
+  const int written = std::min(count, result->object_capacity);
+  for (int i = 0; i < written; ++i) {
+    const algo_utils::TrackBox& track = (*tracks)[i];
+    AlgoTrackObject& object = result->objects[i];
+    object.x1 = track.x1;
+    object.y1 = track.y1;
+    object.x2 = track.x2;
+    object.y2 = track.y2;
+    object.score = track.score;
+    object.class_id = track.class_id;
+    object.track_id = track.track_id;
+    object.time_since_update = track.time_since_update;
+  }
+  result->num_objects = count;
+  result->detected = detected_ ? 1 : 0;
+  result->detect_interval = scheduler_.interval();
+  return written < count ? ALGO_STATUS_ERROR_BUFFER_TOO_SMALL : ALGO_STATUS_SUCCESS;
+}
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::inferDetectionSoA(const AlgoTensor* input,
+                                                         AlgoDetSoA* result) {
+  if (!input || !input->data || !validDetSoA(result)) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  result->num_boxes = 0;
+  result->timestamp = 0;
+
+  std::lock_guard<std::mutex> lock(track_mutex_);
+  if (!this->isInitialized()) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  const std::vector<algo_utils::TrackBox>* tracks = nullptr;
+  AlgoStatus status = step(input, &tracks);
+  if (status != ALGO_STATUS_SUCCESS) {
+    return status;
+  }
+  for (const algo_utils::TrackBox& track : *tracks) {
+    pushDetBox(result, track.x1, track.y1, track.x2, track.y2, track.score, track.class_id);
+  }
+  return result->num_boxes > result->capacity ? ALGO_STATUS_ERROR_BUFFER_TOO_SMALL
+                                              : ALGO_STATUS_SUCCESS;
+}
+
+template <typename Detector>
+AlgoStatus TrackingPipeline<Detector>::inferDetection(const AlgoTensor* input,
+                                                      AlgoDetResult* result,
+                                                      const AlgoInfo* info) {
+  if (!input || !input->data || !result) {
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  }
+  result->boxes = nullptr;
+  result->num_boxes = 0;
+  result->timestamp = 0;
+
+  std::lock_guard<std::mutex> lock(track_mutex_);
+  if (!this->isInitialized()) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  const std::vector<algo_utils::TrackBox>* tracks = nullptr;
+  AlgoStatus status = step(input, &tracks);
+  if (status != ALGO_STATUS_SUCCESS || tracks->empty()) {
+    return status;
+  }
+
+  // 与检测流水线相同，结果由 freeDetResult（delete[]）释放
+  result->boxes = new (std::nothrow) AlgoDetBox[tracks->size()];
+  if (!result->boxes) {
+    return ALGO_STATUS_ERROR_OUT_OF_MEMORY;
+  }
+  ClassNameTable names;
+  if (info) {
+    names = {info->class_names, info->num_classes};
+  }
+  for (const algo_utils::TrackBox& track : *tracks) {
+    AlgoDetBox& box = result->boxes[result->num_boxes++];
+    box.x1 = track.x1;
+    box.y1 = track.y1;
+    box.x2 = track.x2;
+    box.y2 = track.y2;
+    box.score = track.score;
+    box.class_id = track.class_id;
+    std::strncpy(box.class_name, names.name(track.class_id), sizeof(box.class_name) - 1);
+    box.class_name[sizeof(box.class_name) - 1] = '\0';
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+}  // namespace plugin
+}  // namespace infer_frame
+
+/**
+ * @brief 导出 AlgoInferTrack（与 ALGO_PIPELINE_EXPORT_C 一起使用）
+ */
+#define ALGO_TRACK_EXPORT_C(pipeline_class) \
+  extern "C" { \
+  AlgoStatus AlgoInferTrack(AlgoHandle handle, const AlgoTensor* input, \
+                            AlgoTrackResult* result) { \
+    if (!handle) return ALGO_STATUS_ERROR_INVALID_PARAM; \
+    return reinterpret_cast<pipeline_class*>(handle)->inferTrack(input, result); \
+  } \
+  }
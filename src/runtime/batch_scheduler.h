@@ -0,0 +1,491 @@
+#pragma once
+
+/**
+ * @file batch_scheduler.h
+ * @brief 跨摄像头动态批处理：共享同一模型的多路帧攒成一个 batch 后一次 inferBatch
+ *
+ * 每个模型（插件实例）一个 BatchScheduler，各路摄像头 submit() 后立即返回，
+ * 调度线程在以下任一条件满足时发出一个 batch：
+ * - 排队帧数达到 max_batch_size（攒满）
+ * - 最早的一帧到达所属工作流的最大等待时间（截止时间，按工作流配置）
+ * - 高优先级（high）工作流的帧到达（preempt_on_high，抢占攒批：不再等低优先级帧攒满）
+ * 发出时按工作流的 WorkflowQos 取帧：与 TaskExecutor 相同，priority_weights 为 0 的优先级（默认只有
+ * high）严格先取；其余优先级的工作流在同一个加权公平排队域中按 优先级权重 x 工作流权重 分享 batch 位置
+ * （起始时间公平排队，空闲过的工作流不会攒下份额），过载时 low 仍按份额推进而不会饿死。
+ * 推理完成后逐帧回调 Completion，结果回到各自的摄像头。
+ *
+ * @code
+ * runtime::BatchScheduler<Frame, Result> scheduler(
+ *     [&](const std::vector<Frame>& in, std::vector<Result>& out) { return infer(in, out); },
+ *     options);
+ * scheduler.setWorkflowMaxWait(workflow_id, 20000);    // 该工作流最多等 20 ms
+ * scheduler.setWorkflowQos(workflow_id, qos);           // 优先级 / 权重 / SLO，见 workflow_qos.h
+ * scheduler.start();
+ * scheduler.submit(workflow_id, frame, Result(), [cam](AlgoStatus s, Result& r) { ... });
+ * @endcode
+ *
+ * 统计：batch 大小直方图（BatchStats::batch_sizes）与逐帧排队 / 推理耗时
+ * （PerfStats，log2 微秒直方图，可直接交给 PluginStatsAggregator），以及按优先级的
+ * 提交 -> 完成延迟与 SLO 达成率（BatchStats::slo，被挤出 / 因排队已满被拒绝的帧计为未达成）。
+ * AlgoPluginBase::inferBatch 的适配见 plugin_batch_scheduler.h。
+ */
+
+#include "algo_utils/stage_timer.h"
+#include "runtime/workflow_qos.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+struct BatchSchedulerOptions {
+  int max_batch_size = 8;
+  int default_max_wait_us = 10000;    // 未单独配置的工作流的最大等待时间
+  int max_pending = 256;              // 排队上限，超出时 submit 返回 false（由调用者丢帧）
+  bool preempt_on_high = true;        // high 优先级帧到达时立即发出 batch
+  bool shed_by_share = true;          // 排队已满时挤出份额最靠后的帧（而不是拒绝新帧）
+  int priority_weights[kNumTaskPriorities] = {0, 4, 1};   // 0 表示严格优先，其余为份额
+};
+
+/**
+ * @brief 调度统计快照
+ */
+struct BatchStats {
+  uint64_t batches = 0;
+  uint64_t full_batches = 0;          // 攒满后发出
+  uint64_t deadline_batches = 0;      // 截止时间到发出（未攒满）
+  uint64_t preempted_batches = 0;     // 高优先级帧到达提前发出（未攒满）
+  uint64_t failed_batches = 0;        // 批处理函数返回错误
+  uint64_t rejected = 0;              // 排队已满被拒绝的帧
+  uint64_t evicted = 0;               // 排队已满时被优先级更高 / 份额更靠前的帧挤出
+  std::vector<uint64_t> batch_sizes;  // [n] = 大小为 n 的 batch 数，n = 1..max_batch_size
+  algo_utils::PerfStats latency;      // "queue"：提交 -> 进入 batch，"batch_infer"：批处理耗时
+  SloReport slo;                      // 按优先级：提交 -> 完成回调
+
+  double meanBatchSize() const {
+    uint64_t frames = 0;
+    for (size_t n = 0; n < batch_sizes.size(); ++n) {
+      frames += batch_sizes[n] * n;
+    }
+    return batches > 0 ? static_cast<double>(frames) / batches : 0.0;
+  }
+};
+
+template <typename Input, typename Output>
+class BatchScheduler {
+ public:
+  /**
+   * @brief 批处理函数：outputs 与 inputs 一一对应（调用前已按帧放好，函数只负责填充）
+   */
+  using BatchFn =
+      std::function<AlgoStatus(const std::vector<Input>& inputs, std::vector<Output>& outputs)>;
+
+  /**
+   * @brief 单帧完成回调（在调度线程上调用，应尽快返回）
+   */
+  using Completion = std::function<void(AlgoStatus status, Output& output)>;
+
+  explicit BatchScheduler(BatchFn batch_fn, const BatchSchedulerOptions& options = {});
+  ~BatchScheduler() { stop(); }
+
+  BatchScheduler(const BatchScheduler&) = delete;
+  BatchScheduler& operator=(const BatchScheduler&) = delete;
+
+  /**
+   * @brief 设置工作流的最大等待时间（对之后提交的帧生效）
+   */
+  void setWorkflowMaxWait(int workflow_id, int max_wait_us);
+
+  /**
+   * @brief 设置工作流的优先级 / 权重 / SLO（对之后提交的帧生效），未设置时为 normal、权重 1
+   */
+  void setWorkflowQos(int workflow_id, const WorkflowQos& qos);
+
+  void start();
+
+  /**
+   * @brief 停止调度线程；已排队的帧不再等待截止时间，全部推理完成后返回
+   */
+  void stop();
+
+  /**
+   * @brief 提交一帧（不阻塞）
+   *
+   * 排队已满且 shed_by_share 时，若新帧排在（严格优先级, 加权公平排队结束时间）最靠后的排队帧之前，
+   * 挤出该帧（在本线程上以 ALGO_STATUS_ERROR_DROPPED 回调其 done）并接收新帧；
+   * 被挤出的帧退还所占份额，不拖后其工作流之后的帧。
+   * @return 未启动或排队已满（且未能挤出）时返回 false，done 不会被调用
+   */
+  bool submit(int workflow_id, Input input, Output output, Completion done);
+
+  size_t pending() const;
+  const BatchSchedulerOptions& options() const { return options_; }
+  BatchStats stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  enum Stage { kStageQueue = 0, kStageBatchInfer };
+  enum Trigger { kTriggerDeadline = 0, kTriggerFull, kTriggerPreempt };
+
+  struct Request {
+    Input input;
+    Output output;
+    Completion done;
+    Clock::time_point enqueue;
+    Clock::time_point deadline;
+    WorkflowQos qos;
+    int workflow_id = 0;
+    int domain = 0;               // 严格优先级为其优先级序号，加权优先级共用 kWeightedDomain
+    double start_tag = 0.0;       // 加权公平排队的虚拟起始 / 结束时间
+    double finish_tag = 0.0;
+  };
+
+  static constexpr int kWeightedDomain = kNumTaskPriorities;
+
+  struct WorkflowState {
+    int max_wait_us = -1;         // < 0 表示使用 default_max_wait_us
+    WorkflowQos qos;
+    double last_finish = 0.0;
+  };
+
+  BatchFn batch_fn_;
+  BatchSchedulerOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> pending_;       // 按截止时间升序
+  std::unordered_map<int, WorkflowState> workflows_;
+  double virtual_time_[kNumTaskPriorities + 1] = {};   // 按 domain
+  int high_pending_ = 0;              // 排队中的 high 优先级帧
+  bool running_ = false;
+  bool stopping_ = false;
+  std::thread thread_;
+
+  // 只在调度线程上使用，跨 batch 复用
+  std::vector<Request> batch_;
+  std::vector<size_t> order_;
+  std::vector<char> taken_;
+  std::vector<Input> inputs_;
+  std::vector<Output> outputs_;
+
+  std::atomic<uint64_t> batches_{0};
+  std::atomic<uint64_t> full_batches_{0};
+  std::atomic<uint64_t> preempted_batches_{0};
+  std::atomic<uint64_t> failed_batches_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::atomic<uint64_t> evicted_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> batch_sizes_;
+  algo_utils::StageRecorder recorder_{"queue", "batch_infer"};
+  SloTracker slo_;
+
+  /**
+   * @brief 发出顺序：严格优先级在前，同一 domain 按结束时间
+   */
+  static bool servedBefore(const Request& a, const Request& b) {
+    if (a.domain != b.domain) {
+      return a.domain < b.domain;
+    }
+    return a.finish_tag < b.finish_tag;
+  }
+
+  /**
+   * @brief 按工作流的上一帧与所在 domain 的虚拟时间打标签
+   */
+  void assignTags(const WorkflowState& workflow, Request* request) const;
+
+  void run();
+  void take(size_t n);
+  void dispatch(Trigger trigger);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+template <typename Input, typename Output>
+BatchScheduler<Input, Output>::BatchScheduler(BatchFn batch_fn,
+                                              const BatchSchedulerOptions& options)
+    : batch_fn_(std::move(batch_fn)), options_(options) {
+  options_.max_batch_size = std::max(options_.max_batch_size, 1);
+  options_.default_max_wait_us = std::max(options_.default_max_wait_us, 0);
+  options_.max_pending = std::max(options_.max_pending, options_.max_batch_size);
+  batch_sizes_.reset(new std::atomic<uint64_t>[options_.max_batch_size + 1]);
+  for (int n = 0; n <= options_.max_batch_size; ++n) {
+    batch_sizes_[n].store(0, std::memory_order_relaxed);
+  }
+  for (int& weight : options_.priority_weights) {
+    weight = std::max(weight, 0);
+  }
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::assignTags(const WorkflowState& workflow,
+                                               Request* request) const {
+  // 起始时间公平排队：工作流的上一帧未发出时接在其后，否则从所在 domain 的当前虚拟时间开始
+  const int priority = static_cast<int>(request->qos.priority);
+  const int class_weight = priority >= 0 && priority < kNumTaskPriorities
+                               ? options_.priority_weights[priority]
+                               : 1;
+  request->domain = class_weight == 0 ? priority : kWeightedDomain;
+  request->start_tag = std::max(virtual_time_[request->domain], workflow.last_finish);
+  request->finish_tag =
+      request->start_tag + 1.0 / (std::max(class_weight, 1) * request->qos.weight);
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::setWorkflowMaxWait(int workflow_id, int max_wait_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  workflows_[workflow_id].max_wait_us = std::max(max_wait_us, 0);
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::setWorkflowQos(int workflow_id, const WorkflowQos& qos) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  WorkflowQos& current = workflows_[workflow_id].qos;
+  current = qos;
+  current.weight = std::max(current.weight, 1);
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  stopping_ = false;
+  thread_ = std::thread(&BatchScheduler::run, this);
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+      return;
+    }
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  std::lock_guard<std::mutex> lock(mutex_);
+  running_ = false;
+}
+
+template <typename Input, typename Output>
+bool BatchScheduler<Input, Output>::submit(int workflow_id, Input input, Output output,
+                                           Completion done) {
+  const Clock::time_point now = Clock::now();
+  bool wake = false;
+  std::unique_ptr<Request> evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_ || stopping_) {
+      rejected_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    WorkflowState& workflow = workflows_[workflow_id];
+    const int wait_us =
+        workflow.max_wait_us >= 0 ? workflow.max_wait_us : options_.default_max_wait_us;
+    Request request{std::move(input), std::move(output), std::move(done), now,
+                    now + std::chrono::microseconds(wait_us), workflow.qos, workflow_id};
+    assignTags(workflow, &request);
+
+    if (static_cast<int>(pending_.size()) >= options_.max_pending) {
+      auto worst = options_.shed_by_share
+                       ? std::max_element(pending_.begin(), pending_.end(), servedBefore)
+                       : pending_.end();
+      if (worst == pending_.end() || !servedBefore(request, *worst)) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        slo_.recordMiss(request.qos);
+        return false;
+      }
+      high_pending_ -= worst->qos.priority == TaskPriority::kHigh ? 1 : 0;
+      evicted.reset(new Request(std::move(*worst)));
+      pending_.erase(worst);
+      evicted_.fetch_add(1, std::memory_order_relaxed);
+      slo_.recordMiss(evicted->qos);
+      // 被挤出的是其工作流最后排队的一帧：退还份额，之后的帧不因未推理的帧而排后
+      WorkflowState& owner = workflows_[evicted->workflow_id];
+      if (owner.last_finish == evicted->finish_tag) {
+        owner.last_finish = evicted->start_tag;
+        if (evicted->workflow_id == workflow_id) {
+          assignTags(workflow, &request);
+        }
+      }
+    }
+    workflow.last_finish = request.finish_tag;
+    const bool high = request.qos.priority == TaskPriority::kHigh;
+    high_pending_ += high ? 1 : 0;
+
+    // 截止时间相同的帧保持提交顺序
+    auto pos = std::upper_bound(
+        pending_.begin(), pending_.end(), request.deadline,
+        [](const Clock::time_point& t, const Request& r) { return t < r.deadline; });
+    // 调度线程只需在队列由空变非空、攒满、最早截止时间提前或需要抢占时被唤醒
+    wake = pending_.empty() || pos == pending_.begin() ||
+           static_cast<int>(pending_.size()) + 1 >= options_.max_batch_size ||
+           (high && options_.preempt_on_high);
+    pending_.insert(pos, std::move(request));
+  }
+  if (wake) {
+    cv_.notify_one();
+  }
+  if (evicted && evicted->done) {
+    evicted->done(ALGO_STATUS_ERROR_DROPPED, evicted->output);
+  }
+  return true;
+}
+
+template <typename Input, typename Output>
+size_t BatchScheduler<Input, Output>::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::run() {
+  const size_t max_batch = static_cast<size_t>(options_.max_batch_size);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [&] { return stopping_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      break;    // stopping_ 且已排空
+    }
+    // 攒满、最早一帧到期或有 high 优先级帧即发出；停止时不再等待
+    Trigger trigger = kTriggerDeadline;
+    while (!stopping_ && pending_.size() < max_batch) {
+      if (options_.preempt_on_high && high_pending_ > 0) {
+        trigger = kTriggerPreempt;
+        break;
+      }
+      const Clock::time_point deadline = pending_.front().deadline;
+      if (Clock::now() >= deadline) {
+        break;
+      }
+      cv_.wait_until(lock, deadline);
+    }
+    if (pending_.size() >= max_batch) {
+      trigger = kTriggerFull;
+    }
+    take(std::min(pending_.size(), max_batch));
+    lock.unlock();
+    dispatch(trigger);
+    lock.lock();
+  }
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::take(size_t n) {
+  // 按（domain, 加权公平排队结束时间）取前 n 帧，其余帧保持截止时间顺序
+  batch_.clear();
+  order_.resize(pending_.size());
+  for (size_t i = 0; i < order_.size(); ++i) {
+    order_[i] = i;
+  }
+  if (n < pending_.size()) {
+    std::partial_sort(order_.begin(), order_.begin() + n, order_.end(),
+                      [this](size_t a, size_t b) {
+                        // 相同时按截止时间（pending_ 中的位置）
+                        return servedBefore(pending_[a], pending_[b]) ||
+                               (!servedBefore(pending_[b], pending_[a]) && a < b);
+                      });
+  }
+  taken_.assign(pending_.size(), 0);
+  for (size_t k = 0; k < n; ++k) {
+    Request& request = pending_[order_[k]];
+    virtual_time_[request.domain] = std::max(virtual_time_[request.domain], request.start_tag);
+    high_pending_ -= request.qos.priority == TaskPriority::kHigh ? 1 : 0;
+    taken_[order_[k]] = 1;
+    batch_.push_back(std::move(request));
+  }
+  size_t kept = 0;
+  for (size_t i = 0; i < pending_.size(); ++i) {
+    if (!taken_[i]) {
+      if (kept != i) {
+        pending_[kept] = std::move(pending_[i]);
+      }
+      ++kept;
+    }
+  }
+  pending_.erase(pending_.begin() + kept, pending_.end());
+}
+
+template <typename Input, typename Output>
+void BatchScheduler<Input, Output>::dispatch(Trigger trigger) {
+  const Clock::time_point begin = Clock::now();
+  inputs_.clear();
+  outputs_.clear();
+  for (Request& request : batch_) {
+    recorder_.record(kStageQueue, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(begin - request.enqueue).count()));
+    inputs_.push_back(std::move(request.input));
+    outputs_.push_back(std::move(request.output));
+  }
+
+  AlgoStatus status = batch_fn_(inputs_, outputs_);
+  if (outputs_.size() != batch_.size()) {
+    // 批处理函数不应改变输出个数，否则无法按帧分发
+    status = ALGO_STATUS_ERROR_INFERENCE;
+    outputs_.resize(batch_.size());
+  }
+  recorder_.record(kStageBatchInfer, static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+
+  batches_.fetch_add(1, std::memory_order_relaxed);
+  batch_sizes_[batch_.size()].fetch_add(1, std::memory_order_relaxed);
+  if (trigger == kTriggerFull) {
+    full_batches_.fetch_add(1, std::memory_order_relaxed);
+  } else if (trigger == kTriggerPreempt) {
+    preempted_batches_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (status != ALGO_STATUS_SUCCESS) {
+    failed_batches_.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < batch_.size(); ++i) {
+    recorder_.addFrame();
+    if (batch_[i].done) {
+      batch_[i].done(status, outputs_[i]);
+    }
+    slo_.record(batch_[i].qos, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - batch_[i].enqueue)
+            .count()));
+  }
+  batch_.clear();
+}
+
+template <typename Input, typename Output>
+BatchStats BatchScheduler<Input, Output>::stats() const {
+  BatchStats stats;
+  stats.batches = batches_.load(std::memory_order_relaxed);
+  stats.full_batches = full_batches_.load(std::memory_order_relaxed);
+  stats.preempted_batches = preempted_batches_.load(std::memory_order_relaxed);
+  stats.deadline_batches =
+      stats.batches - std::min(stats.batches, stats.full_batches + stats.preempted_batches);
+  stats.failed_batches = failed_batches_.load(std::memory_order_relaxed);
+  stats.rejected = rejected_.load(std::memory_order_relaxed);
+  stats.evicted = evicted_.load(std::memory_order_relaxed);
+  stats.batch_sizes.resize(options_.max_batch_size + 1);
+  for (int n = 0; n <= options_.max_batch_size; ++n) {
+    stats.batch_sizes[n] = batch_sizes_[n].load(std::memory_order_relaxed);
+  }
+  stats.latency = recorder_.snapshot();
+  stats.slo = slo_.snapshot();
+  return stats;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
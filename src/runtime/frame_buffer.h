@@ -0,0 +1,532 @@
+#pragma once
+
+/**
+ * @file frame_buffer.h
+ * @brief 池化、对齐、引用计数共享的视频帧（VideoFrame）与缓冲池（FramePool）
+ *
+ * 一帧要经过多个阶段和多个消费者（多个工作流、抓图编码、录像），每个消费者 clone 一份会把
+ * 内存带宽成倍放大。这里：
+ * - 帧数据放在 FramePool 分配的 64 字节对齐缓冲里，行跨度按 64 字节对齐；释放后按大小回收复用
+ * - VideoFrame 拷贝只增加引用计数，roi() 返回共享同一缓冲的子区域视图，都不拷贝像素
+ * - 写时复制：只有调用 mutablePlane()（如画框叠加）且缓冲被共享时，才把本视图的像素
+ *   拷贝到新的池化缓冲，其他持有者看到的内容不变
+ * - 统计：命中率、在途字节数（已分配未释放）及峰值、缓存字节数、写时复制次数
+ *
+ * @code
+ * runtime::FramePool pool;
+ * runtime::VideoFrame frame = runtime::VideoFrame::allocate(pool, 1920, 1080,
+ *                                                           ALGO_PIXEL_FORMAT_NV12);
+ * decoder.copyTo(frame.mutablePlane(0), frame.stride(0), ...);
+ * runtime::VideoFrame plate = frame.roi(800, 600, 320, 160);    // 零拷贝
+ * algo_utils::letterboxYuvToPlanar(plate.yuvImage(), input, 640, 640);
+ * @endcode
+ */
+
+#include "algo_utils/letterbox_yuv.h"
+#include "plugin/format_negotiation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+struct FramePoolOptions {
+  size_t alignment = 64;                          // 缓冲首地址与行跨度对齐
+  size_t max_cached_bytes = 256u * 1024 * 1024;   // 空闲缓冲上限，超出时直接释放
+};
+
+/**
+ * @brief 缓冲池统计快照
+ */
+struct FramePoolStats {
+  uint64_t acquires = 0;
+  uint64_t hits = 0;                  // 复用空闲缓冲
+  uint64_t misses = 0;                // 新分配
+  uint64_t cow_copies = 0;            // 写时复制次数
+  uint64_t bytes_in_flight = 0;       // 已取出未归还
+  uint64_t peak_bytes_in_flight = 0;
+  uint64_t bytes_cached = 0;          // 池中空闲缓冲
+
+  double hitRate() const {
+    return acquires > 0 ? static_cast<double>(hits) / static_cast<double>(acquires) : 0.0;
+  }
+};
+
+/**
+ * @brief 一块池化缓冲（引用计数由 shared_ptr 管理，最后一个引用释放时归还）
+ */
+struct FrameBlock {
+  uint8_t* data = nullptr;
+  size_t capacity = 0;
+};
+
+class FramePool {
+ public:
+  explicit FramePool(const FramePoolOptions& options = FramePoolOptions())
+      : core_(std::make_shared<Core>(options)) {}
+
+  FramePool(const FramePool&) = delete;
+  FramePool& operator=(const FramePool&) = delete;
+
+  /**
+   * @brief 取一块至少 bytes 字节的对齐缓冲（内容未初始化）
+   *
+   * 返回的缓冲持有池的引用，可以在 FramePool 析构之后才释放。
+   */
+  std::shared_ptr<FrameBlock> acquire(size_t bytes) { return core_->acquire(core_, bytes); }
+
+  /**
+   * @brief 释放所有空闲缓冲
+   */
+  void trim() { core_->trim(); }
+
+  size_t alignment() const { return core_->options.alignment; }
+  FramePoolStats stats() const { return core_->stats(); }
+
+ private:
+  friend class VideoFrame;
+
+  struct Core {
+    FramePoolOptions options;
+    std::mutex mutex;
+    std::unordered_map<size_t, std::vector<uint8_t*>> free_lists;   // 按容量分桶
+    uint64_t bytes_cached = 0;
+    std::atomic<uint64_t> acquires{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> cow_copies{0};
+    std::atomic<uint64_t> bytes_in_flight{0};
+    std::atomic<uint64_t> peak_bytes_in_flight{0};
+
+    explicit Core(const FramePoolOptions& opts) : options(opts) {
+      // aligned_alloc 要求对齐为 2 的幂且不小于指针大小
+      size_t align = sizeof(void*);
+      while (align < options.alignment) {
+        align <<= 1;
+      }
+      options.alignment = align;
+    }
+
+    ~Core() { trim(); }
+
+    /**
+     * @brief 分桶粒度 4 KB：同分辨率的帧与尺寸相近的 ROI 拷贝落在同一桶
+     */
+    static size_t bucketSize(size_t bytes) {
+      const size_t kGranule = 4096;
+      return std::max<size_t>((bytes + kGranule - 1) / kGranule * kGranule, kGranule);
+    }
+
+    std::shared_ptr<FrameBlock> acquire(const std::shared_ptr<Core>& self, size_t bytes);
+    void release(FrameBlock* block);
+    void trim();
+    FramePoolStats stats();
+  };
+
+  std::shared_ptr<Core> core_;
+};
+
+/**
+ * @brief 视频帧：共享缓冲上的一个视图（整帧或 ROI）
+ *
+ * 支持 BGR / RGB（交错）与 NV12 / I420（YUV 平面）。拷贝 VideoFrame 只增加引用计数。
+ */
+class VideoFrame {
+ public:
+  static constexpr int kMaxPlanes = 3;
+
+  VideoFrame() = default;
+
+  /**
+   * @brief 从池中分配一帧（YUV 格式要求宽高为偶数）
+   * @return 参数非法时返回空帧
+   */
+  static VideoFrame allocate(FramePool& pool, int width, int height, AlgoPixelFormat format);
+
+  /**
+   * @brief 从 frame 所在的池分配一帧（frame 持有池的引用，FramePool 对象析构后仍可用）
+   * @return frame 为空或参数非法时返回空帧
+   */
+  static VideoFrame allocateLike(const VideoFrame& frame, int width, int height,
+                                 AlgoPixelFormat format);
+
+  bool empty() const { return !block_; }
+  int width() const { return width_; }
+  int height() const { return height_; }
+  AlgoPixelFormat format() const { return format_; }
+  int numPlanes() const { return num_planes_; }
+  size_t stride(int plane) const { return strides_[plane]; }
+
+  const uint8_t* plane(int plane) const { return block_->data + offsets_[plane]; }
+
+  /**
+   * @brief 可写的平面指针：缓冲被共享时先把本视图拷贝到新缓冲（写时复制）
+   *
+   * 与 shared_ptr 相同，同一个 VideoFrame 对象不能被多个线程同时访问；其他线程持有的副本
+   * 可以随时释放。引用计数为 1 时原地写入，此前其他持有者的读取都已完成（见 soleOwner）。
+   * @return 空帧、plane 越界或拷贝时分配失败返回 nullptr
+   */
+  uint8_t* mutablePlane(int plane);
+
+  /**
+   * @brief 缓冲是否与其他 VideoFrame 共享（共享时写入会触发拷贝）
+   */
+  bool shared() const { return block_ && !soleOwner(); }
+
+  /**
+   * @brief 子区域视图（零拷贝），超出边界的部分被裁掉；YUV 格式起点与尺寸按 2 对齐
+   */
+  VideoFrame roi(int x, int y, int width, int height) const;
+
+  /**
+   * @brief 本视图像素数据的字节数（不含行尾填充）
+   */
+  size_t viewBytes() const;
+
+  /**
+   * @brief YUV 视图，可直接交给 letterboxYuvToPlanar（仅 NV12 / I420）
+   */
+  algo_utils::YuvImage yuvImage() const;
+
+  /**
+   * @brief 描述为插件输入 Tensor（数据只读，不拷贝）
+   * @return YUV 格式的 ROI 视图色度平面不紧跟亮度平面，无法用 AlgoTensor 表示，返回 false
+   */
+  bool toAlgoTensor(AlgoTensor* tensor, const char* name = "images") const;
+
+ private:
+  std::shared_ptr<FrameBlock> block_;
+  std::shared_ptr<FramePool::Core> pool_;     // 写时复制从同一个池取缓冲
+
+  static VideoFrame allocateFrom(const std::shared_ptr<FramePool::Core>& pool, int width,
+                                 int height, AlgoPixelFormat format);
+
+  /**
+   * @brief 本对象是否是缓冲的唯一持有者
+   *
+   * use_count() 是 relaxed 读取，本身不建立同步；读到 1 后加 acquire 栅栏，与其他持有者释放
+   * 引用时的 release 递减配对，它们释放前对缓冲的读取都先于此后的写入。
+   */
+  bool soleOwner() const {
+    if (block_.use_count() != 1) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+  }
+  AlgoPixelFormat format_ = ALGO_PIXEL_FORMAT_UNKNOWN;
+  int width_ = 0;
+  int height_ = 0;
+  int num_planes_ = 0;
+  size_t offsets_[kMaxPlanes] = {};
+  size_t strides_[kMaxPlanes] = {};
+  bool full_frame_ = false;                   // 布局与 allocate 一致（平面连续）
+
+  /**
+   * @brief 平面 i 的（宽字节数, 行数）
+   */
+  void planeExtent(int plane, size_t* row_bytes, int* rows) const;
+
+  /**
+   * @brief 按 allocate 的布局计算各平面偏移与跨度，返回总字节数
+   */
+  static size_t layout(AlgoPixelFormat format, int width, int height, size_t alignment,
+                       size_t* offsets, size_t* strides, int* num_planes);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline std::shared_ptr<FrameBlock> FramePool::Core::acquire(const std::shared_ptr<Core>& self,
+                                                            size_t bytes) {
+  const size_t capacity = bucketSize(bytes);
+  uint8_t* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = free_lists.find(capacity);
+    if (it != free_lists.end() && !it->second.empty()) {
+      data = it->second.back();
+      it->second.pop_back();
+      bytes_cached -= capacity;
+    }
+  }
+  acquires.fetch_add(1, std::memory_order_relaxed);
+  if (data) {
+    hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    misses.fetch_add(1, std::memory_order_relaxed);
+    data = static_cast<uint8_t*>(std::aligned_alloc(options.alignment, capacity));
+    if (!data) {
+      return nullptr;
+    }
+  }
+  const uint64_t in_flight =
+      bytes_in_flight.fetch_add(capacity, std::memory_order_relaxed) + capacity;
+  uint64_t peak = peak_bytes_in_flight.load(std::memory_order_relaxed);
+  while (in_flight > peak &&
+         !peak_bytes_in_flight.compare_exchange_weak(peak, in_flight,
+                                                     std::memory_order_relaxed)) {
+  }
+
+  FrameBlock* block = new FrameBlock{data, capacity};
+  // 删除器持有 Core，池对象先析构时缓冲仍能归还
+  return std::shared_ptr<FrameBlock>(block, [self](FrameBlock* b) { self->release(b); });
+}
+
+inline void FramePool::Core::release(FrameBlock* block) {
+  bytes_in_flight.fetch_sub(block->capacity, std::memory_order_relaxed);
+  bool cached = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bytes_cached + block->capacity <= options.max_cached_bytes) {
+      free_lists[block->capacity].push_back(block->data);
+      bytes_cached += block->capacity;
+      cached = true;
+    }
+  }
+  if (!cached) {
+    std::free(block->data);
+  }
+  delete block;
+}
+
+inline void FramePool::Core::trim() {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto& kv : free_lists) {
+    for (uint8_t* data : kv.second) {
+      std::free(data);
+    }
+  }
+  free_lists.clear();
+  bytes_cached = 0;
+}
+
+inline FramePoolStats FramePool::Core::stats() {
+  FramePoolStats stats;
+  stats.acquires = acquires.load(std::memory_order_relaxed);
+  stats.hits = hits.load(std::memory_order_relaxed);
+  stats.misses = misses.load(std::memory_order_relaxed);
+  stats.cow_copies = cow_copies.load(std::memory_order_relaxed);
+  stats.bytes_in_flight = bytes_in_flight.load(std::memory_order_relaxed);
+  stats.peak_bytes_in_flight = peak_bytes_in_flight.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex);
+  stats.bytes_cached = bytes_cached;
+  return stats;
+}
+
+inline size_t VideoFrame::layout(AlgoPixelFormat format, int width, int height, size_t alignment,
+                                 size_t* offsets, size_t* strides, int* num_planes) {
+  auto align = [alignment](size_t n) { return (n + alignment - 1) / alignment * alignment; };
+  const size_t w = static_cast<size_t>(width);
+  const size_t h = static_cast<size_t>(height);
+  const size_t chroma_rows = (h + 1) / 2;
+  switch (format) {
+    case ALGO_PIXEL_FORMAT_BGR:
+    case ALGO_PIXEL_FORMAT_RGB:
+      *num_planes = 1;
+      strides[0] = align(w * 3);
+      offsets[0] = 0;
+      return strides[0] * h;
+    case ALGO_PIXEL_FORMAT_NV12:
+      // 与 nv12Image / AlgoTensor 的约定一致：UV 平面紧跟 Y 平面，行跨度相同
+      *num_planes = 2;
+      strides[0] = strides[1] = align(w);
+      offsets[0] = 0;
+      offsets[1] = strides[0] * h;
+      return offsets[1] + strides[1] * chroma_rows;
+    case ALGO_PIXEL_FORMAT_I420:
+      // 与 i420Image 的约定一致：U、V 行跨度为 Y 的一半（Y 跨度按 2 倍对齐保证 U、V 也对齐）
+      *num_planes = 3;
+      strides[0] = align(w) % (2 * alignment) == 0 ? align(w) : align(w) + alignment;
+      strides[1] = strides[2] = strides[0] / 2;
+      offsets[0] = 0;
+      offsets[1] = strides[0] * h;
+      offsets[2] = offsets[1] + strides[1] * chroma_rows;
+      return offsets[2] + strides[2] * chroma_rows;
+    default:
+      *num_planes = 0;
+      return 0;
+  }
+}
+
+inline VideoFrame VideoFrame::allocate(FramePool& pool, int width, int height,
+                                       AlgoPixelFormat format) {
+  return allocateFrom(pool.core_, width, height, format);
+}
+
+inline VideoFrame VideoFrame::allocateLike(const VideoFrame& frame, int width, int height,
+                                           AlgoPixelFormat format) {
+  return frame.pool_ ? allocateFrom(frame.pool_, width, height, format) : VideoFrame();
+}
+
+inline VideoFrame VideoFrame::allocateFrom(const std::shared_ptr<FramePool::Core>& pool,
+                                           int width, int height, AlgoPixelFormat format) {
+  VideoFrame frame;
+  if (width <= 0 || height <= 0 ||
+      (plugin::isYuvFormat(format) && (width % 2 != 0 || height % 2 != 0))) {
+    return frame;
+  }
+  const size_t bytes = layout(format, width, height, pool->options.alignment, frame.offsets_,
+                              frame.strides_, &frame.num_planes_);
+  if (bytes == 0) {
+    return VideoFrame();
+  }
+  frame.block_ = pool->acquire(pool, bytes);
+  if (!frame.block_) {
+    return VideoFrame();
+  }
+  frame.pool_ = pool;
+  frame.format_ = format;
+  frame.width_ = width;
+  frame.height_ = height;
+  frame.full_frame_ = true;
+  return frame;
+}
+
+inline void VideoFrame::planeExtent(int plane, size_t* row_bytes, int* rows) const {
+  const bool chroma = plane > 0;
+  const int w = chroma ? (width_ + 1) / 2 : width_;
+  *rows = chroma ? (height_ + 1) / 2 : height_;
+  switch (format_) {
+    case ALGO_PIXEL_FORMAT_BGR:
+    case ALGO_PIXEL_FORMAT_RGB:
+      *row_bytes = static_cast<size_t>(width_) * 3;
+      break;
+    case ALGO_PIXEL_FORMAT_NV12:
+      *row_bytes = chroma ? static_cast<size_t>(w) * 2 : static_cast<size_t>(w);
+      break;
+    default:
+      *row_bytes = static_cast<size_t>(w);
+      break;
+  }
+}
+
+inline size_t VideoFrame::viewBytes() const {
+  size_t total = 0;
+  for (int p = 0; p < num_planes_; ++p) {
+    size_t row_bytes;
+    int rows;
+    planeExtent(p, &row_bytes, &rows);
+    total += row_bytes * static_cast<size_t>(rows);
+  }
+  return total;
+}
+
+inline uint8_t* VideoFrame::mutablePlane(int plane) {
+  if (empty() || plane < 0 || plane >= num_planes_) {
+    return nullptr;
+  }
+  if (!soleOwner() && pool_) {
+    // 把本视图拷贝到新缓冲（ROI 视图只拷贝 ROI），之后按整帧布局访问
+    size_t offsets[kMaxPlanes];
+    size_t strides[kMaxPlanes];
+    int num_planes = 0;
+    const size_t bytes = layout(format_, width_, height_, pool_->options.alignment, offsets,
+                                strides, &num_planes);
+    std::shared_ptr<FrameBlock> copy = pool_->acquire(pool_, bytes);
+    if (!copy) {
+      return nullptr;
+    }
+    for (int p = 0; p < num_planes_; ++p) {
+      size_t row_bytes;
+      int rows;
+      planeExtent(p, &row_bytes, &rows);
+      const uint8_t* src = block_->data + offsets_[p];
+      uint8_t* dst = copy->data + offsets[p];
+      for (int r = 0; r < rows; ++r) {
+        std::memcpy(dst + r * strides[p], src + r * strides_[p], row_bytes);
+      }
+    }
+    pool_->cow_copies.fetch_add(1, std::memory_order_relaxed);
+    block_ = std::move(copy);
+    std::copy(offsets, offsets + kMaxPlanes, offsets_);
+    std::copy(strides, strides + kMaxPlanes, strides_);
+    full_frame_ = true;
+  }
+  return block_->data + offsets_[plane];
+}
+
+inline VideoFrame VideoFrame::roi(int x, int y, int width, int height) const {
+  if (empty()) {
+    return VideoFrame();
+  }
+  int x0 = std::max(x, 0);
+  int y0 = std::max(y, 0);
+  int x1 = std::min(x + width, width_);
+  int y1 = std::min(y + height, height_);
+  if (plugin::isYuvFormat(format_)) {
+    x0 &= ~1;
+    y0 &= ~1;
+    x1 = std::min((x1 + 1) & ~1, width_);
+    y1 = std::min((y1 + 1) & ~1, height_);
+  }
+  if (x1 <= x0 || y1 <= y0) {
+    return VideoFrame();
+  }
+
+  VideoFrame view = *this;
+  view.width_ = x1 - x0;
+  view.height_ = y1 - y0;
+  view.full_frame_ = full_frame_ && x0 == 0 && y0 == 0 && view.width_ == width_ &&
+                     view.height_ == height_;
+  switch (format_) {
+    case ALGO_PIXEL_FORMAT_BGR:
+    case ALGO_PIXEL_FORMAT_RGB:
+      view.offsets_[0] += y0 * strides_[0] + static_cast<size_t>(x0) * 3;
+      break;
+    case ALGO_PIXEL_FORMAT_NV12:
+      view.offsets_[0] += y0 * strides_[0] + x0;
+      view.offsets_[1] += (y0 / 2) * strides_[1] + x0;    // UV 交错：x0 为偶数即 x0 / 2 * 2
+      break;
+    case ALGO_PIXEL_FORMAT_I420:
+      view.offsets_[0] += y0 * strides_[0] + x0;
+      view.offsets_[1] += (y0 / 2) * strides_[1] + x0 / 2;
+      view.offsets_[2] += (y0 / 2) * strides_[2] + x0 / 2;
+      break;
+    default:
+      break;
+  }
+  return view;
+}
+
+inline algo_utils::YuvImage VideoFrame::yuvImage() const {
+  algo_utils::YuvImage image;
+  if (empty() || !plugin::isYuvFormat(format_)) {
+    return image;
+  }
+  image.width = width_;
+  image.height = height_;
+  image.y = plane(0);
+  image.y_stride = strides_[0];
+  image.u = plane(1);
+  image.uv_stride = strides_[1];
+  if (format_ == ALGO_PIXEL_FORMAT_NV12) {
+    image.v = image.u + 1;
+    image.uv_step = 2;
+  } else {
+    image.v = plane(2);
+    image.uv_step = 1;
+  }
+  return image;
+}
+
+inline bool VideoFrame::toAlgoTensor(AlgoTensor* tensor, const char* name) const {
+  if (empty() || (plugin::isYuvFormat(format_) && !full_frame_)) {
+    return false;
+  }
+  plugin::describeImageTensor(tensor, name, format_, ALGO_DATA_TYPE_UINT8, width_, height_,
+                              const_cast<uint8_t*>(plane(0)), static_cast<int>(strides_[0]));
+  return true;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
@@ -0,0 +1,286 @@
+#pragma once
+
+/**
+ * @file frame_mailbox.h
+ * @brief 每路摄像头的解码帧队列：延迟优先（只保留最新 N 帧）或完整性优先（有界 FIFO）
+ *
+ * 推理跟不上时，无界或阻塞的帧队列会让结果晚几秒才到，对告警没有意义。FrameMailbox 两种模式：
+ * - kLatest（mailbox）：队列满时新帧顶替最旧的一帧（superseded），推理总是拿到最新的帧
+ * - kFifo：按到达顺序全部处理，队列满时丢弃新帧（queue_full）
+ * 两种模式下解码线程都不会等待消费者：push 只在极短的临界区内移动帧，被丢弃的帧在锁外析构。
+ * 可选 max_age_ms：出队时跳过排队超过该时间的帧（stale）。丢帧按原因分别计数。
+ *
+ * 摄像头配置（AddCameraRequest.config）：
+ * - queue_mode: "latest" / "fifo"（默认 latest）
+ * - queue_depth: 队列长度（默认 latest 为 1，fifo 为 8）
+ * - max_frame_age_ms: 帧最大排队时间，0 表示不限（默认 0）
+ */
+
+#include "utils/one_logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+enum class FrameQueueMode {
+  kLatest = 0,        // 延迟优先
+  kFifo,              // 完整性优先
+};
+
+enum FrameDropReason {
+  kDropSuperseded = 0,    // kLatest：被更新的帧顶替
+  kDropQueueFull,         // kFifo：队列满，新帧被丢弃
+  kDropStale,             // 排队超过 max_age_ms
+  kDropClosed,            // 队列关闭后到达或关闭时仍在排队
+  kNumDropReasons
+};
+
+inline const char* frameDropReasonName(int reason) {
+  static const char* const kNames[kNumDropReasons] = {"superseded", "queue_full", "stale",
+                                                      "closed"};
+  return reason >= 0 && reason < kNumDropReasons ? kNames[reason] : "unknown";
+}
+
+struct FrameQueueOptions {
+  FrameQueueMode mode = FrameQueueMode::kLatest;
+  int depth = 1;
+  int64_t max_age_ms = 0;
+};
+
+/**
+ * @brief 帧队列计数快照
+ */
+struct FrameQueueStats {
+  uint64_t pushed = 0;
+  uint64_t popped = 0;
+  uint64_t dropped[kNumDropReasons] = {};
+  size_t size = 0;
+  size_t max_size = 0;
+
+  uint64_t totalDropped() const {
+    uint64_t total = 0;
+    for (uint64_t n : dropped) {
+      total += n;
+    }
+    return total;
+  }
+
+  /**
+   * @brief 丢帧比例（相对于到达的帧数）
+   */
+  double dropRatio() const {
+    return pushed > 0 ? static_cast<double>(totalDropped()) / static_cast<double>(pushed) : 0.0;
+  }
+
+  /**
+   * @brief 按原因名称输出非零的丢帧计数（上报用）
+   */
+  std::map<std::string, uint64_t> droppedByReason() const {
+    std::map<std::string, uint64_t> result;
+    for (int r = 0; r < kNumDropReasons; ++r) {
+      if (dropped[r] > 0) {
+        result[frameDropReasonName(r)] = dropped[r];
+      }
+    }
+    return result;
+  }
+};
+
+template <typename Frame>
+class FrameMailbox {
+ public:
+  explicit FrameMailbox(const FrameQueueOptions& options = FrameQueueOptions())
+      : options_(options) {
+    options_.depth = std::max(options_.depth, 1);
+    options_.max_age_ms = std::max<int64_t>(options_.max_age_ms, 0);
+  }
+
+  FrameMailbox(const FrameMailbox&) = delete;
+  FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+  /**
+   * @brief 从摄像头配置解析队列参数
+   * @return 解析失败返回 false，options 保持不变
+   */
+  static bool parseConfig(const std::map<std::string, std::string>& config,
+                          FrameQueueOptions* options);
+
+  /**
+   * @brief 解码线程调用，从不等待消费者
+   * @return 帧已入队返回 true（kLatest 下总是入队，可能顶替旧帧）
+   */
+  bool push(Frame frame);
+
+  /**
+   * @brief 取下一帧（跳过过期帧）
+   * @param timeout_ms 最长等待时间，< 0 表示一直等到有帧或关闭
+   * @return 超时或已关闭且为空时返回 false
+   */
+  bool pop(Frame& frame, int timeout_ms = -1);
+
+  /**
+   * @brief 关闭：之后的 push 计为 closed 丢帧，仍在排队的帧被丢弃，pop 立即返回 false
+   */
+  void close();
+
+  const FrameQueueOptions& options() const { return options_; }
+  FrameQueueStats stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    Frame frame;
+    Clock::time_point enqueue;
+  };
+
+  FrameQueueOptions options_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Entry> queue_;
+  bool closed_ = false;
+  FrameQueueStats stats_;
+
+  /**
+   * @brief 弹出过期帧到 expired（调用者持锁，expired 在锁外析构）
+   */
+  void dropStale(Clock::time_point now, std::vector<Entry>& expired);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+template <typename Frame>
+bool FrameMailbox<Frame>::parseConfig(const std::map<std::string, std::string>& config,
+                                      FrameQueueOptions* options) {
+  // 先解析到副本，全部合法后再写回，失败时不留下部分更新
+  FrameQueueOptions parsed = *options;
+  auto it = config.find("queue_mode");
+  if (it != config.end()) {
+    if (it->second == "latest") {
+      parsed.mode = FrameQueueMode::kLatest;
+      parsed.depth = 1;
+    } else if (it->second == "fifo") {
+      parsed.mode = FrameQueueMode::kFifo;
+      parsed.depth = 8;
+    } else {
+      return false;
+    }
+  }
+  try {
+    if ((it = config.find("queue_depth")) != config.end()) {
+      parsed.depth = std::stoi(it->second);
+    }
+    if ((it = config.find("max_frame_age_ms")) != config.end()) {
+      parsed.max_age_ms = std::stoll(it->second);
+    }
+  } catch (const std::exception& e) {
+    LOG_WARN("Invalid frame queue config: {}", e.what());
+    return false;
+  }
+  if (parsed.depth <= 0 || parsed.max_age_ms < 0) {
+    return false;
+  }
+  *options = parsed;
+  return true;
+}
+
+template <typename Frame>
+bool FrameMailbox<Frame>::push(Frame frame) {
+  Entry dropped;      // 被顶替的帧在锁外析构
+  bool accepted = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.pushed;
+    if (closed_) {
+      ++stats_.dropped[kDropClosed];
+      accepted = false;
+    } else if (static_cast<int>(queue_.size()) < options_.depth) {
+      queue_.push_back(Entry{std::move(frame), Clock::now()});
+    } else if (options_.mode == FrameQueueMode::kLatest) {
+      dropped = std::move(queue_.front());
+      queue_.pop_front();
+      queue_.push_back(Entry{std::move(frame), Clock::now()});
+      ++stats_.dropped[kDropSuperseded];
+    } else {
+      ++stats_.dropped[kDropQueueFull];
+      accepted = false;
+    }
+    stats_.max_size = std::max(stats_.max_size, queue_.size());
+  }
+  if (accepted) {
+    cv_.notify_one();
+  }
+  return accepted;
+}
+
+template <typename Frame>
+void FrameMailbox<Frame>::dropStale(Clock::time_point now, std::vector<Entry>& expired) {
+  if (options_.max_age_ms <= 0) {
+    return;
+  }
+  const auto max_age = std::chrono::milliseconds(options_.max_age_ms);
+  while (!queue_.empty() && now - queue_.front().enqueue > max_age) {
+    expired.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+    ++stats_.dropped[kDropStale];
+  }
+}
+
+template <typename Frame>
+bool FrameMailbox<Frame>::pop(Frame& frame, int timeout_ms) {
+  std::vector<Entry> expired;
+  std::unique_lock<std::mutex> lock(mutex_);
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (true) {
+    dropStale(Clock::now(), expired);
+    if (!queue_.empty()) {
+      frame = std::move(queue_.front().frame);
+      queue_.pop_front();
+      ++stats_.popped;
+      return true;
+    }
+    if (closed_) {
+      return false;
+    }
+    if (timeout_ms < 0) {
+      cv_.wait(lock);
+    } else if (cv_.wait_until(lock, deadline) == std::cv_status::timeout && queue_.empty()) {
+      return false;
+    }
+  }
+}
+
+template <typename Frame>
+void FrameMailbox<Frame>::close() {
+  std::deque<Entry> remaining;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    stats_.dropped[kDropClosed] += queue_.size();
+    remaining.swap(queue_);
+  }
+  cv_.notify_all();
+}
+
+template <typename Frame>
+FrameQueueStats FrameMailbox<Frame>::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FrameQueueStats stats = stats_;
+  stats.size = queue_.size();
+  return stats;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
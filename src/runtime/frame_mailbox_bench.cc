@@ -0,0 +1,106 @@
+/**
+ * @file frame_mailbox_bench.cc
+ * @brief 推理过载时 latest（mailbox）与 fifo 两种帧队列的端到端延迟与丢帧
+ *
+ * 解码线程按 25 fps 送帧，推理线程每帧耗时默认 60 ms（约 16.7 fps，持续过载）：
+ *   1. latest, depth 1 / depth 2
+ *   2. fifo, depth 8 / depth 8 + max_frame_age_ms 200
+ * 输出处理 fps、采集到出结果的延迟 p50 / p99、按原因的丢帧数以及解码线程 push 的最长耗时。
+ *
+ * 用法: frame_mailbox_bench [seconds] [infer_ms]
+ */
+
+#include "algo_utils/stage_timer.h"
+#include "runtime/frame_mailbox.h"
+#include "utils/one_logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace infer_frame;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Frame {
+  int id = -1;
+  Clock::time_point captured;
+};
+
+struct Scenario {
+  const char* name;
+  runtime::FrameQueueOptions options;
+};
+
+uint64_t sinceNs(Clock::time_point t) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t).count());
+}
+
+void runScenario(const Scenario& scenario, int seconds, double infer_ms) {
+  runtime::FrameMailbox<Frame> mailbox(scenario.options);
+  algo_utils::StageRecorder recorder{"e2e", "push"};
+  std::atomic<int> processed{0};
+
+  std::thread consumer([&] {
+    Frame frame;
+    while (mailbox.pop(frame)) {
+      std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int>(infer_ms * 1000)));
+      recorder.record(0, sinceNs(frame.captured));
+      processed.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  const auto period = std::chrono::microseconds(40000);
+  const auto begin = Clock::now();
+  for (int i = 0; i < seconds * 25; ++i) {
+    std::this_thread::sleep_until(begin + i * period);
+    const auto t = Clock::now();
+    mailbox.push(Frame{i, t});
+    recorder.record(1, sinceNs(t));
+  }
+  // 让队列中剩余的帧处理完，再关闭
+  while (mailbox.stats().size > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int>(infer_ms * 1000) + 5000));
+  mailbox.close();
+  consumer.join();
+  const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+  const runtime::FrameQueueStats stats = mailbox.stats();
+  const algo_utils::PerfStats perf = recorder.snapshot();
+  LOG_INFO("{:<24} {:>6.1f} {:>9.0f} {:>9.0f} {:>10} {:>10} {:>6} {:>9.1f}", scenario.name,
+           processed.load() / elapsed, perf.stages[0].percentileUs(0.5),
+           perf.stages[0].percentileUs(0.99), stats.dropped[runtime::kDropSuperseded],
+           stats.dropped[runtime::kDropQueueFull], stats.dropped[runtime::kDropStale],
+           perf.stages[1].max_ns / 1000.0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int seconds = argc > 1 ? std::stoi(argv[1]) : 5;
+  const double infer_ms = argc > 2 ? std::stod(argv[2]) : 60.0;
+
+  LOG_INFO("======================================");
+  LOG_INFO("  Frame Mailbox Benchmark");
+  LOG_INFO("  decoder 25 fps, inference {:.1f} ms/frame, {} s", infer_ms, seconds);
+  LOG_INFO("======================================");
+  LOG_INFO("{:<24} {:>6} {:>9} {:>9} {:>10} {:>10} {:>6} {:>9}", "mode", "fps", "p50 us",
+           "p99 us", "superseded", "queue_full", "stale", "push max");
+
+  const Scenario scenarios[] = {
+    {"latest, depth 1", {runtime::FrameQueueMode::kLatest, 1, 0}},
+    {"latest, depth 2", {runtime::FrameQueueMode::kLatest, 2, 0}},
+    {"fifo, depth 8", {runtime::FrameQueueMode::kFifo, 8, 0}},
+    {"fifo, depth 8, age 200ms", {runtime::FrameQueueMode::kFifo, 8, 200}},
+  };
+  for (const Scenario& scenario : scenarios) {
+    runScenario(scenario, seconds, infer_ms);
+  }
+  return 0;
+}
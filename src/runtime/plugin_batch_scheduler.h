@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * @file plugin_batch_scheduler.h
+ * @brief BatchScheduler 与 C++ 插件 AlgoPluginBase::inferBatch 的适配
+ *
+ * @code
+ * runtime::PluginBatchScheduler scheduler(runtime::pluginBatchFn(plugin), options);
+ * scheduler.start();
+ * // 每路摄像头：输入 / 输出 Tensor 由调用者准备，回调里读取输出
+ * scheduler.submit(workflow_id, {input}, {output}, [cam](AlgoStatus s, auto& outputs) { ... });
+ * @endcode
+ *
+ * 静态链接的插件可按具体类型包装（typedPluginBatchFn），每批的 inferBatch 不经虚表。
+ */
+
+#include "plugin/algo_plugin_base.h"
+#include "runtime/batch_scheduler.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+using PluginBatchScheduler =
+    BatchScheduler<std::vector<base::Tensor*>, std::vector<base::Tensor*>>;
+
+/**
+ * @brief 把插件的 inferBatch 包装为批处理函数（插件生命周期需长于调度器）
+ */
+inline PluginBatchScheduler::BatchFn pluginBatchFn(plugin::AlgoPluginBase* plugin) {
+  return [plugin](const std::vector<std::vector<base::Tensor*>>& inputs,
+                  std::vector<std::vector<base::Tensor*>>& outputs) {
+    if (!plugin || !plugin->isInitialized()) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    base::Status status = plugin->inferBatch(inputs, outputs);
+    return status.ok() ? ALGO_STATUS_SUCCESS : ALGO_STATUS_ERROR_INFERENCE;
+  };
+}
+
+/**
+ * @brief 按具体插件类型包装（插件来自 PluginLoader::getStaticPlugin<Plugin>()），
+ *        Plugin 为 final 时 inferBatch 是直接调用
+ */
+template <typename Plugin>
+PluginBatchScheduler::BatchFn typedPluginBatchFn(Plugin* plugin) {
+  static_assert(std::is_final<Plugin>::value, "typed plugin call path needs a final class");
+  return [plugin](const std::vector<std::vector<base::Tensor*>>& inputs,
+                  std::vector<std::vector<base::Tensor*>>& outputs) {
+    if (!plugin || !plugin->isInitialized()) {
+      return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+    }
+    base::Status status = plugin->inferBatch(inputs, outputs);
+    return status.ok() ? ALGO_STATUS_SUCCESS : ALGO_STATUS_ERROR_INFERENCE;
+  };
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
@@ -0,0 +1,214 @@
+/**
+ * @file qos_scheduling_bench.cc
+ * @brief 工作流优先级 / 权重：过载时安全区域摄像头不排在全景摄像头后面
+ *
+ * 32 路摄像头各 25 fps 共享一个模型，模型耗时按固定开销 + 每帧开销模拟，默认处于过载状态。
+ * 四个工作流（DeployWorkflowRequest.params 中配置）：
+ *   safety   4 路  priority=high                    latency_slo_ms=100
+ *   yard_a  12 路  priority=normal weight=3         latency_slo_ms=500
+ *   yard_b  12 路  priority=normal weight=1         latency_slo_ms=500
+ *   archive  4 路  priority=low                     latency_slo_ms=2000
+ * 推理完成后的后处理作为任务按工作流优先级提交到共享 TaskExecutor。
+ * 对比所有工作流同等对待（不设置 QoS，排队满时拒绝新帧）与按 QoS 调度（抢占攒批、排队满时
+ * 挤出份额最靠后的帧）：每个工作流的实际 fps、在 normal / low 加权域中的吞吐占比与按
+ * 优先级权重 x 工作流权重算出的目标占比（默认负载下三个加权工作流都过载，占比应跟随权重）、
+ * 提交 -> 后处理完成的延迟 p50 / p99 与 SLO 达成率（被拒绝 / 挤出的帧计为未达成）。
+ *
+ * 用法: qos_scheduling_bench [seconds] [fixed_ms] [per_frame_ms]
+ */
+
+#include "runtime/batch_scheduler.h"
+#include "runtime/workflow_qos.h"
+#include "utils/one_logger.hpp"
+#include "utils/task_executor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace infer_frame;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kCameras = 32;
+
+struct WorkflowDef {
+  const char* name;
+  int cameras;
+  std::map<std::string, std::string> params;
+};
+
+const WorkflowDef kWorkflows[] = {
+  {"safety", 4, {{"priority", "high"}, {"latency_slo_ms", "100"}}},
+  {"yard_a", 12, {{"priority", "normal"}, {"weight", "3"}, {"latency_slo_ms", "500"}}},
+  {"yard_b", 12, {{"priority", "normal"}, {"weight", "1"}, {"latency_slo_ms", "500"}}},
+  {"archive", 4, {{"priority", "low"}, {"latency_slo_ms", "2000"}}},
+};
+constexpr int kNumWorkflows = sizeof(kWorkflows) / sizeof(kWorkflows[0]);
+
+struct Frame {
+  int workflow = 0;
+};
+
+struct Result {
+  int workflow = -1;
+};
+
+void busy(double us) {
+  const auto end = Clock::now() + std::chrono::nanoseconds(static_cast<int64_t>(us * 1000));
+  while (Clock::now() < end) {
+  }
+}
+
+void runScenario(const char* name, bool use_qos, int seconds, double fixed_ms,
+                 double per_frame_ms) {
+  runtime::WorkflowQos qos[kNumWorkflows];
+  int camera_workflow[kCameras];
+  for (int w = 0, camera = 0; w < kNumWorkflows; ++w) {
+    if (!runtime::parseWorkflowQos(kWorkflows[w].params, &qos[w])) {
+      LOG_ERROR("Invalid qos params of workflow {}", kWorkflows[w].name);
+      return;
+    }
+    for (int c = 0; c < kWorkflows[w].cameras; ++c) {
+      camera_workflow[camera++] = w;
+    }
+  }
+
+  TaskExecutorOptions executor_options;
+  executor_options.num_workers = 2;
+  TaskExecutor executor(executor_options);
+
+  runtime::BatchSchedulerOptions options;
+  options.max_batch_size = 16;
+  options.max_pending = 160;
+  options.preempt_on_high = use_qos;
+  options.shed_by_share = use_qos;
+  runtime::SloTracker slo;
+  std::atomic<uint64_t> completed[kNumWorkflows] = {};
+
+  runtime::BatchScheduler<Frame, Result> scheduler(
+      [&](const std::vector<Frame>& inputs, std::vector<Result>& outputs) {
+        const double ms = fixed_ms + per_frame_ms * static_cast<double>(inputs.size());
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int>(ms * 1000)));
+        for (size_t i = 0; i < inputs.size(); ++i) {
+          outputs[i].workflow = inputs[i].workflow;
+        }
+        return ALGO_STATUS_SUCCESS;
+      },
+      options);
+  for (int w = 0; w < kNumWorkflows; ++w) {
+    scheduler.setWorkflowMaxWait(w, 10000);
+    if (use_qos) {
+      scheduler.setWorkflowQos(w, qos[w]);
+    }
+  }
+  scheduler.start();
+
+  // 单个线程按时间表送帧：摄像头 c 的第 k 帧在 k * 40 ms + c * 40 ms / N 到达
+  const auto period = std::chrono::microseconds(40000);
+  const auto begin = Clock::now();
+  const int frames_per_camera = seconds * 25;
+  for (int k = 0; k < frames_per_camera; ++k) {
+    for (int c = 0; c < kCameras; ++c) {
+      std::this_thread::sleep_until(begin + k * period + c * period / kCameras);
+      const int w = camera_workflow[c];
+      // 同等对待：所有摄像头提交到同一个调度工作流，按截止时间先后
+      const bool accepted = scheduler.submit(
+          use_qos ? w : 0, Frame{w}, Result(),
+          [&, w, c, submit = Clock::now()](AlgoStatus status, Result&) {
+        if (status != ALGO_STATUS_SUCCESS) {
+          slo.recordMiss(qos[w]);
+          return;
+        }
+        // 后处理（NMS / 跟踪 / 规则）按工作流优先级进入共享执行器
+        const TaskOptions task = use_qos ? runtime::taskOptions(qos[w], c) : TaskOptions{};
+        executor.submit([&, w, submit] {
+          busy(300.0);
+          slo.record(qos[w], static_cast<uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - submit)
+                  .count()));
+          completed[w].fetch_add(1, std::memory_order_relaxed);
+        }, task);
+      });
+      if (!accepted) {
+        slo.recordMiss(qos[w]);
+      }
+    }
+  }
+  scheduler.stop();
+  const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+  const runtime::BatchStats stats = scheduler.stats();
+
+  // 等待后处理任务执行完
+  while (executor.stats().pending > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  const runtime::SloReport report = slo.snapshot();
+
+  LOG_INFO("--- {} (mean batch {:.2f}, preempted batches {}, rejected {}, evicted {}) ---",
+           name, stats.meanBatchSize(), stats.preempted_batches, stats.rejected, stats.evicted);
+  // 加权域（priority_weights 非 0 的优先级）内各工作流的吞吐占比与目标占比
+  uint64_t weighted_frames = 0;
+  int weighted_total = 0;
+  int effective_weight[kNumWorkflows];
+  for (int w = 0; w < kNumWorkflows; ++w) {
+    effective_weight[w] =
+        options.priority_weights[static_cast<int>(qos[w].priority)] * qos[w].weight;
+    weighted_frames += effective_weight[w] > 0 ? completed[w].load() : 0;
+    weighted_total += effective_weight[w];
+  }
+  LOG_INFO("{:<8} {:<7} {:>6} {:>8} {:>7} {:>7}", "workflow", "class", "weight", "fps/cam",
+           "share", "target");
+  for (int w = 0; w < kNumWorkflows; ++w) {
+    const double fps = completed[w].load() / elapsed;
+    if (effective_weight[w] == 0) {
+      LOG_INFO("{:<8} {:<7} {:>6} {:>8.1f} {:>7} {:>7}", kWorkflows[w].name,
+               runtime::priorityClassName(qos[w].priority), qos[w].weight,
+               fps / kWorkflows[w].cameras, "strict", "-");
+      continue;
+    }
+    LOG_INFO("{:<8} {:<7} {:>6} {:>8.1f} {:>6.1f}% {:>6.1f}%", kWorkflows[w].name,
+             runtime::priorityClassName(qos[w].priority), qos[w].weight,
+             fps / kWorkflows[w].cameras,
+             weighted_frames > 0 ? 100.0 * completed[w].load() / weighted_frames : 0.0,
+             100.0 * effective_weight[w] / weighted_total);
+  }
+  LOG_INFO("{:<7} {:>7} {:>10} {:>10} {:>8} {:>8}", "class", "slo ms", "p50 ms", "p99 ms",
+           "met", "dropped");
+  for (int p = 0; p < kNumTaskPriorities; ++p) {
+    const TaskPriority priority = static_cast<TaskPriority>(p);
+    int slo_ms = runtime::defaultLatencySloMs(priority);
+    for (int w = 0; w < kNumWorkflows; ++w) {
+      slo_ms = qos[w].priority == priority ? qos[w].sloMs() : slo_ms;
+    }
+    const algo_utils::StageStats& latency = report.latency.stages[p];
+    LOG_INFO("{:<7} {:>7} {:>10.1f} {:>10.1f} {:>7.1f}% {:>8}",
+             runtime::priorityClassName(priority), slo_ms, latency.percentileUs(0.5) / 1000.0,
+             latency.percentileUs(0.99) / 1000.0, report.of(priority).attainment() * 100.0,
+             report.of(priority).dropped);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int seconds = argc > 1 ? std::stoi(argv[1]) : 4;
+  const double fixed_ms = argc > 2 ? std::stod(argv[2]) : 4.0;
+  const double per_frame_ms = argc > 3 ? std::stod(argv[3]) : 2.0;
+
+  LOG_INFO("======================================");
+  LOG_INFO("  Workflow QoS Scheduling Benchmark");
+  LOG_INFO("  {} cameras x 25 fps, model {:.1f} ms + {:.2f} ms/frame, {} s", kCameras, fixed_ms,
+           per_frame_ms, seconds);
+  LOG_INFO("======================================");
+
+  runScenario("all workflows equal", false, seconds, fixed_ms, per_frame_ms);
+  runScenario("priority + weighted fair queuing", true, seconds, fixed_ms, per_frame_ms);
+  return 0;
+}
@@ -0,0 +1,462 @@
+#pragma once
+
+/**
+ * @file ring_queue.h
+ * @brief 有界无锁环形队列（SPSC / MPMC）与带满策略的阶段间队列 StageQueue
+ *
+ * - SpscRing：单生产者单消费者，每次操作一次 release 写，索引缓存避免频繁读对端
+ * - MpmcRing：多生产者多消费者（Vyukov 有界队列），每次操作一次 CAS
+ * - StageQueue：在环形队列上加满策略（阻塞 / 丢最旧 / 丢最新）、关闭与统计；
+ *   快路径无锁，只有生产者阻塞或消费者空闲时才在条件变量上休眠
+ *
+ * 丢最旧需要生产者从队头取出一项，因此只能用 MPMC；单生产者单消费者且不丢最旧时自动使用 SPSC。
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace infer_frame {
+namespace runtime {
+
+namespace ring_detail {
+
+constexpr size_t kCacheLine = 64;
+
+inline size_t roundUpPow2(size_t n) {
+  size_t p = 2;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+}  // namespace ring_detail
+
+/**
+ * @brief 单生产者单消费者有界队列（容量精确，存储按 2 的幂分配）
+ */
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(size_t capacity)
+      : capacity_(std::max<size_t>(capacity, 1)),
+        mask_(ring_detail::roundUpPow2(capacity_) - 1),
+        slots_(new T[mask_ + 1]) {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  /**
+   * @brief 只能由生产者线程调用
+   */
+  bool tryPush(T&& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ >= capacity_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ >= capacity_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 只能由消费者线程调用
+   */
+  bool tryPop(T& value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return false;
+      }
+    }
+    value = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : 0;
+  }
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<T[]> slots_;
+
+  alignas(ring_detail::kCacheLine) std::atomic<size_t> head_{0};
+  size_t tail_cache_ = 0;     // 消费者缓存的 tail
+  alignas(ring_detail::kCacheLine) std::atomic<size_t> tail_{0};
+  size_t head_cache_ = 0;     // 生产者缓存的 head
+};
+
+/**
+ * @brief 多生产者多消费者有界队列（容量向上取 2 的幂）
+ */
+template <typename T>
+class MpmcRing {
+ public:
+  explicit MpmcRing(size_t capacity)
+      : mask_(ring_detail::roundUpPow2(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcRing(const MpmcRing&) = delete;
+  MpmcRing& operator=(const MpmcRing&) = delete;
+
+  bool tryPush(T&& value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;     // 满
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPop(T& value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;     // 空
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->value);
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? std::min(tail - head, mask_ + 1) : 0;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(ring_detail::kCacheLine) std::atomic<size_t> head_{0};
+  alignas(ring_detail::kCacheLine) std::atomic<size_t> tail_{0};
+};
+
+/**
+ * @brief 队列满时的处理方式
+ */
+enum class QueueFullPolicy {
+  kBlock = 0,         // 生产者等待（保证不丢帧）
+  kDropOldest,        // 丢弃队头最旧的一项后入队（延迟优先）
+  kDropNewest,        // 丢弃新来的一项（生产者不阻塞）
+};
+
+struct StageQueueOptions {
+  size_t capacity = 4;
+  QueueFullPolicy policy = QueueFullPolicy::kBlock;
+  bool single_producer = false;
+  bool single_consumer = false;
+};
+
+/**
+ * @brief 队列计数快照
+ */
+struct StageQueueStats {
+  size_t capacity = 0;
+  size_t size = 0;                  // 当前排队数
+  size_t max_size = 0;              // 出现过的最大排队数
+  uint64_t pushed = 0;
+  uint64_t popped = 0;
+  uint64_t dropped_oldest = 0;
+  uint64_t dropped_newest = 0;
+  uint64_t occupancy_sum = 0;       // 每次入队后的排队数之和
+
+  /**
+   * @brief 入队时的平均占用率（0..1）
+   */
+  double meanOccupancy() const {
+    return pushed > 0 && capacity > 0
+               ? static_cast<double>(occupancy_sum) / pushed / static_cast<double>(capacity)
+               : 0.0;
+  }
+};
+
+/**
+ * @brief 阶段间队列：无锁环形队列 + 满策略 + 关闭
+ *
+ * push / pop 的阻塞时间由调用者计时（见 StagePipeline），这里只计数。
+ */
+template <typename T>
+class StageQueue {
+ public:
+  explicit StageQueue(const StageQueueOptions& options);
+
+  StageQueue(const StageQueue&) = delete;
+  StageQueue& operator=(const StageQueue&) = delete;
+
+  /**
+   * @brief 入队
+   * @param blocked_ns 可选，输出本次因队列满阻塞的时间（仅 kBlock）
+   * @return 已入队返回 true；队列已关闭或按 kDropNewest 丢弃时返回 false
+   */
+  bool push(T&& item, uint64_t* blocked_ns = nullptr);
+
+  /**
+   * @brief 出队（无数据时等待）
+   * @param idle_ns 可选，输出本次等待数据的时间
+   * @return 队列已关闭且为空时返回 false
+   */
+  bool pop(T& item, uint64_t* idle_ns = nullptr);
+
+  bool tryPop(T& item);
+
+  /**
+   * @brief 关闭：之后的 push 失败，pop 取完剩余项后返回 false
+   */
+  void close();
+
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+  size_t size() const { return spsc_ ? spsc_->size() : mpmc_->size(); }
+  size_t capacity() const { return capacity_; }
+  QueueFullPolicy policy() const { return options_.policy; }
+  StageQueueStats stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  StageQueueOptions options_;
+  size_t capacity_;
+  std::unique_ptr<SpscRing<T>> spsc_;
+  std::unique_ptr<MpmcRing<T>> mpmc_;
+  std::atomic<bool> closed_{false};
+
+  // 休眠 / 唤醒：只有存在等待者时生产者 / 消费者才加锁通知
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::atomic<int> waiting_consumers_{0};
+  std::atomic<int> waiting_producers_{0};
+
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> popped_{0};
+  std::atomic<uint64_t> dropped_oldest_{0};
+  std::atomic<uint64_t> dropped_newest_{0};
+  std::atomic<uint64_t> occupancy_sum_{0};
+  std::atomic<size_t> max_size_{0};
+
+  bool tryPushRing(T&& item) {
+    return spsc_ ? spsc_->tryPush(std::move(item)) : mpmc_->tryPush(std::move(item));
+  }
+  bool tryPopRing(T& item) { return spsc_ ? spsc_->tryPop(item) : mpmc_->tryPop(item); }
+
+  void onPushed();
+  void wake(std::atomic<int>& waiters, std::condition_variable& cv);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+template <typename T>
+StageQueue<T>::StageQueue(const StageQueueOptions& options) : options_(options) {
+  const size_t capacity = std::max<size_t>(options.capacity, 1);
+  if (options.single_producer && options.single_consumer &&
+      options.policy != QueueFullPolicy::kDropOldest) {
+    spsc_.reset(new SpscRing<T>(capacity));
+    capacity_ = spsc_->capacity();
+  } else {
+    mpmc_.reset(new MpmcRing<T>(capacity));
+    capacity_ = mpmc_->capacity();
+  }
+}
+
+template <typename T>
+void StageQueue<T>::wake(std::atomic<int>& waiters, std::condition_variable& cv) {
+  // 与等待方的 "登记 -> 复查" 配对：任一方都能看到对方的写入
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv.notify_all();
+  }
+}
+
+template <typename T>
+void StageQueue<T>::onPushed() {
+  pushed_.fetch_add(1, std::memory_order_relaxed);
+  const size_t n = size();
+  occupancy_sum_.fetch_add(n, std::memory_order_relaxed);
+  size_t prev = max_size_.load(std::memory_order_relaxed);
+  while (n > prev && !max_size_.compare_exchange_weak(prev, n, std::memory_order_relaxed)) {
+  }
+  wake(waiting_consumers_, not_empty_);
+}
+
+template <typename T>
+bool StageQueue<T>::push(T&& item, uint64_t* blocked_ns) {
+  if (blocked_ns) {
+    *blocked_ns = 0;
+  }
+  if (closed()) {
+    return false;
+  }
+  if (tryPushRing(std::move(item))) {
+    onPushed();
+    return true;
+  }
+
+  switch (options_.policy) {
+    case QueueFullPolicy::kDropNewest:
+      dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    case QueueFullPolicy::kDropOldest: {
+      // 与消费者竞争：取不到说明消费者刚取走，直接重试入队
+      T oldest;
+      while (!tryPushRing(std::move(item))) {
+        if (tryPopRing(oldest)) {
+          dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      onPushed();
+      return true;
+    }
+    case QueueFullPolicy::kBlock:
+    default:
+      break;
+  }
+
+  const Clock::time_point begin = Clock::now();
+  bool pushed = false;
+  while (!pushed) {
+    waiting_producers_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    pushed = tryPushRing(std::move(item));
+    if (!pushed && !closed()) {
+      // 在锁内复查：消费者出队后持同一把锁唤醒，复查之后的唤醒不会丢失
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_.wait(lock, [this] { return closed() || size() < capacity_; });
+    }
+    waiting_producers_.fetch_sub(1, std::memory_order_relaxed);
+    if (!pushed && closed()) {
+      break;
+    }
+  }
+  if (blocked_ns) {
+    *blocked_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count());
+  }
+  if (pushed) {
+    onPushed();
+  }
+  return pushed;
+}
+
+template <typename T>
+bool StageQueue<T>::tryPop(T& item) {
+  if (!tryPopRing(item)) {
+    return false;
+  }
+  popped_.fetch_add(1, std::memory_order_relaxed);
+  if (options_.policy == QueueFullPolicy::kBlock) {
+    wake(waiting_producers_, not_full_);
+  }
+  return true;
+}
+
+template <typename T>
+bool StageQueue<T>::pop(T& item, uint64_t* idle_ns) {
+  if (idle_ns) {
+    *idle_ns = 0;
+  }
+  if (tryPop(item)) {
+    return true;
+  }
+  const Clock::time_point begin = Clock::now();
+  bool popped = false;
+  while (!popped) {
+    waiting_consumers_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    popped = tryPop(item);
+    const bool done = !popped && closed();
+    if (!popped && !done) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this] { return closed() || size() > 0; });
+    }
+    waiting_consumers_.fetch_sub(1, std::memory_order_relaxed);
+    // 关闭后再取一次，关闭前入队的项不丢
+    if (done && !(popped = tryPop(item))) {
+      break;
+    }
+  }
+  if (idle_ns) {
+    *idle_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count());
+  }
+  return popped;
+}
+
+template <typename T>
+void StageQueue<T>::close() {
+  closed_.store(true, std::memory_order_release);
+  std::lock_guard<std::mutex> lock(mutex_);
+  not_empty_.notify_all();
+  not_full_.notify_all();
+}
+
+template <typename T>
+StageQueueStats StageQueue<T>::stats() const {
+  StageQueueStats stats;
+  stats.capacity = capacity_;
+  stats.size = size();
+  stats.max_size = max_size_.load(std::memory_order_relaxed);
+  stats.pushed = pushed_.load(std::memory_order_relaxed);
+  stats.popped = popped_.load(std::memory_order_relaxed);
+  stats.dropped_oldest = dropped_oldest_.load(std::memory_order_relaxed);
+  stats.dropped_newest = dropped_newest_.load(std::memory_order_relaxed);
+  stats.occupancy_sum = occupancy_sum_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
@@ -0,0 +1,1138 @@
+/**
+ * @file runtime_test.cc
+ * @brief 运行时调度组件的正确性测试（header-only，不依赖 Backend）
+ *
+ * 每组测试对应一个组件，检查失败时进程以 1 退出。
+ *
+ * 用法: runtime_test
+ */
+
+#include "runtime/batch_scheduler.h"
+#include "runtime/frame_buffer.h"
+#include "runtime/frame_mailbox.h"
+#include "runtime/stage_pipeline.h"
+#include "runtime/tensor_cache.h"
+#include "runtime/workflow_engine.h"
+#include "runtime/workflow_graph.h"
+#include "runtime/workflow_qos.h"
+#include "utils/one_logger.hpp"
+#include "utils/task_executor.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace infer_frame;
+
+// 失败的检查数，非 0 时进程以 1 退出
+int g_failed_tests = 0;
+
+void printTestResult(const std::string& test_name, bool passed) {
+  if (passed) {
+    LOG_INFO("✓ {}", test_name);
+  } else {
+    LOG_ERROR("✗ {}", test_name);
+    ++g_failed_tests;
+  }
+}
+
+using Clock = std::chrono::steady_clock;
+
+int64_t elapsedMs(Clock::time_point begin) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief 轮询直到 pred 成立，超时返回 false
+ */
+template <typename Pred>
+bool waitUntil(Pred pred, int timeout_ms = 2000) {
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!pred()) {
+    if (Clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+/**
+ * @brief 让工作线程停在 enter() 上，测试线程在此期间构造排队状态后 open()
+ */
+class Gate {
+ public:
+  void enter() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    entered_ = true;
+    cv_.notify_all();
+    cv_.wait(lock, [this] { return open_; });
+  }
+
+  bool waitEntered(int timeout_ms = 2000) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return entered_; });
+  }
+
+  void open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    cv_.notify_all();
+  }
+
+  /**
+   * @brief 重新关闭（没有线程停在 enter() 上时调用）
+   */
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entered_ = false;
+    open_ = false;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool entered_ = false;
+  bool open_ = false;
+};
+
+// ============================================================================
+// BatchScheduler
+// ============================================================================
+
+using FrameScheduler = runtime::BatchScheduler<int, int>;
+
+// 批处理遇到该帧号时停在 gate 上，其后提交的帧都在排队
+constexpr int kBlockerFrame = -1;
+
+/**
+ * @brief 记录发出顺序（不含阻塞帧）与每帧的完成状态
+ */
+struct BatchLog {
+  std::mutex mutex;
+  std::vector<int> served;
+  std::map<int, AlgoStatus> completed;
+  Gate gate;
+
+  FrameScheduler::BatchFn batchFn() {
+    return [this](const std::vector<int>& inputs, std::vector<int>& outputs) {
+      if (!inputs.empty() && inputs[0] == kBlockerFrame) {
+        gate.enter();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i] != kBlockerFrame) {
+          served.push_back(inputs[i]);
+        }
+        outputs[i] = inputs[i];
+      }
+      return ALGO_STATUS_SUCCESS;
+    };
+  }
+
+  FrameScheduler::Completion completion(int frame) {
+    return [this, frame](AlgoStatus status, int&) {
+      std::lock_guard<std::mutex> lock(mutex);
+      completed[frame] = status;
+    };
+  }
+
+  bool completedWith(int frame, AlgoStatus status) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = completed.find(frame);
+    return it != completed.end() && it->second == status;
+  }
+
+  size_t numCompleted() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completed.size();
+  }
+
+  /**
+   * @brief 提交阻塞帧并等到调度线程停在 gate 上
+   */
+  bool block(FrameScheduler* scheduler, int workflow_id) {
+    return scheduler->submit(workflow_id, kBlockerFrame, 0, completion(kBlockerFrame)) &&
+           gate.waitEntered();
+  }
+};
+
+void testBatchScheduler() {
+  LOG_INFO("\n[Test 1] BatchScheduler batch triggers and eviction order...");
+  runtime::WorkflowQos high;
+  high.priority = TaskPriority::kHigh;
+  runtime::WorkflowQos low;
+  low.priority = TaskPriority::kLow;
+
+  {
+    // 未攒满：最早一帧到达工作流的最大等待时间后发出
+    runtime::BatchSchedulerOptions options;
+    options.max_batch_size = 8;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    scheduler.setWorkflowMaxWait(1, 30000);
+    scheduler.start();
+    const Clock::time_point begin = Clock::now();
+    for (int i = 0; i < 3; ++i) {
+      scheduler.submit(1, i, 0, log.completion(i));
+    }
+    const bool done = waitUntil([&] { return log.numCompleted() == 3; });
+    const int64_t elapsed = elapsedMs(begin);
+    const runtime::BatchStats stats = scheduler.stats();
+    printTestResult("Deadline batch waits for max_wait", done && elapsed >= 30);
+    printTestResult("Deadline batch counted", stats.batches == 1 && stats.deadline_batches == 1 &&
+                                                  stats.batch_sizes[3] == 1);
+    scheduler.stop();
+  }
+
+  {
+    // 攒满：不等截止时间
+    runtime::BatchSchedulerOptions options;
+    options.max_batch_size = 4;
+    options.default_max_wait_us = 10000000;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    scheduler.start();
+    const Clock::time_point begin = Clock::now();
+    for (int i = 0; i < 4; ++i) {
+      scheduler.submit(1, i, 0, log.completion(i));
+    }
+    const bool done = waitUntil([&] { return log.numCompleted() == 4; });
+    const runtime::BatchStats stats = scheduler.stats();
+    printTestResult("Full batch dispatched before deadline", done && elapsedMs(begin) < 2000);
+    printTestResult("Full batch counted", stats.batches == 1 && stats.full_batches == 1 &&
+                                              stats.batch_sizes[4] == 1);
+    scheduler.stop();
+  }
+
+  {
+    // high 帧到达即结束攒批
+    runtime::BatchSchedulerOptions options;
+    options.max_batch_size = 8;
+    options.default_max_wait_us = 10000000;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    scheduler.setWorkflowQos(2, high);
+    scheduler.start();
+    scheduler.submit(1, 0, 0, log.completion(0));
+    scheduler.submit(1, 1, 0, log.completion(1));
+    scheduler.submit(2, 2, 0, log.completion(2));
+    const bool done = waitUntil([&] { return log.numCompleted() == 3; });
+    const runtime::BatchStats stats = scheduler.stats();
+    printTestResult("High frame preempts batching", done && stats.preempted_batches == 1 &&
+                                                        stats.batch_sizes[3] == 1);
+    scheduler.stop();
+  }
+
+  {
+    // stop 不再等待截止时间
+    runtime::BatchSchedulerOptions options;
+    options.default_max_wait_us = 10000000;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    scheduler.start();
+    scheduler.submit(1, 0, 0, log.completion(0));
+    scheduler.submit(1, 1, 0, log.completion(1));
+    const Clock::time_point begin = Clock::now();
+    scheduler.stop();
+    printTestResult("Stop flushes pending frames",
+                    log.numCompleted() == 2 && elapsedMs(begin) < 2000);
+    printTestResult("Submit after stop rejected", !scheduler.submit(1, 2, 0, log.completion(2)));
+  }
+
+  {
+    // 排队已满：挤出份额最靠后的帧，新帧更靠后时拒绝；high 挤出加权域中最靠后的帧
+    runtime::BatchSchedulerOptions options;
+    options.max_batch_size = 1;
+    options.max_pending = 2;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    scheduler.setWorkflowQos(2, high);
+    scheduler.setWorkflowQos(3, low);
+    scheduler.start();
+    const bool blocked = log.block(&scheduler, 9);
+    printTestResult("Scheduler blocked on first batch", blocked);
+    if (blocked) {
+      const bool low_queued = scheduler.submit(3, 10, 0, log.completion(10));
+      const bool normal_queued = scheduler.submit(1, 11, 0, log.completion(11));
+      printTestResult("Queue fills up", low_queued && normal_queued && scheduler.pending() == 2);
+      printTestResult("Normal frame evicts low frame",
+                      scheduler.submit(1, 12, 0, log.completion(12)) &&
+                          log.numCompleted() == 1 &&
+                          log.completedWith(10, ALGO_STATUS_ERROR_DROPPED));
+      printTestResult("Low frame behind its share rejected",
+                      !scheduler.submit(3, 13, 0, log.completion(13)) && log.numCompleted() == 1);
+      printTestResult("High frame evicts the newest normal frame",
+                      scheduler.submit(2, 14, 0, log.completion(14)) &&
+                          log.completedWith(12, ALGO_STATUS_ERROR_DROPPED));
+      log.gate.open();
+      const bool done = waitUntil([&] { return log.numCompleted() == 5; });
+      printTestResult("Remaining frames served high first",
+                      done && log.served == std::vector<int>({14, 11}) &&
+                          log.completedWith(14, ALGO_STATUS_SUCCESS) &&
+                          log.completedWith(11, ALGO_STATUS_SUCCESS));
+      const runtime::BatchStats stats = scheduler.stats();
+      printTestResult("Evictions and rejections counted",
+                      stats.evicted == 2 && stats.rejected == 1);
+    } else {
+      log.gate.open();
+    }
+    scheduler.stop();
+  }
+}
+
+// ============================================================================
+// StagePipeline
+// ============================================================================
+
+void testStagePipeline() {
+  LOG_INFO("\n[Test 2] StagePipeline ordering, filtering and full policies...");
+
+  {
+    // kBlock、容量 1：生产者与消费者反复在满 / 空队列上等待，帧不丢、顺序不变
+    runtime::StagePipeline<int> pipeline;
+    std::vector<int> out;
+    pipeline.addStage({"inc", 1, 1}, [](int& v) { v += 1000; return true; });
+    pipeline.addStage({"filter", 1, 1}, [](int& v) { return v % 10 != 1; });
+    pipeline.addStage({"sink", 1, 1}, [&out](int& v) {
+      if (out.size() % 16 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+      out.push_back(v);
+      return true;
+    });
+    pipeline.start();
+    bool accepted = true;
+    for (int i = 0; i < 500; ++i) {
+      accepted = pipeline.submit(i) && accepted;
+    }
+    pipeline.stop();
+    const runtime::StagePipelineStats stats = pipeline.stats();
+    bool ordered = out.size() == 450;
+    for (size_t k = 1; ordered && k < out.size(); ++k) {
+      ordered = out[k - 1] < out[k];
+    }
+    printTestResult("Blocking pipeline keeps every frame", accepted && stats.submitted == 500 &&
+                                                               stats.completed == 450);
+    printTestResult("Filtered frames counted", stats.stages[1].filtered == 50);
+    printTestResult("Frames leave in submission order", ordered);
+    printTestResult("Queues stay within capacity", stats.stages[2].queue.max_size <= 1);
+  }
+
+  {
+    // kDropOldest：下游卡住时只保留最新的帧
+    runtime::StagePipeline<int> pipeline;
+    std::vector<int> out;
+    Gate gate;
+    pipeline.addStage({"pass", 1, 16}, [](int&) { return true; });
+    pipeline.addStage({"sink", 1, 2, runtime::QueueFullPolicy::kDropOldest},
+                      [&](int& v) {
+                        if (v == 0) {
+                          gate.enter();
+                        }
+                        out.push_back(v);
+                        return true;
+                      });
+    pipeline.start();
+    pipeline.submit(0);
+    bool queued = gate.waitEntered();
+    for (int i = 1; i < 10; ++i) {
+      pipeline.submit(i);
+    }
+    queued = queued && waitUntil([&] { return pipeline.stats().stages[1].queue.pushed == 10; });
+    gate.open();
+    pipeline.stop();
+    const runtime::StagePipelineStats stats = pipeline.stats();
+    printTestResult("Drop-oldest keeps the newest frames",
+                    queued && out == std::vector<int>({0, 8, 9}));
+    printTestResult("Drop-oldest counted", stats.stages[1].queue.dropped_oldest == 7 &&
+                                               stats.completed == 3);
+  }
+
+  {
+    // 多 worker 阶段（MPMC）：顺序不保证，但每帧恰好处理一次
+    runtime::StagePipeline<int> pipeline;
+    std::vector<int> out;
+    pipeline.addStage({"work", 3, 4}, [](int& v) { v *= 2; return true; });
+    pipeline.addStage({"sink", 1, 4}, [&out](int& v) { out.push_back(v); return true; });
+    pipeline.start();
+    for (int i = 0; i < 1000; ++i) {
+      pipeline.submit(i);
+    }
+    pipeline.stop();
+    const long long sum = std::accumulate(out.begin(), out.end(), 0LL);
+    printTestResult("Multi-worker stage processes each frame once",
+                    out.size() == 1000 && sum == 999LL * 1000);
+  }
+}
+
+// ============================================================================
+// TaskExecutor
+// ============================================================================
+
+void testTaskExecutor() {
+  LOG_INFO("\n[Test 3] TaskExecutor wakeups, exceptions and nested waits...");
+
+  {
+    // worker 休眠后提交的任务必须被唤醒执行（休眠等待没有超时，丢失唤醒会一直卡住）
+    TaskExecutorOptions options;
+    options.num_workers = 2;
+    options.spin_before_sleep = 1;
+    TaskExecutor executor(options);
+    int late = 0;
+    for (int i = 0; i < 300 && late == 0; ++i) {
+      std::this_thread::sleep_for(std::chrono::microseconds(i % 2 == 0 ? 500 : 50));
+      auto ran = std::make_shared<std::promise<void>>();
+      std::future<void> future = ran->get_future();
+      executor.submit([ran] { ran->set_value(); });
+      late += future.wait_for(std::chrono::seconds(1)) == std::future_status::ready ? 0 : 1;
+    }
+    printTestResult("Tasks submitted to sleeping workers run", late == 0);
+  }
+
+  {
+    // 异常不离开 worker：计入执行器与 TaskGroup 的 failed，交给 on_task_error
+    std::mutex errors_mutex;
+    std::vector<std::string> errors;
+    TaskExecutorOptions options;
+    options.num_workers = 2;
+    options.on_task_error = [&](const char* what) {
+      std::lock_guard<std::mutex> lock(errors_mutex);
+      errors.push_back(what);
+    };
+    TaskExecutor executor(options);
+    TaskGroup group;
+    std::atomic<int> ran{0};
+    executor.submit(group, [] { throw std::runtime_error("boom"); });
+    executor.submit(group, [] { throw 42; });
+    executor.submit(group, [&ran] { ran.fetch_add(1); });
+    executor.wait(group);
+    std::lock_guard<std::mutex> lock(errors_mutex);
+    const bool reported = errors.size() == 2 && (errors[0] == "boom" || errors[1] == "boom");
+    printTestResult("Task exceptions reported", reported);
+    printTestResult("Task exceptions counted", group.failed() == 2 &&
+                                                   executor.stats().failed == 2 && ran == 1);
+  }
+
+  {
+    // 未设置 on_task_error 时写日志，执行器继续工作
+    TaskExecutorOptions options;
+    options.num_workers = 1;
+    TaskExecutor executor(options);
+    TaskGroup group;
+    executor.submit(group, [] { throw std::runtime_error("logged"); });
+    executor.wait(group);
+    TaskGroup after;
+    std::atomic<int> ran{0};
+    executor.submit(after, [&ran] { ran.fetch_add(1); });
+    executor.wait(after);
+    printTestResult("Executor survives unhandled task exception", group.failed() == 1 && ran == 1);
+  }
+
+  {
+    // worker 内嵌套等待：等待的线程执行子任务，单 worker 也不死锁
+    TaskExecutorOptions options;
+    options.num_workers = 1;
+    TaskExecutor executor(options);
+    TaskGroup outer;
+    std::atomic<int> leaves{0};
+    for (int i = 0; i < 4; ++i) {
+      executor.submit(outer, [&] {
+        TaskGroup inner;
+        for (int k = 0; k < 8; ++k) {
+          executor.submit(inner, [&leaves] { leaves.fetch_add(1); });
+        }
+        executor.wait(inner);
+      });
+    }
+    executor.wait(outer);
+    printTestResult("Nested waits complete", leaves == 32 && outer.pending() == 0);
+  }
+}
+
+// ============================================================================
+// FrameMailbox
+// ============================================================================
+
+/**
+ * @brief 依次推入 0..count-1，再取出全部排队帧
+ */
+std::vector<int> pushAndDrain(runtime::FrameMailbox<int>* mailbox, int count, int* accepted) {
+  *accepted = 0;
+  for (int i = 0; i < count; ++i) {
+    *accepted += mailbox->push(i) ? 1 : 0;
+  }
+  std::vector<int> frames;
+  int frame = 0;
+  while (mailbox->pop(frame, 0)) {
+    frames.push_back(frame);
+  }
+  return frames;
+}
+
+void testFrameMailbox() {
+  LOG_INFO("\n[Test 4] FrameMailbox latest vs FIFO drop accounting...");
+
+  runtime::FrameQueueOptions latest_options;
+  latest_options.mode = runtime::FrameQueueMode::kLatest;
+  latest_options.depth = 3;
+  runtime::FrameQueueOptions fifo_options = latest_options;
+  fifo_options.mode = runtime::FrameQueueMode::kFifo;
+
+  {
+    // 同样 10 帧、深度 3：mailbox 保留最新 3 帧，FIFO 保留最早 3 帧，丢帧原因不同
+    runtime::FrameMailbox<int> latest(latest_options);
+    int accepted = 0;
+    std::vector<int> frames = pushAndDrain(&latest, 10, &accepted);
+    runtime::FrameQueueStats stats = latest.stats();
+    printTestResult("Mailbox keeps the newest frames",
+                    accepted == 10 && frames == std::vector<int>({7, 8, 9}));
+    printTestResult("Mailbox counts superseded frames",
+                    stats.dropped[runtime::kDropSuperseded] == 7 && stats.totalDropped() == 7 &&
+                        stats.pushed == 10 && stats.popped == 3 && stats.max_size == 3);
+
+    runtime::FrameMailbox<int> fifo(fifo_options);
+    frames = pushAndDrain(&fifo, 10, &accepted);
+    stats = fifo.stats();
+    printTestResult("FIFO keeps the oldest frames",
+                    accepted == 3 && frames == std::vector<int>({0, 1, 2}));
+    printTestResult("FIFO counts queue_full drops",
+                    stats.dropped[runtime::kDropQueueFull] == 7 && stats.totalDropped() == 7 &&
+                        stats.dropRatio() == 0.7);
+  }
+
+  {
+    // 排队超过 max_age_ms 的帧出队时跳过
+    runtime::FrameQueueOptions options = fifo_options;
+    options.max_age_ms = 20;
+    runtime::FrameMailbox<int> mailbox(options);
+    mailbox.push(0);
+    mailbox.push(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    mailbox.push(2);
+    int frame = -1;
+    const bool popped = mailbox.pop(frame, 0);
+    printTestResult("Stale frames skipped", popped && frame == 2 &&
+                                                mailbox.stats().dropped[runtime::kDropStale] == 2);
+  }
+
+  {
+    // 阻塞的 pop 被 push 唤醒；关闭后排队帧与新帧计为 closed
+    runtime::FrameMailbox<int> mailbox(fifo_options);
+    std::thread producer([&mailbox] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      mailbox.push(5);
+    });
+    int frame = -1;
+    const bool woke = mailbox.pop(frame, 2000);
+    producer.join();
+    printTestResult("Blocked pop woken by push", woke && frame == 5);
+
+    mailbox.push(6);
+    mailbox.push(7);
+    mailbox.close();
+    const bool rejected = !mailbox.push(8);
+    printTestResult("Close drops queued and late frames",
+                    rejected && !mailbox.pop(frame, 0) &&
+                        mailbox.stats().dropped[runtime::kDropClosed] == 3);
+  }
+
+  {
+    // 摄像头配置：任一键非法时整体不生效
+    runtime::FrameQueueOptions options;
+    bool parsed = runtime::FrameMailbox<int>::parseConfig({{"queue_mode", "fifo"}}, &options);
+    printTestResult("Parse fifo config", parsed && options.mode == runtime::FrameQueueMode::kFifo &&
+                                             options.depth == 8);
+    runtime::FrameQueueOptions unchanged = options;
+    parsed = runtime::FrameMailbox<int>::parseConfig(
+        {{"queue_mode", "latest"}, {"queue_depth", "abc"}}, &options);
+    printTestResult("Invalid config leaves options unchanged",
+                    !parsed && options.mode == unchanged.mode && options.depth == unchanged.depth);
+    parsed = runtime::FrameMailbox<int>::parseConfig({{"queue_depth", "0"}}, &options);
+    printTestResult("Zero depth rejected", !parsed && options.depth == unchanged.depth);
+  }
+}
+
+// ============================================================================
+// WorkflowGraph / WorkflowEngine
+// ============================================================================
+
+const char* const kDiamondWorkflow = R"({
+  "name": "det_ocr",
+  "nodes": [
+    {"id": "rule", "type": "rule", "inputs": ["det", "ocr"]},
+    {"id": "det", "type": "inference", "plugin": "yolov8", "inputs": ["decode"],
+     "params": {"conf_threshold": 0.25}},
+    {"id": "ocr", "type": "inference", "plugin": "paddleocr", "inputs": ["decode"]},
+    {"id": "decode", "type": "decode"}
+  ]
+})";
+
+/**
+ * @brief 解析失败且错误信息包含 reason
+ */
+bool rejectsWorkflow(const std::string& json, const std::string& reason) {
+  runtime::WorkflowSpec spec;
+  std::string error;
+  const AlgoStatus status = runtime::parseWorkflow("wf", json, {}, &spec, &error);
+  return status == ALGO_STATUS_ERROR_INVALID_PARAM && error.find(reason) != std::string::npos;
+}
+
+void testWorkflow() {
+  LOG_INFO("\n[Test 5] Workflow DAG validation and parallel branches...");
+
+  runtime::WorkflowSpec spec;
+  std::string error;
+  AlgoStatus status = runtime::parseWorkflow(
+      "wf", kDiamondWorkflow, {{"det.conf_threshold", "0.5"}, {"priority", "high"}}, &spec, &error);
+  bool topological = status == ALGO_STATUS_SUCCESS && spec.nodes.size() == 4;
+  for (size_t i = 0; topological && i < spec.nodes.size(); ++i) {
+    for (int input : spec.nodes[i].inputs) {
+      topological = input >= 0 && input < static_cast<int>(i);
+    }
+  }
+  printTestResult("Parse workflow into topological order",
+                  topological && spec.nodes[0].id == "decode" && spec.nodes[3].id == "rule");
+  const int det = spec.find("det");
+  printTestResult("Node override and workflow params",
+                  det >= 0 && spec.nodes[det].params.value("conf_threshold", 0.0) == 0.5 &&
+                      spec.params.count("priority") == 1 && spec.params.size() == 1);
+
+  printTestResult("Cycle rejected", rejectsWorkflow(R"({"nodes": [
+      {"id": "decode", "type": "decode"},
+      {"id": "a", "type": "tracker", "inputs": ["decode", "b"]},
+      {"id": "b", "type": "rule", "inputs": ["a"]}]})", "cycle"));
+  printTestResult("Self loop rejected", rejectsWorkflow(R"({"nodes": [
+      {"id": "a", "type": "rule", "inputs": ["a"]}]})", "cycle"));
+  printTestResult("Unknown input rejected", rejectsWorkflow(R"({"nodes": [
+      {"id": "a", "type": "rule", "inputs": ["missing"]}]})", "unknown input"));
+  printTestResult("Duplicate id rejected", rejectsWorkflow(R"({"nodes": [
+      {"id": "a", "type": "decode"}, {"id": "a", "type": "rule"}]})", "duplicate"));
+  if (status != ALGO_STATUS_SUCCESS) {
+    return;
+  }
+
+  // det 与 ocr 互相等待对方开始：只有两个分支同时执行时才能都成功
+  std::atomic<int> arrived{0};
+  std::atomic<bool> det_throws{false};
+  std::atomic<int> decode_running{0};
+  std::atomic<int> overlapped_runs{0};
+  auto branch = [&arrived](runtime::NodeIO& io, int factor) {
+    arrived.fetch_add(1);
+    const bool met = waitUntil([&arrived] { return arrived.load() % 2 == 0; });
+    io.emplaceOutput<int>(*io.input<int>() * factor);
+    return met ? ALGO_STATUS_SUCCESS : ALGO_STATUS_ERROR_INFERENCE;
+  };
+  std::map<std::string, runtime::FunctionNode::Fn> functions;
+  functions["decode"] = [&](runtime::NodeIO& io) {
+    overlapped_runs += decode_running.fetch_add(1) > 0 ? 1 : 0;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    io.emplaceOutput<int>(*io.frame().source<int>());
+    decode_running.fetch_sub(1);
+    return ALGO_STATUS_SUCCESS;
+  };
+  functions["det"] = [&](runtime::NodeIO& io) {
+    if (det_throws) {
+      arrived.fetch_add(1);
+      throw 1;    // 非 std::exception 也不能离开节点
+    }
+    return branch(io, 2);
+  };
+  functions["ocr"] = [&](runtime::NodeIO& io) { return branch(io, 3); };
+  functions["rule"] = [](runtime::NodeIO& io) {
+    io.emplaceOutput<int>(*io.input<int>(0) + *io.input<int>(1));
+    return ALGO_STATUS_SUCCESS;
+  };
+  runtime::WorkflowNodeRegistry registry;
+  auto factory = [&functions](const runtime::WorkflowNodeSpec& node, std::string*) {
+    return std::unique_ptr<runtime::WorkflowNode>(new runtime::FunctionNode(functions[node.id]));
+  };
+  registry.add(runtime::WorkflowNodeType::kDecode, factory);
+  registry.add(runtime::WorkflowNodeType::kInference, factory);
+  registry.add(runtime::WorkflowNodeType::kRule, factory);
+
+  TaskExecutorOptions options;
+  options.num_workers = 2;
+  TaskExecutor executor(options);
+  runtime::WorkflowEngine engine(executor);
+  printTestResult("Build engine", engine.build(spec, registry, &error) == ALGO_STATUS_SUCCESS);
+
+  runtime::WorkflowFrame frame(1);
+  frame.setSource(7);
+  status = engine.run(frame);
+  const int* result = frame.output<int>(spec.find("rule"));
+  printTestResult("Parallel branches run concurrently",
+                  status == ALGO_STATUS_SUCCESS && result && *result == 7 * 2 + 7 * 3);
+
+  det_throws = true;
+  runtime::WorkflowFrame failed(2);
+  failed.setSource(7);
+  status = engine.run(failed);
+  det_throws = false;
+  const std::vector<runtime::WorkflowNodeStats> stats = engine.stats();
+  const int rule = spec.find("rule");
+  printTestResult("Failed branch skips downstream only",
+                  status == ALGO_STATUS_ERROR_UNKNOWN && failed.output<int>(rule) == nullptr &&
+                      failed.output<int>(spec.find("ocr")) != nullptr &&
+                      stats[det].failed == 1 && stats[rule].skipped == 1);
+
+  // 同一引擎的 run 串行：多个线程同时调用时节点不会重入
+  arrived = 0;
+  std::vector<std::thread> callers;
+  std::atomic<int> succeeded{0};
+  for (int t = 0; t < 3; ++t) {
+    callers.emplace_back([&, t] {
+      for (int k = 0; k < 5; ++k) {
+        runtime::WorkflowFrame concurrent(100 + t * 5 + k);
+        concurrent.setSource(k);
+        succeeded += engine.run(concurrent) == ALGO_STATUS_SUCCESS ? 1 : 0;
+      }
+    });
+  }
+  for (std::thread& caller : callers) {
+    caller.join();
+  }
+  printTestResult("Concurrent runs on one engine are serialized",
+                  succeeded == 15 && overlapped_runs == 0);
+}
+
+// ============================================================================
+// FramePool / VideoFrame
+// ============================================================================
+
+/**
+ * @brief 把单平面帧（BGR）的可见像素全部写成 value（原地，调用者保证不共享）
+ */
+void fillFrame(runtime::VideoFrame* frame, uint8_t value) {
+  uint8_t* data = frame->mutablePlane(0);
+  for (int y = 0; y < frame->height(); ++y) {
+    std::memset(data + y * frame->stride(0), value, static_cast<size_t>(frame->width()) * 3);
+  }
+}
+
+/**
+ * @brief 单平面帧（BGR）可见像素之和
+ */
+uint64_t sumFrame(const runtime::VideoFrame& frame) {
+  uint64_t sum = 0;
+  for (int y = 0; y < frame.height(); ++y) {
+    const uint8_t* row = frame.plane(0) + y * frame.stride(0);
+    for (int x = 0; x < frame.width() * 3; ++x) {
+      sum += row[x];
+    }
+  }
+  return sum;
+}
+
+void testFrameBuffer() {
+  LOG_INFO("\n[Test 6] FramePool reuse and copy-on-write...");
+  runtime::FramePool pool;
+
+  {
+    runtime::VideoFrame first = runtime::VideoFrame::allocate(pool, 64, 32, ALGO_PIXEL_FORMAT_BGR);
+    const bool aligned = !first.empty() && first.stride(0) % 64 == 0 &&
+                         reinterpret_cast<uintptr_t>(first.plane(0)) % 64 == 0;
+    printTestResult("Allocate aligned frame", aligned);
+  }
+  runtime::VideoFrame frame = runtime::VideoFrame::allocate(pool, 64, 32, ALGO_PIXEL_FORMAT_BGR);
+  runtime::FramePoolStats stats = pool.stats();
+  printTestResult("Released buffer reused", stats.acquires == 2 && stats.hits == 1 &&
+                                                stats.misses == 1);
+
+  // 唯一持有者：原地写
+  const uint8_t* original = frame.plane(0);
+  fillFrame(&frame, 10);
+  printTestResult("Sole owner writes in place",
+                  frame.plane(0) == original && pool.stats().cow_copies == 0);
+
+  // 共享：写入方拷贝，其他持有者看到的内容不变
+  runtime::VideoFrame copy = frame;
+  printTestResult("Copy shares the buffer", copy.shared() && frame.shared() &&
+                                                copy.plane(0) == original);
+  copy.mutablePlane(0)[0] = 99;
+  printTestResult("Shared write copies",
+                  pool.stats().cow_copies == 1 && copy.plane(0) != original &&
+                      frame.plane(0)[0] == 10 && copy.plane(0)[0] == 99 && !frame.shared() &&
+                      !copy.shared());
+  copy.mutablePlane(0)[1] = 98;
+  printTestResult("Second write on private copy does not copy", pool.stats().cow_copies == 1);
+
+  // ROI 视图：只拷贝 ROI
+  runtime::VideoFrame roi = frame.roi(8, 4, 16, 8);
+  printTestResult("ROI is a zero-copy view",
+                  roi.shared() && roi.width() == 16 && roi.height() == 8 &&
+                      roi.plane(0) == original + 4 * frame.stride(0) + 8 * 3);
+  roi.mutablePlane(0)[0] = 55;
+  printTestResult("ROI write copies only the ROI",
+                  pool.stats().cow_copies == 2 && frame.plane(0)[4 * frame.stride(0) + 24] == 10 &&
+                      roi.plane(0)[0] == 55 && sumFrame(roi) == 55 + 10 * (16 * 8 * 3 - 1));
+
+  runtime::VideoFrame empty;
+  printTestResult("Empty frame or bad plane has no mutable plane",
+                  empty.mutablePlane(0) == nullptr && frame.mutablePlane(1) == nullptr &&
+                      frame.mutablePlane(-1) == nullptr);
+
+  // 其他线程读完后释放副本：写入方看到引用计数为 1 后原地写，读取方读到的是写入前的内容。
+  // soleOwner 靠 acquire 栅栏同步，ThreadSanitizer 不模拟独立栅栏（GCC -Wtsan），该项在 TSan 下跳过
+#if !defined(__SANITIZE_THREAD__)
+  const uint64_t expected = 10ULL * 64 * 32 * 3;
+  const uint64_t copies_before = pool.stats().cow_copies;
+  int torn = 0;
+  for (int i = 0; i < 200; ++i) {
+    runtime::VideoFrame shared = frame;
+    uint64_t seen = 0;
+    std::thread reader([&seen, view = std::move(shared)]() mutable {
+      seen = sumFrame(view);
+      view = runtime::VideoFrame();
+    });
+    while (frame.shared()) {
+      std::this_thread::yield();
+    }
+    fillFrame(&frame, 20);
+    reader.join();
+    torn += seen == expected ? 0 : 1;
+    fillFrame(&frame, 10);
+  }
+  printTestResult("Released readers never see in-place writes",
+                  torn == 0 && pool.stats().cow_copies == copies_before);
+#endif
+
+  copy = runtime::VideoFrame();
+  roi = runtime::VideoFrame();
+  frame = runtime::VideoFrame();
+  stats = pool.stats();
+  printTestResult("All buffers returned to the pool",
+                  stats.bytes_in_flight == 0 && stats.bytes_cached > 0);
+}
+
+// ============================================================================
+// CameraTensorCache
+// ============================================================================
+
+void testTensorCache() {
+  LOG_INFO("\n[Test 7] Tensor cache sharing and hit/miss accounting...");
+  runtime::FramePool pool;
+  runtime::VideoFrame frame = runtime::VideoFrame::allocate(pool, 64, 48, ALGO_PIXEL_FORMAT_BGR);
+  fillFrame(&frame, 80);
+  runtime::TensorCacheKey key;
+  key.width = 32;
+  key.height = 32;
+
+  {
+    runtime::CameraTensorCache cache;
+    auto first = cache.attach(1, frame);
+    auto again = cache.attach(1, frame);
+    auto other = cache.attach(2, frame);
+    printTestResult("Same frame id shares one cache", first == again && first != other &&
+                                                          cache.stats().frames == 2);
+
+    bool hit = true;
+    auto computed = first->tensor(key, &hit);
+    const bool first_missed = computed && !hit;
+    auto reused = again->tensor(key, &hit);
+    runtime::TensorCacheStats stats = cache.stats();
+    printTestResult("First lookup computes, second reuses",
+                    first_missed && hit && reused == computed && stats.lookups == 2 &&
+                        stats.hits == 1 && stats.computes == 1);
+
+    runtime::TensorCacheKey stretch = key;
+    stretch.keep_aspect = false;
+    auto stretched = first->tensor(stretch, &hit);
+    stats = cache.stats();
+    printTestResult("Stretch and letterbox keyed separately",
+                    stretched && !hit && stretched != computed && stats.computes == 2 &&
+                        stats.hits == 1 && stats.hitRate() == 1.0 / 3);
+
+    auto on_other = other->tensor(key, &hit);
+    printTestResult("Caches of different frames do not share results",
+                    on_other && !hit && on_other != computed && cache.stats().computes == 3);
+
+    first.reset();
+    again.reset();
+    printTestResult("Released frame cache no longer live", cache.stats().live_frames == 1);
+    printTestResult("Attach after release creates a new cache",
+                    cache.attach(1, frame)->tensor(key, &hit) != nullptr && !hit &&
+                        cache.stats().frames == 3);
+  }
+
+  {
+    // 同一键的并发调用只计算一次，其余等待并复用
+    runtime::CameraTensorCache cache;
+    auto frame_cache = cache.attach(1, frame);
+    std::vector<std::shared_ptr<const runtime::PreprocessedTensor>> results(4);
+    std::vector<std::thread> consumers;
+    for (size_t i = 0; i < results.size(); ++i) {
+      consumers.emplace_back([&, i] { results[i] = frame_cache->tensor(key); });
+    }
+    for (std::thread& consumer : consumers) {
+      consumer.join();
+    }
+    const runtime::TensorCacheStats stats = cache.stats();
+    bool same = results[0] != nullptr;
+    for (const auto& result : results) {
+      same = same && result == results[0];
+    }
+    printTestResult("Concurrent consumers compute once",
+                    same && stats.computes == 1 && stats.hits == 3 && stats.lookups == 4);
+  }
+
+  {
+    // 空帧没有结果，重复查找不算命中
+    runtime::CameraTensorCache cache;
+    auto frame_cache = cache.attach(1, runtime::VideoFrame());
+    bool hit = true;
+    const bool none = frame_cache->tensor(key, &hit) == nullptr && !hit &&
+                      frame_cache->tensor(key, &hit) == nullptr && !hit;
+    printTestResult("Empty frame lookups are never hits", none && cache.stats().hits == 0);
+  }
+
+  {
+    // 金字塔从源帧所在的池分配，FramePool 对象先析构也可用
+    runtime::CameraTensorCache cache;
+    std::shared_ptr<runtime::FrameTensorCache> frame_cache;
+    {
+      runtime::FramePool scoped_pool;
+      runtime::VideoFrame source =
+          runtime::VideoFrame::allocate(scoped_pool, 64, 48, ALGO_PIXEL_FORMAT_BGR);
+      fillFrame(&source, 40);
+      frame_cache = cache.attach(1, source);
+    }
+    runtime::VideoFrame level2 = frame_cache->pyramid(2);
+    runtime::VideoFrame level1 = frame_cache->pyramid(1);
+    printTestResult("Pyramid halves each level",
+                    level1.width() == 32 && level1.height() == 24 && level2.width() == 16 &&
+                        level2.height() == 12 && sumFrame(level2) == 40ULL * 16 * 12 * 3);
+    printTestResult("Pyramid levels built once", cache.stats().pyramid_levels == 2);
+    printTestResult("Out-of-range pyramid level is empty",
+                    frame_cache->pyramid(runtime::FrameTensorCache::kMaxPyramidLevels).empty());
+  }
+}
+
+// ============================================================================
+// WorkflowQos：加权公平排队与 SLO
+// ============================================================================
+
+/**
+ * @brief served 的前 n 项中属于 workflow 的帧数（帧号为 workflow * 1000 + 序号）
+ */
+int countServed(const std::vector<int>& served, size_t n, int workflow) {
+  int count = 0;
+  for (size_t i = 0; i < std::min(n, served.size()); ++i) {
+    count += served[i] / 1000 == workflow ? 1 : 0;
+  }
+  return count;
+}
+
+void testWorkflowQos() {
+  LOG_INFO("\n[Test 8] Weighted fair shares, share refund and SLO accounting...");
+  runtime::WorkflowQos high;
+  high.priority = TaskPriority::kHigh;
+  runtime::WorkflowQos low;
+  low.priority = TaskPriority::kLow;
+
+  {
+    // 持续积压：normal 权重 3 / normal 权重 1 / low 权重 1 按 4x3 : 4x1 : 1x1 分享 batch 位置
+    runtime::BatchSchedulerOptions options;
+    options.max_batch_size = 4;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    runtime::WorkflowQos heavy;
+    heavy.weight = 3;
+    scheduler.setWorkflowQos(1, heavy);
+    scheduler.setWorkflowQos(3, low);
+    scheduler.start();
+    const bool blocked = log.block(&scheduler, 9);
+    for (int k = 0; blocked && k < 40; ++k) {
+      for (int workflow = 1; workflow <= 3; ++workflow) {
+        const int frame = workflow * 1000 + k;
+        scheduler.submit(workflow, frame, 0, log.completion(frame));
+      }
+    }
+    log.gate.open();
+    const bool done = blocked && waitUntil([&] { return log.numCompleted() == 121; });
+    // 前 48 帧时三个工作流都还有积压
+    const size_t window = 48;
+    const double shares[3] = {12.0 / 17, 4.0 / 17, 1.0 / 17};
+    bool converged = done;
+    for (int workflow = 1; workflow <= 3; ++workflow) {
+      const int served = countServed(log.served, window, workflow);
+      LOG_INFO("workflow {}: {} of {} frames (target {:.1f})", workflow, served, window,
+               shares[workflow - 1] * window);
+      converged = converged && std::fabs(served - shares[workflow - 1] * window) <= 2.0;
+    }
+    printTestResult("Backlogged workflows converge to weighted shares", converged);
+    printTestResult("Low priority not starved", countServed(log.served, window, 3) >= 2);
+    scheduler.stop();
+  }
+
+  {
+    // 被挤出的帧退还份额：该工作流之后的帧不因未推理的帧排后
+    runtime::BatchSchedulerOptions options;
+    options.max_batch_size = 1;
+    options.max_pending = 4;
+    options.priority_weights[static_cast<int>(TaskPriority::kNormal)] = 2;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    runtime::WorkflowQos fast;
+    fast.weight = 4;
+    scheduler.setWorkflowQos(1, fast);
+    scheduler.setWorkflowQos(3, low);
+    scheduler.start();
+    bool ok = log.block(&scheduler, 9);
+    // 结束标签：low 1.0，normal 每帧 1 / (2 x 4)，第 4 帧 normal 挤出 low
+    ok = ok && scheduler.submit(3, 3000, 0, log.completion(3000));
+    for (int k = 1; ok && k <= 4; ++k) {
+      ok = scheduler.submit(1, 1000 + k, 0, log.completion(1000 + k));
+    }
+    ok = ok && log.completedWith(3000, ALGO_STATUS_ERROR_DROPPED);
+    log.gate.open();
+    ok = ok && waitUntil([&] { return log.numCompleted() == 6; });
+    printTestResult("Low frame evicted by normal frames", ok);
+
+    // normal 改为每帧 0.5：low 新帧结束标签 1.5（未退还时为 2.0），排在第二个 normal 帧之前
+    log.gate.reset();
+    runtime::WorkflowQos slow;
+    scheduler.setWorkflowQos(1, slow);
+    ok = ok && log.block(&scheduler, 9);
+    ok = ok && scheduler.submit(3, 3001, 0, log.completion(3001));
+    for (int k = 5; ok && k <= 7; ++k) {
+      ok = scheduler.submit(1, 1000 + k, 0, log.completion(1000 + k));
+    }
+    log.gate.open();
+    ok = ok && waitUntil([&] { return log.numCompleted() == 10; });
+    const std::vector<int> second(log.served.begin() + std::min<size_t>(4, log.served.size()),
+                                  log.served.end());
+    printTestResult("Evicted frame's share refunded",
+                    ok && second == std::vector<int>({1005, 3001, 1006, 1007}));
+    scheduler.stop();
+  }
+
+  {
+    // 被挤出与被拒绝的帧都计为未达成 SLO
+    runtime::BatchSchedulerOptions options;
+    options.max_batch_size = 1;
+    options.max_pending = 1;
+    BatchLog log;
+    FrameScheduler scheduler(log.batchFn(), options);
+    scheduler.setWorkflowQos(2, high);
+    scheduler.setWorkflowQos(3, low);
+    scheduler.start();
+    bool ok = log.block(&scheduler, 9);
+    ok = ok && scheduler.submit(1, 1000, 0, log.completion(1000));
+    ok = ok && !scheduler.submit(3, 3000, 0, log.completion(3000));
+    ok = ok && scheduler.submit(2, 2000, 0, log.completion(2000));
+    log.gate.open();
+    ok = ok && waitUntil([&] { return log.numCompleted() == 3; });
+    const runtime::SloReport slo = scheduler.stats().slo;
+    const runtime::SloClassStats& normal_slo = slo.of(TaskPriority::kNormal);
+    printTestResult("Rejected frame counted as SLO miss",
+                    ok && slo.of(TaskPriority::kLow).frames == 1 &&
+                        slo.of(TaskPriority::kLow).dropped == 1 &&
+                        slo.of(TaskPriority::kLow).attainment() == 0.0);
+    printTestResult("Evicted frame counted as SLO miss",
+                    ok && normal_slo.dropped == 1 && normal_slo.frames == 2 &&
+                        normal_slo.met == 1);
+    printTestResult("Served high frame meets its SLO",
+                    ok && slo.of(TaskPriority::kHigh).met == 1 &&
+                        slo.of(TaskPriority::kHigh).dropped == 0);
+    scheduler.stop();
+  }
+
+  {
+    // TaskExecutor：high 严格优先，normal / low 按 4 : 1 分享 worker
+    TaskExecutorOptions options;
+    options.num_workers = 1;
+    TaskExecutor executor(options);
+    Gate gate;
+    std::mutex order_mutex;
+    std::vector<TaskPriority> order;
+    TaskGroup group;
+    executor.submit(group, [&gate] { gate.enter(); });
+    const bool blocked = gate.waitEntered();
+    for (int k = 0; k < 100; ++k) {
+      for (TaskPriority priority : {TaskPriority::kNormal, TaskPriority::kLow}) {
+        executor.submit(group, [&, priority] {
+          std::lock_guard<std::mutex> lock(order_mutex);
+          order.push_back(priority);
+        }, {priority, 0});
+      }
+    }
+    for (int k = 0; k < 10; ++k) {
+      executor.submit(group, [&] {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back(TaskPriority::kHigh);
+      }, {TaskPriority::kHigh, 0});
+    }
+    gate.open();
+    // 不调用 wait：等待线程会帮忙执行，打乱单 worker 的执行顺序
+    const bool done = blocked && waitUntil([&group] { return group.pending() == 0; });
+    std::lock_guard<std::mutex> lock(order_mutex);
+    bool high_first = done && order.size() == 210;
+    for (size_t i = 0; high_first && i < 10; ++i) {
+      high_first = order[i] == TaskPriority::kHigh;
+    }
+    int normal = 0;
+    for (size_t i = 10; done && i < 60 && i < order.size(); ++i) {
+      normal += order[i] == TaskPriority::kNormal ? 1 : 0;
+    }
+    printTestResult("Executor runs high tasks first", high_first);
+    printTestResult("Executor shares normal / low by weight",
+                    done && std::abs(normal - 40) <= 2);
+  }
+
+  {
+    // 工作流级参数：任一项非法时保持原值
+    runtime::WorkflowQos qos;
+    bool parsed = runtime::parseWorkflowQos(
+        {{"priority", "low"}, {"weight", "5"}, {"latency_slo_ms", "300"}}, &qos);
+    printTestResult("Parse workflow qos", parsed && qos.priority == TaskPriority::kLow &&
+                                              qos.weight == 5 && qos.sloMs() == 300);
+    const runtime::WorkflowQos unchanged = qos;
+    const bool rejected =
+        !runtime::parseWorkflowQos({{"priority", "high"}, {"weight", "0"}}, &qos) &&
+        !runtime::parseWorkflowQos({{"priority", "urgent"}}, &qos) &&
+        !runtime::parseWorkflowQos({{"latency_slo_ms", "abc"}}, &qos);
+    printTestResult("Invalid qos leaves params unchanged",
+                    rejected && qos.priority == unchanged.priority &&
+                        qos.weight == unchanged.weight &&
+                        qos.latency_slo_ms == unchanged.latency_slo_ms);
+    runtime::WorkflowQos defaults;
+    defaults.priority = TaskPriority::kHigh;
+    printTestResult("Default SLO by priority", defaults.sloMs() == 100);
+  }
+}
+
+int main() {
+  LOG_INFO("======================================");
+  LOG_INFO("  Runtime Scheduling Test");
+  LOG_INFO("======================================");
+
+  testBatchScheduler();
+  testStagePipeline();
+  testTaskExecutor();
+  testFrameMailbox();
+  testWorkflow();
+  testFrameBuffer();
+  testTensorCache();
+  testWorkflowQos();
+
+  LOG_INFO("\n======================================");
+  if (g_failed_tests > 0) {
+    LOG_ERROR("  {} test(s) failed", g_failed_tests);
+  } else {
+    LOG_INFO("  All tests completed!");
+  }
+  LOG_INFO("======================================");
+
+  return g_failed_tests > 0 ? 1 : 0;
+}
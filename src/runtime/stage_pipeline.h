@@ -0,0 +1,265 @@
+#pragma once
+
+/**
+ * @file stage_pipeline.h
+ * @brief 单路摄像头的分阶段流水线：解码 / 预处理 / 推理 / 后处理各自在独立线程上运行
+ *
+ * 阶段之间用有界队列（ring_queue.h）连接，第 N 帧推理时第 N+1 帧已在预处理、
+ * 第 N+2 帧已在解码，吞吐由最慢的阶段决定而不是各阶段耗时之和；
+ * 最慢的阶段可以配多个 worker（此时队列自动改用 MPMC，输出顺序不再保证）。
+ *
+ * @code
+ * runtime::StagePipeline<FrameJob> pipeline;
+ * pipeline.addStage({"decode"}, [&](FrameJob& job) { return decoder.next(job.frame); });
+ * pipeline.addStage({"preprocess"}, [&](FrameJob& job) { return pre(job); });
+ * pipeline.addStage({"infer", 1, 2, runtime::QueueFullPolicy::kDropOldest},
+ *                   [&](FrameJob& job) { return infer(job); });
+ * pipeline.addStage({"postprocess"}, [&](FrameJob& job) { return publish(job); });
+ * pipeline.start();
+ * pipeline.submit(FrameJob{frame_id});   // 阶段函数返回 false 表示丢弃该帧（如运动门控）
+ * pipeline.stop();                       // 排空后返回
+ * @endcode
+ *
+ * 统计（stats()）：每个阶段输入队列的占用率 / 丢弃数，以及
+ * "service"（阶段函数耗时）、"queue_wait"（在输入队列中等待）、
+ * "idle"（worker 等待输入）、"output_blocked"（下游队列满时阻塞）四项 log2 微秒直方图。
+ */
+
+#include "algo_utils/stage_timer.h"
+#include "runtime/ring_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+struct StageOptions {
+  std::string name;
+  int workers = 1;
+  size_t queue_capacity = 4;                        // 该阶段输入队列容量
+  QueueFullPolicy policy = QueueFullPolicy::kBlock;  // 输入队列满时的处理
+};
+
+/**
+ * @brief 单个阶段的统计快照
+ */
+struct StageRuntimeStats {
+  std::string name;
+  int workers = 0;
+  uint64_t filtered = 0;            // 阶段函数返回 false 丢弃的帧
+  StageQueueStats queue;            // 输入队列
+  algo_utils::PerfStats timing;     // service / queue_wait / idle / output_blocked
+};
+
+struct StagePipelineStats {
+  uint64_t submitted = 0;
+  uint64_t rejected = 0;            // 已停止或输入队列按 kDropNewest 丢弃
+  uint64_t completed = 0;           // 走完最后一个阶段的帧
+  std::vector<StageRuntimeStats> stages;
+};
+
+template <typename T>
+class StagePipeline {
+ public:
+  /**
+   * @brief 阶段函数：就地处理 item，返回 false 时该帧不再向下游传递
+   */
+  using StageFn = std::function<bool(T& item)>;
+
+  enum Timing { kService = 0, kQueueWait, kIdle, kOutputBlocked };
+
+  /**
+   * @param single_submitter 只有一个线程调用 submit 时为 true（第一个队列可用 SPSC）
+   */
+  explicit StagePipeline(bool single_submitter = true) : single_submitter_(single_submitter) {}
+  ~StagePipeline() { stop(); }
+
+  StagePipeline(const StagePipeline&) = delete;
+  StagePipeline& operator=(const StagePipeline&) = delete;
+
+  /**
+   * @brief 追加一个阶段（只能在 start 之前调用）
+   */
+  void addStage(const StageOptions& options, StageFn fn);
+
+  /**
+   * @brief 创建各阶段队列并启动 worker
+   */
+  void start();
+
+  /**
+   * @brief 按阶段顺序关闭队列并等待 worker 退出；关闭前已提交的帧全部处理完
+   */
+  void stop();
+
+  /**
+   * @brief 提交一帧到第一个阶段（第一个阶段的满策略决定是否阻塞）
+   * @return 已停止或被 kDropNewest 丢弃时返回 false
+   */
+  bool submit(T item);
+
+  size_t numStages() const { return stages_.size(); }
+  StagePipelineStats stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Slot {
+    T item;
+    Clock::time_point enqueue;
+  };
+
+  struct Stage {
+    StageOptions options;
+    StageFn fn;
+    std::unique_ptr<StageQueue<Slot>> input;
+    std::vector<std::thread> workers;
+    algo_utils::StageRecorder recorder{"service", "queue_wait", "idle", "output_blocked"};
+    std::atomic<uint64_t> filtered{0};
+  };
+
+  bool single_submitter_;
+  bool running_ = false;
+  std::vector<std::unique_ptr<Stage>> stages_;
+  std::atomic<uint64_t> submitted_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::atomic<uint64_t> completed_{0};
+
+  void work(size_t index);
+
+  static uint64_t elapsedNs(Clock::time_point begin, Clock::time_point end) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+  }
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+template <typename T>
+void StagePipeline<T>::addStage(const StageOptions& options, StageFn fn) {
+  if (running_) {
+    return;
+  }
+  std::unique_ptr<Stage> stage(new Stage());
+  stage->options = options;
+  stage->options.workers = std::max(options.workers, 1);
+  stage->fn = std::move(fn);
+  stages_.push_back(std::move(stage));
+}
+
+template <typename T>
+void StagePipeline<T>::start() {
+  if (running_ || stages_.empty()) {
+    return;
+  }
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    Stage& stage = *stages_[i];
+    StageQueueOptions queue;
+    queue.capacity = stage.options.queue_capacity;
+    queue.policy = stage.options.policy;
+    queue.single_producer = i == 0 ? single_submitter_ : stages_[i - 1]->options.workers == 1;
+    queue.single_consumer = stage.options.workers == 1;
+    stage.input.reset(new StageQueue<Slot>(queue));
+  }
+  running_ = true;
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    for (int w = 0; w < stages_[i]->options.workers; ++w) {
+      stages_[i]->workers.emplace_back(&StagePipeline::work, this, i);
+    }
+  }
+}
+
+template <typename T>
+void StagePipeline<T>::stop() {
+  if (!running_) {
+    return;
+  }
+  // 上游 worker 全部退出后才关闭下游队列，保证在途帧不丢
+  for (auto& stage : stages_) {
+    stage->input->close();
+    for (std::thread& worker : stage->workers) {
+      worker.join();
+    }
+    stage->workers.clear();
+  }
+  running_ = false;
+}
+
+template <typename T>
+bool StagePipeline<T>::submit(T item) {
+  if (!running_) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  submitted_.fetch_add(1, std::memory_order_relaxed);
+  if (!stages_.front()->input->push(Slot{std::move(item), Clock::now()})) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+template <typename T>
+void StagePipeline<T>::work(size_t index) {
+  Stage& stage = *stages_[index];
+  StageQueue<Slot>* next = index + 1 < stages_.size() ? stages_[index + 1]->input.get() : nullptr;
+  Slot slot;
+  uint64_t idle_ns = 0;
+  while (stage.input->pop(slot, &idle_ns)) {
+    const Clock::time_point begin = Clock::now();
+    stage.recorder.record(kIdle, idle_ns);
+    stage.recorder.record(kQueueWait, elapsedNs(slot.enqueue, begin));
+    const bool keep = stage.fn(slot.item);
+    const Clock::time_point end = Clock::now();
+    stage.recorder.record(kService, elapsedNs(begin, end));
+    stage.recorder.addFrame();
+
+    if (!keep) {
+      stage.filtered.fetch_add(1, std::memory_order_relaxed);
+    } else if (!next) {
+      completed_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      // 下游 kDropNewest 丢弃的帧计入下游队列的 dropped_newest
+      uint64_t blocked_ns = 0;
+      slot.enqueue = end;
+      next->push(std::move(slot), &blocked_ns);
+      if (next->policy() == QueueFullPolicy::kBlock) {
+        stage.recorder.record(kOutputBlocked, blocked_ns);
+      }
+    }
+    slot = Slot();
+  }
+}
+
+template <typename T>
+StagePipelineStats StagePipeline<T>::stats() const {
+  StagePipelineStats stats;
+  stats.submitted = submitted_.load(std::memory_order_relaxed);
+  stats.rejected = rejected_.load(std::memory_order_relaxed);
+  stats.completed = completed_.load(std::memory_order_relaxed);
+  for (const auto& stage : stages_) {
+    StageRuntimeStats s;
+    s.name = stage->options.name;
+    s.workers = stage->options.workers;
+    s.filtered = stage->filtered.load(std::memory_order_relaxed);
+    if (stage->input) {
+      s.queue = stage->input->stats();
+    }
+    s.timing = stage->recorder.snapshot();
+    stats.stages.push_back(std::move(s));
+  }
+  return stats;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
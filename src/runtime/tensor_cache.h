@@ -0,0 +1,387 @@
+#pragma once
+
+/**
+ * @file tensor_cache.h
+ * @brief 一次解码、多个工作流：每路摄像头共享的前处理结果缓存
+ *
+ * 一路摄像头被多个工作流使用时，输入尺寸相同的模型会对同一帧各自做一遍 letterbox + 归一化。
+ * 这里按帧缓存前处理结果：
+ * - CameraTensorCache 每路摄像头一个，attach(frame_id, frame) 返回该帧的 FrameTensorCache，
+ *   同一帧的所有工作流拿到同一个对象；所有持有者释放后缓存随帧一起释放
+ * - FrameTensorCache::tensor(key) 按（目标尺寸, letterbox / 拉伸, 填充值, 归一化, 通道顺序, 布局）查找，
+ *   第一个消费者计算，并发到达的其他消费者等待并复用同一结果
+ * - pyramid(level) 按需构建多尺度金字塔（每级宽高减半，同像素格式），各级从源帧所在的池分配，
+ *   同样随帧释放
+ *
+ * @code
+ * runtime::CameraTensorCache cache;
+ * auto frame_cache = cache.attach(frame_id, frame);       // 放进 WorkflowFrame 随帧传递
+ * runtime::TensorCacheKey key;
+ * key.width = key.height = 640;
+ * auto input = frame_cache->tensor(key);                   // 第一个工作流计算，其余复用
+ * describeTensor(..., input->data.data());
+ * float x = input->params.toSrcX(box_x);
+ * @endcode
+ */
+
+#include "algo_utils/letterbox_yuv.h"
+#include "runtime/frame_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+enum class TensorLayout {
+  kChw = 0,   // 平面 float（RGB_PLANAR），多数检测模型
+  kHwc        // 交错 float
+};
+
+/**
+ * @brief 前处理结果的缓存键（帧由 FrameTensorCache 本身确定）
+ */
+struct TensorCacheKey {
+  int width = 640;
+  int height = 640;
+  bool keep_aspect = true;          // true 为 letterbox（等比 + 填充），false 为拉伸到目标尺寸
+  float pad_value = 114.0f;         // letterbox 填充值（归一化前）
+  float norm = 1.0f / 255.0f;       // 归一化系数
+  bool rgb = true;                  // 输出通道顺序：true 为 RGB，false 为 BGR
+  bool yuv_full_range = false;      // YUV 源：BT.601 全范围 / 有限范围
+  TensorLayout layout = TensorLayout::kChw;
+
+  bool operator==(const TensorCacheKey& other) const {
+    return width == other.width && height == other.height &&
+           keep_aspect == other.keep_aspect && pad_value == other.pad_value &&
+           norm == other.norm && rgb == other.rgb && yuv_full_range == other.yuv_full_range &&
+           layout == other.layout;
+  }
+};
+
+struct TensorCacheKeyHash {
+  size_t operator()(const TensorCacheKey& key) const {
+    size_t h = std::hash<int>()(key.width);
+    auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+    mix(std::hash<int>()(key.height));
+    mix(std::hash<float>()(key.pad_value));
+    mix(std::hash<float>()(key.norm));
+    mix((key.rgb ? 1u : 0u) | (key.yuv_full_range ? 2u : 0u) | (key.keep_aspect ? 4u : 0u));
+    mix(static_cast<size_t>(key.layout));
+    return h;
+  }
+};
+
+/**
+ * @brief 前处理结果（只读共享）
+ */
+struct PreprocessedTensor {
+  TensorCacheKey key;
+  algo_utils::LetterboxParams params;   // 把模型坐标映射回原图
+  std::vector<float> data;              // 3 * width * height
+};
+
+/**
+ * @brief 每路摄像头的缓存统计快照
+ */
+struct TensorCacheStats {
+  uint64_t frames = 0;            // attach 创建的帧缓存数
+  uint64_t lookups = 0;
+  uint64_t hits = 0;              // 复用了已有（或正在计算的）有效结果
+  uint64_t computes = 0;
+  uint64_t compute_ns = 0;        // 实际计算耗时
+  uint64_t pyramid_levels = 0;    // 构建的金字塔层数
+  uint64_t live_frames = 0;       // 当前仍被持有的帧缓存
+
+  double hitRate() const {
+    return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+  }
+};
+
+namespace tensor_cache_detail {
+
+struct Counters {
+  std::atomic<uint64_t> frames{0};
+  std::atomic<uint64_t> lookups{0};
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> computes{0};
+  std::atomic<uint64_t> compute_ns{0};
+  std::atomic<uint64_t> pyramid_levels{0};
+};
+
+/**
+ * @brief 2x2 均值缩小一个平面（channels 为每像素交错的字节数）
+ */
+inline void downsamplePlane(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                            int dst_width, int dst_height, int channels) {
+  for (int y = 0; y < dst_height; ++y) {
+    const uint8_t* row0 = src + (2 * y) * src_stride;
+    const uint8_t* row1 = row0 + src_stride;
+    uint8_t* out = dst + y * dst_stride;
+    for (int x = 0; x < dst_width; ++x) {
+      const int i = 2 * x * channels;
+      for (int c = 0; c < channels; ++c) {
+        const int sum = row0[i + c] + row0[i + channels + c] + row1[i + c] +
+                        row1[i + channels + c];
+        out[x * channels + c] = static_cast<uint8_t>((sum + 2) >> 2);
+      }
+    }
+  }
+}
+
+}  // namespace tensor_cache_detail
+
+/**
+ * @brief 单帧的前处理缓存与金字塔
+ *
+ * 由 CameraTensorCache::attach 创建；持有源帧的引用（不拷贝像素），线程安全。
+ * 源帧持有所在池的引用，金字塔从同一个池分配，FramePool 对象先于缓存析构也不受影响。
+ */
+class FrameTensorCache {
+ public:
+  static constexpr int kMaxPyramidLevels = 8;
+
+  FrameTensorCache(int64_t frame_id, const VideoFrame& frame,
+                   std::shared_ptr<tensor_cache_detail::Counters> counters)
+      : frame_id_(frame_id), counters_(std::move(counters)) {
+    levels_[0] = frame;
+  }
+
+  FrameTensorCache(const FrameTensorCache&) = delete;
+  FrameTensorCache& operator=(const FrameTensorCache&) = delete;
+
+  int64_t frameId() const { return frame_id_; }
+  const VideoFrame& frame() const { return levels_[0]; }
+
+  /**
+   * @brief 取前处理结果：未命中时由调用线程计算，同一键的并发调用等待该结果
+   * @param hit 可选，返回是否复用了其他消费者的有效结果
+   * @return 源帧为空或格式不支持时返回 nullptr
+   */
+  std::shared_ptr<const PreprocessedTensor> tensor(const TensorCacheKey& key,
+                                                   bool* hit = nullptr);
+
+  /**
+   * @brief 金字塔第 level 级（0 为源帧，每级宽高减半）；首次访问时逐级构建
+   * @return level 越界或尺寸过小时返回空帧
+   */
+  VideoFrame pyramid(int level);
+
+ private:
+  struct Entry {
+    std::once_flag once;
+    std::shared_ptr<const PreprocessedTensor> tensor;
+  };
+
+  const int64_t frame_id_;
+  std::shared_ptr<tensor_cache_detail::Counters> counters_;
+
+  std::mutex mutex_;
+  std::unordered_map<TensorCacheKey, std::shared_ptr<Entry>, TensorCacheKeyHash> entries_;
+
+  std::mutex pyramid_mutex_;
+  VideoFrame levels_[kMaxPyramidLevels];
+
+  std::shared_ptr<const PreprocessedTensor> compute(const TensorCacheKey& key) const;
+};
+
+/**
+ * @brief 每路摄像头一个：把同一帧的多个消费者关联到同一个 FrameTensorCache
+ */
+class CameraTensorCache {
+ public:
+  CameraTensorCache() : counters_(std::make_shared<tensor_cache_detail::Counters>()) {}
+
+  /**
+   * @brief 取帧缓存：该帧已有仍被持有的缓存时返回同一对象，否则新建
+   *
+   * 只保存弱引用，缓存的生命周期由持有者（随帧传递的 WorkflowFrame 等）决定。
+   */
+  std::shared_ptr<FrameTensorCache> attach(int64_t frame_id, const VideoFrame& frame);
+
+  TensorCacheStats stats() const;
+
+ private:
+  std::shared_ptr<tensor_cache_detail::Counters> counters_;
+  mutable std::mutex mutex_;
+  std::vector<std::pair<int64_t, std::weak_ptr<FrameTensorCache>>> frames_;
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline std::shared_ptr<const PreprocessedTensor> FrameTensorCache::tensor(
+    const TensorCacheKey& key, bool* hit) {
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<Entry>& slot = entries_[key];
+    if (!slot) {
+      slot = std::make_shared<Entry>();
+    }
+    entry = slot;
+  }
+  bool computed = false;
+  std::call_once(entry->once, [&] {
+    const auto begin = std::chrono::steady_clock::now();
+    entry->tensor = compute(key);
+    computed = true;
+    counters_->computes.fetch_add(1, std::memory_order_relaxed);
+    counters_->compute_ns.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             begin)
+            .count(),
+        std::memory_order_relaxed);
+  });
+  // 源帧为空或格式不支持时结果为 nullptr，不算命中
+  const bool reused = !computed && entry->tensor;
+  counters_->lookups.fetch_add(1, std::memory_order_relaxed);
+  if (reused) {
+    counters_->hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (hit) {
+    *hit = reused;
+  }
+  return entry->tensor;
+}
+
+inline std::shared_ptr<const PreprocessedTensor> FrameTensorCache::compute(
+    const TensorCacheKey& key) const {
+  const VideoFrame& frame = levels_[0];
+  if (frame.empty() || key.width <= 0 || key.height <= 0) {
+    return nullptr;
+  }
+  auto result = std::make_shared<PreprocessedTensor>();
+  result->key = key;
+  result->data.resize(3 * static_cast<size_t>(key.width) * key.height);
+
+  algo_utils::LetterboxOptions options;
+  options.pad_value = key.pad_value;
+  options.norm = key.norm;
+  options.yuv_full_range = key.yuv_full_range;
+  options.keep_aspect = key.keep_aspect;
+  switch (frame.format()) {
+    case ALGO_PIXEL_FORMAT_BGR:
+    case ALGO_PIXEL_FORMAT_RGB:
+      // letterboxToPlanar 的 swap_rb 表示交换首尾通道
+      options.swap_rb = (frame.format() == ALGO_PIXEL_FORMAT_BGR) == key.rgb;
+      result->params = algo_utils::letterboxToPlanar(frame.plane(0), frame.width(),
+                                                     frame.height(), frame.stride(0),
+                                                     result->data.data(), key.width,
+                                                     key.height, options);
+      break;
+    case ALGO_PIXEL_FORMAT_NV12:
+    case ALGO_PIXEL_FORMAT_I420:
+      options.swap_rb = key.rgb;
+      result->params = algo_utils::letterboxYuvToPlanar(frame.yuvImage(), result->data.data(),
+                                                        key.width, key.height, options);
+      break;
+    default:
+      return nullptr;
+  }
+
+  if (key.layout == TensorLayout::kHwc) {
+    const size_t area = static_cast<size_t>(key.width) * key.height;
+    std::vector<float> hwc(result->data.size());
+    for (size_t i = 0; i < area; ++i) {
+      hwc[3 * i] = result->data[i];
+      hwc[3 * i + 1] = result->data[area + i];
+      hwc[3 * i + 2] = result->data[2 * area + i];
+    }
+    result->data.swap(hwc);
+  }
+  return result;
+}
+
+inline VideoFrame FrameTensorCache::pyramid(int level) {
+  if (level < 0 || level >= kMaxPyramidLevels) {
+    return VideoFrame();
+  }
+  std::lock_guard<std::mutex> lock(pyramid_mutex_);
+  for (int k = 1; k <= level; ++k) {
+    if (!levels_[k].empty()) {
+      continue;
+    }
+    const VideoFrame& src = levels_[k - 1];
+    if (src.empty()) {
+      return VideoFrame();
+    }
+    const bool yuv = plugin::isYuvFormat(src.format());
+    // YUV 格式宽高保持偶数
+    const int width = yuv ? (src.width() / 2) & ~1 : src.width() / 2;
+    const int height = yuv ? (src.height() / 2) & ~1 : src.height() / 2;
+    VideoFrame dst = VideoFrame::allocateLike(src, width, height, src.format());
+    if (dst.empty()) {
+      return VideoFrame();
+    }
+    for (int p = 0; p < dst.numPlanes(); ++p) {
+      int plane_width = p == 0 ? width : width / 2;
+      int plane_height = p == 0 ? height : height / 2;
+      int channels = 1;
+      if (src.format() == ALGO_PIXEL_FORMAT_BGR || src.format() == ALGO_PIXEL_FORMAT_RGB) {
+        channels = 3;
+      } else if (src.format() == ALGO_PIXEL_FORMAT_NV12 && p == 1) {
+        channels = 2;
+      }
+      tensor_cache_detail::downsamplePlane(src.plane(p), src.stride(p), dst.mutablePlane(p),
+                                           dst.stride(p), plane_width, plane_height, channels);
+    }
+    levels_[k] = std::move(dst);
+    counters_->pyramid_levels.fetch_add(1, std::memory_order_relaxed);
+  }
+  return levels_[level];
+}
+
+inline std::shared_ptr<FrameTensorCache> CameraTensorCache::attach(int64_t frame_id,
+                                                                   const VideoFrame& frame) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_ptr<FrameTensorCache> found;
+  // 顺带清理已释放的帧；在途帧数很少，线性查找即可
+  size_t kept = 0;
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    std::shared_ptr<FrameTensorCache> cache = frames_[i].second.lock();
+    if (!cache) {
+      continue;
+    }
+    if (frames_[i].first == frame_id) {
+      found = cache;
+    }
+    if (kept != i) {
+      frames_[kept] = std::move(frames_[i]);
+    }
+    ++kept;
+  }
+  frames_.resize(kept);
+  if (found) {
+    return found;
+  }
+  auto cache = std::make_shared<FrameTensorCache>(frame_id, frame, counters_);
+  frames_.emplace_back(frame_id, cache);
+  counters_->frames.fetch_add(1, std::memory_order_relaxed);
+  return cache;
+}
+
+inline TensorCacheStats CameraTensorCache::stats() const {
+  TensorCacheStats stats;
+  stats.frames = counters_->frames.load(std::memory_order_relaxed);
+  stats.lookups = counters_->lookups.load(std::memory_order_relaxed);
+  stats.hits = counters_->hits.load(std::memory_order_relaxed);
+  stats.computes = counters_->computes.load(std::memory_order_relaxed);
+  stats.compute_ns = counters_->compute_ns.load(std::memory_order_relaxed);
+  stats.pyramid_levels = counters_->pyramid_levels.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& kv : frames_) {
+    stats.live_frames += kv.second.expired() ? 0 : 1;
+  }
+  return stats;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
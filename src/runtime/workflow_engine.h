@@ -0,0 +1,383 @@
+#pragma once
+
+/**
+ * @file workflow_engine.h
+ * @brief 工作流 DAG 执行：互不依赖的分支在共享执行器（TaskExecutor）上并行
+ *
+ * 节点实现由 WorkflowNodeRegistry 按节点类型创建（插件推理节点的工厂共享同一个插件实例），
+ * 每路摄像头一个 WorkflowEngine：跟踪器等有状态节点不跨摄像头共享。
+ *
+ * 一帧的数据放在 WorkflowFrame 中：调用者放入源数据（如解码前的包或解码后的帧），
+ * 每个节点的输出在该节点的槽位里就地构造一次，下游节点通过 NodeIO::input<T>() 以常量引用读取，
+ * 不在节点之间拷贝。检测与 OCR 同时依赖同一帧时两者并行执行，读的是同一份图像。
+ * （槽位是 std::any，输出类型须可拷贝构造，但引擎从不拷贝；只能移动的类型用 shared_ptr 包装。）
+ *
+ * @code
+ * runtime::WorkflowEngine engine;
+ * engine.build(spec, registry, &error);
+ * runtime::WorkflowFrame frame(frame_id, timestamp_ms);
+ * frame.setSource(std::move(packet));
+ * engine.run(frame, {TaskPriority::kNormal, camera_index});
+ * const auto* events = frame.output<Events>(spec.find("rule"));
+ * @endcode
+ *
+ * 节点失败时其所有下游节点跳过（不执行），其他分支照常完成；run 返回第一个失败节点的状态。
+ */
+
+#include "algo_utils/stage_timer.h"
+#include "runtime/workflow_graph.h"
+#include "utils/one_logger.hpp"
+#include "utils/task_executor.hpp"
+
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+/**
+ * @brief 一帧在工作流中的全部数据：源数据 + 每个节点的输出槽位
+ */
+class WorkflowFrame {
+ public:
+  WorkflowFrame(int64_t frame_id = 0, int64_t timestamp_ms = 0)
+      : frame_id_(frame_id), timestamp_ms_(timestamp_ms) {}
+
+  WorkflowFrame(const WorkflowFrame&) = delete;
+  WorkflowFrame& operator=(const WorkflowFrame&) = delete;
+
+  int64_t frameId() const { return frame_id_; }
+  int64_t timestampMs() const { return timestamp_ms_; }
+
+  template <typename T>
+  void setSource(T&& value) {
+    source_ = std::forward<T>(value);
+  }
+
+  template <typename T>
+  const T* source() const {
+    return std::any_cast<T>(&source_);
+  }
+
+  /**
+   * @brief 节点输出（类型不符或该节点未执行时返回 nullptr）
+   */
+  template <typename T>
+  const T* output(int node) const {
+    return node >= 0 && node < static_cast<int>(outputs_.size())
+               ? std::any_cast<T>(&outputs_[node])
+               : nullptr;
+  }
+
+ private:
+  friend class WorkflowEngine;
+  friend class NodeIO;
+
+  int64_t frame_id_;
+  int64_t timestamp_ms_;
+  std::any source_;
+  std::vector<std::any> outputs_;     // 每个槽位只由对应节点写一次，下游在依赖完成后读取
+};
+
+/**
+ * @brief 一次节点执行的输入 / 输出视图
+ */
+class NodeIO {
+ public:
+  NodeIO(WorkflowFrame& frame, const WorkflowNodeSpec& spec, int self)
+      : frame_(frame), spec_(spec), self_(self) {}
+
+  const WorkflowFrame& frame() const { return frame_; }
+  const WorkflowNodeSpec& spec() const { return spec_; }
+  size_t numInputs() const { return spec_.inputs.size(); }
+
+  /**
+   * @brief 第 i 个上游节点的输出（常量引用语义，不拷贝）
+   */
+  template <typename T>
+  const T* input(size_t i = 0) const {
+    return i < spec_.inputs.size() ? frame_.output<T>(spec_.inputs[i]) : nullptr;
+  }
+
+  /**
+   * @brief 在本节点的槽位中就地构造输出
+   */
+  template <typename T, typename... Args>
+  T& emplaceOutput(Args&&... args) {
+    return frame_.outputs_[self_].template emplace<T>(std::forward<Args>(args)...);
+  }
+
+ private:
+  WorkflowFrame& frame_;
+  const WorkflowNodeSpec& spec_;
+  int self_;
+};
+
+class WorkflowNode {
+ public:
+  virtual ~WorkflowNode() = default;
+  virtual AlgoStatus run(NodeIO& io) = 0;
+};
+
+/**
+ * @brief 按函数实现的节点
+ */
+class FunctionNode : public WorkflowNode {
+ public:
+  using Fn = std::function<AlgoStatus(NodeIO& io)>;
+  explicit FunctionNode(Fn fn) : fn_(std::move(fn)) {}
+  AlgoStatus run(NodeIO& io) override { return fn_(io); }
+
+ private:
+  Fn fn_;
+};
+
+/**
+ * @brief 节点类型 -> 节点工厂
+ */
+class WorkflowNodeRegistry {
+ public:
+  /**
+   * @brief 创建节点，失败返回 nullptr 并写入原因
+   */
+  using Factory =
+      std::function<std::unique_ptr<WorkflowNode>(const WorkflowNodeSpec& spec,
+                                                  std::string* error)>;
+
+  void add(WorkflowNodeType type, Factory factory) { factories_[type] = std::move(factory); }
+
+  const Factory* find(WorkflowNodeType type) const {
+    auto it = factories_.find(type);
+    return it != factories_.end() ? &it->second : nullptr;
+  }
+
+ private:
+  std::map<WorkflowNodeType, Factory> factories_;
+};
+
+/**
+ * @brief 单个节点的统计快照
+ */
+struct WorkflowNodeStats {
+  std::string id;
+  WorkflowNodeType type = WorkflowNodeType::kDecode;
+  uint64_t failed = 0;
+  uint64_t skipped = 0;               // 上游失败而未执行
+  algo_utils::StageStats run;         // 执行耗时
+};
+
+class WorkflowEngine {
+ public:
+  explicit WorkflowEngine(TaskExecutor& executor = TaskExecutor::getInstance())
+      : executor_(executor) {}
+
+  WorkflowEngine(const WorkflowEngine&) = delete;
+  WorkflowEngine& operator=(const WorkflowEngine&) = delete;
+
+  /**
+   * @brief 按工作流定义创建全部节点（任一节点类型未注册或创建失败即整体失败）
+   */
+  AlgoStatus build(const WorkflowSpec& spec, const WorkflowNodeRegistry& registry,
+                   std::string* error);
+
+  /**
+   * @brief 执行一帧，返回时所有节点已完成（调用线程等待期间也执行节点）
+   *
+   * 同一引擎的 run 串行执行：跟踪器等有状态节点按帧顺序看到输入。多个线程同时调用时后到的等待，
+   * 需要并行处理多路摄像头时每路各用一个引擎。
+   * @param options 提交到执行器的优先级与亲和性（如摄像头序号）
+   */
+  AlgoStatus run(WorkflowFrame& frame, const TaskOptions& options = {});
+
+  const WorkflowSpec& spec() const { return spec_; }
+  std::vector<WorkflowNodeStats> stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Node {
+    std::unique_ptr<WorkflowNode> impl;
+    std::vector<int> successors;
+    algo_utils::StageRecorder recorder{"run"};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> skipped{0};
+  };
+
+  /**
+   * @brief 一次 run 的状态（每帧独立，节点任务持有它的引用，run 返回前全部完成）
+   */
+  struct RunState {
+    WorkflowFrame& frame;
+    TaskOptions options;
+    std::unique_ptr<std::atomic<int>[]> remaining;    // 未完成的上游节点数
+    std::vector<AlgoStatus> status;                   // 每个节点只由自己写
+    TaskGroup group;
+  };
+
+  TaskExecutor& executor_;
+  WorkflowSpec spec_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::vector<int> roots_;
+  std::mutex run_mutex_;      // run 串行：有状态节点不并发
+
+  void execute(RunState& state, int index);
+};
+
+// ============================================================================
+// 内联实现
+// ============================================================================
+
+inline AlgoStatus WorkflowEngine::build(const WorkflowSpec& spec,
+                                        const WorkflowNodeRegistry& registry,
+                                        std::string* error) {
+  std::vector<std::unique_ptr<Node>> nodes;
+  std::vector<int> roots;
+  for (size_t i = 0; i < spec.nodes.size(); ++i) {
+    const WorkflowNodeSpec& node_spec = spec.nodes[i];
+    const WorkflowNodeRegistry::Factory* factory = registry.find(node_spec.type);
+    std::string reason;
+    std::unique_ptr<Node> node(new Node());
+    if (factory) {
+      node->impl = (*factory)(node_spec, &reason);
+    } else {
+      reason = std::string("no factory for node type '") + workflowNodeTypeName(node_spec.type) +
+               "'";
+    }
+    if (!node->impl) {
+      if (error) {
+        *error = "node '" + node_spec.id + "': " + reason;
+      }
+      return ALGO_STATUS_ERROR_INVALID_PARAM;
+    }
+    for (int input : node_spec.inputs) {
+      if (input < 0 || input >= static_cast<int>(i)) {
+        if (error) {
+          *error = "node '" + node_spec.id + "': inputs are not in topological order";
+        }
+        return ALGO_STATUS_ERROR_INVALID_PARAM;
+      }
+      nodes[input]->successors.push_back(static_cast<int>(i));
+    }
+    if (node_spec.inputs.empty()) {
+      roots.push_back(static_cast<int>(i));
+    }
+    nodes.push_back(std::move(node));
+  }
+  spec_ = spec;
+  nodes_ = std::move(nodes);
+  roots_ = std::move(roots);
+  return ALGO_STATUS_SUCCESS;
+}
+
+inline AlgoStatus WorkflowEngine::run(WorkflowFrame& frame, const TaskOptions& options) {
+  const size_t n = nodes_.size();
+  if (n == 0) {
+    return ALGO_STATUS_ERROR_NOT_INITIALIZED;
+  }
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  frame.outputs_.clear();
+  frame.outputs_.resize(n);
+
+  RunState state{frame, options, std::unique_ptr<std::atomic<int>[]>(new std::atomic<int>[n]),
+                 std::vector<AlgoStatus>(n, ALGO_STATUS_SUCCESS), {}};
+  for (size_t i = 0; i < n; ++i) {
+    state.remaining[i].store(static_cast<int>(spec_.nodes[i].inputs.size()),
+                             std::memory_order_relaxed);
+  }
+  // 第一个根节点在调用线程上直接执行，其余根节点交给执行器
+  for (size_t r = 1; r < roots_.size(); ++r) {
+    const int root = roots_[r];
+    executor_.submit(state.group, [this, &state, root] { execute(state, root); }, options);
+  }
+  execute(state, roots_[0]);
+  executor_.wait(state.group);
+
+  for (size_t i = 0; i < n; ++i) {
+    if (state.status[i] != ALGO_STATUS_SUCCESS) {
+      return state.status[i];
+    }
+  }
+  return ALGO_STATUS_SUCCESS;
+}
+
+inline void WorkflowEngine::execute(RunState& state, int index) {
+  // 链式节点就地继续执行：只有第二个及以后就绪的下游才提交到执行器
+  while (index >= 0) {
+    const WorkflowNodeSpec& spec = spec_.nodes[index];
+    Node& node = *nodes_[index];
+
+    AlgoStatus upstream = ALGO_STATUS_SUCCESS;
+    for (int input : spec.inputs) {
+      if (state.status[input] != ALGO_STATUS_SUCCESS) {
+        upstream = state.status[input];
+        break;
+      }
+    }
+    if (upstream != ALGO_STATUS_SUCCESS) {
+      state.status[index] = upstream;
+      node.skipped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      NodeIO io(state.frame, spec, index);
+      const Clock::time_point begin = Clock::now();
+      AlgoStatus status;
+      try {
+        status = node.impl->run(io);
+      } catch (const std::exception& e) {
+        LOG_ERROR("Workflow {} node {} threw: {}", spec_.workflow_id, spec.id, e.what());
+        status = ALGO_STATUS_ERROR_UNKNOWN;
+      } catch (...) {
+        // 异常不能离开 execute：执行器上的任务还持有 run 栈上的 state
+        LOG_ERROR("Workflow {} node {} threw a non-standard exception", spec_.workflow_id,
+                  spec.id);
+        status = ALGO_STATUS_ERROR_UNKNOWN;
+      }
+      node.recorder.record(0, static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+      node.recorder.addFrame();
+      state.status[index] = status;
+      if (status != ALGO_STATUS_SUCCESS) {
+        node.failed.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    int next = -1;
+    for (int succ : node.successors) {
+      // acq_rel：最后一个完成的上游把所有上游的输出与状态发布给下游
+      if (state.remaining[succ].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        continue;
+      }
+      if (next < 0) {
+        next = succ;
+      } else {
+        executor_.submit(state.group, [this, &state, succ] { execute(state, succ); },
+                         state.options);
+      }
+    }
+    index = next;
+  }
+}
+
+inline std::vector<WorkflowNodeStats> WorkflowEngine::stats() const {
+  std::vector<WorkflowNodeStats> result;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    WorkflowNodeStats s;
+    s.id = spec_.nodes[i].id;
+    s.type = spec_.nodes[i].type;
+    s.failed = nodes_[i]->failed.load(std::memory_order_relaxed);
+    s.skipped = nodes_[i]->skipped.load(std::memory_order_relaxed);
+    s.run = nodes_[i]->recorder.snapshot().stages[0];
+    result.push_back(std::move(s));
+  }
+  return result;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
@@ -0,0 +1,195 @@
+/**
+ * @file workflow_engine_bench.cc
+ * @brief 工作流 DAG：检测与 OCR 两个分支在共享执行器上并行执行同一帧
+ *
+ * 工作流 decode -> preprocess -> det -> tracker ─┐
+ *                 └──────────────> ocr ──────────┴─> rule -> publish
+ * 各节点耗时用 sleep 模拟（推理节点等待加速器，默认 det 8 ms、ocr 10 ms）。
+ * 输出每帧耗时与各节点耗时之和（串行执行的耗时）、每个节点的耗时 / 失败 / 跳过次数，
+ * 以及解码图像被拷贝的次数（节点之间按引用传递，应为 0）。每 10 帧 OCR 失败一次，
+ * 检查只有依赖 OCR 的节点被跳过。
+ *
+ * 用法: workflow_engine_bench [frames] [det_ms] [ocr_ms]
+ */
+
+#include "runtime/workflow_engine.h"
+#include "utils/one_logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace infer_frame;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<int> g_image_copies{0};
+
+struct Image {
+  std::vector<uint8_t> pixels;
+
+  explicit Image(size_t bytes) : pixels(bytes) {}
+  Image(const Image& other) : pixels(other.pixels) { g_image_copies.fetch_add(1); }
+  Image(Image&&) = default;
+  Image& operator=(const Image& other) {
+    pixels = other.pixels;
+    g_image_copies.fetch_add(1);
+    return *this;
+  }
+  Image& operator=(Image&&) = default;
+};
+
+struct Detections {
+  int count = 0;
+};
+
+struct Events {
+  int detections = 0;
+  int texts = 0;
+};
+
+const char* kWorkflowJson = R"({
+  "name": "det_ocr",
+  "nodes": [
+    {"id": "decode", "type": "decode"},
+    {"id": "pre", "type": "preprocess", "inputs": ["decode"]},
+    {"id": "det", "type": "inference", "plugin": "yolov8", "inputs": ["pre"],
+     "params": {"sleep_ms": 8}},
+    {"id": "ocr", "type": "inference", "plugin": "paddleocr", "inputs": ["decode"],
+     "params": {"sleep_ms": 10}},
+    {"id": "track", "type": "tracker", "inputs": ["det"]},
+    {"id": "rule", "type": "rule", "inputs": ["track", "ocr"]},
+    {"id": "publish", "type": "publish", "inputs": ["rule"]}
+  ]
+})";
+
+void work(double ms) {
+  std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int>(ms * 1000)));
+}
+
+runtime::WorkflowNodeRegistry makeRegistry() {
+  using runtime::FunctionNode;
+  using runtime::NodeIO;
+  using runtime::WorkflowNodeSpec;
+  runtime::WorkflowNodeRegistry registry;
+  registry.add(runtime::WorkflowNodeType::kDecode, [](const WorkflowNodeSpec&, std::string*) {
+    return std::unique_ptr<runtime::WorkflowNode>(new FunctionNode([](NodeIO& io) {
+      work(2.0);
+      io.emplaceOutput<Image>(1920 * 1080 * 3 / 2);
+      return ALGO_STATUS_SUCCESS;
+    }));
+  });
+  registry.add(runtime::WorkflowNodeType::kPreprocess, [](const WorkflowNodeSpec&, std::string*) {
+    return std::unique_ptr<runtime::WorkflowNode>(new FunctionNode([](NodeIO& io) {
+      const Image* image = io.input<Image>();
+      if (!image) {
+        return ALGO_STATUS_ERROR_INVALID_PARAM;
+      }
+      work(1.0);
+      io.emplaceOutput<Image>(640 * 640 * 3);
+      return ALGO_STATUS_SUCCESS;
+    }));
+  });
+  registry.add(runtime::WorkflowNodeType::kInference,
+               [](const WorkflowNodeSpec& spec, std::string*) {
+    const double ms = spec.params.value("sleep_ms", 5.0);
+    const bool ocr = spec.plugin == "paddleocr";
+    return std::unique_ptr<runtime::WorkflowNode>(new FunctionNode([ms, ocr](NodeIO& io) {
+      if (!io.input<Image>()) {
+        return ALGO_STATUS_ERROR_INVALID_PARAM;
+      }
+      work(ms);
+      if (ocr && io.frame().frameId() % 10 == 9) {
+        return ALGO_STATUS_ERROR_INFERENCE;
+      }
+      io.emplaceOutput<Detections>(Detections{ocr ? 2 : 5});
+      return ALGO_STATUS_SUCCESS;
+    }));
+  });
+  registry.add(runtime::WorkflowNodeType::kTracker, [](const WorkflowNodeSpec&, std::string*) {
+    return std::unique_ptr<runtime::WorkflowNode>(new FunctionNode([](NodeIO& io) {
+      work(0.5);
+      io.emplaceOutput<Detections>(*io.input<Detections>());
+      return ALGO_STATUS_SUCCESS;
+    }));
+  });
+  registry.add(runtime::WorkflowNodeType::kRule, [](const WorkflowNodeSpec&, std::string*) {
+    return std::unique_ptr<runtime::WorkflowNode>(new FunctionNode([](NodeIO& io) {
+      io.emplaceOutput<Events>(Events{io.input<Detections>(0)->count,
+                                      io.input<Detections>(1)->count});
+      return ALGO_STATUS_SUCCESS;
+    }));
+  });
+  registry.add(runtime::WorkflowNodeType::kPublish, [](const WorkflowNodeSpec&, std::string*) {
+    return std::unique_ptr<runtime::WorkflowNode>(new FunctionNode([](NodeIO& io) {
+      work(0.5);
+      return io.input<Events>() ? ALGO_STATUS_SUCCESS : ALGO_STATUS_ERROR_INVALID_PARAM;
+    }));
+  });
+  return registry;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int frames = argc > 1 ? std::stoi(argv[1]) : 100;
+  std::map<std::string, std::string> overrides;
+  if (argc > 2) {
+    overrides["det.sleep_ms"] = argv[2];
+  }
+  if (argc > 3) {
+    overrides["ocr.sleep_ms"] = argv[3];
+  }
+
+  runtime::WorkflowSpec spec;
+  std::string error;
+  if (runtime::parseWorkflow("wf_bench", kWorkflowJson, overrides, &spec, &error) !=
+      ALGO_STATUS_SUCCESS) {
+    LOG_ERROR("Failed to parse workflow: {}", error);
+    return 1;
+  }
+  TaskExecutorOptions executor_options;
+  executor_options.num_workers = 4;
+  TaskExecutor executor(executor_options);
+  runtime::WorkflowEngine engine(executor);
+  if (engine.build(spec, makeRegistry(), &error) != ALGO_STATUS_SUCCESS) {
+    LOG_ERROR("Failed to build workflow: {}", error);
+    return 1;
+  }
+
+  LOG_INFO("======================================");
+  LOG_INFO("  Workflow Engine Benchmark");
+  LOG_INFO("  workflow '{}', {} nodes, {} frames, {} workers", spec.name, spec.nodes.size(),
+           frames, executor.numWorkers());
+  LOG_INFO("======================================");
+
+  int failed_frames = 0;
+  int events = 0;
+  const auto begin = Clock::now();
+  for (int i = 0; i < frames; ++i) {
+    runtime::WorkflowFrame frame(i, i * 40);
+    if (engine.run(frame, {TaskPriority::kNormal, 0}) != ALGO_STATUS_SUCCESS) {
+      ++failed_frames;
+    }
+    events += frame.output<Events>(spec.find("rule")) != nullptr;
+  }
+  const double frame_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / frames;
+
+  double serial_ms = 0.0;
+  LOG_INFO("{:<10} {:<11} {:>9} {:>7} {:>8}", "node", "type", "avg us", "failed", "skipped");
+  for (const runtime::WorkflowNodeStats& node : engine.stats()) {
+    LOG_INFO("{:<10} {:<11} {:>9.0f} {:>7} {:>8}", node.id,
+             runtime::workflowNodeTypeName(node.type), node.run.avgUs(), node.failed,
+             node.skipped);
+    serial_ms += node.run.count > 0 ? node.run.total_ns / 1e6 / frames : 0.0;
+  }
+  LOG_INFO("per frame: {:.2f} ms (serial sum {:.2f} ms), failed frames {}, frames with events {}",
+           frame_ms, serial_ms, failed_frames, events);
+  LOG_INFO("image copies between nodes: {}", g_image_copies.load());
+  return 0;
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+/**
+ * @file workflow_graph.h
+ * @brief DeployWorkflowRequest.workflow_json 的解析与校验：节点 DAG
+ *
+ * 格式：
+ * @code
+ * {
+ *   "name": "det_ocr",
+ *   "nodes": [
+ *     {"id": "decode", "type": "decode"},
+ *     {"id": "pre", "type": "preprocess", "inputs": ["decode"]},
+ *     {"id": "det", "type": "inference", "plugin": "yolov8", "inputs": ["pre"],
+ *      "params": {"conf_threshold": 0.25}},
+ *     {"id": "ocr", "type": "inference", "plugin": "paddleocr", "inputs": ["decode"]},
+ *     {"id": "track", "type": "tracker", "inputs": ["det"]},
+ *     {"id": "rule", "type": "rule", "inputs": ["track", "ocr"]},
+ *     {"id": "publish", "type": "publish", "inputs": ["rule"]}
+ *   ]
+ * }
+ * @endcode
+ *
+ * DeployWorkflowRequest.params 中 "<节点 id>.<参数>" 形式的键覆盖对应节点的 params
+ * （值按 JSON 解析，解析失败按字符串处理），其余键保留为工作流级参数。
+ * 解析后的节点按拓扑序排列，inputs 转换为节点序号。
+ */
+
+#include "plugin/algo_plugin_interface.h"
+
+#include <nlohmann/json.hpp>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace infer_frame {
+namespace runtime {
+
+enum class WorkflowNodeType {
+  kDecode = 0,
+  kPreprocess,
+  kInference,
+  kTracker,
+  kRule,
+  kEncoder,
+  kPublish,
+  kNumTypes
+};
+
+inline const char* workflowNodeTypeName(WorkflowNodeType type) {
+  static const char* const kNames[] = {"decode", "preprocess", "inference", "tracker",
+                                       "rule",   "encoder",    "publish"};
+  const int index = static_cast<int>(type);
+  return index >= 0 && index < static_cast<int>(WorkflowNodeType::kNumTypes) ? kNames[index]
+                                                                              : "unknown";
+}
+
+inline bool parseWorkflowNodeType(const std::string& name, WorkflowNodeType* type) {
+  for (int i = 0; i < static_cast<int>(WorkflowNodeType::kNumTypes); ++i) {
+    if (name == workflowNodeTypeName(static_cast<WorkflowNodeType>(i))) {
+      *type = static_cast<WorkflowNodeType>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+struct WorkflowNodeSpec {
+  std::string id;
+  WorkflowNodeType type = WorkflowNodeType::kDecode;
+  std::string plugin;                 // inference 节点使用的插件名
+  std::vector<int> inputs;            // 上游节点序号（均小于本节点序号）
+  nlohmann::json params = nlohmann::json::object();
+};
+
+struct WorkflowSpec {
+  std::string workflow_id;
+  std::string name;
+  std::vector<WorkflowNodeSpec> nodes;            // 拓扑序
+  std::map<std::string, std::string> params;      // 工作流级参数（未指向节点的覆盖项）
+
+  int find(const std::string& id) const {
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (nodes[i].id == id) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+};
+
+/**
+ * @brief 解析工作流定义
+ * @param overrides DeployWorkflowRequest.params
+ * @param error 失败时写入原因（用于 DeployWorkflowResponse.message）
+ * @return 格式错误、节点类型未知、id 重复、输入不存在或存在环时返回 INVALID_PARAM
+ */
+inline AlgoStatus parseWorkflow(const std::string& workflow_id, const std::string& workflow_json,
+                                const std::map<std::string, std::string>& overrides,
+                                WorkflowSpec* spec, std::string* error) {
+  auto fail = [error](const std::string& message) {
+    if (error) {
+      *error = message;
+    }
+    return ALGO_STATUS_ERROR_INVALID_PARAM;
+  };
+
+  nlohmann::json root = nlohmann::json::parse(workflow_json, nullptr, false);
+  if (root.is_discarded() || !root.is_object()) {
+    return fail("workflow_json is not a JSON object");
+  }
+  auto nodes_it = root.find("nodes");
+  if (nodes_it == root.end() || !nodes_it->is_array() || nodes_it->empty()) {
+    return fail("workflow has no nodes");
+  }
+
+  // 先按声明顺序读出节点，再按 Kahn 算法排成拓扑序
+  std::vector<WorkflowNodeSpec> declared;
+  std::vector<std::vector<std::string>> input_ids;
+  std::unordered_map<std::string, int> index_of;
+  try {
+    for (const nlohmann::json& node : *nodes_it) {
+      WorkflowNodeSpec node_spec;
+      node_spec.id = node.at("id").get<std::string>();
+      const std::string type = node.at("type").get<std::string>();
+      if (node_spec.id.empty()) {
+        return fail("node id is empty");
+      }
+      if (!parseWorkflowNodeType(type, &node_spec.type)) {
+        return fail("node '" + node_spec.id + "' has unknown type '" + type + "'");
+      }
+      node_spec.plugin = node.value("plugin", std::string());
+      if (node_spec.type == WorkflowNodeType::kInference && node_spec.plugin.empty()) {
+        return fail("inference node '" + node_spec.id + "' has no plugin");
+      }
+      if (node.contains("params")) {
+        node_spec.params = node.at("params");
+        if (!node_spec.params.is_object()) {
+          return fail("params of node '" + node_spec.id + "' is not an object");
+        }
+      }
+      std::vector<std::string> inputs;
+      if (node.contains("inputs")) {
+        inputs = node.at("inputs").get<std::vector<std::string>>();
+      }
+      if (!index_of.emplace(node_spec.id, static_cast<int>(declared.size())).second) {
+        return fail("duplicate node id '" + node_spec.id + "'");
+      }
+      declared.push_back(std::move(node_spec));
+      input_ids.push_back(std::move(inputs));
+    }
+  } catch (const nlohmann::json::exception& e) {
+    return fail(std::string("invalid node definition: ") + e.what());
+  }
+
+  const size_t n = declared.size();
+  std::vector<std::vector<int>> successors(n);
+  std::vector<int> in_degree(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    for (const std::string& input : input_ids[i]) {
+      auto it = index_of.find(input);
+      if (it == index_of.end()) {
+        return fail("node '" + declared[i].id + "' has unknown input '" + input + "'");
+      }
+      successors[it->second].push_back(static_cast<int>(i));
+      ++in_degree[i];
+    }
+  }
+  std::vector<int> order;
+  std::vector<int> ready;
+  for (size_t i = 0; i < n; ++i) {
+    if (in_degree[i] == 0) {
+      ready.push_back(static_cast<int>(i));
+    }
+  }
+  // 同一层按声明顺序输出，拓扑序稳定
+  for (size_t head = 0; head < ready.size(); ++head) {
+    const int i = ready[head];
+    order.push_back(i);
+    for (int succ : successors[i]) {
+      if (--in_degree[succ] == 0) {
+        ready.push_back(succ);
+      }
+    }
+  }
+  if (order.size() != n) {
+    return fail("workflow graph has a cycle");
+  }
+
+  std::vector<int> position(n);
+  for (size_t k = 0; k < n; ++k) {
+    position[order[k]] = static_cast<int>(k);
+  }
+  WorkflowSpec result;
+  result.workflow_id = workflow_id;
+  result.name = root.value("name", workflow_id);
+  for (int i : order) {
+    WorkflowNodeSpec node = std::move(declared[i]);
+    for (const std::string& input : input_ids[i]) {
+      node.inputs.push_back(position[index_of[input]]);
+    }
+    result.nodes.push_back(std::move(node));
+  }
+
+  for (const auto& kv : overrides) {
+    const size_t dot = kv.first.find('.');
+    const int node = dot == std::string::npos ? -1 : result.find(kv.first.substr(0, dot));
+    if (node < 0) {
+      result.params[kv.first] = kv.second;
+      continue;
+    }
+    nlohmann::json value = nlohmann::json::parse(kv.second, nullptr, false);
+    result.nodes[node].params[kv.first.substr(dot + 1)] =
+        value.is_discarded() ? nlohmann::json(kv.second) : value;
+  }
+
+  *spec = std::move(result);
+  return ALGO_STATUS_SUCCESS;
+}
+
+}  // namespace runtime
+}  // namespace infer_frame
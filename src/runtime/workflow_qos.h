@@ -0,0 +1,190 @@
+#pragma once
+
+/**
+ * @file workflow_qos.h
+ * @brief 工作流的优先级、权重与延迟 SLO
+ *
+ * 在 DeployWorkflowRequest.params 中配置（工作流级参数，见 workflow_graph.h）：
+ * - priority：high / normal / low。high 严格优先（安全区域摄像头不排在全景摄像头后面），
+ *   normal 与 low 的所有工作流在同一个加权公平排队域中分享（优先级权重默认 4 : 1，与 TaskExecutor 相同）
+ * - weight：工作流的份额（1..1000，默认 1），与优先级权重相乘，BatchScheduler 按加权公平排队组 batch
+ * - latency_slo_ms：延迟目标，0 表示使用优先级的默认值（high 100 ms、normal 500 ms、low 2000 ms）
+ *
+ * 优先级直接对应 TaskExecutor 的 TaskPriority，taskOptions() 生成提交任务用的 TaskOptions。
+ * SloTracker 按优先级统计延迟直方图与 SLO 达成率；被丢弃的帧用 recordMiss 计为未达成。
+ *
+ * @code
+ * runtime::WorkflowQos qos;
+ * if (!runtime::parseWorkflowQos(spec.params, &qos)) { ... }
+ * batch_scheduler.setWorkflowQos(workflow_id, qos);
+ * engine.run(frame, runtime::taskOptions(qos, camera_id));
+ * @endcode
+ */
+
+#include "algo_utils/stage_timer.h"
+#include "utils/one_logger.hpp"
+#include "utils/task_executor.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <string>
+
+namespace infer_frame {
+namespace runtime {
+
+struct WorkflowQos {
+  TaskPriority priority = TaskPriority::kNormal;
+  int weight = 1;
+  int latency_slo_ms = 0;     // 0 表示使用优先级的默认值
+
+  int sloMs() const;
+};
+
+inline const char* priorityClassName(TaskPriority priority) {
+  static const char* const kNames[kNumTaskPriorities] = {"high", "normal", "low"};
+  const int index = static_cast<int>(priority);
+  return index >= 0 && index < kNumTaskPriorities ? kNames[index] : "unknown";
+}
+
+inline bool parsePriorityClass(const std::string& name, TaskPriority* priority) {
+  for (int i = 0; i < kNumTaskPriorities; ++i) {
+    if (name == priorityClassName(static_cast<TaskPriority>(i))) {
+      *priority = static_cast<TaskPriority>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+inline int defaultLatencySloMs(TaskPriority priority) {
+  switch (priority) {
+    case TaskPriority::kHigh:
+      return 100;
+    case TaskPriority::kNormal:
+      return 500;
+    default:
+      return 2000;
+  }
+}
+
+inline int WorkflowQos::sloMs() const {
+  return latency_slo_ms > 0 ? latency_slo_ms : defaultLatencySloMs(priority);
+}
+
+/**
+ * @brief 从工作流级参数读取 priority / weight / latency_slo_ms（未出现的键保持原值）
+ * @return 取值非法时返回 false，qos 保持不变
+ */
+inline bool parseWorkflowQos(const std::map<std::string, std::string>& params,
+                             WorkflowQos* qos) {
+  WorkflowQos parsed = *qos;
+  auto it = params.find("priority");
+  if (it != params.end() && !parsePriorityClass(it->second, &parsed.priority)) {
+    LOG_WARN("Invalid workflow priority '{}'", it->second);
+    return false;
+  }
+  try {
+    if ((it = params.find("weight")) != params.end()) {
+      parsed.weight = std::stoi(it->second);
+    }
+    if ((it = params.find("latency_slo_ms")) != params.end()) {
+      parsed.latency_slo_ms = std::stoi(it->second);
+    }
+  } catch (const std::exception& e) {
+    LOG_WARN("Invalid workflow qos params: {}", e.what());
+    return false;
+  }
+  if (parsed.weight < 1 || parsed.weight > 1000 || parsed.latency_slo_ms < 0) {
+    LOG_WARN("Invalid workflow qos params: weight {}, latency_slo_ms {}", parsed.weight,
+             parsed.latency_slo_ms);
+    return false;
+  }
+  *qos = parsed;
+  return true;
+}
+
+/**
+ * @brief 工作流任务提交到 TaskExecutor 时使用的选项
+ */
+inline TaskOptions taskOptions(const WorkflowQos& qos, int affinity = -1) {
+  return TaskOptions{qos.priority, affinity};
+}
+
+/**
+ * @brief 单个优先级的 SLO 达成情况
+ */
+struct SloClassStats {
+  uint64_t frames = 0;    // 含被丢弃的帧
+  uint64_t met = 0;       // 延迟不超过 SLO 的帧数
+  uint64_t dropped = 0;   // 被挤出 / 拒绝而未完成的帧（计为未达成）
+
+  double attainment() const {
+    return frames > 0 ? static_cast<double>(met) / static_cast<double>(frames) : 1.0;
+  }
+};
+
+struct SloReport {
+  SloClassStats classes[kNumTaskPriorities];
+  algo_utils::PerfStats latency;    // 阶段 "high" / "normal" / "low"：各优先级的延迟直方图
+
+  const SloClassStats& of(TaskPriority priority) const {
+    return classes[static_cast<int>(priority)];
+  }
+};
+
+/**
+ * @brief 按优先级统计延迟与 SLO 达成率（线程安全）
+ */
+class SloTracker {
+ public:
+  SloTracker() = default;
+  SloTracker(const SloTracker&) = delete;
+  SloTracker& operator=(const SloTracker&) = delete;
+
+  void record(const WorkflowQos& qos, uint64_t latency_ns) {
+    const int p = static_cast<int>(qos.priority);
+    if (p < 0 || p >= kNumTaskPriorities) {
+      return;
+    }
+    recorder_.record(p, latency_ns);
+    recorder_.addFrame();
+    frames_[p].fetch_add(1, std::memory_order_relaxed);
+    if (latency_ns <= static_cast<uint64_t>(qos.sloMs()) * 1000000ULL) {
+      met_[p].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief 记录一帧被丢弃（排队已满被挤出或拒绝）：计入帧数但不计入达成，也不进入延迟直方图
+   */
+  void recordMiss(const WorkflowQos& qos) {
+    const int p = static_cast<int>(qos.priority);
+    if (p < 0 || p >= kNumTaskPriorities) {
+      return;
+    }
+    frames_[p].fetch_add(1, std::memory_order_relaxed);
+    dropped_[p].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  SloReport snapshot() const {
+    SloReport report;
+    for (int p = 0; p < kNumTaskPriorities; ++p) {
+      report.classes[p].frames = frames_[p].load(std::memory_order_relaxed);
+      report.classes[p].met = met_[p].load(std::memory_order_relaxed);
+      report.classes[p].dropped = dropped_[p].load(std::memory_order_relaxed);
+    }
+    report.latency = recorder_.snapshot();
+    return report;
+  }
+
+ private:
+  std::atomic<uint64_t> frames_[kNumTaskPriorities] = {};
+  std::atomic<uint64_t> met_[kNumTaskPriorities] = {};
+  std::atomic<uint64_t> dropped_[kNumTaskPriorities] = {};
+  algo_utils::StageRecorder recorder_{"high", "normal", "low"};
+};
+
+}  // namespace runtime
+}  // namespace infer_frame